@@ -0,0 +1,91 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+// Std
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * Small helpers shared by the benchmarks.
+ *
+ * Each benchmark is a standalone executable printing one line per result,
+ * so the output of two builds can be compared with diff.
+ */
+namespace Benchmark {
+
+///The resident set size in kB, 0 if it cannot be read (not Linux)
+inline long rss()
+{
+   QFile f(QStringLiteral("/proc/self/status"));
+
+   if (!f.open(QIODevice::ReadOnly))
+      return 0;
+
+   while (!f.atEnd()) {
+      const QByteArray line = f.readLine();
+
+      if (line.startsWith("VmRSS:"))
+         return line.mid(6).trimmed().split(' ').first().toLong();
+   }
+
+   return 0;
+}
+
+/**
+ * Call "f" until at least "minMs" milliseconds elapsed.
+ *
+ * @return the average duration of a call in microseconds
+ */
+template<typename F>
+double measure(F f, int minMs = 500)
+{
+   // Warm up the caches and the pools
+   f();
+
+   QElapsedTimer timer;
+   timer.start();
+
+   qint64 count = 0;
+
+   do {
+      f();
+      count++;
+   } while (timer.elapsed() < minMs);
+
+   return timer.nsecsElapsed() / 1000.0 / count;
+}
+
+inline void report(const char* name, double value, const char* unit)
+{
+   printf("%-40s %14.2f %s\n", name, value, unit);
+   fflush(stdout);
+}
+
+///The argument at "index" as a number, or "value" if it is missing
+inline int argument(int argc, char* argv[], int index, int value)
+{
+   return argc > index ? atoi(argv[index]) : value;
+}
+
+} // namespace Benchmark
@@ -0,0 +1,75 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+/**
+ * Generate text conversations in the format of the JSON recordings.
+ */
+namespace Conversation {
+
+///A plain text message, "index" makes each of them different
+inline QJsonObject message(int index)
+{
+   QJsonObject payload;
+   payload["payload" ] = QStringLiteral("Message number %1, with a few words to make it realistic").arg(index);
+   payload["mimeType"] = QStringLiteral("text/plain");
+
+   QJsonObject message;
+   message["timestamp" ] = 1460000000 + index;
+   message["authorSha1"] = QStringLiteral("4c3ad6a5c0b6b6e5d2b6a0e4c7a3f3f1e6b2d9c8");
+   message["isRead"    ] = true;
+   message["direction" ] = index % 2;
+   message["type"      ] = 0;
+   message["id"        ] = QString::number(index);
+   message["payloads"  ] = QJsonArray { payload };
+
+   return message;
+}
+
+/**
+ * A whole recording file with "count" messages in a single group.
+ *
+ * There is no peer, so loading it doesn't need the contact methods.
+ */
+inline QJsonObject recording(const QString& sha1, int count)
+{
+   QJsonArray messages;
+
+   for (int i = 0; i < count; i++)
+      messages.append(message(i));
+
+   QJsonObject group;
+   group["id"           ] = 0;
+   group["nextGroupSha1"] = QString();
+   group["nextGroupId"  ] = 0;
+   group["messages"     ] = messages;
+
+   QJsonObject ret;
+   ret["sha1s" ] = QJsonArray { sha1 };
+   ret["groups"] = QJsonArray { group };
+   ret["peers" ] = QJsonArray {};
+
+   return ret;
+}
+
+} // namespace Conversation
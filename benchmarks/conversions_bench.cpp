@@ -0,0 +1,99 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+/*
+ * Cost of the string conversions done for each libwrap call and callback.
+ *
+ * Usage: conversions_bench [milliseconds per case]
+ *
+ * The current conversions_wrap.hpp functions are compared with the ones
+ * they replaced, on an account details map and on a list of call ids.
+ */
+
+//Qt
+#include <QtCore/QCoreApplication>
+
+//Ring
+#include "conversions_wrap.hpp"
+#include "benchmark.h"
+
+namespace Legacy {
+
+static MapStringString convertMap(const std::map<std::string, std::string>& m)
+{
+   MapStringString temp;
+   for (const auto& x : m) {
+      temp[QString(x.first.c_str())] = QString(x.second.c_str());
+   }
+   return temp;
+}
+
+static std::map<std::string, std::string> convertMap(const MapStringString& m)
+{
+   std::map<std::string, std::string> temp;
+   for (const auto& x : m.toStdMap()) {
+      temp[x.first.toStdString()] = x.second.toStdString();
+   }
+   return temp;
+}
+
+static QStringList convertStringList(const std::vector<std::string>& v)
+{
+   QStringList temp;
+   for (const auto& x : v) {
+      temp.push_back(QString(x.c_str()));
+   }
+   return temp;
+}
+
+} // namespace Legacy
+
+int main(int argc, char* argv[])
+{
+   QCoreApplication app(argc, argv);
+
+   const int duration = Benchmark::argument(argc, argv, 1, 500);
+
+   // Every known property, like getAccountDetails() returns
+   std::map<std::string, std::string> details;
+   for (const auto& key : knownKeys())
+      details[key.first] = "some value of a typical length";
+
+   std::vector<std::string> ids;
+   for (int i = 0; i < 100; i++)
+      ids.push_back(std::to_string(1234567890123456789ULL + i));
+
+   const MapStringString qDetails = convertMap(details);
+
+   const double oldToQt   = Benchmark::measure([&]() { Legacy::convertMap(details); }, duration);
+   const double newToQt   = Benchmark::measure([&]() { convertMap        (details); }, duration);
+   const double oldToStd  = Benchmark::measure([&]() { Legacy::convertMap(qDetails); }, duration);
+   const double newToStd  = Benchmark::measure([&]() { convertMap        (qDetails); }, duration);
+   const double oldList   = Benchmark::measure([&]() { Legacy::convertStringList(ids); }, duration);
+   const double newList   = Benchmark::measure([&]() { convertStringList        (ids); }, duration);
+
+   printf("%d details, %d ids\n", static_cast<int>(details.size()), static_cast<int>(ids.size()));
+   Benchmark::report("details to Qt, before"  , oldToQt , "us");
+   Benchmark::report("details to Qt, now"     , newToQt , "us");
+   Benchmark::report("details to std, before" , oldToStd, "us");
+   Benchmark::report("details to std, now"    , newToStd, "us");
+   Benchmark::report("id list to Qt, before"  , oldList , "us");
+   Benchmark::report("id list to Qt, now"     , newList , "us");
+
+   return 0;
+}
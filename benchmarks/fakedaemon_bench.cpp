@@ -0,0 +1,104 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+/*
+ * Drive thousands of simulated calls through the models, without a daemon.
+ *
+ * Usage: fakedaemon_bench [seconds]
+ *
+ * The library has to be built with ENABLE_FAKEDAEMON. The scenario is read
+ * from LRC_FAKEDAEMON (see fakedaemon/fakedaemon.h), the default one keeps
+ * up to 5000 calls alive. One line is printed every second with the number
+ * of calls in the CallModel, the CPU used by the process and its memory.
+ */
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimer>
+
+// Std
+#include <ctime>
+
+//Ring
+#include "callmodel.h"
+#include "fakedaemon/fakedaemon.h"
+#include "benchmark.h"
+
+int main(int argc, char* argv[])
+{
+   QCoreApplication app(argc, argv);
+
+   const int seconds = Benchmark::argument(argc, argv, 1, 30);
+
+   // Before the first FakeDaemon::instance(), it creates the accounts
+   if (!qEnvironmentVariableIsSet("LRC_FAKEDAEMON"))
+      qputenv("LRC_FAKEDAEMON",
+         "accounts=10,maxCalls=5000,callRate=200,transitionRate=500,conferenceRate=5,seed=1"
+      );
+
+   QElapsedTimer timer;
+   timer.start();
+
+   CallModel& model = CallModel::instance();
+
+   Benchmark::report("model initialization", timer.nsecsElapsed() / 1000000.0, "ms");
+
+   int incoming = 0;
+   QObject::connect(&model, &CallModel::incomingCall, [&incoming]() { incoming++; });
+
+   const long    startRss = Benchmark::rss();
+   std::clock_t  lastCpu  = std::clock();
+   qint64        lastTime = timer.elapsed();
+   int           maxRows  = 0;
+
+   printf("%8s %10s %10s %10s %8s %10s\n", "time(s)", "rows", "daemon", "incoming", "cpu(%)", "rss(MB)");
+
+   QTimer sample;
+   QObject::connect(&sample, &QTimer::timeout, [&]() {
+      const std::clock_t cpu = std::clock();
+      const qint64       now = timer.elapsed();
+
+      const double usage = 100.0 * (cpu - lastCpu) / CLOCKS_PER_SEC / ((now - lastTime) / 1000.0);
+
+      maxRows  = qMax(maxRows, model.rowCount());
+      lastCpu  = cpu;
+      lastTime = now;
+
+      printf("%8.1f %10d %10d %10d %8.1f %10.1f\n",
+         now / 1000.0,
+         model.rowCount(),
+         FakeDaemon::instance().callList().size(),
+         incoming,
+         usage,
+         Benchmark::rss() / 1024.0
+      );
+      fflush(stdout);
+   });
+   sample.start(1000);
+
+   QTimer::singleShot(seconds * 1000, &app, &QCoreApplication::quit);
+
+   app.exec();
+
+   Benchmark::report("incoming calls"   , incoming                          , "calls");
+   Benchmark::report("largest model"    , maxRows                           , "rows" );
+   Benchmark::report("average cpu"      , 100.0 * std::clock() / CLOCKS_PER_SEC / (timer.elapsed() / 1000.0), "%");
+   Benchmark::report("resident growth"  , (Benchmark::rss() - startRss) / 1024.0, "MB");
+
+   return 0;
+}
@@ -0,0 +1,84 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+/*
+ * Throughput of the Video::FrameConverter for common camera resolutions.
+ *
+ * Usage: frameconverter_bench [milliseconds per case]
+ *
+ * Each BGRA source frame is converted to every output color space, at the
+ * same size and scaled down to a 320x180 thumbnail.
+ */
+
+//Qt
+#include <QtCore/QCoreApplication>
+
+//Ring
+#include "video/frameconverter.h"
+#include "benchmark.h"
+
+using ColorSpace = Video::Renderer::ColorSpace;
+
+static const char* name(ColorSpace colorSpace)
+{
+   switch (colorSpace) {
+      case ColorSpace::BGRA: return "BGRA";
+      case ColorSpace::RGBA: return "RGBA";
+      case ColorSpace::I420: return "I420";
+      case ColorSpace::NV12: return "NV12";
+   }
+
+   return "";
+}
+
+int main(int argc, char* argv[])
+{
+   QCoreApplication app(argc, argv);
+
+   const int duration = Benchmark::argument(argc, argv, 1, 500);
+
+   const Video::FrameConverter converter;
+
+   for (const QSize& size : { QSize(1280, 720), QSize(1920, 1080) }) {
+      // A gradient, so the scaling doesn't only read constant pixels
+      Video::Frame source;
+      source.storage.resize(size.width() * size.height() * 4);
+      source.ptr  = source.storage.data();
+      source.size = source.storage.size();
+
+      for (std::size_t i = 0; i < source.size; i++)
+         source.ptr[i] = static_cast<uint8_t>(i * 7);
+
+      for (const QSize& targetSize : { size, QSize(320, 180) }) {
+         for (const auto target : { ColorSpace::RGBA, ColorSpace::I420, ColorSpace::NV12 }) {
+            const double us = Benchmark::measure([&]() {
+               converter.convert(source, ColorSpace::BGRA, size, target, targetSize);
+            }, duration);
+
+            const QString label = QStringLiteral("%1x%2 BGRA -> %3x%4 %5")
+               .arg(size.width()).arg(size.height())
+               .arg(targetSize.width()).arg(targetSize.height())
+               .arg(QString::fromLatin1(name(target)));
+
+            Benchmark::report(qPrintable(label), 1000000.0 / us, "frames/s");
+         }
+      }
+   }
+
+   return 0;
+}
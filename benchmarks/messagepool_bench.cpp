@@ -0,0 +1,89 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+/*
+ * Memory and time used to load a large conversation, with the messages
+ * and their nodes allocated one by one or from an ObjectPool.
+ *
+ * Usage: messagepool_bench [heap|pool] [message count]
+ *
+ * The resident memory of a process doesn't reliably shrink once freed, run
+ * each mode in its own process to compare them:
+ *
+ *    messagepool_bench heap 100000
+ *    messagepool_bench pool 100000
+ */
+
+//Qt
+#include <QtCore/QCoreApplication>
+
+// Std
+#include <vector>
+
+//Ring
+#include "private/textrecording_p.h"
+#include "benchmark.h"
+#include "conversation.h"
+
+int main(int argc, char* argv[])
+{
+   QCoreApplication app(argc, argv);
+
+   const bool usePool = argc < 2 || qstrcmp(argv[1], "heap");
+   const int  count   = Benchmark::argument(argc, argv, 2, 100000);
+
+   // Parse the JSON first, only the messages are measured
+   std::vector<QJsonObject> json;
+   json.reserve(count);
+
+   for (int i = 0; i < count; i++)
+      json.push_back(Conversation::message(i));
+
+   ObjectPool<Serializable::Message> messagePool;
+   ObjectPool<TextMessageNode>       nodePool   ;
+
+   std::vector<TextMessageNode*> nodes;
+   nodes.reserve(count);
+
+   const long before = Benchmark::rss();
+
+   QElapsedTimer timer;
+   timer.start();
+
+   for (const QJsonObject& obj : json) {
+      Serializable::Message* m = usePool ? messagePool.create() : new Serializable::Message();
+      m->read(obj);
+
+      TextMessageNode* n = usePool ? nodePool.create() : new TextMessageNode();
+      n->m_pMessage = m;
+
+      nodes.push_back(n);
+   }
+
+   const double elapsed = timer.nsecsElapsed() / 1000.0;
+   const long   growth  = Benchmark::rss() - before;
+
+   printf("%s, %d messages\n", usePool ? "pool" : "heap", count);
+   Benchmark::report("load time"        , elapsed / count                , "us/message");
+   Benchmark::report("resident growth"  , growth / 1024.0                , "MB"        );
+   Benchmark::report("resident growth"  , growth * 1024.0 / count        , "B/message" );
+   Benchmark::report("message blocks"   , usePool ? messagePool.blocks() : count, "allocations");
+
+   // The pools free their objects, the heap ones are left to the OS
+   return 0;
+}
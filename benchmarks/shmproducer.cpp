@@ -0,0 +1,299 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "shmproducer.h"
+
+// Std
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+//Ring
+#include "private/shmheader.h"
+
+namespace {
+
+///The frames are aligned on 16 bytes, like the daemon does
+constexpr std::size_t ALIGNMENT = 16;
+
+std::size_t aligned(std::size_t size)
+{
+   return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+int64_t threadCpuTime()
+{
+   timespec ts;
+   ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+   return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+} // namespace
+
+ShmProducer::ShmProducer(const std::string& path, const Settings& settings) :
+m_Path(path), m_Settings(settings)
+{
+}
+
+ShmProducer::~ShmProducer()
+{
+   stop();
+   destroy();
+}
+
+///The name to give to ShmRenderer, it starts with a "/"
+const std::string& ShmProducer::path() const
+{
+   return m_Path;
+}
+
+///The number of frames published so far
+unsigned ShmProducer::frames() const
+{
+   return m_Frames;
+}
+
+unsigned ShmProducer::resizes() const
+{
+   return m_Resizes;
+}
+
+///The CPU used by the thread started by start()
+std::chrono::nanoseconds ShmProducer::cpuTime() const
+{
+   return std::chrono::nanoseconds(m_CpuTime.load());
+}
+
+///Create the shared memory area, a stale one with the same name is replaced
+bool ShmProducer::create()
+{
+   if (m_pHeader)
+      return true;
+
+   ::shm_unlink(m_Path.c_str());
+
+   m_Fd = ::shm_open(m_Path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+
+   if (m_Fd < 0)
+      return false;
+
+   const std::size_t frameSize = static_cast<std::size_t>(m_Settings.width) * m_Settings.height * 4;
+   const std::size_t mapSize   = sizeof(SHMHeader) + 2 * aligned(frameSize);
+
+   if (::ftruncate(m_Fd, static_cast<off_t>(mapSize)) < 0) {
+      destroy();
+      return false;
+   }
+
+   void* area = ::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_Fd, 0);
+
+   if (area == MAP_FAILED) {
+      destroy();
+      return false;
+   }
+
+   m_pHeader = static_cast<SHMHeader*>(area);
+   m_MapSize = mapSize;
+
+   ::sem_init(&m_pHeader->mutex        , 1, 1);
+   ::sem_init(&m_pHeader->frameGenMutex, 1, 0);
+
+   m_pHeader->frameGen    = 0;
+   m_pHeader->frameSize   = static_cast<unsigned>(frameSize);
+   m_pHeader->mapSize     = static_cast<unsigned>(mapSize);
+   m_pHeader->readOffset  = 0;
+   m_pHeader->writeOffset = static_cast<unsigned>(aligned(frameSize));
+
+   return true;
+}
+
+/**
+ * Change the frame size, called with the mutex held.
+ *
+ * Like with the daemon, the area only grows, a client may still be reading
+ * the previous frame. It grows at each resize, so the clients always have
+ * to remap it.
+ */
+bool ShmProducer::resize(std::size_t frameSize)
+{
+   const std::size_t page    = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+   const std::size_t needed  = sizeof(SHMHeader) + 2 * aligned(frameSize);
+   const std::size_t mapSize = std::max(needed, m_MapSize + page);
+
+   if (::ftruncate(m_Fd, static_cast<off_t>(mapSize)) < 0)
+      return false;
+
+   // The semaphores live in the file, they survive the remap
+   void* area = ::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_Fd, 0);
+
+   if (area == MAP_FAILED)
+      return false;
+
+   ::munmap(m_pHeader, m_MapSize);
+
+   m_pHeader = static_cast<SHMHeader*>(area);
+   m_MapSize = mapSize;
+
+   m_pHeader->frameSize   = static_cast<unsigned>(frameSize);
+   m_pHeader->mapSize     = static_cast<unsigned>(mapSize);
+   m_pHeader->readOffset  = 0;
+   m_pHeader->writeOffset = static_cast<unsigned>(aligned(frameSize));
+
+   m_Resizes++;
+
+   return true;
+}
+
+///Write and publish the next frame
+bool ShmProducer::push()
+{
+   if ((!m_pHeader) && !create())
+      return false;
+
+   const unsigned index = m_Frames + 1;
+
+   // Alternate between the full and the half size
+   if (m_Settings.resizeEvery > 0 && m_Frames && !(m_Frames % m_Settings.resizeEvery)) {
+      m_IsHalf = !m_IsHalf;
+
+      const int         divider   = m_IsHalf ? 2 : 1;
+      const std::size_t frameSize = static_cast<std::size_t>(std::max(2, m_Settings.width  / divider))
+                                  * static_cast<std::size_t>(std::max(2, m_Settings.height / divider)) * 4;
+
+      ::sem_wait(&m_pHeader->mutex);
+      const bool resized = resize(frameSize);
+      ::sem_post(&m_pHeader->mutex);
+
+      if (!resized)
+         return false;
+   }
+
+   // Only the producer uses the write buffer, no need to lock
+   const std::size_t frameSize = m_pHeader->frameSize;
+   uint8_t*          frame     = m_pHeader->data + m_pHeader->writeOffset;
+
+   ::memset(frame + sizeof(Stamp), static_cast<int>(index & 0xff), frameSize - sizeof(Stamp));
+
+   const Stamp s {
+      index, 0,
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now().time_since_epoch()
+      ).count()
+   };
+
+   ::memcpy(frame, &s, sizeof(Stamp));
+
+   ::sem_wait(&m_pHeader->mutex);
+   std::swap(m_pHeader->readOffset, m_pHeader->writeOffset);
+   m_pHeader->frameGen++;
+   ::sem_post(&m_pHeader->mutex);
+
+   ::sem_post(&m_pHeader->frameGenMutex);
+
+   m_Frames++;
+
+   return true;
+}
+
+///Publish the frames at the configured rate from a thread
+bool ShmProducer::start()
+{
+   if (m_Thread.joinable())
+      return true;
+
+   if (!create())
+      return false;
+
+   m_Stop   = false;
+   m_Thread = std::thread(&ShmProducer::run, this);
+
+   return true;
+}
+
+void ShmProducer::stop()
+{
+   if (!m_Thread.joinable())
+      return;
+
+   m_Stop = true;
+   m_Thread.join();
+}
+
+void ShmProducer::run()
+{
+   const auto period = std::chrono::nanoseconds(1000000000LL / std::max(1, m_Settings.fps));
+   auto       next   = std::chrono::steady_clock::now();
+
+   while (!m_Stop) {
+      if (!push())
+         break;
+
+      m_CpuTime = threadCpuTime();
+
+      next += period;
+      std::this_thread::sleep_until(next);
+   }
+}
+
+///Remove the area, the clients keep their mapping until they close it
+void ShmProducer::destroy()
+{
+   if (m_pHeader)
+      ::munmap(m_pHeader, m_MapSize);
+
+   if (m_Fd >= 0) {
+      ::close(m_Fd);
+      ::shm_unlink(m_Path.c_str());
+   }
+
+   m_pHeader = nullptr;
+   m_MapSize = 0;
+   m_Fd      = -1;
+}
+
+///If the frame is filled with the value its stamp expects, it is not torn
+bool ShmProducer::isValid(const uint8_t* frame, std::size_t size)
+{
+   if ((!frame) || size < sizeof(Stamp))
+      return false;
+
+   const uint8_t value = static_cast<uint8_t>(stamp(frame).index & 0xff);
+
+   return std::all_of(frame + sizeof(Stamp), frame + size, [value](uint8_t b) {
+      return b == value;
+   });
+}
+
+ShmProducer::Stamp ShmProducer::stamp(const uint8_t* frame)
+{
+   Stamp s;
+   ::memcpy(&s, frame, sizeof(Stamp));
+   return s;
+}
+
+///When the frame was published, comparable with the renderer timestamps
+std::chrono::steady_clock::time_point ShmProducer::published(const uint8_t* frame)
+{
+   return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::nanoseconds(stamp(frame).published)
+   ));
+}
@@ -0,0 +1,100 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+// Std
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+struct SHMHeader;
+
+/**
+ * A stand-in for the daemon video sink.
+ *
+ * It writes BGRA frames in a POSIX shared memory area using the SHMHeader
+ * layout, so a Video::ShmRenderer can be tested and measured without a
+ * daemon. The frames are produced by a thread at the configured rate, or
+ * one at a time with push().
+ *
+ * Every frame starts with a stamp (its index and when it was published)
+ * and the rest of it is filled with the low byte of its index, so the
+ * client can check that it didn't read a torn frame and compute the
+ * delivery latency.
+ */
+class ShmProducer final
+{
+public:
+   struct Settings {
+      int width       { 1280 };
+      int height      { 720  };
+      int fps         { 30   };
+      int resizeEvery { 0    }; /*!< Alternate with half the size every N frames, 0 to never resize */
+   };
+
+   ///What push() writes at the beginning of each frame
+   struct Stamp {
+      uint32_t index;
+      uint32_t reserved;
+      int64_t  published; /*!< steady_clock, in nanoseconds */
+   };
+
+   ShmProducer(const std::string& path, const Settings& settings);
+   ~ShmProducer();
+
+   ShmProducer(const ShmProducer&) = delete;
+   ShmProducer& operator=(const ShmProducer&) = delete;
+
+   //Getters
+   const std::string& path         () const;
+   unsigned           frames       () const;
+   unsigned           resizes      () const;
+   std::chrono::nanoseconds cpuTime() const;
+
+   //Mutators
+   bool create();
+   bool push  ();
+   bool start ();
+   void stop  ();
+
+   //Helpers
+   static bool  isValid  (const uint8_t* frame, std::size_t size);
+   static Stamp stamp    (const uint8_t* frame);
+   static std::chrono::steady_clock::time_point published(const uint8_t* frame);
+
+private:
+   //Attributes
+   std::string           m_Path     ;
+   Settings              m_Settings ;
+   int                   m_Fd       {-1};
+   SHMHeader*            m_pHeader  {nullptr};
+   std::size_t           m_MapSize  {0};
+   bool                  m_IsHalf   {false};
+   std::atomic<unsigned> m_Frames   {0};
+   std::atomic<unsigned> m_Resizes  {0};
+   std::atomic<int64_t>  m_CpuTime  {0};
+   std::atomic_bool      m_Stop     {false};
+   std::thread           m_Thread   ;
+
+   //Helpers
+   bool resize(std::size_t frameSize);
+   void run   ();
+   void destroy();
+};
@@ -0,0 +1,149 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+/*
+ * Throughput, latency and CPU usage of Video::ShmRenderer, without a
+ * daemon.
+ *
+ * Usage: shmrenderer_bench [width] [height] [fps] [streams] [seconds]
+ *
+ * Each stream has its own ShmProducer and ShmRenderer, the renderers share
+ * a RenderWorkerPool like in VideoRendererManager. The frames are
+ * taken from the renderer queues, the latency is the time between the
+ * producer publishing a frame and the renderer receiving it. The CPU usage
+ * excludes the producer threads.
+ */
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+
+// Std
+#include <algorithm>
+#include <ctime>
+#include <memory>
+#include <vector>
+#include <unistd.h>
+
+//Ring
+#include "private/shmrenderer.h"
+#include "private/renderworkerpool.h"
+#include "shmproducer.h"
+#include "benchmark.h"
+
+struct Stream {
+   std::unique_ptr<ShmProducer> producer;
+   Video::ShmRenderer*          renderer {nullptr};
+   unsigned                     received {0      };
+};
+
+int main(int argc, char* argv[])
+{
+   QCoreApplication app(argc, argv);
+
+   ShmProducer::Settings settings;
+   settings.width  = Benchmark::argument(argc, argv, 1, 1280);
+   settings.height = Benchmark::argument(argc, argv, 2, 720 );
+   settings.fps    = Benchmark::argument(argc, argv, 3, 30  );
+
+   const int count   = Benchmark::argument(argc, argv, 4, 1 );
+   const int seconds = Benchmark::argument(argc, argv, 5, 10);
+
+   RenderWorkerPool pool;
+
+   std::vector<Stream> streams(count);
+
+   for (int i = 0; i < count; i++) {
+      const std::string path = "/lrc-shmrenderer-bench-" + std::to_string(::getpid()) + "-" + std::to_string(i);
+
+      streams[i].producer.reset(new ShmProducer(path, settings));
+
+      if (!streams[i].producer->create()) {
+         printf("Could not create the shared memory area %s\n", path.c_str());
+         return 1;
+      }
+
+      streams[i].renderer = new Video::ShmRenderer(
+         QByteArray::number(i), QString::fromStdString(path), QSize(settings.width, settings.height)
+      );
+      streams[i].renderer->setBufferSize(8);
+      pool.add(streams[i].renderer);
+      streams[i].renderer->startRendering();
+   }
+
+   const std::clock_t startCpu = std::clock();
+
+   for (auto& s : streams)
+      s.producer->start();
+
+   std::vector<double> latencies; // microseconds
+   latencies.reserve(static_cast<std::size_t>(settings.fps) * seconds * count);
+
+   QElapsedTimer timer;
+   timer.start();
+
+   while (timer.elapsed() < seconds * 1000) {
+      for (auto& s : streams) {
+         Video::Frame frame;
+
+         while (s.renderer->takeFrame(frame)) {
+            s.received++;
+
+            const auto latency = frame.timestamp - ShmProducer::published(frame.ptr);
+            latencies.push_back(std::chrono::duration<double, std::micro>(latency).count());
+         }
+      }
+
+      QThread::msleep(2);
+   }
+
+   const double elapsed = timer.elapsed() / 1000.0;
+
+   unsigned produced = 0;
+   unsigned received = 0;
+   double   producerCpu = 0;
+
+   for (auto& s : streams) {
+      s.producer->stop();
+      s.renderer->stopRendering();
+      pool.remove(s.renderer);
+
+      produced    += s.producer->frames();
+      received    += s.received;
+      producerCpu += std::chrono::duration<double>(s.producer->cpuTime()).count();
+   }
+
+   const double cpu = double(std::clock() - startCpu) / CLOCKS_PER_SEC - producerCpu;
+
+   std::sort(latencies.begin(), latencies.end());
+
+   const auto percentile = [&latencies](double p) {
+      return latencies.empty() ? 0.0 : latencies[static_cast<std::size_t>(p * (latencies.size() - 1))];
+   };
+
+   printf("%d streams of %dx%d at %d fps\n", count, settings.width, settings.height, settings.fps);
+   Benchmark::report("received"       , received / elapsed / count          , "frames/s/stream");
+   Benchmark::report("lost"           , produced ? 100.0 * (produced - received) / produced : 0, "%");
+   Benchmark::report("latency, median", percentile(0.5 )                     , "us" );
+   Benchmark::report("latency, 99th"  , percentile(0.99)                     , "us" );
+   Benchmark::report("latency, max"   , percentile(1.0 )                     , "us" );
+   Benchmark::report("cpu"            , 100.0 * cpu / elapsed                , "% of a core");
+
+   return 0;
+}
@@ -0,0 +1,156 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+/*
+ * Create and destroy many Video::ShmRenderer in a RenderWorkerPool and check
+ * that no thread or file descriptor is leaked.
+ *
+ * Usage: shmrenderer_stress_test [renderers]
+ *
+ * The renderers are created in batches, some are stopped before being
+ * removed from the pool and some are still rendering when deleted.
+ */
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+
+// Std
+#include <atomic>
+#include <vector>
+#include <unistd.h>
+
+//Ring
+#include "private/shmrenderer.h"
+#include "private/renderworkerpool.h"
+#include "shmproducer.h"
+#include "benchmark.h"
+
+static int failures = 0;
+
+#define CHECK(condition) \
+   if (!(condition)) { \
+      printf("FAILED: %s (line %d)\n", #condition, __LINE__); \
+      failures++; \
+   }
+
+///The number of entries of a /proc/self directory
+static int entries(const char* path)
+{
+   return QDir(QString::fromLatin1(path)).entryList(QDir::AllEntries | QDir::NoDotAndDotDot).size();
+}
+
+int main(int argc, char* argv[])
+{
+   QCoreApplication app(argc, argv);
+
+   const int count = Benchmark::argument(argc, argv, 1, 300);
+
+   static const int BATCH = 8;
+
+   const std::string path = "/lrc-shmrenderer-stress-" + std::to_string(::getpid());
+
+   ShmProducer::Settings settings;
+   settings.width       = 160;
+   settings.height      = 120;
+   settings.fps         = 200;
+   settings.resizeEvery = 7  ;
+
+   ShmProducer producer(path, settings);
+
+   if (!producer.create() || !producer.start()) {
+      printf("Could not create the shared memory area %s\n", path.c_str());
+      return 1;
+   }
+
+   RenderWorkerPool pool(2);
+
+   std::atomic_int created  {0};
+   std::atomic_int deleted  {0};
+   std::atomic_int notified {0};
+
+   // Create "n" renderers, let them render for a while and remove them
+   const auto batch = [&](int n) {
+      std::vector<Video::ShmRenderer*> renderers;
+
+      for (int i = 0; i < n; i++) {
+         auto r = new Video::ShmRenderer(
+            QByteArray::number(created++), QString::fromStdString(path), QSize(settings.width, settings.height)
+         );
+
+         QObject::connect(r, &QObject::destroyed, [&deleted]() { deleted++; });
+         QObject::connect(r, &Video::Renderer::frameUpdated, [&notified]() { notified++; });
+
+         r->setBufferSize(i % 2 ? 2 : 0);
+         pool.add(r);
+         r->startRendering();
+
+         renderers.push_back(r);
+      }
+
+      QThread::msleep(15);
+
+      for (int i = 0; i < n; i++) {
+         Video::Frame frame;
+         renderers[i]->takeFrame(frame);
+
+         if (i % 3)
+            renderers[i]->stopRendering();
+
+         pool.remove(renderers[i]);
+      }
+   };
+
+   // The renderers are deleted by the pool threads
+   const auto waitDeleted = [&]() {
+      QElapsedTimer timer;
+      timer.start();
+
+      while (deleted < created && timer.elapsed() < 5000)
+         QThread::msleep(5);
+   };
+
+   // The pool threads and their waiters are created on demand
+   batch(BATCH);
+   waitDeleted();
+
+   const int fds     = entries("/proc/self/fd"  );
+   const int threads = entries("/proc/self/task");
+
+   for (int done = 0; done < count; done += BATCH)
+      batch(qMin(BATCH, count - done));
+
+   waitDeleted();
+
+   printf("%d renderers, %d notifications, %d/%d fds, %d/%d threads\n",
+      created.load(), notified.load(), entries("/proc/self/fd"), fds, entries("/proc/self/task"), threads
+   );
+
+   CHECK(deleted == created);
+   CHECK(notified > 0);
+   CHECK(pool.rendererCount() == 0);
+   CHECK(pool.threadCount() == 2);
+   CHECK(entries("/proc/self/fd"  ) == fds    );
+   CHECK(entries("/proc/self/task") == threads);
+
+   producer.stop();
+
+   return failures ? 1 : 0;
+}
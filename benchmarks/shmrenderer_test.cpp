@@ -0,0 +1,129 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+/*
+ * Check that a Video::ShmRenderer receives the frames of a producer using
+ * the SHMHeader layout, including when the area is resized mid-stream.
+ *
+ * Usage: shmrenderer_test
+ *
+ * The frames are read from the renderer queue, each of them must be
+ * complete (not torn), in order, and both frame sizes must be seen.
+ */
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+
+// Std
+#include <unistd.h>
+
+//Ring
+#include "private/shmrenderer.h"
+#include "private/renderworkerpool.h"
+#include "shmproducer.h"
+
+static int failures = 0;
+
+#define CHECK(condition) \
+   if (!(condition)) { \
+      printf("FAILED: %s (line %d)\n", #condition, __LINE__); \
+      failures++; \
+   }
+
+int main(int argc, char* argv[])
+{
+   QCoreApplication app(argc, argv);
+
+   const std::string path = "/lrc-shmrenderer-test-" + std::to_string(::getpid());
+
+   ShmProducer::Settings settings;
+   settings.width       = 320;
+   settings.height      = 240;
+   settings.fps         = 100;
+   settings.resizeEvery = 25;
+
+   ShmProducer producer(path, settings);
+
+   if (!producer.create()) {
+      printf("Could not create the shared memory area %s\n", path.c_str());
+      return 1;
+   }
+
+   RenderWorkerPool pool(1);
+
+   auto renderer = new Video::ShmRenderer("test", QString::fromStdString(path), QSize(settings.width, settings.height));
+   renderer->setBufferSize(8);
+   pool.add(renderer);
+   renderer->startRendering();
+
+   CHECK(renderer->isRendering());
+
+   producer.start();
+
+   unsigned      received   = 0;
+   unsigned      torn       = 0;
+   unsigned      outOfOrder = 0;
+   unsigned      lastIndex  = 0;
+   QSet<quint64> sizes      ;
+
+   QElapsedTimer timer;
+   timer.start();
+
+   while (timer.elapsed() < 2000) {
+      Video::Frame frame;
+
+      while (renderer->takeFrame(frame)) {
+         received++;
+
+         if (!ShmProducer::isValid(frame.ptr, frame.size)) {
+            torn++;
+            continue;
+         }
+
+         const unsigned index = ShmProducer::stamp(frame.ptr).index;
+
+         if (index <= lastIndex)
+            outOfOrder++;
+
+         lastIndex = index;
+         sizes << frame.size;
+      }
+
+      QThread::msleep(5);
+   }
+
+   producer.stop();
+   renderer->stopRendering();
+
+   printf("%u frames produced, %u received, %u resizes\n", producer.frames(), received, producer.resizes());
+
+   CHECK(!renderer->isRendering());
+   CHECK(!renderer->currentFrame().ptr);
+   CHECK(producer.resizes() > 0);
+   CHECK(received > producer.frames() / 2);
+   CHECK(torn == 0);
+   CHECK(outOfOrder == 0);
+   CHECK(sizes.size() == 2);
+
+   pool.remove(renderer);
+
+   return failures ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+/*
+ * Compare the linear link scanner of TextFormatter::format() with the
+ * regular expression formatter it replaced.
+ *
+ * Usage: textformatter_bench [message count]
+ *
+ * Both formatters run on the same generated messages, a mix of plain text,
+ * punctuation and links. Any difference in their output is reported and
+ * makes the benchmark fail.
+ */
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QStringList>
+#include <QtCore/QUrl>
+
+//Ring
+#include "private/textformatter.h"
+#include "benchmark.h"
+
+///The formatter used before TextFormatter, kept as the reference output
+static void regexFormat(const QString& plainText, QString& html, QList<QUrl>& links)
+{
+   static const QRegularExpression linkRegex(
+      QStringLiteral("((?>(?>https|http|ftp|ring):|www\\.)(?>[^\\s,.);!>]|[,.);!>](?!\\s|$))+)"),
+      QRegularExpression::CaseInsensitiveOption
+   );
+
+   QString re;
+   auto p = 0;
+   auto it = linkRegex.globalMatch(plainText);
+
+   while (it.hasNext()) {
+      QRegularExpressionMatch match = it.next();
+      auto start = match.capturedStart();
+
+      auto url = QUrl::fromUserInput(match.capturedRef().toString());
+
+      if (start > p)
+         re.append(plainText.mid(p, start - p).toHtmlEscaped().replace(QLatin1Char('\n'),
+                                                                       QStringLiteral("<br/>")));
+      re.append(QStringLiteral("<a href=\"%1\">%2</a>")
+                .arg(QString::fromLatin1(url.toEncoded()).toHtmlEscaped(),
+                     match.capturedRef().toString().toHtmlEscaped()));
+      links.append(url);
+      p = match.capturedEnd();
+   }
+
+   if (p < plainText.size())
+      re.append(plainText.mid(p, plainText.size() - p));
+
+   html = QStringLiteral("<body>%1</body>").arg(re);
+}
+
+///Messages similar to a real conversation, most of them without links
+static QStringList messages(int count)
+{
+   static const char* const samples[] = {
+      "ok",
+      "Are you coming to the meeting at 3pm?",
+      "Sure, see you there!\nI'll bring the slides.",
+      "Look at this: https://ring.cx/en/documentation, it explains everything.",
+      "www.savoirfairelinux.com (the company website)",
+      "call me at ring:a1b2c3d4e5f6a7b8c9d0e1f2a3b4c5d6e7f8a9b0 or http://example.com/a?b=c&d=e.",
+      "<b>not html</b> & still escaped; ftp://ftp.example.org/pub/file.tar.gz!",
+      "http: alone is not a link, nor is www. followed by a space",
+   };
+
+   static const int sampleCount = sizeof(samples) / sizeof(samples[0]);
+
+   QStringList ret;
+   ret.reserve(count);
+
+   for (int i = 0; i < count; i++)
+      ret << QString::fromUtf8(samples[i % sampleCount]);
+
+   return ret;
+}
+
+int main(int argc, char* argv[])
+{
+   QCoreApplication app(argc, argv);
+
+   const QStringList texts = messages(Benchmark::argument(argc, argv, 1, 10000));
+
+   int mismatches = 0;
+
+   for (const QString& text : texts.mid(0, 8)) {
+      QString     html1, html2;
+      QList<QUrl> links1, links2;
+
+      regexFormat          (text, html1, links1);
+      TextFormatter::format(text, html2, links2);
+
+      if (html1 != html2 || links1 != links2) {
+         printf("Different output for: %s\n", qPrintable(text));
+         mismatches++;
+      }
+   }
+
+   const auto run = [&texts](void (*format)(const QString&, QString&, QList<QUrl>&)) {
+      return [&texts, format]() {
+         for (const QString& text : texts) {
+            QString     html;
+            QList<QUrl> links;
+            format(text, html, links);
+         }
+      };
+   };
+
+   const double regex   = Benchmark::measure(run(regexFormat          ));
+   const double scanner = Benchmark::measure(run(TextFormatter::format));
+
+   Benchmark::report("regex formatter"  , regex   / texts.size(), "us/message");
+   Benchmark::report("linear scanner"   , scanner / texts.size(), "us/message");
+   Benchmark::report("speedup"          , regex   / scanner     , "x"         );
+
+   return mismatches ? 1 : 0;
+}
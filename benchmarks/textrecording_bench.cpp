@@ -0,0 +1,105 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+/*
+ * Compare the size and the speed of the JSON and binary text recordings.
+ *
+ * Usage: textrecording_bench [message count] [files]
+ *
+ * The same conversation is saved and loaded "files" times in each format,
+ * like LocalTextRecordingCollection does. Each copy uses its own sha1, as
+ * SerializableEntityManager keeps the recordings it already loaded.
+ */
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonDocument>
+
+//Ring
+#include "private/textrecording_p.h"
+#include "benchmark.h"
+#include "conversation.h"
+
+int main(int argc, char* argv[])
+{
+   QCoreApplication app(argc, argv);
+
+   const int count = Benchmark::argument(argc, argv, 1, 10000);
+   const int files = Benchmark::argument(argc, argv, 2, 20   );
+
+   Serializable::Peers* p = SerializableEntityManager::fromJson(
+      Conversation::recording(QStringLiteral("source"), count)
+   );
+
+   if (!p) {
+      printf("Could not load the generated conversation\n");
+      return 1;
+   }
+
+   QList<QByteArray> jsonFiles, binaryFiles;
+   QElapsedTimer     timer;
+
+   // Save
+   timer.start();
+   for (int i = 0; i < files; i++) {
+      p->sha1s = { QStringLiteral("json%1").arg(i) };
+
+      QJsonObject output;
+      p->write(output);
+      jsonFiles << QJsonDocument(output).toJson();
+   }
+   const double jsonWrite = timer.nsecsElapsed() / 1000.0 / files;
+
+   timer.restart();
+   for (int i = 0; i < files; i++) {
+      p->sha1s = { QStringLiteral("binary%1").arg(i) };
+      binaryFiles << SerializableEntityManager::toBinary(p);
+   }
+   const double binaryWrite = timer.nsecsElapsed() / 1000.0 / files;
+
+   // Load
+   int loaded = 0;
+
+   timer.restart();
+   for (const QByteArray& content : jsonFiles) {
+      const QJsonDocument doc = QJsonDocument::fromJson(content);
+      loaded += SerializableEntityManager::fromJson(doc.object()) ? 1 : 0;
+   }
+   const double jsonRead = timer.nsecsElapsed() / 1000.0 / files;
+
+   timer.restart();
+   for (const QByteArray& content : binaryFiles)
+      loaded += SerializableEntityManager::fromBinary(content) ? 1 : 0;
+   const double binaryRead = timer.nsecsElapsed() / 1000.0 / files;
+
+   if (loaded != 2 * files) {
+      printf("Only %d of the %d files could be loaded\n", loaded, 2 * files);
+      return 1;
+   }
+
+   printf("%d messages\n", count);
+   Benchmark::report("json size"   , jsonFiles  .first().size() / 1024.0, "kB"      );
+   Benchmark::report("binary size" , binaryFiles.first().size() / 1024.0, "kB"      );
+   Benchmark::report("json save"   , jsonWrite   / count * 1000         , "ns/message");
+   Benchmark::report("binary save" , binaryWrite / count * 1000         , "ns/message");
+   Benchmark::report("json load"   , jsonRead    / count * 1000         , "ns/message");
+   Benchmark::report("binary load" , binaryRead  / count * 1000         , "ns/message");
+
+   // The loaded recordings are owned by SerializableEntityManager
+   return 0;
+}
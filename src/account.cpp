@@ -66,7 +66,6 @@
 #include "private/securityevaluationmodel_p.h"
 #include "extensions/securityevaluationextension.h"
 #define TO_BOOL ?"true":"false"
-#define IS_TRUE == "true"
 
 
 #define AP &AccountPrivate
@@ -121,7 +120,7 @@ Account::Account():ItemBase(&AccountModel::instance()),d_ptr(new AccountPrivate(
 }
 
 ///Build an account from it'id
-Account* AccountPrivate::buildExistingAccountFromId(const QByteArray& _accountId)
+Account* AccountPrivate::buildExistingAccountFromId(const QByteArray& _accountId, const MapStringString& details)
 {
 //    qDebug() << "Building an account from id: " << _accountId;
    Account* a = new Account();
@@ -129,6 +128,9 @@ Account* AccountPrivate::buildExistingAccountFromId(const QByteArray& _accountId
    a->d_ptr->setObjectName(_accountId);
    a->d_ptr->m_RemoteEnabledState = true;
 
+   //The details may have been requested along with other accounts ones
+   a->d_ptr->m_hPrefetchedDetails = details;
+
    a->performAction(Account::EditAction::RELOAD);
 
    //If a placeholder exist for this account, upgrade it
@@ -159,8 +161,8 @@ Account* AccountPrivate::buildNewAccountFromAlias(Account::Protocol proto, const
    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
    Account* a = new Account();
    a->setProtocol(proto);
-   a->d_ptr->m_hAccountDetails.clear();
-   a->d_ptr->m_hAccountDetails[DRing::Account::ConfProperties::ENABLED] = "false";
+   a->d_ptr->m_Details.clear();
+   a->d_ptr->m_Details.setValue(AccountDetails::Property::ENABLED, AccountPrivate::RegistrationEnabled::NO);
    a->d_ptr->m_pAccountNumber = const_cast<ContactMethod*>(ContactMethod::BLANK());
    MapStringString tmp;
    switch (proto) {
@@ -173,11 +175,8 @@ Account* AccountPrivate::buildNewAccountFromAlias(Account::Protocol proto, const
       case Account::Protocol::COUNT__:
          break;
    }
-   QMutableMapIterator<QString, QString> iter(tmp);
-   while (iter.hasNext()) {
-      iter.next();
-      a->d_ptr->m_hAccountDetails[iter.key()] = iter.value();
-   }
+   for (auto iter = tmp.constBegin(); iter != tmp.constEnd(); ++iter)
+      a->d_ptr->m_Details.setValue(iter.key(), iter.value());
 
    if (proto == Account::Protocol::RING)
    {
@@ -187,7 +186,7 @@ Account* AccountPrivate::buildNewAccountFromAlias(Account::Protocol proto, const
    }
    else
    {
-       a->setHostname(a->d_ptr->m_hAccountDetails[DRing::Account::ConfProperties::HOSTNAME]);
+       a->setHostname(a->d_ptr->m_Details.value(AccountDetails::Property::HOSTNAME));
    }
 
    a->d_ptr->setAccountProperty(DRing::Account::ConfProperties::ALIAS,alias);
@@ -228,15 +227,15 @@ void AccountPrivate::slotUpdateCertificate()
    if (cert) {
       switch (cert->type()) {
          case Certificate::Type::AUTHORITY:
-            if (accountDetail(DRing::Account::ConfProperties::TLS::CA_LIST_FILE) != cert->path())
+            if (accountDetail(AccountDetails::Property::TLS_CA_LIST_FILE) != cert->path())
                setAccountProperty(DRing::Account::ConfProperties::TLS::CA_LIST_FILE, cert->path());
             break;
          case Certificate::Type::USER:
-            if (accountDetail(DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE) != cert->path())
+            if (accountDetail(AccountDetails::Property::TLS_CERTIFICATE_FILE) != cert->path())
                setAccountProperty(DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE, cert->path());
             break;
          case Certificate::Type::PRIVATE_KEY:
-            if (accountDetail(DRing::Account::ConfProperties::TLS::PRIVATE_KEY_FILE) != cert->path())
+            if (accountDetail(AccountDetails::Property::TLS_PRIVATE_KEY_FILE) != cert->path())
                setAccountProperty(DRing::Account::ConfProperties::TLS::PRIVATE_KEY_FILE, cert->path());
             break;
          case Certificate::Type::NONE:
@@ -281,7 +280,7 @@ const QByteArray Account::id() const
 ///Get current state
 const QString Account::toHumanStateName() const
 {
-   const QString s = d_ptr->m_hAccountDetails[DRing::Account::ConfProperties::Registration::STATUS];
+   const QString& s = d_ptr->m_Details.value(AccountDetails::Property::REGISTRATION_STATUS);
 
                                                  //: Account state
    static const QString ready                  = tr("Ready"                    );
@@ -344,36 +343,54 @@ const QString Account::toHumanStateName() const
 ///Get an account detail
 const QString AccountPrivate::accountDetail(const QString& param) const
 {
-   if (!m_hAccountDetails.size()) {
-      qDebug() << "The account details is not set";
-      return QString(); //May crash, but better than crashing now
-   }
-   if (m_hAccountDetails.find(param) != m_hAccountDetails.end()) {
-      return m_hAccountDetails[param];
-   }
-   else if (m_hAccountDetails.count() > 0) {
-      if (param == DRing::Account::ConfProperties::ENABLED) //If an account is invalid, at least does not try to register it
-         return AccountPrivate::RegistrationEnabled::NO;
-      if (param == DRing::Account::ConfProperties::Registration::STATUS) { //If an account is new, then it is unregistered
-         return DRing::Account::States::UNREGISTERED;
-      }
+   const AccountDetails::Property p = AccountDetails::property(param);
+
+   if (p != AccountDetails::Property::COUNT__)
+      return accountDetail(p);
+
+   if (m_Details.contains(param))
+      return m_Details.value(param);
+
+   if (!m_Details.isEmpty()) {
       static QHash<QString,bool> alreadyWarned;
       if (!alreadyWarned[param]) {
          alreadyWarned[param] = true;
          qDebug() << "Account parameter \"" << param << "\" not found";
       }
-      return QString();
    }
-   else {
-      qDebug() << "Account details not found, there is " << m_hAccountDetails.count() << " details available";
-      return QString();
+   else
+      qDebug() << "The account details is not set";
+
+   return QString();
+}
+
+///Get a known account detail without looking up its key
+const QString& AccountPrivate::accountDetail(AccountDetails::Property p) const
+{
+   static const QString no           = AccountPrivate::RegistrationEnabled::NO;
+   static const QString unregistered = DRing::Account::States::UNREGISTERED;
+
+   if (m_Details.contains(p) || m_Details.isEmpty())
+      return m_Details.value(p);
+
+   if (p == AccountDetails::Property::ENABLED) //If an account is invalid, at least does not try to register it
+      return no;
+   else if (p == AccountDetails::Property::REGISTRATION_STATUS) //If an account is new, then it is unregistered
+      return unregistered;
+
+   static bool alreadyWarned[enum_class_size<AccountDetails::Property>()] = {};
+   if (!alreadyWarned[static_cast<int>(p)]) {
+      alreadyWarned[static_cast<int>(p)] = true;
+      qDebug() << "Account parameter \"" << AccountDetails::key(p) << "\" not found";
    }
+
+   return m_Details.value(p);
 } //accountDetail
 
 ///Get the alias
 const QString Account::alias() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ALIAS);
+   return d_ptr->accountDetail(AccountDetails::Property::ALIAS);
 }
 
 ///Return the model index of this item
@@ -617,31 +634,31 @@ QString Account::hostname() const
 ///Return if the account is enabled
 bool Account::isEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ENABLED) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::ENABLED);
 }
 
 ///Return if the account should auto answer
 bool Account::isAutoAnswer() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::AUTOANSWER) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::AUTOANSWER);
 }
 
 ///Return the account user name
 QString Account::username() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::USERNAME);
+   return d_ptr->accountDetail(AccountDetails::Property::USERNAME);
 }
 
 ///Return the account mailbox address
 QString Account::mailbox() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::MAILBOX);
+   return d_ptr->accountDetail(AccountDetails::Property::MAILBOX);
 }
 
 ///Return the account mailbox address
 QString Account::proxy() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ROUTE);
+   return d_ptr->accountDetail(AccountDetails::Property::ROUTE);
 }
 
 
@@ -663,68 +680,68 @@ QString Account::password() const
 ///Return the account security fallback
 bool Account::isSrtpRtpFallback() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::SRTP::RTP_FALLBACK) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::SRTP_RTP_FALLBACK);
 }
 
 //Return if SRTP is enabled or not
 bool Account::isSrtpEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::SRTP::ENABLED) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::SRTP_ENABLED);
 }
 
 ///Return if the account is using a STUN server
 bool Account::isSipStunEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::STUN::ENABLED) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::STUN_ENABLED);
 }
 
 ///Return the account STUN server
 QString Account::sipStunServer() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::STUN::SERVER);
+   return d_ptr->accountDetail(AccountDetails::Property::STUN_SERVER);
 }
 
 ///Return when the account expire (require renewal)
 int Account::registrationExpire() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Registration::EXPIRE).toInt();
+   return d_ptr->m_Details.toInt(AccountDetails::Property::REGISTRATION_EXPIRE);
 }
 
 ///Return if the published address is the same as the local one
 bool Account::isPublishedSameAsLocal() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::PUBLISHED_SAMEAS_LOCAL) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::PUBLISHED_SAMEAS_LOCAL);
 }
 
 ///Return the account published address
 QString Account::publishedAddress() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::PUBLISHED_ADDRESS);
+   return d_ptr->accountDetail(AccountDetails::Property::PUBLISHED_ADDRESS);
 }
 
 ///Return the account published port
 int Account::publishedPort() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::PUBLISHED_PORT).toUInt();
+   return d_ptr->m_Details.toInt(AccountDetails::Property::PUBLISHED_PORT);
 }
 
 ///Return the account tls password
 QString Account::tlsPassword() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::PASSWORD);
+   return d_ptr->accountDetail(AccountDetails::Property::TLS_PASSWORD);
 }
 
 ///Return the account TLS port
 int Account::bootstrapPort() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::DHT::PORT).toInt();
+   return d_ptr->m_Details.toInt(AccountDetails::Property::DHT_PORT);
 }
 
 ///Return the account TLS certificate authority list file
 Certificate* Account::tlsCaListCertificate() const
 {
    if (!d_ptr->m_pCaCert) {
-      const QString& path = d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::CA_LIST_FILE);
+      const QString& path = d_ptr->accountDetail(AccountDetails::Property::TLS_CA_LIST_FILE);
       if (path.isEmpty())
          return nullptr;
       d_ptr->m_pCaCert = CertificateModel::instance().getCertificateFromPath(path,Certificate::Type::AUTHORITY);
@@ -737,7 +754,7 @@ Certificate* Account::tlsCaListCertificate() const
 Certificate* Account::tlsCertificate() const
 {
    if (!d_ptr->m_pTlsCert) {
-      const QString& path = d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE);
+      const QString& path = d_ptr->accountDetail(AccountDetails::Property::TLS_CERTIFICATE_FILE);
       if (path.isEmpty())
          return nullptr;
       d_ptr->m_pTlsCert = CertificateModel::instance().getCertificateFromPath(path,Certificate::Type::USER);
@@ -755,49 +772,49 @@ QString Account::tlsPrivateKey() const
 ///Return the account TLS server name
 QString Account::tlsServerName() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::SERVER_NAME);
+   return d_ptr->accountDetail(AccountDetails::Property::TLS_SERVER_NAME);
 }
 
 ///Return the account negotiation timeout in seconds
 int Account::tlsNegotiationTimeoutSec() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::NEGOTIATION_TIMEOUT_SEC).toInt();
+   return d_ptr->m_Details.toInt(AccountDetails::Property::TLS_NEGOTIATION_TIMEOUT_SEC);
 }
 
 ///Return the account TLS verify server
 bool Account::isTlsVerifyServer() const
 {
-   return (d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::VERIFY_SERVER) IS_TRUE);
+   return d_ptr->m_Details.toBool(AccountDetails::Property::TLS_VERIFY_SERVER);
 }
 
 ///Return the account TLS verify client
 bool Account::isTlsVerifyClient() const
 {
-   return (d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::VERIFY_CLIENT) IS_TRUE);
+   return d_ptr->m_Details.toBool(AccountDetails::Property::TLS_VERIFY_CLIENT);
 }
 
 ///Return if it is required for the peer to have a certificate
 bool Account::isTlsRequireClientCertificate() const
 {
-   return (d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::REQUIRE_CLIENT_CERTIFICATE) IS_TRUE);
+   return d_ptr->m_Details.toBool(AccountDetails::Property::TLS_REQUIRE_CLIENT_CERTIFICATE);
 }
 
 ///Return the account TLS security is enabled
 bool Account::isTlsEnabled() const
 {
-   return protocol() == Account::Protocol::RING || (d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::ENABLED) IS_TRUE);
+   return protocol() == Account::Protocol::RING || d_ptr->m_Details.toBool(AccountDetails::Property::TLS_ENABLED);
 }
 
 ///Return if the ringtone are enabled
 bool Account::isRingtoneEnabled() const
 {
-   return (d_ptr->accountDetail(DRing::Account::ConfProperties::Ringtone::ENABLED) IS_TRUE);
+   return d_ptr->m_Details.toBool(AccountDetails::Property::RINGTONE_ENABLED);
 }
 
 ///Return the account ringtone path
 QString Account::ringtonePath() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Ringtone::PATH);
+   return d_ptr->accountDetail(AccountDetails::Property::RINGTONE_PATH);
 }
 
 ///Return the last error message received
@@ -830,11 +847,11 @@ int Account::localPort() const
    switch (protocol()) {
       case Account::Protocol::SIP:
          if (isTlsEnabled())
-            return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::LISTENER_PORT).toInt();
+            return d_ptr->m_Details.toInt(AccountDetails::Property::TLS_LISTENER_PORT);
          else
-            return d_ptr->accountDetail(DRing::Account::ConfProperties::LOCAL_PORT).toInt();
+            return d_ptr->m_Details.toInt(AccountDetails::Property::LOCAL_PORT);
       case Account::Protocol::RING:
-         return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::LISTENER_PORT).toInt();
+         return d_ptr->m_Details.toInt(AccountDetails::Property::TLS_LISTENER_PORT);
       case Account::Protocol::COUNT__:
          break;
    };
@@ -856,7 +873,7 @@ Account::RegistrationState Account::registrationState() const
 ///Return the account type
 Account::Protocol Account::protocol() const
 {
-   const QString str = d_ptr->accountDetail(DRing::Account::ConfProperties::TYPE);
+   const QString str = d_ptr->accountDetail(AccountDetails::Property::TYPE);
 
    if (str.isEmpty() || str == DRing::Account::ProtocolNames::SIP)
       return Account::Protocol::SIP;
@@ -875,7 +892,7 @@ ContactMethod* Account::contactMethod() const
 ///Return the DTMF type
 DtmfType Account::DTMFType() const
 {
-   QString type = d_ptr->accountDetail(DRing::Account::ConfProperties::DTMF_TYPE);
+   QString type = d_ptr->accountDetail(AccountDetails::Property::DTMF_TYPE);
    return (type == "overrtp" || type.isEmpty())? DtmfType::OverRtp:DtmfType::OverSip;
 }
 
@@ -891,57 +908,57 @@ QString Account::presenceMessage() const
 
 bool Account::supportPresencePublish() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Presence::SUPPORT_PUBLISH) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::PRESENCE_SUPPORT_PUBLISH);
 }
 
 bool Account::supportPresenceSubscribe() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Presence::SUPPORT_SUBSCRIBE) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::PRESENCE_SUPPORT_SUBSCRIBE);
 }
 
 bool Account::presenceEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Presence::ENABLED) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::PRESENCE_ENABLED);
 }
 
 bool Account::isVideoEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Video::ENABLED) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::VIDEO_ENABLED);
 }
 
 int Account::videoPortMax() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Video::PORT_MAX).toInt();
+   return d_ptr->m_Details.toInt(AccountDetails::Property::VIDEO_PORT_MAX);
 }
 
 int Account::videoPortMin() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Video::PORT_MIN).toInt();
+   return d_ptr->m_Details.toInt(AccountDetails::Property::VIDEO_PORT_MIN);
 }
 
 int Account::audioPortMin() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Audio::PORT_MIN).toInt();
+   return d_ptr->m_Details.toInt(AccountDetails::Property::AUDIO_PORT_MIN);
 }
 
 int Account::audioPortMax() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Audio::PORT_MAX).toInt();
+   return d_ptr->m_Details.toInt(AccountDetails::Property::AUDIO_PORT_MAX);
 }
 
 bool Account::isUpnpEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::UPNP_ENABLED) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::UPNP_ENABLED);
 }
 
 bool Account::hasCustomUserAgent() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::HAS_CUSTOM_USER_AGENT) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::HAS_CUSTOM_USER_AGENT);
 }
 
 QString Account::userAgent() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::USER_AGENT);
+   return d_ptr->accountDetail(AccountDetails::Property::USER_AGENT);
 }
 
 bool Account::useDefaultPort() const
@@ -951,27 +968,27 @@ bool Account::useDefaultPort() const
 
 bool Account::isTurnEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::ENABLED) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::TURN_ENABLED);
 }
 
 QString Account::turnServer() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER);
+   return d_ptr->accountDetail(AccountDetails::Property::TURN_SERVER);
 }
 
 QString Account::turnServerUsername() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_UNAME);
+   return d_ptr->accountDetail(AccountDetails::Property::TURN_SERVER_UNAME);
 }
 
 QString Account::turnServerPassword() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_PWD);
+   return d_ptr->accountDetail(AccountDetails::Property::TURN_SERVER_PWD);
 }
 
 QString Account::turnServerRealm() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_REALM);
+   return d_ptr->accountDetail(AccountDetails::Property::TURN_SERVER_REALM);
 }
 
 bool Account::hasProxy() const
@@ -981,12 +998,12 @@ bool Account::hasProxy() const
 
 QString Account::displayName() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::DISPLAYNAME);
+   return d_ptr->accountDetail(AccountDetails::Property::DISPLAYNAME);
 }
 
 bool Account::allowIncomingFromUnknown() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::DHT::PUBLIC_IN_CALLS) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::DHT_PUBLIC_IN_CALLS);
 }
 
 bool Account::allowIncomingFromHistory() const
@@ -994,7 +1011,7 @@ bool Account::allowIncomingFromHistory() const
    if (protocol() != Account::Protocol::RING)
       return false;
 
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ALLOW_CERT_FROM_HISTORY) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::ALLOW_CERT_FROM_HISTORY);
 }
 
 bool Account::allowIncomingFromContact() const
@@ -1002,12 +1019,12 @@ bool Account::allowIncomingFromContact() const
    if (protocol() != Account::Protocol::RING)
       return false;
 
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ALLOW_CERT_FROM_CONTACT) IS_TRUE;
+   return d_ptr->m_Details.toBool(AccountDetails::Property::ALLOW_CERT_FROM_CONTACT);
 }
 
 int Account::activeCallLimit() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ACTIVE_CALL_LIMIT).toInt();
+   return d_ptr->m_Details.toInt(AccountDetails::Property::ACTIVE_CALL_LIMIT);
 }
 
 bool Account::hasActiveCallLimit() const
@@ -1302,20 +1319,21 @@ uint AccountPrivate::internalId() const
 ///Set account details
 void AccountPrivate::setAccountProperties(const QHash<QString,QString>& m)
 {
-   m_hAccountDetails.clear();
-   m_hAccountDetails = m;
-   m_HostName = m[DRing::Account::ConfProperties::HOSTNAME];
+   m_Details.clear();
+   for (auto i = m.constBegin(); i != m.constEnd(); ++i)
+      m_Details.setValue(i.key(), i.value());
+   m_HostName = m_Details.value(AccountDetails::Property::HOSTNAME);
 }
 
 ///Set a specific detail
 bool AccountPrivate::setAccountProperty(const QString& param, const QString& val)
 {
-   const QString buf = m_hAccountDetails[param];
+   const QString buf = m_Details.value(param);
    const bool accChanged = buf != val;
    //Status can be changed regardless of the EditState
    //TODO make this more generic for volatile properties
    if (param == DRing::Account::ConfProperties::Registration::STATUS) {
-      m_hAccountDetails[param] = val;
+      m_Details.setValue(AccountDetails::Property::REGISTRATION_STATUS, val);
       if (accChanged) {
          emit q_ptr->changed(q_ptr);
          emit q_ptr->propertyChanged(q_ptr,param,val,buf);
@@ -1323,7 +1341,7 @@ bool AccountPrivate::setAccountProperty(const QString& param, const QString& val
    }
    else if (accChanged) {
 
-      m_hAccountDetails[param] = val;
+      m_Details.setValue(param, val);
       emit q_ptr->changed(q_ptr);
       emit q_ptr->propertyChanged(q_ptr,param,val,buf);
 
@@ -2238,29 +2256,16 @@ void AccountPrivate::save()
 {
    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
    if (q_ptr->isNew()) {
-      MapStringString details;
-      QMutableHashIterator<QString,QString> iter(m_hAccountDetails);
+      const QString currentId = configurationManager.addAccount(m_Details.toMap());
 
-      while (iter.hasNext()) {
-         iter.next();
-         details[iter.key()] = iter.value();
-      }
-
-      const QString currentId = configurationManager.addAccount(details);
-
-      q_ptr->codecModel() << CodecModel::EditAction::RELOAD;
+      //The codecs are loaded on demand, nothing to do if they were not used
+      if (m_pCodecModel)
+         m_pCodecModel << CodecModel::EditAction::RELOAD;
 
       q_ptr->setId(currentId.toLatin1());
    } //New account
    else { //Existing account
-      MapStringString tmp;
-      QMutableHashIterator<QString,QString> iter(m_hAccountDetails);
-
-      while (iter.hasNext()) {
-         iter.next();
-         tmp[iter.key()] = iter.value();
-      }
-      configurationManager.setAccountDetails(q_ptr->id(), tmp);
+      configurationManager.setAccountDetails(q_ptr->id(), m_Details.toMap());
       if (m_RemoteEnabledState != q_ptr->isEnabled()) {
          m_RemoteEnabledState = q_ptr->isEnabled();
          emit q_ptr->enabled(m_RemoteEnabledState);
@@ -2283,7 +2288,8 @@ void AccountPrivate::save()
       changeState(Account::EditState::READY);
    }
 
-   q_ptr->codecModel() << CodecModel::EditAction::SAVE;
+   if (m_pCodecModel)
+      m_pCodecModel << CodecModel::EditAction::SAVE;
 
    emit q_ptr->changed(q_ptr);
 }
@@ -2292,32 +2298,34 @@ void AccountPrivate::save()
 void AccountPrivate::reload()
 {
    if (!q_ptr->isNew()) {
-      if (m_hAccountDetails.size())
+      if (!m_Details.isEmpty())
          qDebug() << "Reloading" << q_ptr->id() << q_ptr->alias();
       else
          qDebug() << "Loading" << q_ptr->id();
       ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
-      QMap<QString,QString> aDetails = configurationManager.getAccountDetails(q_ptr->id());
+
+      //Send both requests before waiting for the first reply
+      auto volatileDetails = configurationManager.getVolatileAccountDetails(q_ptr->id());
+
+      QMap<QString,QString> aDetails = m_hPrefetchedDetails;
+      m_hPrefetchedDetails.clear();
+
+      if (aDetails.isEmpty())
+         aDetails = configurationManager.getAccountDetails(q_ptr->id());
 
       if (!aDetails.count()) {
          qDebug() << "Account not found";
       }
       else {
-         m_hAccountDetails.clear();
-         //In case not all elements match, it is better to do a "merge"
-         QMutableMapIterator<QString, QString> iter(aDetails);
-         while (iter.hasNext()) {
-            iter.next();
-            m_hAccountDetails[iter.key()] = iter.value();
-         }
+         m_Details.fromMap(aDetails);
 
          //Manually re-set elements that need extra business logic or caching
-         q_ptr->setHostname(m_hAccountDetails[DRing::Account::ConfProperties::HOSTNAME]);
+         q_ptr->setHostname(m_Details.value(AccountDetails::Property::HOSTNAME));
 
-         const QString ca  (m_hAccountDetails[DRing::Account::ConfProperties::TLS::CA_LIST_FILE    ]);
-         const QString cert(m_hAccountDetails[DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE]);
-         const QString key (m_hAccountDetails[DRing::Account::ConfProperties::TLS::PRIVATE_KEY_FILE]);
-         const QString pass(m_hAccountDetails[DRing::Account::ConfProperties::TLS::PASSWORD]);
+         const QString ca  (m_Details.value(AccountDetails::Property::TLS_CA_LIST_FILE    ));
+         const QString cert(m_Details.value(AccountDetails::Property::TLS_CERTIFICATE_FILE));
+         const QString key (m_Details.value(AccountDetails::Property::TLS_PRIVATE_KEY_FILE));
+         const QString pass(m_Details.value(AccountDetails::Property::TLS_PASSWORD        ));
 
          if (!ca.isEmpty())
             q_ptr->setTlsCaListCertificate(ca);
@@ -2364,7 +2372,7 @@ void AccountPrivate::reload()
       //The registration state is cached, update that cache
       updateState();
 
-      AccountModel::instance().d_ptr->slotVolatileAccountDetailsChange(q_ptr->id(),configurationManager.getVolatileAccountDetails(q_ptr->id()));
+      AccountModel::instance().d_ptr->slotVolatileAccountDetailsChange(q_ptr->id(),volatileDetails);
    }
 }
 
@@ -2504,5 +2512,4 @@ bool AccountPrivate::merge(Account* account)
 }
 
 #undef TO_BOOL
-#undef IS_TRUE
 #include <account.moc>
@@ -47,6 +47,7 @@
 #include "dbus/instancemanager.h"
 #include "codecmodel.h"
 #include "private/pendingtrustrequestmodel_p.h"
+#include "private/asyncrequest.h"
 
 QHash<QByteArray,AccountPlaceHolder*> AccountModelPrivate::m_hsPlaceHolder;
 
@@ -55,7 +56,10 @@ m_pIP2IP(nullptr),m_pProtocolModel(nullptr),m_pSelectionModel(nullptr),m_lMimes(
 m_lSupportedProtocols {{
    /* SIP  */ false,
    /* RING */ false,
-}}
+}},
+m_RegistrationEvents([this](const EventCoalescer<QString, RegistrationEvent>::Batch& events) {
+   processRegistrationEvents(events);
+})
 {}
 
 ///Constructors
@@ -66,11 +70,19 @@ AccountModel::AccountModel()
 
 void AccountModelPrivate::init()
 {
-    InstanceManager::instance(); // Make sure the daemon is running before calling updateAccounts()
-    q_ptr->updateAccounts();
+    InstanceManager::instance(); // Make sure the daemon is running before loading the accounts
 
-    CallManagerInterface& callManager = CallManager::instance();
+    // The accounts are expected to be there once the model exists, this is
+    // the only time they are fetched synchronously
     ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
+    const QStringList accountIds = configurationManager.getAccountList();
+    const QStringList newIds     = newAccountIds(accountIds);
+
+    addAccounts(accountIds, newIds, AsyncRequest::collect(newIds, [&configurationManager](const QString& id) {
+       return configurationManager.getAccountDetails(id);
+    }));
+
+    CallManagerInterface& callManager = CallManager::instance();
 
     connect(&configurationManager, &ConfigurationManagerInterface::registrationStateChanged,this ,
             &AccountModelPrivate::slotDaemonAccountChanged);
@@ -273,55 +285,83 @@ Account::RegistrationState AccountModelPrivate::fromDaemonName(const QString& st
 
 }
 
-///Account status changed
+/**
+ * Account status changed.
+ *
+ * The daemon can send many of those at once, for example when the network
+ * comes back, they are processed in batch once per event loop iteration.
+ */
 void AccountModelPrivate::slotDaemonAccountChanged(const QString& account, const QString& registration_state, unsigned code, const QString& status)
 {
-   Q_UNUSED(registration_state);
-   Account* a = q_ptr->getById(account.toLatin1());
+   m_RegistrationEvents.add(account, { registration_state, code, status });
+}
 
-   //TODO move this to AccountStatusModel
-   if (!a || (a && a->d_ptr->m_LastSipRegistrationStatus != status )) {
-      if (status != "OK") //Do not pollute the log
-         qDebug() << "Account" << account << "status changed to" << status;
+///The account may have been deleted by the user, but 'apply' have not been pressed
+void AccountModelPrivate::addMissingAccounts()
+{
+   ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
+
+   const QStringList accountIds = configurationManager.getAccountList();
+   for (int i = 0; i < accountIds.size(); ++i) {
+      if ((!q_ptr->getById(accountIds[i].toLatin1())) && m_lDeletedAccounts.indexOf(accountIds[i]) == -1) {
+         Account* acc = AccountPrivate::buildExistingAccountFromId(accountIds[i].toLatin1());
+         insertAccount(acc,i);
+         connect(acc, &Account::changed                , this, &AccountModelPrivate::slotAccountChanged                );
+         connect(acc, &Account::presenceEnabledChanged , this, &AccountModelPrivate::slotAccountPresenceEnabledChanged );
+         connect(acc, &Account::enabled                , this, &AccountModelPrivate::slotSupportedProtocolsChanged     );
+         emit q_ptr->dataChanged(q_ptr->index(i,0),q_ptr->index(q_ptr->size()-1));
+         emit q_ptr->layoutChanged();
+
+         if (!acc->isIp2ip())
+            enableProtocol(acc->protocol());
+
+      }
    }
+   foreach (Account* acc, m_lAccounts) {
+      const int idx =accountIds.indexOf(acc->id());
+      if (idx == -1 && (acc->editState() == Account::EditState::READY || acc->editState() == Account::EditState::REMOVED)) {
+         m_lAccounts.remove(idx);
+         emit q_ptr->dataChanged(q_ptr->index(idx - 1, 0), q_ptr->index(m_lAccounts.size()-1, 0));
+         emit q_ptr->layoutChanged();
+      }
+   }
+}
 
-   if (a)
-      a->d_ptr->m_LastSipRegistrationStatus = status;
+void AccountModelPrivate::processRegistrationEvents(const EventCoalescer<QString, RegistrationEvent>::Batch& events)
+{
+   bool hasUnknownAccount = false;
+   int  firstRow          = -1;
+   int  lastRow           = -1;
 
-   ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
+   for (const auto& event : events) {
+      const QString& account = event.first;
+      const unsigned code    = event.second.code;
+      const QString& status  = event.second.status;
 
-   //The account may have been deleted by the user, but 'apply' have not been pressed
-   if (!a) {
-      const QStringList accountIds = configurationManager.getAccountList();
-      for (int i = 0; i < accountIds.size(); ++i) {
-         if ((!q_ptr->getById(accountIds[i].toLatin1())) && m_lDeletedAccounts.indexOf(accountIds[i]) == -1) {
-            Account* acc = AccountPrivate::buildExistingAccountFromId(accountIds[i].toLatin1());
-            insertAccount(acc,i);
-            connect(acc, &Account::changed                , this, &AccountModelPrivate::slotAccountChanged                );
-            connect(acc, &Account::presenceEnabledChanged , this, &AccountModelPrivate::slotAccountPresenceEnabledChanged );
-            connect(acc, &Account::enabled                , this, &AccountModelPrivate::slotSupportedProtocolsChanged     );
-            emit q_ptr->dataChanged(q_ptr->index(i,0),q_ptr->index(q_ptr->size()-1));
-            emit q_ptr->layoutChanged();
-
-            if (!acc->isIp2ip())
-               enableProtocol(acc->protocol());
+      Account* a = q_ptr->getById(account.toLatin1());
 
-         }
+      //TODO move this to AccountStatusModel
+      if (!a || (a && a->d_ptr->m_LastSipRegistrationStatus != status )) {
+         if (status != "OK") //Do not pollute the log
+            qDebug() << "Account" << account << "status changed to" << status;
       }
-      foreach (Account* acc, m_lAccounts) {
-         const int idx =accountIds.indexOf(acc->id());
-         if (idx == -1 && (acc->editState() == Account::EditState::READY || acc->editState() == Account::EditState::REMOVED)) {
-            m_lAccounts.remove(idx);
-            emit q_ptr->dataChanged(q_ptr->index(idx - 1, 0), q_ptr->index(m_lAccounts.size()-1, 0));
-            emit q_ptr->layoutChanged();
-         }
+
+      if (!a) {
+         hasUnknownAccount = true;
+         continue;
       }
-   }
-   else {
+
+      a->d_ptr->m_LastSipRegistrationStatus = status;
+
       const bool isRegistered = a->registrationState() == Account::RegistrationState::READY;
       a->d_ptr->updateState();
-      const QModelIndex idx = a->index();
-      emit q_ptr->dataChanged(idx, idx);
+
+      const int row = a->index().row();
+      if (row != -1) {
+         firstRow = firstRow == -1 ? row : qMin(firstRow, row);
+         lastRow  = qMax(lastRow, row);
+      }
+
       const bool regStateChanged = isRegistered != (a->registrationState() == Account::RegistrationState::READY);
 
       //Handle some important events directly
@@ -336,11 +376,21 @@ void AccountModelPrivate::slotDaemonAccountChanged(const QString& account, const
 
       //Make sure volatile details get reloaded
       //TODO eventually remove this call and trust the signal
-      slotVolatileAccountDetailsChange(account,configurationManager.getVolatileAccountDetails(account));
+      AsyncRequest::call(this, [account]() {
+         return ConfigurationManager::instance().getVolatileAccountDetails(account);
+      }, [this, account](const MapStringString& details) {
+         slotVolatileAccountDetailsChange(account, details);
+      });
 
       emit q_ptr->accountStateChanged(a,a->registrationState());
    }
 
+   //One notification for the whole batch
+   if (firstRow != -1)
+      emit q_ptr->dataChanged(q_ptr->index(firstRow, 0), q_ptr->index(lastRow, 0));
+
+   if (hasUnknownAccount)
+      addMissingAccounts();
 }
 
 void AccountModelPrivate::slotSupportedProtocolsChanged()
@@ -417,7 +467,7 @@ void AccountModelPrivate::slotIncomingTrustRequest(const QString& accountId, con
    a->pendingTrustRequestModel()->d_ptr->addRequest(r);
 }
 
-///Update accounts
+///Update accounts, synchronously: the removed rows are back on return
 void AccountModel::update()
 {
    ConfigurationManagerInterface & configurationManager = ConfigurationManager::instance();
@@ -435,9 +485,15 @@ void AccountModel::update()
    }
    //ask for the list of accounts ids to the configurationManager
    const QStringList accountIds = configurationManager.getAccountList();
+
+   //Request all the details at once rather than one account at a time
+   const auto details = AsyncRequest::collect(accountIds, [&configurationManager](const QString& id) {
+      return configurationManager.getAccountDetails(id);
+   });
+
    for (int i = 0; i < accountIds.size(); ++i) {
       if (d_ptr->m_lDeletedAccounts.indexOf(accountIds[i]) == -1) {
-         Account* a = AccountPrivate::buildExistingAccountFromId(accountIds[i].toLatin1());
+         Account* a = AccountPrivate::buildExistingAccountFromId(accountIds[i].toLatin1(), details[i]);
          d_ptr->insertAccount(a,i);
          emit dataChanged(index(i,0),index(size()-1,0));
          connect(a,SIGNAL(changed(Account*)),d_ptr,SLOT(slotAccountChanged(Account*)));
@@ -451,34 +507,69 @@ void AccountModel::update()
    }
 } //update
 
-///Update accounts
+///Update accounts, the new ones are added once their details are fetched
 void AccountModel::updateAccounts()
 {
    qDebug() << "Updating all accounts";
-   ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
-   QStringList accountIds = configurationManager.getAccountList();
+
+   AsyncRequest::call(this, []() {
+      return ConfigurationManager::instance().getAccountList();
+   }, [this](const QStringList& accountIds) {
+      //Request the details of all the new accounts at once
+      const QStringList newIds = d_ptr->newAccountIds(accountIds);
+
+      AsyncRequest::collect(this, newIds, [](const QString& id) {
+         return ConfigurationManager::instance().getAccountDetails(id);
+      }, [this, accountIds, newIds](const QVector<MapStringString>& details) {
+         d_ptr->addAccounts(accountIds, newIds, details);
+      });
+   });
+} //updateAccounts
+
+///The accounts the model doesn't have yet
+QStringList AccountModelPrivate::newAccountIds(const QStringList& accountIds) const
+{
+   QStringList newIds;
+   for (const QString& id : accountIds) {
+      if (!q_ptr->getById(id.toLatin1()))
+         newIds << id;
+   }
+
+   return newIds;
+}
+
+/**
+ * Add the new accounts and reload the others.
+ *
+ * @param newIds the accounts "details" are for, an account may have been
+ *  added since they were requested
+ */
+void AccountModelPrivate::addAccounts(const QStringList& accountIds, const QStringList& newIds, const QVector<MapStringString>& details)
+{
    //m_lAccounts.clear();
    for (int i = 0; i < accountIds.size(); ++i) {
-      Account* acc = getById(accountIds[i].toLatin1());
+      Account* acc = q_ptr->getById(accountIds[i].toLatin1());
       if (!acc) {
-         Account* a = AccountPrivate::buildExistingAccountFromId(accountIds[i].toLatin1());
-         d_ptr->insertAccount(a,d_ptr->m_lAccounts.size());
-         connect(a,SIGNAL(changed(Account*)),d_ptr,SLOT(slotAccountChanged(Account*)));
-         //connect(a,SIGNAL(propertyChanged(Account*,QString,QString,QString)),d_ptr,SLOT(slotAccountChanged(Account*)));
-         connect(a,SIGNAL(presenceEnabledChanged(bool)),d_ptr,SLOT(slotAccountPresenceEnabledChanged(bool)));
-         emit dataChanged(index(size()-1,0),index(size()-1,0));
+         Account* a = AccountPrivate::buildExistingAccountFromId(
+            accountIds[i].toLatin1(), details.value(newIds.indexOf(accountIds[i]))
+         );
+         insertAccount(a,m_lAccounts.size());
+         connect(a,SIGNAL(changed(Account*)),this,SLOT(slotAccountChanged(Account*)));
+         //connect(a,SIGNAL(propertyChanged(Account*,QString,QString,QString)),this,SLOT(slotAccountChanged(Account*)));
+         connect(a,SIGNAL(presenceEnabledChanged(bool)),this,SLOT(slotAccountPresenceEnabledChanged(bool)));
+         emit q_ptr->dataChanged(q_ptr->index(q_ptr->size()-1,0),q_ptr->index(q_ptr->size()-1,0));
 
          if (!a->isIp2ip())
-            d_ptr->enableProtocol(a->protocol());
+            enableProtocol(a->protocol());
 
-         emit accountAdded(a);
+         emit q_ptr->accountAdded(a);
       }
-      else {
+      else if (newIds.indexOf(accountIds[i]) == -1) {
          acc->performAction(Account::EditAction::RELOAD);
       }
    }
-   emit accountListUpdated();
-} //updateAccounts
+   emit q_ptr->accountListUpdated();
+}
 
 ///Save accounts details and reload it
 void AccountModel::save()
@@ -680,7 +771,8 @@ void AccountModelPrivate::slotMediaParametersChanged(const QString& accountId)
 {
    Account* a = q_ptr->getById(accountId.toLatin1());
    if (a) {
-      if (auto codecModel = a->codecModel()) {
+      //Don't load the codecs of an account only to reload them
+      if (auto codecModel = a->d_ptr->m_pCodecModel) {
          qDebug() << "reloading codecs";
          codecModel << CodecModel::EditAction::RELOAD;
       }
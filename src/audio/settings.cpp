@@ -28,6 +28,7 @@
 #include "managermodel.h"
 #include "outputdevicemodel.h"
 #include "inputdevicemodel.h"
+#include "private/eventcoalescer.h"
 
 namespace Audio {
 class SettingsPrivate final : public QObject
@@ -43,6 +44,10 @@ public:
    mutable Audio::ManagerModel*        m_pAudioManagerModel  ;
    mutable Audio::RingtoneDeviceModel* m_pRingtoneDeviceModel;
    bool                 m_EnableRoomTone      ;
+   EventCoalescer<QString, double> m_VolumeEvents; // the meters can change very often
+
+   //Helpers
+   void volumeChanged(const QString& str, double volume);
 
 private Q_SLOTS:
    void slotVolumeChanged(const QString& str, double volume);
@@ -55,7 +60,11 @@ private:
 Audio::SettingsPrivate::SettingsPrivate(Audio::Settings* parent) : q_ptr(parent),m_EnableRoomTone(false),
  m_pAlsaPluginModel  (nullptr), m_pInputDeviceModel   (nullptr),
  m_pAudioManagerModel(nullptr), m_pRingtoneDeviceModel(nullptr),
- m_pOutputDeviceModel(nullptr)
+ m_pOutputDeviceModel(nullptr),
+ m_VolumeEvents([this](const EventCoalescer<QString, double>::Batch& events) {
+   for (const auto& e : events)
+      volumeChanged(e.first, e.second);
+ })
 {
 
 }
@@ -242,7 +251,13 @@ bool Audio::Settings::areDTMFMuted() const
 }
 
 ///Called when the volume change for external reasons
+///Only the latest volume of each device is kept until the next event loop iteration
 void Audio::SettingsPrivate::slotVolumeChanged(const QString& str, double volume)
+{
+   m_VolumeEvents.add(str, volume);
+}
+
+void Audio::SettingsPrivate::volumeChanged(const QString& str, double volume)
 {
    if (str == Audio::Settings::DeviceKey::CAPTURE)
       emit q_ptr->captureVolumeChanged(static_cast<int>(volume*100));
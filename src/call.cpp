@@ -45,6 +45,7 @@
 #include "accountmodel.h"
 #include "availableaccountmodel.h"
 #include "private/videorenderermanager.h"
+#include "private/callstatemirror.h"
 #include "localrecordingcollection.h"
 #include "categorizedhistorymodel.h"
 #include "useractionmodel.h"
@@ -340,9 +341,15 @@ Call::Call(const QString& confId, const QString& account)
    if (type() == Call::Type::CONFERENCE) {
       d_ptr->setStartTimeStamp();
       d_ptr->initTimer();
-      CallManagerInterface& callManager = CallManager::instance();
-      MapStringString        details    = callManager.getConferenceDetails(dringId())  ;
-      d_ptr->m_CurrentState             = d_ptr->confStatetoCallState(details[CallPrivate::ConfDetailsMapFields::CONF_STATE]);
+      const CallStateMirror& mirror = CallStateMirror::instance();
+      QString confState = mirror.conferenceState(dringId());
+
+      if (!mirror.hasConference(dringId())) {
+         const MapStringString details = CallManager::instance().getConferenceDetails(dringId());
+         confState = details[CallPrivate::ConfDetailsMapFields::CONF_STATE];
+      }
+
+      d_ptr->m_CurrentState = d_ptr->confStatetoCallState(confState);
       emit stateChanged(state(),Call::State::NEW);
    }
 }
@@ -418,8 +425,12 @@ MapStringString CallPrivate::getCallDetailsCommon(const QString& callId)
 {
    CallManagerInterface& callManager = CallManager::instance();
 
-   MapStringString details = callManager.getCallDetails(callId);
+   return getCallDetailsCommon(MapStringString(callManager.getCallDetails(callId)));
+}
 
+///Same as above for details already received from the daemon
+MapStringString CallPrivate::getCallDetailsCommon(MapStringString details)
+{
    const QString account = details[ DRing::Call::Details::ACCOUNTID ];
 
    if (account.isEmpty())
@@ -446,8 +457,13 @@ MapStringString CallPrivate::getCallDetailsCommon(const QString& callId)
 ///Build a call from a dbus event
 Call* CallPrivate::buildCall(const QString& callId, Call::Direction callDirection, Call::State startState)
 {
-    const auto& details = getCallDetailsCommon(callId);
+    return buildCall(callId, callDirection, startState, getCallDetailsCommon(callId));
+}
 
+///Build a call from the (processed) details already received from the daemon
+Call* CallPrivate::buildCall(const QString& callId, Call::Direction callDirection, Call::State startState,
+                             const MapStringString& details)
+{
     const auto& peerNumber    = details[ DRing::Call::Details::PEER_NUMBER ];
     const auto& peerName      = details[ DRing::Call::Details::DISPLAY_NAME];
     const auto& account       = details[ DRing::Call::Details::ACCOUNTID   ];
@@ -500,11 +516,17 @@ Call* CallPrivate::buildCall(const QString& callId, Call::Direction callDirectio
 ///Build a call from its ID
 Call* CallPrivate::buildExistingCall(const QString& callId)
 {
-    const auto& details = getCallDetailsCommon(callId);
+    return buildExistingCall(callId, CallManager::instance().getCallDetails(callId));
+}
+
+///Build a call from its ID and the details returned by the daemon
+Call* CallPrivate::buildExistingCall(const QString& callId, const MapStringString& daemonDetails)
+{
+    const auto& details = getCallDetailsCommon(daemonDetails);
     const auto daemon_state = details[DRing::Call::Details::CALL_STATE];
     const auto daemon_type = details[DRing::Call::Details::CALL_TYPE];
     const auto direction = daemon_type == CallPrivate::CallDirection::OUTGOING ? Call::Direction::OUTGOING : Call::Direction::INCOMING;
-    return buildCall(callId, direction, startStateFromDaemonCallState(daemon_state, daemon_type));
+    return buildCall(callId, direction, startStateFromDaemonCallState(daemon_state, daemon_type), details);
 }
 
 ///Build a call from a dbus event
@@ -2270,7 +2292,7 @@ QVariant Call::roleData(int role) const
          return GlobalInstances::pixmapManipulator().securityLevelIcon(account()->securityEvaluationModel()->securityLevel());
       case static_cast<int>(Ring::Role::UnreadTextMessageCount):
          if (peerContactMethod() && peerContactMethod()->textRecording())
-            return peerContactMethod()->textRecording()->unreadInstantTextMessagingModel()->rowCount();
+            return peerContactMethod()->textRecording()->unreadCount();
          else
             return 0;
          break;
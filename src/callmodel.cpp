@@ -39,6 +39,7 @@
 #include "dbus/instancemanager.h"
 #include "private/videorenderermanager.h"
 #include "private/imconversationmanagerprivate.h"
+#include "private/callstatemirror.h"
 #include "mime.h"
 #include "typedefs.h"
 #include "collectioninterface.h"
@@ -97,7 +98,8 @@ public:
       bool isPartOf(const QModelIndex& confIdx, Call* call);
       void removeConference       ( Call* conf                    );
       void removeInternal(InternalStruct* internal);
-      static QStringList getCallList();
+      void addExistingCalls();
+      static QStringList getCallList(QVector<MapStringString>* details = nullptr);
 
    private:
       CallModel* q_ptr;
@@ -117,6 +119,7 @@ public:
       void slotAudioMuted         ( const QString& callId    , bool state             );
       void slotVideoMutex         ( const QString& callId    , bool state             );
       void slotPeerHold           ( const QString& callId    , bool state             );
+      void slotConferenceDiverged ( const QString& confId                             );
 };
 
 
@@ -167,12 +170,13 @@ void CallModelPrivate::init()
     VideoManager::instance();
 #endif
 
+    //The mirror has to be updated before the slots below are called
+    CallStateMirror& mirror = CallStateMirror::instance();
+
     //SLOTS
     /*             SENDER                          SIGNAL                     RECEIVER                    SLOT                   */
     /**/connect(&callManager, SIGNAL(callStateChanged(QString,QString,int))  , this , SLOT(slotCallStateChanged(QString,QString,int)));
     /**/connect(&callManager, SIGNAL(incomingCall(QString,QString,QString))   , this , SLOT(slotIncomingCall(QString,QString))       );
-    /**/connect(&callManager, SIGNAL(conferenceCreated(QString))              , this , SLOT(slotIncomingConference(QString))         );
-    /**/connect(&callManager, SIGNAL(conferenceChanged(QString,QString))      , this , SLOT(slotChangingConference(QString,QString)) );
     /**/connect(&callManager, SIGNAL(conferenceRemoved(QString))              , this , SLOT(slotConferenceRemoved(QString))          );
     /**/connect(&callManager, SIGNAL(recordPlaybackFilepath(QString,QString)) , this , SLOT(slotNewRecordingAvail(QString,QString))  );
     /**/connect(&callManager, SIGNAL(recordingStateChanged(QString,bool))     , this , SLOT(slotRecordStateChanged(QString,bool)));
@@ -182,17 +186,40 @@ void CallModelPrivate::init()
     /*                                                                                                                           */
 
     connect(&CategorizedHistoryModel::instance(),SIGNAL(newHistoryCall(Call*)),this,SLOT(slotAddPrivateCall(Call*)));
+    connect(&mirror, &CallStateMirror::conferenceDiverged, this, &CallModelPrivate::slotConferenceDiverged);
+
+    //The conference participants are fetched by the mirror first
+    connect(&mirror, &CallStateMirror::conferenceCreated, this, &CallModelPrivate::slotIncomingConference);
+    connect(&mirror, &CallStateMirror::conferenceChanged, this, &CallModelPrivate::slotChangingConference);
 
     registerCommTypes();
 
-    const QStringList callList = getCallList();
-    foreach (const QString& callId, callList) {
-        Call* tmpCall = CallPrivate::buildExistingCall(callId);
+    //The mirror is filled without blocking, add the existing calls once it is
+    if (mirror.isLoaded())
+        addExistingCalls();
+    else
+        connect(&mirror, &CallStateMirror::loaded, this, &CallModelPrivate::addExistingCalls);
+}
+
+///Add the calls and conferences that existed before the client started
+void CallModelPrivate::addExistingCalls()
+{
+    QVector<MapStringString> callDetails;
+    const QStringList callList = getCallList(&callDetails);
+    for (int i = 0; i < callList.size(); i++) {
+        // The signals received while the mirror was loaded may have added it
+        if (m_shDringId.value(callList[i]))
+            continue;
+
+        Call* tmpCall = CallPrivate::buildExistingCall(callList[i], callDetails[i]);
         addCall2(tmpCall);
     }
 
-    const QStringList confList = callManager.getConferenceList();
+    const QStringList confList = CallStateMirror::instance().conferences();
     foreach (const QString& confId, confList) {
+        if (m_shDringId.value(confId))
+            continue;
+
         Call* conf = addConference(confId);
         emit q_ptr->conferenceCreated(conf);
     }
@@ -213,7 +240,7 @@ CallModel::~CallModel()
    //Unregister from the daemon
    InstanceManagerInterface& instance = InstanceManager::instance();
    Q_NOREPLY instance.Unregister(getpid());
-#ifdef ENABLE_LIBWRAP
+#if defined(ENABLE_LIBWRAP) || defined(ENABLE_FAKEDAEMON)
 
 #else
    instance.connection().disconnectFromBus(instance.connection().baseService());
@@ -335,7 +362,7 @@ CallList CallModel::getActiveConferences()
    CallList confList;
 
    //That way it can not be invalid
-   const QStringList confListS = CallManager::instance().getConferenceList();
+   const QStringList confListS = CallStateMirror::instance().conferences();
    foreach (const QString& confId, confListS) {
       InternalStruct* internalS = d_ptr->m_shDringId[confId];
       if (!internalS) {
@@ -372,7 +399,7 @@ QList<Call*> CallModel::getConferenceParticipants(Call* conf) const
 
 bool CallModel::isConnected() const
 {
-#ifdef ENABLE_LIBWRAP
+#if defined(ENABLE_LIBWRAP) || defined(ENABLE_FAKEDAEMON)
    return InstanceManager::instance().isConnected();
 #else
    return InstanceManager::instance().connection().isConnected();
@@ -603,19 +630,17 @@ void CallModelPrivate::removeInternal(InternalStruct* internal)
  * LibRingClient doesn't [need to] handle INACTIVE calls
  * This method make sure they never get into the system.
  *
- * It's not very efficient, but do the job. This method isn't
- * called very often anyway.
+ * The list comes from the local mirror, it doesn't query the daemon.
  */
-QStringList CallModelPrivate::getCallList()
+QStringList CallModelPrivate::getCallList(QVector<MapStringString>* details)
 {
-   CallManagerInterface& callManager = CallManager::instance();
-   const QStringList callList = callManager.getCallList();
-   QStringList ret;
+   const CallStateMirror& mirror = CallStateMirror::instance();
+   const QStringList ret = mirror.calls();
 
-   for (const QString& callId : callList) {
-      QMap<QString, QString> details = callManager.getCallDetails(callId);
-      if (details[DRing::Call::Details::CALL_STATE] != DRing::Call::StateEvent::INACTIVE)
-         ret << callId;
+   if (details) {
+      details->reserve(ret.size());
+      for (const QString& callId : ret)
+         (*details) << mirror.details(callId);
    }
 
    return ret;
@@ -719,8 +744,7 @@ void CallModel::transfer(Call* toTransfer, const ContactMethod* target)
 Call* CallModelPrivate::addConference(const QString& confID)
 {
    qDebug() << "Notified of a new conference " << confID;
-   CallManagerInterface& callManager = CallManager::instance();
-   const QStringList callList = callManager.getParticipantList(confID);
+   const QStringList callList = CallStateMirror::instance().participants(confID);
    qDebug() << "Paticiapants are:" << callList;
 
    if (!callList.size()) {
@@ -1247,8 +1271,7 @@ void CallModelPrivate::slotChangingConference(const QString &confID, const QStri
       }
 
       conf->d_ptr->stateChanged(state);
-      CallManagerInterface& callManager = CallManager::instance();
-      const QStringList participants = callManager.getParticipantList(confID);
+      const QStringList participants = CallStateMirror::instance().participants(confID);
 
       qDebug() << "The conf has" << confInt->m_lChildren.size() << "calls, daemon has" <<participants.size();
 
@@ -1291,10 +1314,12 @@ void CallModelPrivate::slotChangingConference(const QString &confID, const QStri
          }
       }
 
-      //Test if there is no inconsistencies between the daemon and the client
-      const QStringList deamonCallList = getCallList();
-      foreach(const QString& callId, deamonCallList) {
-         const QMap<QString,QString> callDetails = callManager.getCallDetails(callId);
+      //Test if there is no inconsistencies between the daemon mirror and the client
+      QVector<MapStringString> deamonCallDetails;
+      const QStringList deamonCallList = getCallList(&deamonCallDetails);
+      for (int i = 0; i < deamonCallList.size(); i++) {
+         const QString&         callId      = deamonCallList[i];
+         const MapStringString& callDetails = deamonCallDetails[i];
          InternalStruct* callInt = m_shDringId[callId];
          if (callInt) {
             const QString confId = callDetails[DRing::Call::Details::CONF_ID];
@@ -1347,6 +1372,21 @@ void CallModelPrivate::slotConferenceRemoved(const QString &confId)
    emit q_ptr->conferenceRemoved(conf);
 }
 
+///When the daemon missed a conference signal, replay it
+void CallModelPrivate::slotConferenceDiverged(const QString& confId)
+{
+   const CallStateMirror& mirror = CallStateMirror::instance();
+
+   if (!mirror.hasConference(confId)) {
+      if (m_shDringId.value(confId))
+         slotConferenceRemoved(confId);
+   }
+   else if (!m_shDringId.value(confId))
+      slotIncomingConference(confId);
+   else
+      slotChangingConference(confId, mirror.conferenceState(confId));
+}
+
 ///Make the call aware it has a recording
 void CallModelPrivate::slotNewRecordingAvail( const QString& callId, const QString& filePath)
 {
@@ -19,6 +19,7 @@
 
 //Qt
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QDir>
 #include <QtCore/QDateTime>
 
@@ -35,6 +36,8 @@
 #include "private/account_p.h"
 #include "private/certificatemodel_p.h"
 #include "private/certificate_p.h"
+#include "private/certificatecache.h"
+#include "private/asyncrequest.h"
 #include <account.h>
 #include <chainoftrustmodel.h>
 #include "contactmethod.h"
@@ -204,18 +207,60 @@ ChecksCache::ChecksCache(const MapStringString& checks)
    m_NotActivated                        = CertificatePrivate::toBool(checks[DRing::Certificate::ChecksNames::NOT_ACTIVATED                    ]);
 }
 
+/**
+ * The results depend on the password, don't keep anything related to
+ * it on disk.
+ */
+bool CertificatePrivate::isCacheable() const
+{
+   return m_PrivateKeyPassword.isEmpty();
+}
+
+///The cache key, the checks also depend on the private key
+QString CertificatePrivate::cacheKey() const
+{
+   switch(m_LoadingType) {
+      case LoadingType::FROM_PATH:
+         return QStringLiteral("path:") + m_Path + QLatin1Char('|') + m_PrivateKey;
+      case LoadingType::FROM_ID:
+         return QStringLiteral("id:") + m_Id;
+   }
+   return QString();
+}
+
+///Detect when a certificate file is replaced
+QDateTime CertificatePrivate::modificationTime() const
+{
+   if (m_LoadingType != LoadingType::FROM_PATH)
+      return QDateTime();
+
+   QFileInfo info(m_Path);
+   return info.exists() ? info.lastModified().toUTC() : QDateTime();
+}
+
 void CertificatePrivate::loadDetails(bool reload)
 {
    if (!m_pDetailsCache || reload) {
+      CertificateCache& cache = CertificateCache::instance();
       MapStringString d;
-      switch(m_LoadingType) {
-         case LoadingType::FROM_PATH:
-            d = ConfigurationManager::instance().getCertificateDetailsPath(m_Path, m_PrivateKey, m_PrivateKeyPassword);
-            break;
-         case LoadingType::FROM_ID:
-            d = ConfigurationManager::instance().getCertificateDetails(m_Id);
-            break;
+
+      if (reload || !isCacheable()
+       || cache.find(cacheKey(), CertificateCache::Kind::DETAILS, modificationTime(), d) == CertificateCache::Status::MISSING) {
+         switch(m_LoadingType) {
+            case LoadingType::FROM_PATH:
+               d = ConfigurationManager::instance().getCertificateDetailsPath(m_Path, m_PrivateKey, m_PrivateKeyPassword);
+               break;
+            case LoadingType::FROM_ID:
+               d = ConfigurationManager::instance().getCertificateDetails(m_Id);
+               break;
+         }
+
+         if (isCacheable())
+            cache.insert(cacheKey(), CertificateCache::Kind::DETAILS, modificationTime(), d);
       }
+
+      if (m_pDetailsCache)
+         delete m_pDetailsCache;
       m_pDetailsCache = new DetailsCache(d);
    }
 }
@@ -223,22 +268,70 @@ void CertificatePrivate::loadDetails(bool reload)
 void CertificatePrivate::loadChecks(bool reload)
 {
    if ((!m_pCheckCache) || reload) {
+      CertificateCache& cache = CertificateCache::instance();
       MapStringString checks;
-      switch(m_LoadingType) {
-         case LoadingType::FROM_PATH:
-            checks = ConfigurationManager::instance().validateCertificatePath(QString(),m_Path,m_PrivateKey, m_PrivateKeyPassword, {});
-            break;
-         case LoadingType::FROM_ID:
-            checks = ConfigurationManager::instance().validateCertificate(QString(),m_Id);
-            break;
+
+      const CertificateCache::Status status = (reload || !isCacheable()) ? CertificateCache::Status::MISSING :
+         cache.find(cacheKey(), CertificateCache::Kind::CHECKS, modificationTime(), checks);
+
+      if (status == CertificateCache::Status::MISSING) {
+         switch(m_LoadingType) {
+            case LoadingType::FROM_PATH:
+               checks = ConfigurationManager::instance().validateCertificatePath(QString(),m_Path,m_PrivateKey, m_PrivateKeyPassword, {});
+               break;
+            case LoadingType::FROM_ID:
+               checks = ConfigurationManager::instance().validateCertificate(QString(),m_Id);
+               break;
+         }
+
+         if (isCacheable())
+            cache.insert(cacheKey(), CertificateCache::Kind::CHECKS, modificationTime(), checks);
       }
-      if (reload && m_pCheckCache)
-         delete m_pCheckCache;
-      m_pCheckCache = new ChecksCache(checks);
-      CertificateModel::instance().d_ptr->regenChecks(q_ptr);
+      else if (status == CertificateCache::Status::STALE)
+         revalidateChecks();
+
+      setChecks(checks);
    }
 }
 
+void CertificatePrivate::setChecks(const MapStringString& checks)
+{
+   if (m_pCheckCache)
+      delete m_pCheckCache;
+   m_pCheckCache = new ChecksCache(checks);
+   CertificateModel::instance().d_ptr->regenChecks(q_ptr);
+}
+
+///Validate the certificate again in the background, update it if it changed
+void CertificatePrivate::revalidateChecks()
+{
+   CertificateCache::instance().revalidate(q_ptr, [this]() {
+      const QString     key      = cacheKey();
+      const QDateTime   modified = modificationTime();
+      const LoadingType type     = m_LoadingType;
+      const QString     path     = m_Path;
+      const QString     privKey  = m_PrivateKey;
+      const QString     id       = m_Id;
+
+      AsyncRequest::call(q_ptr, [type, path, privKey, id]() {
+         if (type == LoadingType::FROM_PATH)
+            return ConfigurationManager::instance().validateCertificatePath(QString(), path, privKey, QString(), {});
+
+         return ConfigurationManager::instance().validateCertificate(QString(), id);
+      }, [this, key, modified](const MapStringString& checks) {
+         // The certificate changed in the meantime, the result is outdated
+         if (key != cacheKey() || !isCacheable())
+            return;
+
+         if (CertificateCache::instance().insert(key, CertificateCache::Kind::CHECKS, modified, checks)) {
+            setChecks(checks);
+            m_hasLoadedSecurityLevel = false;
+            emit q_ptr->changed();
+         }
+      });
+   });
+}
+
 Certificate::Certificate(const QString& path, Type type, const QString& privateKey) : ItemBase(nullptr),d_ptr(new CertificatePrivate(this,LoadingType::FROM_PATH))
 {
    Q_UNUSED(privateKey)
@@ -22,8 +22,12 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QSortFilterProxyModel>
 #include <QtCore/QItemSelectionModel>
+#include <QtCore/QPointer>
 #include <QMimeData>
 
+// Std
+#include <functional>
+
 //DRing
 #include <account_const.h>
 
@@ -33,9 +37,44 @@
 #include "mime.h"
 #include "callmodel.h"
 #include <private/matrixutils.h>
+#include <private/asyncrequest.h>
 
 typedef void (CodecModelPrivate::*CodecModelFct)();
 
+/**
+ * The codecs supported by the daemon and their default properties.
+ *
+ * They are the same for every account, so they are fetched once for the
+ * whole process, without blocking, the first time a CodecModel is loaded.
+ * Only the order, the activation and the properties overridden by an
+ * account are fetched per account.
+ */
+class CodecCatalog final : public QObject
+{
+public:
+   static CodecCatalog& instance();
+
+   //Getters, valid once loaded
+   const VectorUInt& codecs (       ) const;
+   MapStringString   details(uint id) const;
+
+   void whenLoaded(QObject* context, const std::function<void()>& callback);
+
+private:
+   enum class State {
+      NONE   ,
+      LOADING,
+      LOADED ,
+   };
+
+   void load();
+
+   State                        m_State {State::NONE};
+   VectorUInt                   m_lCodecs  ;
+   QHash<uint, MapStringString> m_hDetails ;
+   QList<QPair<QPointer<QObject>, std::function<void()>>> m_lPending; // the whenLoaded() callbacks
+};
+
 class CodecModelPrivate final : public QObject
 {
    Q_OBJECT
@@ -54,6 +93,7 @@ public:
       QString          min_quality;
       QString          max_quality;
       QString          auto_quality_enabled;
+      bool             loaded     ; /*!< If the account properties are known */
    };
 
    //Attributes
@@ -77,6 +117,10 @@ public:
    void        modify      (                        );
 
    //Helpers
+   void reloadCodecs();
+   void loadDetails(CodecData* codec);
+   static void fill(CodecData* codec, const MapStringString& details);
+   static bool isAccountRole(int role);
    bool findCodec(int id);
    QModelIndex getIndexofCodecByID(int id);
    inline void performAction(const CodecModel::EditAction action);
@@ -85,6 +129,81 @@ private:
    CodecModel* q_ptr;
 };
 
+CodecCatalog& CodecCatalog::instance()
+{
+   static auto catalog = new CodecCatalog();
+   return *catalog;
+}
+
+const VectorUInt& CodecCatalog::codecs() const
+{
+   return m_lCodecs;
+}
+
+MapStringString CodecCatalog::details(uint id) const
+{
+   return m_hDetails.value(id);
+}
+
+/**
+ * Call "callback" once the codecs are known, right away if they already
+ * are. It is also called if loading them fails, with what was received,
+ * the next call then tries again.
+ */
+void CodecCatalog::whenLoaded(QObject* context, const std::function<void()>& callback)
+{
+   if (m_State == State::LOADED) {
+      callback();
+      return;
+   }
+
+   m_lPending << qMakePair(QPointer<QObject>(context), callback);
+
+   if (m_State == State::NONE)
+      load();
+}
+
+///Fetch all the codecs at once, without an account they have their defaults
+void CodecCatalog::load()
+{
+   m_State = State::LOADING;
+
+   AsyncRequest::call(this, []() {
+      return ConfigurationManager::instance().getCodecList();
+   }, [this](const VectorUInt& codecs) {
+      QStringList ids;
+      ids.reserve(codecs.size());
+      for (const uint id : codecs)
+         ids << QString::number(id);
+
+      AsyncRequest::collect(this, ids, [](const QString& id) {
+         return ConfigurationManager::instance().getCodecDetails(QString(), id.toInt());
+      }, [this, codecs](const QVector<MapStringString>& details) {
+         m_lCodecs = codecs;
+
+         // A failed request gives an empty reply
+         bool isComplete = !codecs.isEmpty();
+
+         for (int i = 0; i < codecs.size(); i++) {
+            m_hDetails[codecs[i]] = details[i];
+            isComplete &= !details[i].isEmpty();
+         }
+
+         // Use what was received, but the next whenLoaded() tries again
+         m_State = isComplete ? State::LOADED : State::NONE;
+
+         const auto pending = m_lPending;
+         m_lPending.clear();
+
+         // Skip the models deleted in the meantime
+         for (const auto& p : pending) {
+            if (p.first)
+               p.second();
+         }
+      });
+   });
+}
+
 #define CMP &CodecModelPrivate
 Matrix2D<CodecModel::EditState, CodecModel::EditAction,CodecModelFct> CodecModelPrivate::m_mStateMachine ={{
    /*                     SAVE         MODIFY        RELOAD        CLEAR      */
@@ -115,8 +234,9 @@ QAbstractListModel(account?(QObject*)account:(QObject*)QCoreApplication::instanc
       setObjectName("CodecModel: "+(account?account->id():"Unknown"));
 
    d_ptr->m_lMimes << RingMimes::AUDIO_CODEC << RingMimes::VIDEO_CODEC;
+
+   // READY once the codecs are loaded
    this << EditAction::RELOAD;
-   d_ptr->m_EditState = CodecModel::EditState::READY;
 }
 
 CodecModel::~CodecModel()
@@ -162,6 +282,9 @@ QVariant CodecModel::data(const QModelIndex& idx, int role) const
     if (idx.column() != 0)
         return QVariant();
 
+    if (CodecModelPrivate::isAccountRole(role))
+        d_ptr->loadDetails(d_ptr->m_lCodecs[idx.row()]);
+
     switch (role) {
         case Qt::DisplayRole:
             return QVariant(d_ptr->m_lCodecs[idx.row()]->name);
@@ -219,6 +342,10 @@ bool CodecModel::setData( const QModelIndex& idx, const QVariant &value, int rol
     if (idx.column() != 0)
         return false;
 
+    //Don't let the other account properties be saved with their defaults
+    if (CodecModelPrivate::isAccountRole(role))
+        d_ptr->loadDetails(d_ptr->m_lCodecs[idx.row()]);
+
     switch (role) {
         case CodecModel::NAME :
             d_ptr->m_lCodecs[idx.row()]->name = value.toString();
@@ -270,7 +397,7 @@ bool CodecModel::setData( const QModelIndex& idx, const QVariant &value, int rol
 QModelIndex CodecModelPrivate::add()
 {
    q_ptr->beginInsertRows(QModelIndex(), m_lCodecs.size()-1, m_lCodecs.size()-1);
-   m_lCodecs << new CodecModelPrivate::CodecData;
+   m_lCodecs << new CodecModelPrivate::CodecData();
    q_ptr->endInsertRows();
    emit q_ptr->dataChanged(q_ptr->index(m_lCodecs.size()-1,0), q_ptr->index(m_lCodecs.size()-1,0));
    q_ptr << CodecModel::EditAction::MODIFY;
@@ -312,43 +439,42 @@ void CodecModelPrivate::reload()
 {
    m_EditState = CodecModel::EditState::RELOADING;
 
-   ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
-   QVector<uint> codecIdList = configurationManager.getCodecList();
+   // The rows are added once the codecs are known
+   CodecCatalog::instance().whenLoaded(this, [this]() {
+      reloadCodecs();
+   });
+}
 
-   QVector<uint> activeCodecList = m_pAccount->isNew() ? codecIdList :
-      configurationManager.getActiveCodecList(m_pAccount->id());
+///Add or update the rows from the catalog and the account codecs
+void CodecModelPrivate::reloadCodecs()
+{
+   CodecCatalog& catalog = CodecCatalog::instance();
+   QVector<uint> codecIdList = catalog.codecs();
 
-   QStringList tmpNameList;
+   QVector<uint> activeCodecList = m_pAccount->isNew() ? codecIdList :
+      ConfigurationManager::instance().getActiveCodecList(m_pAccount->id());
 
    //TODO: the following method cannot update the order of the codecs if it
    //      changes in the daemon after it has been initially loaded in the client
 
-   // load the active codecs first to get the correct order
-   foreach (const int aCodec, activeCodecList) {
-
-      const QMap<QString,QString> codec = configurationManager.getCodecDetails(
-         m_pAccount->isNew()? QString() : m_pAccount->id(), aCodec
-      );
-
+   const auto update = [this, &catalog](uint aCodec, bool active) {
       if (!findCodec(aCodec)) {
-         const QModelIndex& idx = add();
-         q_ptr->setData(idx,QString::number(aCodec), CodecModel::Role::ID);
+         add();
+         m_lCodecs.last()->id = aCodec;
       }
 
-      // update the codec
-
-      const auto& idx = getIndexofCodecByID(aCodec);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::NAME        ] ,CodecModel::Role::NAME       );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::SAMPLE_RATE ] ,CodecModel::Role::SAMPLERATE );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::BITRATE     ] ,CodecModel::Role::BITRATE    );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MIN_BITRATE ] ,CodecModel::Role::MIN_BITRATE);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MAX_BITRATE ] ,CodecModel::Role::MAX_BITRATE);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::TYPE        ] ,CodecModel::Role::TYPE       );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::QUALITY     ] ,CodecModel::Role::QUALITY    );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MIN_QUALITY ] ,CodecModel::Role::MIN_QUALITY);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MAX_QUALITY ] ,CodecModel::Role::MAX_QUALITY);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::AUTO_QUALITY_ENABLED] ,CodecModel::Role::AUTO_QUALITY_ENABLED);
-      q_ptr->setData(idx, Qt::Checked ,Qt::CheckStateRole);
+      // The account properties are fetched when they are first used, a new
+      // account doesn't have any, it uses the defaults
+      CodecData* codec = m_lCodecs[getIndexofCodecByID(aCodec).row()];
+      fill(codec, catalog.details(aCodec));
+      codec->loaded = m_pAccount->isNew();
+
+      m_lEnabledCodecs[aCodec] = active;
+   };
+
+   // load the active codecs first to get the correct order
+   foreach (const uint aCodec, activeCodecList) {
+      update(aCodec, true);
 
       // remove from list of all codecs, since we have already updated it
       if (codecIdList.indexOf(aCodec)!=-1)
@@ -356,33 +482,60 @@ void CodecModelPrivate::reload()
    }
 
    // now add add/update remaining (inactive) codecs
-   foreach (const int aCodec, codecIdList) {
+   foreach (const uint aCodec, codecIdList)
+      update(aCodec, false);
 
-      const QMap<QString,QString> codec = configurationManager.getCodecDetails(
-         m_pAccount->isNew()? QString() : m_pAccount->id(), aCodec
-      );
+   if (m_lCodecs.size())
+      emit q_ptr->dataChanged(q_ptr->index(0,0), q_ptr->index(m_lCodecs.size()-1,0));
 
-      if (!findCodec(aCodec)) {
-         const QModelIndex& idx = add();
-         q_ptr->setData(idx,QString::number(aCodec), CodecModel::Role::ID);
-      }
+   m_EditState = CodecModel::EditState::READY;
+}
 
-      // update the codec
-      const auto& idx = getIndexofCodecByID(aCodec);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::NAME        ] ,CodecModel::Role::NAME       );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::SAMPLE_RATE ] ,CodecModel::Role::SAMPLERATE );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::BITRATE     ] ,CodecModel::Role::BITRATE    );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MIN_BITRATE ] ,CodecModel::Role::MIN_BITRATE);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MAX_BITRATE ] ,CodecModel::Role::MAX_BITRATE);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::TYPE        ] ,CodecModel::Role::TYPE       );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::QUALITY     ] ,CodecModel::Role::QUALITY    );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MIN_QUALITY ] ,CodecModel::Role::MIN_QUALITY);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MAX_QUALITY ] ,CodecModel::Role::MAX_QUALITY);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::AUTO_QUALITY_ENABLED] ,CodecModel::Role::AUTO_QUALITY_ENABLED);
-      q_ptr->setData(idx, Qt::Unchecked ,Qt::CheckStateRole);
-   }
+///Fetch the codec properties for this account, if it wasn't done yet
+void CodecModelPrivate::loadDetails(CodecData* codec)
+{
+   if (codec->loaded)
+      return;
 
-   m_EditState = CodecModel::EditState::READY;
+   codec->loaded = true;
+
+   const MapStringString details = ConfigurationManager::instance().getCodecDetails(
+      m_pAccount->isNew()? QString() : m_pAccount->id(), codec->id
+   );
+
+   fill(codec, details);
+}
+
+///Copy the daemon codec details
+void CodecModelPrivate::fill(CodecData* codec, const MapStringString& details)
+{
+   codec->name                 = details[ DRing::Account::ConfProperties::CodecInfo::NAME        ];
+   codec->samplerate           = details[ DRing::Account::ConfProperties::CodecInfo::SAMPLE_RATE ];
+   codec->bitrate              = details[ DRing::Account::ConfProperties::CodecInfo::BITRATE     ];
+   codec->min_bitrate          = details[ DRing::Account::ConfProperties::CodecInfo::MIN_BITRATE ];
+   codec->max_bitrate          = details[ DRing::Account::ConfProperties::CodecInfo::MAX_BITRATE ];
+   codec->type                 = details[ DRing::Account::ConfProperties::CodecInfo::TYPE        ];
+   codec->quality              = details[ DRing::Account::ConfProperties::CodecInfo::QUALITY     ];
+   codec->min_quality          = details[ DRing::Account::ConfProperties::CodecInfo::MIN_QUALITY ];
+   codec->max_quality          = details[ DRing::Account::ConfProperties::CodecInfo::MAX_QUALITY ];
+   codec->auto_quality_enabled = details[ DRing::Account::ConfProperties::CodecInfo::AUTO_QUALITY_ENABLED];
+}
+
+///If the role is a property an account can override
+bool CodecModelPrivate::isAccountRole(int role)
+{
+   switch (role) {
+      case CodecModel::Role::BITRATE    :
+      case CodecModel::Role::MIN_BITRATE:
+      case CodecModel::Role::MAX_BITRATE:
+      case CodecModel::Role::SAMPLERATE :
+      case CodecModel::Role::QUALITY    :
+      case CodecModel::Role::MIN_QUALITY:
+      case CodecModel::Role::MAX_QUALITY:
+      case CodecModel::Role::AUTO_QUALITY_ENABLED:
+         return true;
+   }
+   return false;
 }
 
 ///Save details
@@ -402,8 +555,11 @@ void CodecModelPrivate::save()
    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
    configurationManager.setActiveCodecList(m_pAccount->id(), _codecList);
 
-   //Update codec details
+   //Update codec details, the ones never loaded cannot have changed
    for (int i=0; i < q_ptr->rowCount();i++) {
+      if (!m_lCodecs[i]->loaded)
+         continue;
+
       const QModelIndex& idx = q_ptr->index(i,0);
       MapStringString codecDetails;
       codecDetails[ DRing::Account::ConfProperties::CodecInfo::NAME        ] = q_ptr->data(idx,CodecModel::Role::NAME).toString();
@@ -23,7 +23,7 @@
 
 CallManagerInterface & CallManager::instance(){
 
-#ifdef ENABLE_LIBWRAP
+#if defined(ENABLE_LIBWRAP) || defined(ENABLE_FAKEDAEMON)
     static auto interface = new CallManagerInterface();
 #else
     if (!dbus_metaTypeInit) registerCommTypes();
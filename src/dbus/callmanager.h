@@ -18,7 +18,9 @@
  ***************************************************************************/
 #pragma once
 
-#ifdef ENABLE_LIBWRAP
+#if defined(ENABLE_FAKEDAEMON)
+ #include "../fakedaemon/callmanager_fake.h"
+#elif defined(ENABLE_LIBWRAP)
  #include "../qtwrapper/callmanager_wrap.h"
 #else
  #include "callmanager_dbus_interface.h"
@@ -23,7 +23,7 @@
 
 ConfigurationManagerInterface& ConfigurationManager::instance()
 {
-#ifdef ENABLE_LIBWRAP
+#if defined(ENABLE_LIBWRAP) || defined(ENABLE_FAKEDAEMON)
     static auto interface = new ConfigurationManagerInterface();
 #else
     if (!dbus_metaTypeInit) registerCommTypes();
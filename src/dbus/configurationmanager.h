@@ -18,7 +18,9 @@
  ***************************************************************************/
 #pragma once
 
-#ifdef ENABLE_LIBWRAP
+#if defined(ENABLE_FAKEDAEMON)
+ #include "../fakedaemon/configurationmanager_fake.h"
+#elif defined(ENABLE_LIBWRAP)
  #include "../qtwrapper/configurationmanager_wrap.h"
 #else
  #include "configurationmanager_dbus_interface.h"
@@ -24,9 +24,13 @@
 #include "../globalinstances.h"
 #include "../interfaces/dbuserrorhandleri.h"
 
+#ifdef ENABLE_IPC_STATS
+ #include "../qtwrapper/ipcstats.h"
+#endif
+
 InstanceManagerInterface& InstanceManager::instance()
 {
-#ifdef ENABLE_LIBWRAP
+#if defined(ENABLE_LIBWRAP) || defined(ENABLE_FAKEDAEMON)
     static auto interface = new InstanceManagerInterface();
 #else
     if (!dbus_metaTypeInit) registerCommTypes();
@@ -45,6 +49,12 @@ InstanceManagerInterface& InstanceManager::instance()
         QDBusPendingReply<QString> reply = interface->Register(getpid(), "");
         registered = true;
         reply.waitForFinished();
+
+#ifdef ENABLE_IPC_STATS
+        const int dumpInterval = qgetenv("LRC_IPC_STATS_DUMP").toInt();
+        if (dumpInterval > 0)
+            IpcStats::setDumpInterval(dumpInterval);
+#endif
     }
 
     /* we do not check if the interface isValid;
@@ -18,7 +18,9 @@
  ***************************************************************************/
 #pragma once
 
-#ifdef ENABLE_LIBWRAP
+#if defined(ENABLE_FAKEDAEMON)
+ #include "../fakedaemon/instancemanager_fake.h"
+#elif defined(ENABLE_LIBWRAP)
  #include "../qtwrapper/instancemanager_wrap.h"
 #else
 #include "instance_dbus_interface.h"
@@ -25,7 +25,7 @@
 
 #include "../typedefs.h"
 
-#ifndef ENABLE_LIBWRAP
+#if !defined(ENABLE_LIBWRAP) && !defined(ENABLE_FAKEDAEMON)
 #include <QtDBus/QtDBus>
 #endif
 #pragma GCC diagnostic push
@@ -41,11 +41,11 @@ Q_DECLARE_METATYPE(VectorString)
 Q_DECLARE_METATYPE(MapStringVectorString)
 Q_DECLARE_METATYPE(VectorVectorByte)
 
-#ifndef ENABLE_LIBWRAP
+#if !defined(ENABLE_LIBWRAP) && !defined(ENABLE_FAKEDAEMON)
 static bool dbus_metaTypeInit = false;
 #endif
 inline void registerCommTypes() {
-#ifndef ENABLE_LIBWRAP
+#if !defined(ENABLE_LIBWRAP) && !defined(ENABLE_FAKEDAEMON)
    qDBusRegisterMetaType<MapStringString>               ();
    qDBusRegisterMetaType<MapStringInt>                  ();
    qDBusRegisterMetaType<VectorMapStringString>         ();
@@ -22,7 +22,7 @@
 
 PresenceManagerInterface& PresenceManager::instance()
 {
-#ifdef ENABLE_LIBWRAP
+#if defined(ENABLE_LIBWRAP) || defined(ENABLE_FAKEDAEMON)
     static auto interface = new PresenceManagerInterface();
 #else
     if (!dbus_metaTypeInit) registerCommTypes();
@@ -17,7 +17,9 @@
  ***************************************************************************/
 #pragma once
 
-#ifdef ENABLE_LIBWRAP
+#if defined(ENABLE_FAKEDAEMON)
+ #include "../fakedaemon/presencemanager_fake.h"
+#elif defined(ENABLE_LIBWRAP)
  #include "../qtwrapper/presencemanager_wrap.h"
 #else
  #include "presencemanager_dbus_interface.h"
@@ -17,7 +17,9 @@
  ***************************************************************************/
 #pragma once
 
-#ifdef ENABLE_LIBWRAP
+#if defined(ENABLE_FAKEDAEMON)
+ #include "../fakedaemon/videomanager_fake.h"
+#elif defined(ENABLE_LIBWRAP)
  #include "videomanager_wrap.h"
 #else
  #include "video_dbus_interface.h"
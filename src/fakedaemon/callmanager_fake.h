@@ -0,0 +1,259 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+//Ring
+#include "typedefs.h"
+#include "fakedaemon.h"
+
+/*
+ * Fake daemon replacement for the CallManager interface,
+ * see fakedaemon.h
+ */
+class CallManagerInterface: public QObject
+{
+   Q_OBJECT
+public:
+   CallManagerInterface()
+   {
+      connect(&FakeDaemon::instance(), &FakeDaemon::callStateChanged, this, &CallManagerInterface::callStateChanged);
+      connect(&FakeDaemon::instance(), &FakeDaemon::incomingCall, this, &CallManagerInterface::incomingCall);
+      connect(&FakeDaemon::instance(), &FakeDaemon::incomingMessage, this, &CallManagerInterface::incomingMessage);
+      connect(&FakeDaemon::instance(), &FakeDaemon::newCallCreated, this, &CallManagerInterface::newCallCreated);
+      connect(&FakeDaemon::instance(), &FakeDaemon::conferenceCreated, this, &CallManagerInterface::conferenceCreated);
+      connect(&FakeDaemon::instance(), &FakeDaemon::conferenceChanged, this, &CallManagerInterface::conferenceChanged);
+      connect(&FakeDaemon::instance(), &FakeDaemon::conferenceRemoved, this, &CallManagerInterface::conferenceRemoved);
+   }
+
+public Q_SLOTS: // METHODS
+   bool accept(const QString &callID)
+   {
+      return FakeDaemon::instance().accept(callID);
+   }
+
+   bool addMainParticipant(const QString &confID)
+   {
+      Q_UNUSED(confID)
+      return true;
+   }
+
+   bool addParticipant(const QString &callID, const QString &confID)
+   {
+      return FakeDaemon::instance().addParticipant(callID, confID);
+   }
+
+   bool attendedTransfer(const QString &transferID, const QString &targetID)
+   {
+      Q_UNUSED(transferID)
+      Q_UNUSED(targetID)
+      return false;
+   }
+
+   void createConfFromParticipantList(const QStringList &participants)
+   {
+      for (int i = 1; i < participants.size(); i++)
+         FakeDaemon::instance().joinParticipant(participants.first(), participants[i]);
+   }
+
+   bool detachParticipant(const QString &callID)
+   {
+      return FakeDaemon::instance().detachParticipant(callID);
+   }
+
+   MapStringString getCallDetails(const QString &callID)
+   {
+      return FakeDaemon::instance().callDetails(callID);
+   }
+
+   QStringList getCallList()
+   {
+      return FakeDaemon::instance().callList();
+   }
+
+   MapStringString getConferenceDetails(const QString &callID)
+   {
+      return FakeDaemon::instance().conferenceDetails(callID);
+   }
+
+   QString getConferenceId(const QString &callID)
+   {
+      return FakeDaemon::instance().conferenceId(callID);
+   }
+
+   QStringList getConferenceList()
+   {
+      return FakeDaemon::instance().conferenceList();
+   }
+
+   QStringList getDisplayNames(const QString &confID)
+   {
+      return FakeDaemon::instance().participants(confID);
+   }
+
+   bool getIsRecording(const QString &callID)
+   {
+      Q_UNUSED(callID)
+      return false;
+   }
+
+   QStringList getParticipantList(const QString &confID)
+   {
+      return FakeDaemon::instance().participants(confID);
+   }
+
+   bool hangUp(const QString &callID)
+   {
+      return FakeDaemon::instance().hangUp(callID);
+   }
+
+   bool hangUpConference(const QString &confID)
+   {
+      return FakeDaemon::instance().hangUpConference(confID);
+   }
+
+   bool hold(const QString &callID)
+   {
+      return FakeDaemon::instance().hold(callID);
+   }
+
+   bool holdConference(const QString &confID)
+   {
+      return FakeDaemon::instance().holdConference(confID, true);
+   }
+
+   bool isConferenceParticipant(const QString &callID)
+   {
+      return !FakeDaemon::instance().conferenceId(callID).isEmpty();
+   }
+
+   bool joinConference(const QString &sel_confID, const QString &drag_confID)
+   {
+      return FakeDaemon::instance().joinConference(sel_confID, drag_confID);
+   }
+
+   bool joinParticipant(const QString &sel_callID, const QString &drag_callID)
+   {
+      return FakeDaemon::instance().joinParticipant(sel_callID, drag_callID);
+   }
+
+   QString placeCall(const QString &accountID, const QString &to)
+   {
+      return FakeDaemon::instance().placeCall(accountID, to);
+   }
+
+   void playDTMF(const QString &key)
+   {
+      Q_UNUSED(key)
+   }
+
+   void recordPlaybackSeek(double value)
+   {
+      Q_UNUSED(value)
+   }
+
+   bool refuse(const QString &callID)
+   {
+      return FakeDaemon::instance().refuse(callID);
+   }
+
+   void sendTextMessage(const QString &callID, const QMap<QString,QString> &message, bool isMixed)
+   {
+      Q_UNUSED(isMixed)
+      FakeDaemon::instance().sendMessage(callID, message);
+   }
+
+   bool startRecordedFilePlayback(const QString &filepath)
+   {
+      Q_UNUSED(filepath)
+      return false;
+   }
+
+   void startTone(int start, int type)
+   {
+      Q_UNUSED(start)
+      Q_UNUSED(type)
+   }
+
+   void stopRecordedFilePlayback(const QString &filepath)
+   {
+      Q_UNUSED(filepath)
+   }
+
+   bool toggleRecording(const QString &callID)
+   {
+      Q_UNUSED(callID)
+      return false;
+   }
+
+   bool transfer(const QString &callID, const QString &to)
+   {
+      Q_UNUSED(callID)
+      Q_UNUSED(to)
+      return false;
+   }
+
+   bool unhold(const QString &callID)
+   {
+      return FakeDaemon::instance().unhold(callID);
+   }
+
+   bool unholdConference(const QString &confID)
+   {
+      return FakeDaemon::instance().holdConference(confID, false);
+   }
+
+   bool muteLocalMedia(const QString& callid, const QString& mediaType, bool mute)
+   {
+      Q_UNUSED(callid)
+      Q_UNUSED(mediaType)
+      Q_UNUSED(mute)
+      return false;
+   }
+
+Q_SIGNALS: // SIGNALS
+   void callStateChanged(const QString &callID, const QString &state, int code);
+   void transferFailed();
+   void transferSucceeded();
+   void recordPlaybackStopped(const QString &filepath);
+   void voiceMailNotify(const QString &accountID, int count);
+   void incomingMessage(const QString &callID, const QString &from, const MapStringString &message);
+   void incomingCall(const QString &accountID, const QString &callID, const QString &from);
+   void recordPlaybackFilepath(const QString &callID, const QString &filepath);
+   void conferenceCreated(const QString &confID);
+   void conferenceChanged(const QString &confID, const QString &state);
+   void updatePlaybackScale(const QString &filepath, int position, int size);
+   void conferenceRemoved(const QString &confID);
+   void newCallCreated(const QString &accountID, const QString &callID, const QString &to);
+   void recordingStateChanged(const QString &callID, bool recordingState);
+   void onRtcpReportReceived(const QString &callID, MapStringInt report);
+   void audioMuted(const QString &callID, bool state);
+   void videoMuted(const QString &callID, bool state);
+   void peerHold(const QString &callID, bool state);
+};
+namespace org {
+  namespace ring {
+    namespace Ring {
+      typedef ::CallManagerInterface CallManager;
+    }
+  }
+}
@@ -0,0 +1,523 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+//Ring
+#include "typedefs.h"
+#include "fakedaemon.h"
+
+/*
+ * Fake daemon replacement for the ConfigurationManager interface,
+ * see fakedaemon.h
+ */
+class ConfigurationManagerInterface: public QObject
+{
+   Q_OBJECT
+public:
+   ConfigurationManagerInterface()
+   {
+      connect(&FakeDaemon::instance(), &FakeDaemon::accountsChanged, this, &ConfigurationManagerInterface::accountsChanged);
+      connect(&FakeDaemon::instance(), &FakeDaemon::registrationStateChanged, this, &ConfigurationManagerInterface::registrationStateChanged);
+      connect(&FakeDaemon::instance(), &FakeDaemon::volatileAccountDetailsChanged, this, &ConfigurationManagerInterface::volatileAccountDetailsChanged);
+      connect(&FakeDaemon::instance(), &FakeDaemon::incomingAccountMessage, this, &ConfigurationManagerInterface::incomingAccountMessage);
+      connect(&FakeDaemon::instance(), &FakeDaemon::accountMessageStatusChanged, this, &ConfigurationManagerInterface::accountMessageStatusChanged);
+   }
+
+public Q_SLOTS: // METHODS
+   QString addAccount(MapStringString details)
+   {
+      return FakeDaemon::instance().addAccount(details);
+   }
+
+   MapStringString getAccountDetails(const QString& accountID)
+   {
+      return FakeDaemon::instance().accountDetails(accountID);
+   }
+
+   QStringList getAccountList()
+   {
+      return FakeDaemon::instance().accountList();
+   }
+
+   MapStringString getAccountTemplate(const QString& accountType)
+   {
+      return FakeDaemon::instance().accountTemplate(accountType);
+   }
+
+   VectorUInt getActiveCodecList(const QString& accountID)
+   {
+      Q_UNUSED(accountID)
+      return VectorUInt();
+   }
+
+   QString getAddrFromInterfaceName(const QString& interface)
+   {
+      Q_UNUSED(interface)
+      return QString();
+   }
+
+   QStringList getAllIpInterface()
+   {
+      return QStringList();
+   }
+
+   QStringList getAllIpInterfaceByName()
+   {
+      return QStringList();
+   }
+
+   MapStringString getCodecDetails(const QString& accountID, int payload)
+   {
+      Q_UNUSED(accountID)
+      Q_UNUSED(payload)
+      return MapStringString();
+   }
+
+   VectorUInt getCodecList()
+   {
+      return VectorUInt();
+   }
+
+   int getAudioInputDeviceIndex(const QString& devname)
+   {
+      Q_UNUSED(devname)
+      return 0;
+   }
+
+   QStringList getAudioInputDeviceList()
+   {
+      return QStringList();
+   }
+
+   QString getAudioManager()
+   {
+      return QString();
+   }
+
+   int getAudioOutputDeviceIndex(const QString& devname)
+   {
+      Q_UNUSED(devname)
+      return 0;
+   }
+
+   QStringList getAudioOutputDeviceList()
+   {
+      return QStringList();
+   }
+
+   QStringList getAudioPluginList()
+   {
+      return QStringList();
+   }
+
+   VectorMapStringString getCredentials(const QString& accountID)
+   {
+      Q_UNUSED(accountID)
+      return VectorMapStringString();
+   }
+
+   QStringList getCurrentAudioDevicesIndex()
+   {
+      return QStringList();
+   }
+
+   QString getCurrentAudioOutputPlugin()
+   {
+      return QString();
+   }
+
+   int getHistoryLimit()
+   {
+      return 0;
+   }
+
+   MapStringString getHookSettings()
+   {
+      return MapStringString();
+   }
+
+   bool getIsAlwaysRecording()
+   {
+      return false;
+   }
+
+   bool getNoiseSuppressState()
+   {
+      return false;
+   }
+
+   QString getRecordPath()
+   {
+      return QString();
+   }
+
+   QStringList getSupportedAudioManagers()
+   {
+      return QStringList();
+   }
+
+   MapStringString getShortcuts()
+   {
+      return MapStringString();
+   }
+
+   QStringList getSupportedTlsMethod()
+   {
+      return QStringList();
+   }
+
+   MapStringString validateCertificate(const QString& unused, const QString& certificate)
+   {
+      Q_UNUSED(unused)
+      Q_UNUSED(certificate)
+      return MapStringString();
+   }
+
+   MapStringString validateCertificatePath(const QString& unused, const QString& certificate, const QString& privateKey, const QString& privateKeyPass, const QString& caListPath)
+   {
+      Q_UNUSED(unused)
+      Q_UNUSED(certificate)
+      Q_UNUSED(privateKey)
+      Q_UNUSED(privateKeyPass)
+      Q_UNUSED(caListPath)
+      return MapStringString();
+   }
+
+   MapStringString getCertificateDetails(const QString& certificate)
+   {
+      Q_UNUSED(certificate)
+      return MapStringString();
+   }
+
+   MapStringString getCertificateDetailsPath(const QString& certificate, const QString& privateKey, const QString& privateKeyPass)
+   {
+      Q_UNUSED(certificate)
+      Q_UNUSED(privateKey)
+      Q_UNUSED(privateKeyPass)
+      return MapStringString();
+   }
+
+   QStringList getSupportedCiphers(const QString& accountID)
+   {
+      Q_UNUSED(accountID)
+      return QStringList();
+   }
+
+   MapStringString getTlsDefaultSettings()
+   {
+      return MapStringString();
+   }
+
+   double getVolume(const QString& device)
+   {
+      Q_UNUSED(device)
+      return 0;
+   }
+
+   bool isAgcEnabled()
+   {
+      return false;
+   }
+
+   bool isCaptureMuted()
+   {
+      return false;
+   }
+
+   bool isDtmfMuted()
+   {
+      return false;
+   }
+
+   bool isPlaybackMuted()
+   {
+      return false;
+   }
+
+   void muteCapture(bool mute)
+   {
+      Q_UNUSED(mute)
+   }
+
+   void muteDtmf(bool mute)
+   {
+      Q_UNUSED(mute)
+   }
+
+   void mutePlayback(bool mute)
+   {
+      Q_UNUSED(mute)
+   }
+
+   void registerAllAccounts()
+   {
+
+   }
+
+   void removeAccount(const QString& accountID)
+   {
+      FakeDaemon::instance().removeAccount(accountID);
+   }
+
+   int  exportAccounts(const QStringList& accountIDs, const QString& filePath, const QString& password)
+   {
+      Q_UNUSED(accountIDs)
+      Q_UNUSED(filePath)
+      Q_UNUSED(password)
+      return 0;
+   }
+
+   int importAccounts(const QString& filePath, const QString& password)
+   {
+      Q_UNUSED(filePath)
+      Q_UNUSED(password)
+      return 0;
+   }
+
+   void sendRegister(const QString& accountID, bool enable)
+   {
+      Q_UNUSED(accountID)
+      Q_UNUSED(enable)
+   }
+
+   void setAccountDetails(const QString& accountID, MapStringString details)
+   {
+      FakeDaemon::instance().setAccountDetails(accountID, details);
+   }
+
+   void setAccountsOrder(const QString& order)
+   {
+      Q_UNUSED(order)
+   }
+
+   void setActiveCodecList(const QString& accountID, VectorUInt &list)
+   {
+      Q_UNUSED(accountID)
+      Q_UNUSED(list)
+   }
+
+   void setAgcState(bool enabled)
+   {
+      Q_UNUSED(enabled)
+   }
+
+   void setAudioInputDevice(int index)
+   {
+      Q_UNUSED(index)
+   }
+
+   bool setAudioManager(const QString& api)
+   {
+      Q_UNUSED(api)
+      return false;
+   }
+
+   void setAudioOutputDevice(int index)
+   {
+      Q_UNUSED(index)
+   }
+
+   void setAudioPlugin(const QString& audioPlugin)
+   {
+      Q_UNUSED(audioPlugin)
+   }
+
+   void setAudioRingtoneDevice(int index)
+   {
+      Q_UNUSED(index)
+   }
+
+   void setCredentials(const QString& accountID, VectorMapStringString credentialInformation)
+   {
+      Q_UNUSED(accountID)
+      Q_UNUSED(credentialInformation)
+   }
+
+   void setHistoryLimit(int days)
+   {
+      Q_UNUSED(days)
+   }
+
+   void setHookSettings(MapStringString settings)
+   {
+      Q_UNUSED(settings)
+   }
+
+   void setIsAlwaysRecording(bool enabled)
+   {
+      Q_UNUSED(enabled)
+   }
+
+   void setNoiseSuppressState(bool state)
+   {
+      Q_UNUSED(state)
+   }
+
+   void setRecordPath(const QString& rec)
+   {
+      Q_UNUSED(rec)
+   }
+
+   void setShortcuts(MapStringString shortcutsMap)
+   {
+      Q_UNUSED(shortcutsMap)
+   }
+
+   void setVolume(const QString& device, double value)
+   {
+      Q_UNUSED(device)
+      Q_UNUSED(value)
+   }
+
+   MapStringString getVolatileAccountDetails(const QString& accountID)
+   {
+      return FakeDaemon::instance().volatileAccountDetails(accountID);
+   }
+
+   QStringList getPinnedCertificates()
+   {
+      return QStringList();
+   }
+
+   QStringList pinCertificate(const QByteArray& content, bool local)
+   {
+      Q_UNUSED(content)
+      Q_UNUSED(local)
+      return QStringList();
+   }
+
+   bool unpinCertificate(const QString& certId)
+   {
+      Q_UNUSED(certId)
+      return false;
+   }
+
+   void pinCertificatePath(const QString& certPath)
+   {
+      Q_UNUSED(certPath)
+   }
+
+   uint unpinCertificatePath(const QString& certPath)
+   {
+      Q_UNUSED(certPath)
+      return 0;
+   }
+
+   bool pinRemoteCertificate(const QString& accountId, const QString& certPath)
+   {
+      Q_UNUSED(accountId)
+      Q_UNUSED(certPath)
+      return false;
+   }
+
+   bool setCertificateStatus(const QString& accountId, const QString& certPath, const QString& status)
+   {
+      Q_UNUSED(accountId)
+      Q_UNUSED(certPath)
+      Q_UNUSED(status)
+      return false;
+   }
+
+   QStringList getCertificatesByStatus(const QString& accountId, const QString& status)
+   {
+      Q_UNUSED(accountId)
+      Q_UNUSED(status)
+      return QStringList();
+   }
+
+   MapStringString getTrustRequests(const QString& accountId)
+   {
+      Q_UNUSED(accountId)
+      return MapStringString();
+   }
+
+   bool acceptTrustRequest(const QString& accountId, const QString& from)
+   {
+      Q_UNUSED(accountId)
+      Q_UNUSED(from)
+      return false;
+   }
+
+   bool discardTrustRequest(const QString& accountId, const QString& from)
+   {
+      Q_UNUSED(accountId)
+      Q_UNUSED(from)
+      return false;
+   }
+
+   void sendTrustRequest(const QString& accountId, const QString& from, const QByteArray& payload)
+   {
+      Q_UNUSED(accountId)
+      Q_UNUSED(from)
+      Q_UNUSED(payload)
+   }
+
+   uint64_t sendTextMessage(const QString& accountId, const QString& to, const QMap<QString,QString>& payloads)
+   {
+      return FakeDaemon::instance().sendAccountMessage(accountId, to, payloads);
+   }
+
+   bool setCodecDetails(const QString& accountId, unsigned int codecId, const MapStringString& details)
+   {
+      Q_UNUSED(accountId)
+      Q_UNUSED(codecId)
+      Q_UNUSED(details)
+      return false;
+   }
+
+   int getMessageStatus(uint64_t id)
+   {
+      Q_UNUSED(id)
+      return 0;
+   }
+
+   void connectivityChanged()
+   {
+
+   }
+
+Q_SIGNALS: // SIGNALS
+   void volumeChanged(const QString& device, double value);
+   void accountsChanged();
+   void historyChanged();
+   void stunStatusFailure(const QString& reason);
+   void registrationStateChanged(const QString& accountID, const QString& registration_state, unsigned detail_code, const QString& detail_str);
+   void stunStatusSuccess(const QString& message);
+   void errorAlert(int code);
+   void volatileAccountDetailsChanged(const QString& accountID, MapStringString details);
+   void certificatePinned(const QString& certId);
+   void certificatePathPinned(const QString& path, const QStringList& certIds);
+   void certificateExpired(const QString& certId);
+   void incomingTrustRequest(const QString& accountId, const QString& from, const QByteArray& payload, qulonglong timeStamp);
+   void incomingAccountMessage(const QString& accountId, const QString& from, const MapStringString& payloads);
+   void mediaParametersChanged(const QString& accountId);
+   void audioDeviceEvent();
+   void accountMessageStatusChanged(const QString& accountId, const uint64_t id, const QString& to, int status);
+};
+namespace org {
+  namespace ring {
+    namespace Ring {
+      typedef ::ConfigurationManagerInterface ConfigurationManager;
+    }
+  }
+}
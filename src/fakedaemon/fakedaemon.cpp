@@ -0,0 +1,776 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "fakedaemon.h"
+
+//Qt
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QTimer>
+#include <QtCore/QMutexLocker>
+
+//Ring
+#include <account_const.h>
+#include <call_const.h>
+
+// Std
+#include <algorithm>
+
+namespace {
+
+///"getConferenceDetails()" and "conferenceChanged()" values
+constexpr static const char CONF_ACTIVE[] = "ACTIVE_ATTACHED";
+constexpr static const char CONF_HOLD  [] = "HOLD"           ;
+
+///"getCallDetails()" CALL_TYPE values
+constexpr static const char INCOMING[] = "0";
+constexpr static const char OUTGOING[] = "1";
+
+///Never generate more than that many events of a kind per tick
+constexpr static const int MAX_EVENTS_PER_TICK = 10000;
+
+}
+
+FakeDaemon::Scenario FakeDaemon::Scenario::fromString(const QString& description)
+{
+   Scenario ret;
+
+   for (const QString& entry : description.split(',', QString::SkipEmptyParts)) {
+      const QString key   = entry.section('=', 0, 0).trimmed();
+      const QString value = entry.section('=', 1   ).trimmed();
+
+      if      (key == QLatin1String("accounts"      )) ret.accounts       = value.toInt   ();
+      else if (key == QLatin1String("buddies"       )) ret.buddies        = value.toInt   ();
+      else if (key == QLatin1String("maxCalls"      )) ret.maxCalls       = value.toInt   ();
+      else if (key == QLatin1String("callRate"      )) ret.callRate       = value.toDouble();
+      else if (key == QLatin1String("transitionRate")) ret.transitionRate = value.toDouble();
+      else if (key == QLatin1String("conferenceRate")) ret.conferenceRate = value.toDouble();
+      else if (key == QLatin1String("presenceRate"  )) ret.presenceRate   = value.toDouble();
+      else if (key == QLatin1String("messageRate"   )) ret.messageRate    = value.toDouble();
+      else if (key == QLatin1String("seed"          )) ret.seed           = value.toUInt  ();
+      else
+         qWarning() << "Unknown fake daemon scenario key" << key;
+   }
+
+   return ret;
+}
+
+FakeDaemon::FakeDaemon() : QObject(),
+m_Scenario(Scenario::fromString(qgetenv("LRC_FAKEDAEMON"))), m_pTick(new QTimer(this))
+{
+   m_Random.seed(m_Scenario.seed);
+   createAccounts();
+
+   m_pTick->setInterval(20);
+   connect(m_pTick, &QTimer::timeout, this, &FakeDaemon::tick);
+   m_pTick->start();
+   m_Elapsed.start();
+}
+
+FakeDaemon& FakeDaemon::instance()
+{
+   static auto instance = new FakeDaemon();
+   return *instance;
+}
+
+FakeDaemon::Scenario FakeDaemon::scenario() const
+{
+   QMutexLocker l(&m_Mutex);
+   return m_Scenario;
+}
+
+/**
+ * Change the event rates. The accounts are only created once, changing
+ * their number afterward has no effect.
+ */
+void FakeDaemon::setScenario(const Scenario& s)
+{
+   QMutexLocker l(&m_Mutex);
+   m_Scenario = s;
+   m_Random.seed(s.seed);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Helpers                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+QString FakeDaemon::nextId(const char* prefix)
+{
+   return QString("%1%2").arg(prefix).arg(m_NextId++);
+}
+
+int FakeDaemon::random(int count)
+{
+   return count > 0 ? std::uniform_int_distribution<int>(0, count - 1)(m_Random) : 0;
+}
+
+/**
+ * Emit from the thread of the fake daemon once the mutex is released, the
+ * slots are free to call the interfaces back.
+ */
+void FakeDaemon::post(std::function<void()> event)
+{
+   QMutexLocker l(&m_PendingMutex);
+
+   if (m_lPending.isEmpty())
+      QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+
+   m_lPending << event;
+}
+
+void FakeDaemon::flush()
+{
+   QVector<std::function<void()>> events;
+
+   {
+      QMutexLocker l(&m_PendingMutex);
+      events.swap(m_lPending);
+   }
+
+   for (const auto& event : events)
+      event();
+}
+
+void FakeDaemon::setState(const QString& callId, const char* state)
+{
+   m_hCalls[callId].state = state;
+
+   const QString s = state;
+   post([this, callId, s]() { emit callStateChanged(callId, s, 0); });
+}
+
+///Remove a call, and its conference if it was one of the last 2 participants
+void FakeDaemon::endCall(const QString& callId)
+{
+   if (!m_hCalls.contains(callId))
+      return;
+
+   const QString confId = m_hCalls[callId].confId;
+
+   post([this, callId]() {
+      emit callStateChanged(callId, DRing::Call::StateEvent::HUNGUP, 0);
+      emit callStateChanged(callId, DRing::Call::StateEvent::OVER  , 0);
+   });
+
+   m_hCalls.remove(callId);
+   m_lCalls.removeOne(callId);
+
+   if (confId.isEmpty())
+      return;
+
+   QStringList& participants = m_hConferences[confId];
+   participants.removeOne(callId);
+
+   if (participants.size() < 2) {
+      for (const QString& p : participants)
+         m_hCalls[p].confId.clear();
+
+      m_hConferences.remove(confId);
+      post([this, confId]() { emit conferenceRemoved(confId); });
+   }
+   else
+      post([this, confId]() { emit conferenceChanged(confId, CONF_ACTIVE); });
+}
+
+void FakeDaemon::createAccounts()
+{
+   for (int i = 0; i < m_Scenario.accounts; i++) {
+      const QString id = nextId("fakeaccount");
+
+      MapStringString details = accountTemplate(DRing::Account::ProtocolNames::SIP);
+      details[ DRing::Account::ConfProperties::ALIAS       ] = QString("Fake account %1").arg(i);
+      details[ DRing::Account::ConfProperties::USERNAME    ] = QString("user%1"        ).arg(i);
+      details[ DRing::Account::ConfProperties::DISPLAYNAME ] = QString("User %1"       ).arg(i);
+
+      m_lAccounts << id;
+      m_hAccounts[id] = details;
+
+      QStringList& buddies = m_hSubscriptions[id];
+      for (int j = 0; j < m_Scenario.buddies; j++)
+         buddies << QString("sip:buddy%1@fake.invalid").arg(j);
+
+      post([this, id]() {
+         emit registrationStateChanged(id, DRing::Account::States::REGISTERED, 0, QString());
+      });
+   }
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Generators                                *
+ *                                                                           *
+ ****************************************************************************/
+
+void FakeDaemon::tick()
+{
+   const double elapsed = m_Elapsed.restart() / 1000.0;
+
+   QMutexLocker l(&m_Mutex);
+
+   static const std::array<void (FakeDaemon::*)(), enum_class_size<Generator>()> generators {{
+      /* CALL       */ &FakeDaemon::generateCall      ,
+      /* TRANSITION */ &FakeDaemon::generateTransition,
+      /* CONFERENCE */ &FakeDaemon::generateConference,
+      /* PRESENCE   */ &FakeDaemon::generatePresence  ,
+      /* MESSAGE    */ &FakeDaemon::generateMessage   ,
+   }};
+
+   const std::array<double, enum_class_size<Generator>()> rates {{
+      /* CALL       */ m_Scenario.callRate      ,
+      /* TRANSITION */ m_Scenario.transitionRate,
+      /* CONFERENCE */ m_Scenario.conferenceRate,
+      /* PRESENCE   */ m_Scenario.presenceRate  ,
+      /* MESSAGE    */ m_Scenario.messageRate   ,
+   }};
+
+   for (int i = 0; i < enum_class_size<Generator>(); i++) {
+      m_lCarry[i] += rates[i] * elapsed;
+
+      const int count = std::min(static_cast<int>(m_lCarry[i]), MAX_EVENTS_PER_TICK);
+      m_lCarry[i] -= static_cast<int>(m_lCarry[i]);
+
+      for (int j = 0; j < count; j++)
+         (this->*generators[i])();
+   }
+}
+
+void FakeDaemon::generateCall()
+{
+   if (m_lAccounts.isEmpty() || m_hCalls.size() >= m_Scenario.maxCalls)
+      return;
+
+   const QString id        = nextId("fakecall");
+   const QString accountId = m_lAccounts[random(m_lAccounts.size())];
+   const QString peer      = QString("sip:peer%1@fake.invalid").arg(random(100000));
+
+   m_hCalls[id] = {accountId, peer, DRing::Call::StateEvent::INCOMING, QString(), false,
+      QDateTime::currentMSecsSinceEpoch() / 1000};
+   m_lCalls << id;
+
+   post([this, accountId, id, peer]() { emit incomingCall(accountId, id, peer); });
+}
+
+///Move a random call to its next state, most calls eventually end
+void FakeDaemon::generateTransition()
+{
+   if (m_lCalls.isEmpty())
+      return;
+
+   const QString id    = m_lCalls[random(m_lCalls.size())];
+   const QString state = m_hCalls[id].state;
+   const int     dice  = random(10);
+
+   if (state == DRing::Call::StateEvent::CONNECTING)
+      setState(id, DRing::Call::StateEvent::RINGING);
+   else if (state == DRing::Call::StateEvent::HOLD)
+      setState(id, DRing::Call::StateEvent::CURRENT);
+   else if (state == DRing::Call::StateEvent::CURRENT && dice < 3)
+      setState(id, DRing::Call::StateEvent::HOLD);
+   else if (state == DRing::Call::StateEvent::CURRENT)
+      endCall(id);
+   else if (dice < 8) // INCOMING or RINGING, answered
+      setState(id, DRing::Call::StateEvent::CURRENT);
+   else // missed or refused
+      endCall(id);
+}
+
+///Merge two established calls, or add one to an existing conference
+void FakeDaemon::generateConference()
+{
+   QStringList candidates;
+
+   // A few random picks are enough, this doesn't have to be exhaustive
+   for (int i = 0; i < 8 && candidates.size() < 2 && !m_lCalls.isEmpty(); i++) {
+      const QString& id   = m_lCalls[random(m_lCalls.size())];
+      const FakeCall& c   = m_hCalls[id];
+
+      if ((c.state == DRing::Call::StateEvent::CURRENT || c.state == DRing::Call::StateEvent::HOLD)
+        && c.confId.isEmpty() && !candidates.contains(id))
+         candidates << id;
+   }
+
+   if (candidates.isEmpty())
+      return;
+
+   if (candidates.size() == 1 || (!m_hConferences.isEmpty() && random(2))) {
+      if (m_hConferences.isEmpty())
+         return;
+
+      const QString confId = m_hConferences.keys()[random(m_hConferences.size())];
+      m_hCalls[candidates.first()].confId = confId;
+      m_hConferences[confId] << candidates.first();
+      post([this, confId]() { emit conferenceChanged(confId, CONF_ACTIVE); });
+      return;
+   }
+
+   const QString confId = nextId("fakeconf");
+
+   for (const QString& id : candidates) {
+      m_hCalls[id].confId = confId;
+      if (m_hCalls[id].state == DRing::Call::StateEvent::HOLD)
+         setState(id, DRing::Call::StateEvent::CURRENT);
+   }
+
+   m_hConferences[confId] = candidates;
+   post([this, confId]() { emit conferenceCreated(confId); });
+}
+
+void FakeDaemon::generatePresence()
+{
+   if (m_lAccounts.isEmpty() || m_Scenario.buddies <= 0)
+      return;
+
+   const QString accountId = m_lAccounts[random(m_lAccounts.size())];
+   const QString uri       = QString("sip:buddy%1@fake.invalid").arg(random(m_Scenario.buddies));
+   const bool    status    = random(2);
+
+   post([this, accountId, uri, status]() {
+      emit newBuddyNotification(accountId, uri, status, status ? "Online" : "Offline");
+   });
+}
+
+///Half the messages are sent in a call, the other half to an account
+void FakeDaemon::generateMessage()
+{
+   MapStringString payloads;
+   payloads["text/plain"] = QString("Message %1").arg(m_NextId++);
+
+   if (!m_lCalls.isEmpty() && random(2)) {
+      const QString callId = m_lCalls[random(m_lCalls.size())];
+      const QString peer   = m_hCalls[callId].peer;
+
+      post([this, callId, peer, payloads]() { emit incomingMessage(callId, peer, payloads); });
+   }
+   else if (!m_lAccounts.isEmpty()) {
+      const QString accountId = m_lAccounts[random(m_lAccounts.size())];
+      const QString from      = QString("sip:buddy%1@fake.invalid").arg(random(std::max(1, m_Scenario.buddies)));
+
+      post([this, accountId, from, payloads]() { emit incomingAccountMessage(accountId, from, payloads); });
+   }
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   Calls                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+QString FakeDaemon::placeCall(const QString& accountId, const QString& to)
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (!m_hAccounts.contains(accountId))
+      return QString();
+
+   const QString id = nextId("fakecall");
+
+   m_hCalls[id] = {accountId, to, DRing::Call::StateEvent::CONNECTING, QString(), true,
+      QDateTime::currentMSecsSinceEpoch() / 1000};
+   m_lCalls << id;
+
+   post([this, accountId, id, to]() {
+      emit newCallCreated(accountId, id, to);
+      emit callStateChanged(id, DRing::Call::StateEvent::CONNECTING, 0);
+   });
+
+   return id;
+}
+
+bool FakeDaemon::accept(const QString& callId)
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (m_hCalls.value(callId).state != DRing::Call::StateEvent::INCOMING)
+      return false;
+
+   setState(callId, DRing::Call::StateEvent::CURRENT);
+   return true;
+}
+
+bool FakeDaemon::refuse(const QString& callId)
+{
+   return hangUp(callId);
+}
+
+bool FakeDaemon::hangUp(const QString& callId)
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (!m_hCalls.contains(callId))
+      return false;
+
+   endCall(callId);
+   return true;
+}
+
+bool FakeDaemon::hold(const QString& callId)
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (m_hCalls.value(callId).state != DRing::Call::StateEvent::CURRENT)
+      return false;
+
+   setState(callId, DRing::Call::StateEvent::HOLD);
+   return true;
+}
+
+bool FakeDaemon::unhold(const QString& callId)
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (m_hCalls.value(callId).state != DRing::Call::StateEvent::HOLD)
+      return false;
+
+   setState(callId, DRing::Call::StateEvent::CURRENT);
+   return true;
+}
+
+QStringList FakeDaemon::callList() const
+{
+   QMutexLocker l(&m_Mutex);
+   return m_lCalls;
+}
+
+MapStringString FakeDaemon::callDetails(const QString& callId) const
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (!m_hCalls.contains(callId))
+      return MapStringString();
+
+   const FakeCall& c = m_hCalls[callId];
+
+   MapStringString ret;
+   ret[ DRing::Call::Details::ACCOUNTID       ] = c.accountId;
+   ret[ DRing::Call::Details::PEER_NUMBER     ] = c.peer;
+   ret[ DRing::Call::Details::DISPLAY_NAME    ] = c.peer.section('@', 0, 0).section(':', 1);
+   ret[ DRing::Call::Details::CALL_STATE      ] = c.state;
+   ret[ DRing::Call::Details::CALL_TYPE       ] = c.outgoing ? OUTGOING : INCOMING;
+   ret[ DRing::Call::Details::CONF_ID         ] = c.confId;
+   ret[ DRing::Call::Details::TIMESTAMP_START ] = QString::number(c.start);
+
+   return ret;
+}
+
+///Messages sent to the fake peers are dropped
+void FakeDaemon::sendMessage(const QString& callId, const MapStringString& payloads)
+{
+   Q_UNUSED(callId)
+   Q_UNUSED(payloads)
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                Conferences                                *
+ *                                                                           *
+ ****************************************************************************/
+
+bool FakeDaemon::joinParticipant(const QString& callId1, const QString& callId2)
+{
+   {
+      QMutexLocker l(&m_Mutex);
+
+      if (!(m_hCalls.contains(callId1) && m_hCalls.contains(callId2)))
+         return false;
+
+      const QString conf1 = m_hCalls[callId1].confId;
+      const QString conf2 = m_hCalls[callId2].confId;
+
+      if (conf1.isEmpty() && conf2.isEmpty()) {
+         const QString confId = nextId("fakeconf");
+         m_hCalls[callId1].confId = confId;
+         m_hCalls[callId2].confId = confId;
+         m_hConferences[confId] = QStringList { callId1, callId2 };
+         post([this, confId]() { emit conferenceCreated(confId); });
+         return true;
+      }
+   }
+
+   const QString confId = conferenceId(callId1);
+
+   return confId.isEmpty() ? addParticipant(callId1, conferenceId(callId2))
+                           : addParticipant(callId2, confId);
+}
+
+bool FakeDaemon::addParticipant(const QString& callId, const QString& confId)
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (!(m_hCalls.contains(callId) && m_hConferences.contains(confId)))
+      return false;
+
+   const QString previous = m_hCalls[callId].confId;
+
+   if (previous == confId)
+      return true;
+
+   if (!previous.isEmpty())
+      m_hConferences[previous].removeOne(callId);
+
+   m_hCalls[callId].confId = confId;
+   m_hConferences[confId] << callId;
+
+   post([this, confId]() { emit conferenceChanged(confId, CONF_ACTIVE); });
+
+   return true;
+}
+
+bool FakeDaemon::joinConference(const QString& confId1, const QString& confId2)
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (confId1 == confId2 || !(m_hConferences.contains(confId1) && m_hConferences.contains(confId2)))
+      return false;
+
+   for (const QString& callId : m_hConferences[confId2])
+      m_hCalls[callId].confId = confId1;
+
+   const QStringList merged = m_hConferences.take(confId2);
+   m_hConferences[confId1] << merged;
+
+   post([this, confId1, confId2]() {
+      emit conferenceRemoved(confId2);
+      emit conferenceChanged(confId1, CONF_ACTIVE);
+   });
+
+   return true;
+}
+
+bool FakeDaemon::detachParticipant(const QString& callId)
+{
+   QMutexLocker l(&m_Mutex);
+
+   const QString confId = m_hCalls.value(callId).confId;
+
+   if (confId.isEmpty())
+      return false;
+
+   QStringList& participants = m_hConferences[confId];
+   participants.removeOne(callId);
+   m_hCalls[callId].confId.clear();
+
+   if (participants.size() < 2) {
+      for (const QString& p : participants)
+         m_hCalls[p].confId.clear();
+
+      m_hConferences.remove(confId);
+      post([this, confId]() { emit conferenceRemoved(confId); });
+   }
+   else
+      post([this, confId]() { emit conferenceChanged(confId, CONF_ACTIVE); });
+
+   return true;
+}
+
+bool FakeDaemon::hangUpConference(const QString& confId)
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (!m_hConferences.contains(confId))
+      return false;
+
+   // endCall() removes the conference with its second last participant
+   for (const QString& callId : QStringList(m_hConferences[confId]))
+      endCall(callId);
+
+   return true;
+}
+
+bool FakeDaemon::holdConference(const QString& confId, bool hold)
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (!m_hConferences.contains(confId))
+      return false;
+
+   for (const QString& callId : m_hConferences[confId])
+      setState(callId, hold ? DRing::Call::StateEvent::HOLD : DRing::Call::StateEvent::CURRENT);
+
+   post([this, confId, hold]() { emit conferenceChanged(confId, hold ? CONF_HOLD : CONF_ACTIVE); });
+
+   return true;
+}
+
+QStringList FakeDaemon::conferenceList() const
+{
+   QMutexLocker l(&m_Mutex);
+   return m_hConferences.keys();
+}
+
+QStringList FakeDaemon::participants(const QString& confId) const
+{
+   QMutexLocker l(&m_Mutex);
+   return m_hConferences.value(confId);
+}
+
+QString FakeDaemon::conferenceId(const QString& callId) const
+{
+   QMutexLocker l(&m_Mutex);
+   return m_hCalls.value(callId).confId;
+}
+
+MapStringString FakeDaemon::conferenceDetails(const QString& confId) const
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (!m_hConferences.contains(confId))
+      return MapStringString();
+
+   const QStringList& participants = m_hConferences[confId];
+   const bool onHold = !participants.isEmpty()
+      && m_hCalls.value(participants.first()).state == DRing::Call::StateEvent::HOLD;
+
+   MapStringString ret;
+   ret[ "CONFID"     ] = confId;
+   ret[ "CONF_STATE" ] = onHold ? CONF_HOLD : CONF_ACTIVE;
+
+   return ret;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Accounts                                 *
+ *                                                                           *
+ ****************************************************************************/
+
+QStringList FakeDaemon::accountList() const
+{
+   QMutexLocker l(&m_Mutex);
+   return m_lAccounts;
+}
+
+MapStringString FakeDaemon::accountTemplate(const QString& type) const
+{
+   MapStringString ret;
+   ret[ DRing::Account::ConfProperties::TYPE     ] = type;
+   ret[ DRing::Account::ConfProperties::ENABLED  ] = "true";
+   ret[ DRing::Account::ConfProperties::HOSTNAME ] = "fake.invalid";
+
+   return ret;
+}
+
+MapStringString FakeDaemon::accountDetails(const QString& accountId) const
+{
+   QMutexLocker l(&m_Mutex);
+   return m_hAccounts.value(accountId);
+}
+
+///All accounts are always registered
+MapStringString FakeDaemon::volatileAccountDetails(const QString& accountId) const
+{
+   QMutexLocker l(&m_Mutex);
+
+   MapStringString ret;
+
+   if (m_hAccounts.contains(accountId))
+      ret[DRing::Account::ConfProperties::Registration::STATUS] = DRing::Account::States::REGISTERED;
+
+   return ret;
+}
+
+QString FakeDaemon::addAccount(const MapStringString& details)
+{
+   QMutexLocker l(&m_Mutex);
+
+   const QString id = nextId("fakeaccount");
+
+   m_lAccounts << id;
+   m_hAccounts[id] = details;
+
+   post([this, id]() {
+      emit accountsChanged();
+      emit registrationStateChanged(id, DRing::Account::States::REGISTERED, 0, QString());
+   });
+
+   return id;
+}
+
+void FakeDaemon::setAccountDetails(const QString& accountId, const MapStringString& details)
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (!m_hAccounts.contains(accountId))
+      return;
+
+   m_hAccounts[accountId] = details;
+   post([this]() { emit accountsChanged(); });
+}
+
+void FakeDaemon::removeAccount(const QString& accountId)
+{
+   QMutexLocker l(&m_Mutex);
+
+   if (!m_hAccounts.remove(accountId))
+      return;
+
+   m_lAccounts.removeOne(accountId);
+   m_hSubscriptions.remove(accountId);
+   post([this]() { emit accountsChanged(); });
+}
+
+///The messages are always delivered
+uint64_t FakeDaemon::sendAccountMessage(const QString& accountId, const QString& to, const MapStringString& payloads)
+{
+   Q_UNUSED(payloads)
+
+   QMutexLocker l(&m_Mutex);
+
+   const uint64_t id = m_NextId++;
+
+   post([this, accountId, id, to]() {
+      emit accountMessageStatusChanged(accountId, id, to, static_cast<int>(DRing::Account::MessageStates::SENT));
+   });
+
+   return id;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Presence                                 *
+ *                                                                           *
+ ****************************************************************************/
+
+void FakeDaemon::subscribeBuddy(const QString& accountId, const QString& uri, bool flag)
+{
+   QMutexLocker l(&m_Mutex);
+
+   QStringList& buddies = m_hSubscriptions[accountId];
+
+   if (flag && !buddies.contains(uri))
+      buddies << uri;
+   else if (!flag)
+      buddies.removeOne(uri);
+
+   post([this, accountId, uri, flag]() { emit subscriptionStateChanged(accountId, uri, flag); });
+}
+
+VectorMapStringString FakeDaemon::subscriptions(const QString& accountId) const
+{
+   QMutexLocker l(&m_Mutex);
+
+   VectorMapStringString ret;
+
+   for (const QString& uri : m_hSubscriptions.value(accountId)) {
+      MapStringString s;
+      s["Buddy"] = uri;
+      ret << s;
+   }
+
+   return ret;
+}
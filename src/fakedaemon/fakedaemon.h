@@ -0,0 +1,205 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+#include <QtCore/QElapsedTimer>
+
+//Ring
+#include <typedefs.h>
+
+// Std
+#include <array>
+#include <functional>
+#include <random>
+
+class QTimer;
+
+#ifndef Q_NOREPLY
+ #define Q_NOREPLY
+#endif
+
+/**
+ * An in-process replacement for the daemon.
+ *
+ * When the library is built with ENABLE_FAKEDAEMON, the CallManager,
+ * ConfigurationManager, PresenceManager, VideoManager and InstanceManager
+ * interfaces forward to this object instead of dring. It keeps a plausible
+ * state (accounts, calls, conferences and subscriptions) and generates
+ * events at the rates of its Scenario, so the models can be profiled at
+ * scale without a daemon or a network.
+ *
+ * The scenario is read from the LRC_FAKEDAEMON environment variable, a
+ * comma separated list of key=value using the Scenario field names. For
+ * example:
+ *
+ * @code
+ * LRC_FAKEDAEMON="accounts=10,maxCalls=5000,callRate=200,transitionRate=500"
+ * @endcode
+ *
+ * Like the daemon, the events are delivered asynchronously and the methods
+ * can be called from any thread.
+ */
+class FakeDaemon final : public QObject
+{
+   Q_OBJECT
+public:
+
+   ///What to simulate, the rates are in events per second
+   struct Scenario {
+      int    accounts       {   3 };
+      int    buddies        { 100 }; /*!< Presence subscriptions per account  */
+      int    maxCalls       { 100 }; /*!< No new incoming call past this      */
+      double callRate       {   0 }; /*!< Incoming calls                      */
+      double transitionRate {   0 }; /*!< Call state changes                  */
+      double conferenceRate {   0 }; /*!< Two calls merged into a conference  */
+      double presenceRate   {   0 }; /*!< Buddy presence notifications        */
+      double messageRate    {   0 }; /*!< Incoming call and account messages  */
+      uint   seed           {   0 }; /*!< Same seed, same sequence of events  */
+
+      static Scenario fromString(const QString& description);
+   };
+
+   static FakeDaemon& instance();
+
+   //Getters
+   Scenario scenario() const;
+
+   //Setters
+   void setScenario(const Scenario& s);
+
+   //Calls
+   QString         placeCall   (const QString& accountId, const QString& to);
+   bool            accept      (const QString& callId);
+   bool            refuse      (const QString& callId);
+   bool            hangUp      (const QString& callId);
+   bool            hold        (const QString& callId);
+   bool            unhold      (const QString& callId);
+   QStringList     callList    () const;
+   MapStringString callDetails (const QString& callId) const;
+   void            sendMessage (const QString& callId, const MapStringString& payloads);
+
+   //Conferences
+   bool            joinParticipant   (const QString& callId1, const QString& callId2);
+   bool            addParticipant    (const QString& callId , const QString& confId );
+   bool            joinConference    (const QString& confId1, const QString& confId2);
+   bool            detachParticipant (const QString& callId);
+   bool            hangUpConference  (const QString& confId);
+   bool            holdConference    (const QString& confId, bool hold);
+   QStringList     conferenceList    () const;
+   QStringList     participants      (const QString& confId) const;
+   QString         conferenceId      (const QString& callId) const;
+   MapStringString conferenceDetails (const QString& confId) const;
+
+   //Accounts
+   QStringList     accountList           () const;
+   MapStringString accountTemplate       (const QString& type) const;
+   MapStringString accountDetails        (const QString& accountId) const;
+   MapStringString volatileAccountDetails(const QString& accountId) const;
+   QString         addAccount            (const MapStringString& details);
+   void            setAccountDetails     (const QString& accountId, const MapStringString& details);
+   void            removeAccount         (const QString& accountId);
+   uint64_t        sendAccountMessage    (const QString& accountId, const QString& to, const MapStringString& payloads);
+
+   //Presence
+   void                  subscribeBuddy(const QString& accountId, const QString& uri, bool flag);
+   VectorMapStringString subscriptions (const QString& accountId) const;
+
+private:
+   explicit FakeDaemon();
+
+   struct FakeCall {
+      QString accountId;
+      QString peer     ;
+      QString state    ;
+      QString confId   ;
+      bool    outgoing ;
+      qint64  start    ;
+   };
+
+   enum class Generator {
+      CALL       ,
+      TRANSITION ,
+      CONFERENCE ,
+      PRESENCE   ,
+      MESSAGE    ,
+      COUNT__
+   };
+
+   //Attributes
+   mutable QMutex                 m_Mutex         ;
+   Scenario                       m_Scenario      ;
+   QStringList                    m_lAccounts     ;
+   QHash<QString,MapStringString> m_hAccounts     ;
+   QHash<QString,FakeCall>        m_hCalls        ;
+   QStringList                    m_lCalls        ; // for random picks
+   QHash<QString,QStringList>     m_hConferences  ;
+   QHash<QString,QStringList>     m_hSubscriptions;
+   quint64                        m_NextId        {1};
+   std::mt19937                   m_Random        ;
+   QTimer*                        m_pTick         ;
+   QMutex                         m_PendingMutex  ;
+   QVector<std::function<void()>> m_lPending      ;
+   QElapsedTimer                  m_Elapsed       ;
+   std::array<double, enum_class_size<Generator>()> m_lCarry {{}};
+
+   //Helpers
+   QString nextId     (const char* prefix);
+   int     random     (int count);
+   void    post       (std::function<void()> event);
+   void    setState   (const QString& callId, const char* state);
+   void    endCall    (const QString& callId);
+   void    createAccounts();
+
+   //Generators, called with the mutex held
+   void generateCall      ();
+   void generateTransition();
+   void generateConference();
+   void generatePresence  ();
+   void generateMessage   ();
+
+private Q_SLOTS:
+   void tick ();
+   void flush();
+
+Q_SIGNALS:
+   //CallManager
+   void callStateChanged  (const QString &callID, const QString &state, int code);
+   void incomingCall      (const QString &accountID, const QString &callID, const QString &from);
+   void incomingMessage   (const QString &callID, const QString &from, const MapStringString &message);
+   void newCallCreated    (const QString &accountID, const QString &callID, const QString &to);
+   void conferenceCreated (const QString &confID);
+   void conferenceChanged (const QString &confID, const QString &state);
+   void conferenceRemoved (const QString &confID);
+
+   //ConfigurationManager
+   void accountsChanged              ();
+   void registrationStateChanged     (const QString& accountID, const QString& registration_state, unsigned detail_code, const QString& detail_str);
+   void volatileAccountDetailsChanged(const QString& accountID, MapStringString details);
+   void incomingAccountMessage       (const QString& accountId, const QString& from, const MapStringString& payloads);
+   void accountMessageStatusChanged  (const QString& accountId, const uint64_t id, const QString& to, int status);
+
+   //PresenceManager
+   void newBuddyNotification    (const QString &accountID, const QString &buddyUri, bool status, const QString &lineStatus);
+   void subscriptionStateChanged(const QString &accountID, const QString &buddyUri, bool state);
+};
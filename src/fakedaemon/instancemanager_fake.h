@@ -0,0 +1,62 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+//Ring
+#include "typedefs.h"
+#include "fakedaemon.h"
+
+/*
+ * Fake daemon replacement for the InstanceManager interface,
+ * see fakedaemon.h
+ */
+class InstanceManagerInterface: public QObject
+{
+   Q_OBJECT
+public:
+   InstanceManagerInterface() {}
+
+   bool isConnected() { return true; }
+
+public Q_SLOTS: // METHODS
+   void Register(int pid, const QString &name)
+   {
+      Q_UNUSED(pid)
+      Q_UNUSED(name)
+   }
+
+   void Unregister(int pid)
+   {
+      Q_UNUSED(pid)
+   }
+
+Q_SIGNALS: // SIGNALS
+   void started();
+};
+namespace cx {
+  namespace Ring {
+    namespace Ring {
+      typedef ::InstanceManagerInterface Instance;
+    }
+  }
+}
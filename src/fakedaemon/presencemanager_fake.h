@@ -0,0 +1,85 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+//Ring
+#include "typedefs.h"
+#include "fakedaemon.h"
+
+/*
+ * Fake daemon replacement for the PresenceManager interface,
+ * see fakedaemon.h
+ */
+class PresenceManagerInterface: public QObject
+{
+   Q_OBJECT
+public:
+   PresenceManagerInterface()
+   {
+      connect(&FakeDaemon::instance(), &FakeDaemon::newBuddyNotification, this, &PresenceManagerInterface::newBuddyNotification);
+      connect(&FakeDaemon::instance(), &FakeDaemon::subscriptionStateChanged, this, &PresenceManagerInterface::subscriptionStateChanged);
+   }
+
+public Q_SLOTS: // METHODS
+   void answerServerRequest(const QString &uri, bool flag)
+   {
+      Q_UNUSED(uri)
+      Q_UNUSED(flag)
+   }
+
+   VectorMapStringString getSubscriptions(const QString &accountID)
+   {
+      return FakeDaemon::instance().subscriptions(accountID);
+   }
+
+   void publish(const QString &accountID, bool status, const QString &note)
+   {
+      Q_UNUSED(accountID)
+      Q_UNUSED(status)
+      Q_UNUSED(note)
+   }
+
+   void setSubscriptions(const QString &accountID, const QStringList &uriList)
+   {
+      for (const QString& uri : uriList)
+         FakeDaemon::instance().subscribeBuddy(accountID, uri, true);
+   }
+
+   void subscribeBuddy(const QString &accountID, const QString &uri, bool flag)
+   {
+      FakeDaemon::instance().subscribeBuddy(accountID, uri, flag);
+   }
+
+Q_SIGNALS: // SIGNALS
+   void newServerSubscriptionRequest(const QString &buddyUri);
+   void serverError(const QString &accountID, const QString &error, const QString &msg);
+   void newBuddyNotification(const QString &accountID, const QString &buddyUri, bool status, const QString &lineStatus);
+   void subscriptionStateChanged(const QString &accountID, const QString &buddyUri, bool state);
+};
+namespace org {
+  namespace ring {
+    namespace Ring {
+      typedef ::PresenceManagerInterface PresenceManager;
+    }
+  }
+}
@@ -0,0 +1,105 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+//Ring
+#include "typedefs.h"
+#include "fakedaemon.h"
+
+/*
+ * Fake daemon replacement for the VideoManager interface,
+ * see fakedaemon.h
+ */
+class VideoManagerInterface: public QObject
+{
+   Q_OBJECT
+public:
+   VideoManagerInterface() {}
+
+public Q_SLOTS: // METHODS
+   void applySettings(const QString &name, MapStringString settings)
+   {
+      Q_UNUSED(name)
+      Q_UNUSED(settings)
+   }
+
+   MapStringMapStringVectorString getCapabilities(const QString &name)
+   {
+      Q_UNUSED(name)
+      return MapStringMapStringVectorString();
+   }
+
+   QString getDefaultDevice()
+   {
+      return QString();
+   }
+
+   QStringList getDeviceList()
+   {
+      return QStringList();
+   }
+
+   MapStringString getSettings(const QString &device)
+   {
+      Q_UNUSED(device)
+      return MapStringString();
+   }
+
+   bool hasCameraStarted()
+   {
+      return false;
+   }
+
+   void setDefaultDevice(const QString &name)
+   {
+      Q_UNUSED(name)
+   }
+
+   void startCamera()
+   {
+
+   }
+
+   void stopCamera()
+   {
+
+   }
+
+   bool switchInput(const QString &resource)
+   {
+      Q_UNUSED(resource)
+      return false;
+   }
+
+Q_SIGNALS: // SIGNALS
+   void deviceEvent();
+   void startedDecoding(const QString &id, const QString &shmPath, int width, int height, bool isMixer);
+   void stoppedDecoding(const QString &id, const QString &shmPath, bool isMixer);
+};
+namespace org {
+  namespace ring {
+    namespace Ring {
+      typedef ::VideoManagerInterface VideoManager;
+    }
+  }
+}
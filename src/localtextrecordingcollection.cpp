@@ -18,9 +18,15 @@
 #include "localtextrecordingcollection.h"
 
 //Qt
+#include <QtCore/QCoreApplication>
 #include <QtCore/QDir>
+#include <QtCore/QDateTime>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSet>
 #include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
+#include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 
@@ -34,6 +40,34 @@
 #include <private/contactmethod_p.h>
 #include <media/media.h>
 
+static const char* extension(LocalTextRecordingCollection::Format format)
+{
+   return format == LocalTextRecordingCollection::Format::BINARY ? ".bin" : ".json";
+}
+
+///The index has no extension so it is never mistaken for a conversation
+static const char indexFileName[] = "index";
+
+///Time between a change and writing the index to disk, in milliseconds
+static constexpr const int INDEX_SAVE_DELAY = 5000;
+
+static Media::TextRecording* parse(const QByteArray& content, LocalTextRecordingCollection::Format format,
+                                   const ContactMethod* cm, CollectionInterface* backend)
+{
+   if (format == LocalTextRecordingCollection::Format::BINARY)
+      return Media::TextRecording::fromBinary({content}, cm, backend);
+
+   QJsonParseError err;
+   QJsonDocument loadDoc = QJsonDocument::fromJson(content, &err);
+
+   if (err.error != QJsonParseError::ParseError::NoError) {
+      qWarning() << "Error Decoding Text Message History Json" << err.errorString();
+      return nullptr;
+   }
+
+   return Media::TextRecording::fromJson({loadDoc.object()}, cm, backend);
+}
+
 /*
  * This collection store and load the instant messaging conversations. Lets call
  * them "imc" for this section. An imc is a graph of one or more groups. Groups
@@ -44,18 +78,40 @@
  *
  * If more than 1 peer is part of the conversation, then their hash are
  * concatenated then hashed in sha1 again.
+ *
+ * The files can also be stored in a binary format (.bin), it contains the same
+ * data as the json.
+ *
+ * The "index" file keeps, for each file, its modification time, size, peers
+ * and unread message count. A conversation with a single peer that didn't
+ * change since it was indexed isn't parsed at startup, its ContactMethod is
+ * recovered from the index and its unread messages are counted from it until
+ * it is fetched.
  */
 
 class LocalTextRecordingEditor final : public CollectionEditor<Media::Recording>
 {
 public:
-   LocalTextRecordingEditor(CollectionMediator<Media::Recording>* m) : CollectionEditor<Media::Recording>(m) {}
+   LocalTextRecordingEditor(CollectionMediator<Media::Recording>* m);
    virtual bool save       ( const Media::Recording* item ) override;
    virtual bool remove     ( const Media::Recording* item ) override;
    virtual bool edit       ( Media::Recording*       item ) override;
    virtual bool addNew     ( Media::Recording*       item ) override;
    virtual bool addExisting( const Media::Recording* item ) override;
-   QString fetch(const QByteArray& sha1);
+   QByteArray fetch(const QByteArray& sha1, LocalTextRecordingCollection::Format& format);
+
+   //Index
+   void loadIndex         ();
+   void saveIndex         ();
+   void scheduleIndexSave ();
+   void updateIndex(const QString& path, const Serializable::Peers* p);
+   void updateIndex(const QString& path, const Media::TextRecording* r);
+
+   //Attributes
+   LocalTextRecordingCollection::Format m_Format {LocalTextRecordingCollection::Format::JSON};
+   QJsonObject           m_Index        ; ///File name -> modified, size, unread, lastUsed and peers
+   QHash<QByteArray,int> m_hPendingUnread; ///Unread count of the indexed conversations not parsed yet
+   QTimer                m_IndexTimer   ; ///Pending index save, see scheduleIndexSave()
 
 private:
    virtual QVector<Media::Recording*> items() const override;
@@ -63,6 +119,22 @@ private:
    QVector<Media::Recording*> m_lNumbers;
 };
 
+LocalTextRecordingEditor::LocalTextRecordingEditor(CollectionMediator<Media::Recording>* m) :
+   CollectionEditor<Media::Recording>(m)
+{
+   m_IndexTimer.setSingleShot(true);
+   m_IndexTimer.setInterval(INDEX_SAVE_DELAY);
+   QObject::connect(&m_IndexTimer, &QTimer::timeout, [this]() { saveIndex(); });
+
+   // Don't lose the last changes
+   if (QCoreApplication::instance()) {
+      QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, &m_IndexTimer, [this]() {
+         if (m_IndexTimer.isActive())
+            saveIndex();
+      });
+   }
+}
+
 LocalTextRecordingCollection::LocalTextRecordingCollection(CollectionMediator<Media::Recording>* mediator) :
    CollectionInterface(new LocalTextRecordingEditor(mediator))
 {
@@ -83,7 +155,10 @@ LocalTextRecordingCollection& LocalTextRecordingCollection::instance()
 bool LocalTextRecordingEditor::save(const Media::Recording* recording)
 {
    Q_UNUSED(recording)
-   QHash<QByteArray,QByteArray> ret = static_cast<const Media::TextRecording*>(recording)->d_ptr->toJsons();
+   const bool isBinary = m_Format == LocalTextRecordingCollection::Format::BINARY;
+   const auto d = static_cast<const Media::TextRecording*>(recording)->d_ptr;
+
+   QHash<QByteArray,QByteArray> ret = isBinary ? d->toBinaries() : d->toJsons();
 
    QDir dir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
 
@@ -92,17 +167,40 @@ bool LocalTextRecordingEditor::save(const Media::Recording* recording)
 
    //Save each file
    for (QHash<QByteArray,QByteArray>::const_iterator i = ret.begin(); i != ret.end(); ++i) {
-      QFile file(QString("%1/text/%2.json").arg(dir.path()).arg(QString(i.key())));
+      const QString base = QString("%1/text/%2").arg(dir.path()).arg(QString(i.key()));
+
+      QFile file(base + extension(m_Format));
 
-      if ( file.open(QIODevice::WriteOnly | QIODevice::Text) ) {
+      if (isBinary) {
+         if (file.open(QIODevice::WriteOnly)) {
+            file.write(i.value());
+            file.close();
+         }
+      }
+      else if ( file.open(QIODevice::WriteOnly | QIODevice::Text) ) {
          QTextStream streamFileOut(&file);
          streamFileOut.setCodec("UTF-8");
          streamFileOut << i.value();
          streamFileOut.flush();
          file.close();
       }
+
+      //Don't leave a stale copy in the other format behind
+      if (file.error() == QFileDevice::NoError) {
+         const QString other = base + extension(isBinary ?
+            LocalTextRecordingCollection::Format::JSON : LocalTextRecordingCollection::Format::BINARY
+         );
+         QFile::remove(other);
+         m_Index.remove(QFileInfo(other).fileName());
+      }
    }
 
+   //Keep the index in sync so the next startup doesn't have to parse the files
+   for (const Serializable::Peers* p : d->m_lAssociatedPeers) {
+      updateIndex(QString("%1/text/%2%3").arg(dir.path()).arg(p->sha1s[0]).arg(extension(m_Format)), p);
+   }
+   scheduleIndexSave();
+
    return true;
 }
 
@@ -133,15 +231,114 @@ bool LocalTextRecordingEditor::addExisting(const Media::Recording* item)
    return false;
 }
 
-QString LocalTextRecordingEditor::fetch(const QByteArray& sha1)
+QByteArray LocalTextRecordingEditor::fetch(const QByteArray& sha1, LocalTextRecordingCollection::Format& format)
+{
+   const QString base = QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/text/" + sha1;
+
+   for (const auto f : {LocalTextRecordingCollection::Format::BINARY, LocalTextRecordingCollection::Format::JSON}) {
+      QFile file(base + extension(f));
+
+      if (file.open(QIODevice::ReadOnly)) {
+         format = f;
+         return file.readAll();
+      }
+   }
+
+   return QByteArray();
+}
+
+void LocalTextRecordingEditor::loadIndex()
+{
+   QFile file(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/text/" + indexFileName);
+
+   if (!file.open(QIODevice::ReadOnly))
+      return;
+
+   QJsonParseError err;
+   const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &err);
+
+   if (err.error != QJsonParseError::ParseError::NoError) {
+      qWarning() << "Error Decoding Text Message Index Json" << err.errorString();
+      return;
+   }
+
+   m_Index = doc.object();
+}
+
+/**
+ * Write the index later, along with the next changes.
+ *
+ * Each new message saves its conversation, the index is written at most
+ * once every INDEX_SAVE_DELAY and when the application quits. If it is
+ * lost, the files saved since it was written are parsed at startup.
+ */
+void LocalTextRecordingEditor::scheduleIndexSave()
+{
+   if (!m_IndexTimer.isActive())
+      m_IndexTimer.start();
+}
+
+void LocalTextRecordingEditor::saveIndex()
+{
+   m_IndexTimer.stop();
+
+   QFile file(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/text/" + indexFileName);
+
+   if (!file.open(QIODevice::WriteOnly)) {
+      qWarning() << "Could not save the text recording index";
+      return;
+   }
+
+   file.write(QJsonDocument(m_Index).toJson(QJsonDocument::Compact));
+}
+
+///Index the file at `path`, which contains `p`
+void LocalTextRecordingEditor::updateIndex(const QString& path, const Serializable::Peers* p)
 {
-   QFile file(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/text/" + sha1 + ".json");
+   const QFileInfo info(path);
 
-   if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-      return QByteArray();
+   if (!info.exists()) {
+      m_Index.remove(info.fileName());
+      return;
+   }
+
+   int    unread   = 0;
+   time_t lastUsed = 0;
+   for (const Serializable::Group* g : p->groups) {
+      for (const Serializable::Message* m : g->messages) {
+         if (m->m_HasText && !m->isRead)
+            unread++;
+
+         if (lastUsed < m->timestamp)
+            lastUsed = m->timestamp;
+      }
    }
 
-   return QString::fromUtf8(file.readAll());
+   QJsonArray peers;
+   for (const Serializable::Peer* peer : p->peers) {
+      QJsonObject o;
+      peer->write(o);
+      peers.append(o);
+   }
+
+   QJsonObject entry;
+   entry["modified"] = static_cast<double>(info.lastModified().toMSecsSinceEpoch());
+   entry["size"    ] = static_cast<double>(info.size()                          );
+   entry["unread"  ] = unread                                                  ;
+   entry["lastUsed"] = static_cast<double>(lastUsed                            );
+   entry["peers"   ] = peers                                                   ;
+
+   m_Index[info.fileName()] = entry;
+}
+
+///Index the file at `path`, parsed into `r`
+void LocalTextRecordingEditor::updateIndex(const QString& path, const Media::TextRecording* r)
+{
+   //A file is parsed into a single Peers
+   if (r->d_ptr->m_lAssociatedPeers.size() == 1)
+      updateIndex(path, r->d_ptr->m_lAssociatedPeers.first());
+   else
+      m_Index.remove(QFileInfo(path).fileName());
 }
 
 QVector<Media::Recording*> LocalTextRecordingEditor::items() const
@@ -169,53 +366,109 @@ bool LocalTextRecordingCollection::isEnabled() const
    return true;
 }
 
+/**
+ * Return the ContactMethod of a conversation that can be recovered from its
+ * index entry without parsing the file, or nullptr if the file has to be parsed.
+ */
+static ContactMethod* indexedContactMethod(const QFileInfo& fileInfo, const QJsonObject& entry)
+{
+   if (entry.isEmpty())
+      return nullptr;
+
+   //The file changed since it was indexed
+   if (static_cast<qint64>(entry["modified"].toDouble()) != fileInfo.lastModified().toMSecsSinceEpoch()
+    || static_cast<qint64>(entry["size"    ].toDouble()) != fileInfo.size())
+      return nullptr;
+
+   const QJsonArray peers = entry["peers"].toArray();
+
+   if (peers.size() != 1)
+      return nullptr;
+
+   Serializable::Peer peer;
+   peer.read(peers.first().toObject());
+
+   ContactMethod* cm = peer.m_pContactMethod;
+
+   //fetchFor() looks the file up using the ContactMethod hash
+   if ((!cm) || cm->sha1() != fileInfo.completeBaseName().toLatin1())
+      return nullptr;
+
+   return cm;
+}
+
 bool LocalTextRecordingCollection::load()
 {
+    LocalTextRecordingEditor* e = static_cast<LocalTextRecordingEditor*>(editor<Media::Recording>());
+    e->loadIndex();
+    const QJsonObject previousIndex = e->m_Index;
+
     // load all text recordings so we can recover CMs that are not in the call history
     QDir dir(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/text/");
     if (dir.exists()) {
-        // get .json files, sorted by time, latest first
+        // get .json and .bin files, sorted by time, latest first
         QStringList filters;
-        filters << "*.json";
+        filters << "*.json" << "*.bin";
         auto list = dir.entryInfoList(filters, QDir::Files | QDir::NoSymLinks | QDir::Readable, QDir::Time);
 
+        QSet<QString> fileNames;
+
         for (int i = 0; i < list.size(); ++i) {
             QFileInfo fileInfo = list.at(i);
+            fileNames << fileInfo.fileName();
+
+            // the conversation will be parsed when it is fetched, until then its unread messages
+            // are counted from the index. If a newer conversation was already associated with the
+            // CM, parse it like before.
+            const QJsonObject entry = e->m_Index.value(fileInfo.fileName()).toObject();
+            ContactMethod* indexedCM = indexedContactMethod(fileInfo, entry);
+            if (indexedCM && !indexedCM->d_ptr->m_pTextRecording) {
+                e->m_hPendingUnread[indexedCM->sha1()] = entry["unread"].toInt();
+                indexedCM->setLastUsed(static_cast<time_t>(entry["lastUsed"].toDouble()));
+                continue;
+            }
+
+            const Format format = fileInfo.suffix() == QLatin1String("bin") ? Format::BINARY : Format::JSON;
 
-            QString content;
+            // the json parser and binary reader both want the raw bytes
+            QByteArray content;
             QFile file(fileInfo.absoluteFilePath());
-            if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-                content = QString::fromUtf8(file.readAll());
+            if (file.open(QIODevice::ReadOnly)) {
+                content = file.readAll();
             } else {
-                qWarning() << "Could not open text recording json file";
+                qWarning() << "Could not open text recording file";
             }
 
             if (!content.isEmpty()) {
-                QJsonParseError err;
-                QJsonDocument loadDoc = QJsonDocument::fromJson(content.toUtf8(), &err);
-
-                if (err.error == QJsonParseError::ParseError::NoError) {
-                    Media::TextRecording* r = Media::TextRecording::fromJson({loadDoc.object()}, nullptr, this);
+                if (Media::TextRecording* r = parse(content, format, nullptr, this)) {
 
                     editor<Media::Recording>()->addExisting(r);
+                    e->updateIndex(fileInfo.absoluteFilePath(), r);
 
                     // get CMs from recording
                     for (ContactMethod *cm : r->peers()) {
                         // since we load the recordings in order from newest to oldest, if there is
                         // more than one found associated with a CM, we take the newest one
-                        if (!cm->d_ptr->m_pTextRecording) {
+                        if (!cm->d_ptr->m_pTextRecording && !e->m_hPendingUnread.contains(cm->sha1())) {
                             cm->d_ptr->setTextRecording(r);
                         } else {
                             qWarning() << "CM already has text recording" << cm;
                         }
                     }
-                } else {
-                    qWarning() << "Error Decoding Text Message History Json" << err.errorString();
                 }
             } else {
                 qWarning() << "Text recording file is empty";
             }
         }
+
+        // forget the files that were removed
+        for (const QString& name : e->m_Index.keys()) {
+            if (!fileNames.contains(name))
+                e->m_Index.remove(name);
+        }
+
+        if (e->m_Index != previousIndex)
+            e->saveIndex();
     }
 
     // always return true, even if noting was loaded, since the collection can still be used to
@@ -260,7 +513,7 @@ bool LocalTextRecordingCollection::listId(std::function<void(const QList<Element
    if (!dir.exists())
       return false;
 
-   for (const QString& str : dir.entryList({"*.json"}) ) {
+   for (const QString& str : dir.entryList({"*.json","*.bin"}) ) {
       list << str.toLatin1();
    }
 
@@ -288,26 +541,59 @@ bool LocalTextRecordingCollection::fetch( const QList<CollectionInterface::Eleme
 Media::TextRecording* LocalTextRecordingCollection::fetchFor(const ContactMethod* cm)
 {
    const QByteArray& sha1 = cm->sha1();
-   const QString content = static_cast<LocalTextRecordingEditor*>(editor<Media::Recording>())->fetch(sha1);
+
+   Format format;
+   const QByteArray content = static_cast<LocalTextRecordingEditor*>(editor<Media::Recording>())->fetch(sha1, format);
 
    if (content.isEmpty())
       return nullptr;
 
-   QJsonParseError err;
-   QJsonDocument loadDoc = QJsonDocument::fromJson(content.toUtf8(), &err);
+   Media::TextRecording* r = parse(content, format, cm, this);
 
-   if (err.error != QJsonParseError::ParseError::NoError) {
-       qWarning() << "Error Decoding Text Message History Json" << err.errorString();
-       return nullptr;
-   }
+   if (!r)
+      return nullptr;
+
+   auto e = static_cast<LocalTextRecordingEditor*>(editor<Media::Recording>());
 
-   Media::TextRecording* r = Media::TextRecording::fromJson({loadDoc.object()}, cm, this);
+   // addExisting() counts the unread messages again, stop counting them from the index
+   const int indexedUnread = e->m_hPendingUnread.take(sha1);
 
-   editor<Media::Recording>()->addExisting(r);
+   e->addExisting(r);
+
+   if (indexedUnread)
+      emit r->unreadCountChange(-indexedUnread);
 
    return r;
 }
 
+/**
+ * The number of unread messages in the conversations counted from the index
+ * that were not fetched yet.
+ */
+int LocalTextRecordingCollection::unreadCount() const
+{
+   int count = 0;
+
+   for (const int unread : static_cast<LocalTextRecordingEditor*>(editor<Media::Recording>())->m_hPendingUnread)
+      count += unread;
+
+   return count;
+}
+
+LocalTextRecordingCollection::Format LocalTextRecordingCollection::format() const
+{
+   return static_cast<LocalTextRecordingEditor*>(editor<Media::Recording>())->m_Format;
+}
+
+/**
+ * Select the format used to save the conversations. Existing files are
+ * converted the next time they are saved.
+ */
+void LocalTextRecordingCollection::setFormat(Format format)
+{
+   static_cast<LocalTextRecordingEditor*>(editor<Media::Recording>())->m_Format = format;
+}
+
 Media::TextRecording* LocalTextRecordingCollection::createFor(const ContactMethod* cm)
 {
    Media::TextRecording* r = fetchFor(cm);
@@ -30,6 +30,12 @@ namespace Media {
 class LIB_EXPORT LocalTextRecordingCollection : public CollectionInterface
 {
 public:
+   ///The on disk format used when saving, both are always loaded
+   enum class Format {
+      JSON  , /*!< Human readable, also used for export           */
+      BINARY, /*!< Compact and faster to load, see Serializable:: */
+   };
+
    explicit LocalTextRecordingCollection(CollectionMediator<Media::Recording>* mediator);
    virtual ~LocalTextRecordingCollection();
 
@@ -50,6 +56,10 @@ public:
    Media::TextRecording* fetchFor (const ContactMethod* cm);
    Media::TextRecording* createFor(const ContactMethod* cm);
 
+   int    unreadCount(              ) const;
+   Format format     (              ) const;
+   void   setFormat  (Format format);
+
    virtual FlagPack<SupportedFeatures> supportedFeatures() const override;
 
    static LocalTextRecordingCollection& instance();
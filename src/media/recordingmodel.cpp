@@ -89,7 +89,7 @@ RecordingNode::~RecordingNode()
 }
 
 RecordingModelPrivate::RecordingModelPrivate(Media::RecordingModel* parent) : q_ptr(parent),m_pText(nullptr),
-m_pAudioVideo(nullptr)/*,m_pFiles(nullptr)*/
+m_pAudioVideo(nullptr),m_UnreadCount(0)/*,m_pFiles(nullptr)*/
 {
 
 }
@@ -134,6 +134,10 @@ d_ptr(new RecordingModelPrivate(this))
 
    d_ptr->m_pTextRecordingCollection = addCollection<LocalTextRecordingCollection>();
 
+   //The conversations that are not parsed yet are counted from the collection index
+   if (const int count = d_ptr->m_pTextRecordingCollection->unreadCount())
+      d_ptr->updateUnreadCount(count);
+
    d_ptr->m_pTextRecordingCollection->listId([](const QList<CollectionInterface::Element>& e) {
       //TODO
       Q_UNUSED(e);
@@ -297,6 +301,10 @@ bool Media::RecordingModel::addItemCallback(const Recording* item)
          const TextRecording* r = static_cast<const TextRecording*>(item);
          connect(r, &TextRecording::messageInserted, d_ptr, &RecordingModelPrivate::forwardInsertion);
          connect(r, &TextRecording::unreadCountChange, d_ptr, &RecordingModelPrivate::updateUnreadCount);
+
+         //The recording counted its unread messages while loading
+         if (const int count = r->unreadCount())
+            d_ptr->updateUnreadCount(count);
       }
 
       return true;
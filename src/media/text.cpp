@@ -39,6 +39,13 @@
 #include <accountmodel.h>
 #include <personmodel.h>
 
+//Qt
+#include <QtCore/QBitArray>
+#include <QtCore/QElapsedTimer>
+
+//Std
+#include <limits>
+
 /*
  * Instant message have 3 major modes, "past", "in call" and "offline"
  *
@@ -74,6 +81,18 @@ private:
    Media::Text* q_ptr;
 };
 
+//Limits for the vCard reassembly, a profile with a large avatar is a few
+//hundred kilobytes, so a peer can't grow memory usage without bound
+static const int    MAX_PROFILE_PARTS     = 1024            ;
+static const int    MAX_PROFILE_TRANSFERS = 32              ;
+static const int    MAX_PROFILE_BYTES     = 8 * 1024 * 1024 ;
+static const qint64 PROFILE_EXPIRY_MS     = 60 * 1000       ;
+
+/**
+ * Reassemble the vCard profiles sent in multiple parts. The parts may arrive
+ * in any order, partial transfers are dropped when they expire or when the
+ * limits are reached.
+ */
 class ProfileChunk
 {
 public:
@@ -81,15 +100,30 @@ public:
    static Person* addChunk( const QMap<QString,QString>& args, const QString& payload);
 
 private:
+   explicit ProfileChunk(int total);
+
    //Attributes
-   QHash<int, QString> m_hParts     {       };
-   int                 m_PartsCount { 0     };
-   static QHash<QString, ProfileChunk*> m_hRequest;
+   QVector<QByteArray> m_lParts     {       };
+   QBitArray           m_Received   {       };
+   int                 m_Count      { 0     };
+   int                 m_Size       { 0     };
+   qint64              m_LastUpdate { 0     };
+
+   static QHash<QString, ProfileChunk*> m_hRequest ;
+   static int                           m_TotalSize;
+
+   //Helpers
+   static qint64 now   ();
+   static void   drop  (const QString& id);
+   static void   expire();
+   static void   dropOldest(const QString& except);
 };
 
 QHash<QString, ProfileChunk*> ProfileChunk::m_hRequest;
+int ProfileChunk::m_TotalSize = 0;
 
-IMConversationManagerPrivate::IMConversationManagerPrivate(QObject* parent) : QObject(parent)
+IMConversationManagerPrivate::IMConversationManagerPrivate(QObject* parent) : QObject(parent),
+m_StatusEvents([this](const StatusEvents::Batch& events) { processStatusEvents(events); })
 {
    CallManagerInterface& callManager                   = CallManager::instance();
    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
@@ -105,34 +139,121 @@ IMConversationManagerPrivate& IMConversationManagerPrivate::instance()
    return *instance;
 }
 
+ProfileChunk::ProfileChunk(int total) : m_lParts(total), m_Received(total)
+{
+}
+
+qint64 ProfileChunk::now()
+{
+   static QElapsedTimer clock;
+
+   if (!clock.isValid())
+      clock.start();
+
+   return clock.elapsed();
+}
+
+void ProfileChunk::drop(const QString& id)
+{
+   if (ProfileChunk* c = m_hRequest.take(id)) {
+      m_TotalSize -= c->m_Size;
+      delete c;
+   }
+}
+
+///Drop the partial transfers that didn't receive anything for a while
+void ProfileChunk::expire()
+{
+   const qint64 limit = now() - PROFILE_EXPIRY_MS;
+
+   for (auto i = m_hRequest.begin(); i != m_hRequest.end();) {
+      if (i.value()->m_LastUpdate < limit) {
+         qWarning() << "Dropping incomplete profile" << i.key();
+         m_TotalSize -= i.value()->m_Size;
+         delete i.value();
+         i = m_hRequest.erase(i);
+      }
+      else
+         ++i;
+   }
+}
+
+void ProfileChunk::dropOldest(const QString& except)
+{
+   QString oldest;
+   qint64  time = std::numeric_limits<qint64>::max();
+
+   for (auto i = m_hRequest.constBegin(); i != m_hRequest.constEnd(); ++i) {
+      if (i.key() != except && i.value()->m_LastUpdate < time) {
+         oldest = i.key();
+         time   = i.value()->m_LastUpdate;
+      }
+   }
+
+   if (!oldest.isNull()) {
+      qWarning() << "Too many incomplete profiles, dropping" << oldest;
+      drop(oldest);
+   }
+}
+
 Person* ProfileChunk::addChunk(const QMap<QString, QString>& args, const QString& payload)
 {
     const int total  = args[ "of"   ].toInt();
     const int part   = args[ "part" ].toInt();
     const QString id = args[ "id"   ];
 
-    auto c = m_hRequest[id];
+    if (id.isEmpty() || total < 1 || total > MAX_PROFILE_PARTS || part < 1 || part > total)
+        return nullptr;
+
+    expire();
+
+    auto c = m_hRequest.value(id);
     if (!c) {
-        c = new ProfileChunk();
-        c->m_PartsCount = total;
+        while (m_hRequest.size() >= MAX_PROFILE_TRANSFERS)
+            dropOldest(id);
+
+        c = new ProfileChunk(total);
         m_hRequest[id] = c;
     }
+    else if (c->m_lParts.size() != total) {
+        qWarning() << "Profile" << id << "parts count changed, ignoring";
+        return nullptr;
+    }
+
+    c->m_LastUpdate = now();
+
+    //The same part was already received
+    if (c->m_Received.testBit(part - 1))
+        return nullptr;
+
+    const QByteArray data = payload.toUtf8();
 
-    if (part < 1 and part > total)
+    //Make room for this part, the current transfer goes last
+    while (m_TotalSize + data.size() > MAX_PROFILE_BYTES && m_hRequest.size() > 1)
+        dropOldest(id);
+
+    if (m_TotalSize + data.size() > MAX_PROFILE_BYTES) {
+        qWarning() << "Profile" << id << "is too large, dropping";
+        drop(id);
         return nullptr;
+    }
 
-    c->m_hParts[part] = payload;
+    c->m_lParts[part - 1] = data;
+    c->m_Received.setBit(part - 1);
+    c->m_Count++;
+    c->m_Size   += data.size();
+    m_TotalSize += data.size();
 
-    if (c->m_hParts.size() != c->m_PartsCount)
+    if (c->m_Count != total)
         return nullptr;
 
+    //Join the parts with a single allocation
     QByteArray cv;
-    for (int i=0; i < c->m_PartsCount; ++i) {
-        cv += c->m_hParts[i+1];
-    }
+    cv.reserve(c->m_Size);
+    for (const QByteArray& p : c->m_lParts)
+        cv += p;
 
-    m_hRequest[id] = nullptr;
-    delete c;
+    drop(id);
 
     return VCardUtils::mapToPerson(VCardUtils::toHashMap(cv));
 }
@@ -189,10 +310,33 @@ void IMConversationManagerPrivate::newAccountMessage(const QString& accountId, c
 
 void IMConversationManagerPrivate::accountMessageStatusChanged(const QString& accountId, uint64_t id, const QString& to, int status)
 {
-    if (auto cm = PhoneDirectoryModel::instance().getNumber(to, AccountModel::instance().getById(accountId.toLatin1()))) {
-        auto txtRecording = cm->textRecording();
-        txtRecording->d_ptr->accountMessageStatusChanged(id, static_cast<DRing::Account::MessageStates>(status));
+    m_StatusEvents.add({accountId, id}, {to, status});
+}
+
+///Each recording is saved once for all the statuses received in the same event loop iteration
+void IMConversationManagerPrivate::processStatusEvents(const StatusEvents::Batch& events)
+{
+    QHash<Media::TextRecording*, QVector<QPair<uint64_t, DRing::Account::MessageStates>>> changes;
+    QVector<Media::TextRecording*> recordings;
+
+    for (const auto& event : events) {
+        const QString& accountId = event.first.first;
+        const QString& to        = event.second.first;
+
+        if (auto cm = PhoneDirectoryModel::instance().getNumber(to, AccountModel::instance().getById(accountId.toLatin1()))) {
+            auto txtRecording = cm->textRecording();
+
+            if (!changes.contains(txtRecording))
+                recordings << txtRecording;
+
+            changes[txtRecording] << qMakePair<uint64_t, DRing::Account::MessageStates>(
+                event.first.second, static_cast<DRing::Account::MessageStates>(event.second.second)
+            );
+        }
     }
+
+    for (auto txtRecording : recordings)
+        txtRecording->d_ptr->accountMessageStatusChanged(changes[txtRecording]);
 }
 
 MediaTextPrivate::MediaTextPrivate(Media::Text* parent) : q_ptr(parent),m_pRecording(nullptr),m_HasChecked(false)
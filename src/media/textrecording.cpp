@@ -25,6 +25,8 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QCryptographicHash>
 #include <QtCore/QUrl>
+#include <QtCore/QDataStream>
+#include <QtCore/QMutex>
 
 //Daemon
 #include <account_const.h>
@@ -45,9 +47,14 @@
 
 //Std
 #include <ctime>
+#include <algorithm>
 
 QHash<QByteArray, Serializable::Peers*> SerializableEntityManager::m_hPeers;
 
+///"RTXR", the first 4 bytes of the binary conversation files
+static const quint32 BINARY_MAGIC   = 0x52545852;
+static const quint16 BINARY_VERSION = 1;
+
 void addPeer(Serializable::Peers* p,  const ContactMethod* cm);
 void addPeer(Serializable::Peers* p,  const ContactMethod* cm)
 {
@@ -154,7 +161,72 @@ Serializable::Peers* SerializableEntityManager::fromJson(const QJsonObject& json
    return p;
 }
 
-Media::TextRecordingPrivate::TextRecordingPrivate(TextRecording* r) : q_ptr(r),m_pImModel(nullptr),m_pCurrentGroup(nullptr),m_UnreadCount(0)
+///The file content read by fromBinary()
+QByteArray SerializableEntityManager::toBinary(const Serializable::Peers* p)
+{
+   QByteArray data;
+   QDataStream stream(&data, QIODevice::WriteOnly);
+   stream.setVersion(QDataStream::Qt_5_0);
+
+   stream << BINARY_MAGIC << BINARY_VERSION;
+   p->write(stream);
+
+   return data;
+}
+
+Serializable::Peers* SerializableEntityManager::fromBinary(const QByteArray& data, const ContactMethod* cm)
+{
+   QDataStream stream(data);
+   stream.setVersion(QDataStream::Qt_5_0);
+
+   quint32 magic  ;
+   quint16 version;
+   stream >> magic >> version;
+
+   if (stream.status() != QDataStream::Ok || magic != BINARY_MAGIC) {
+      qWarning() << "Invalid binary text recording";
+      return nullptr;
+   }
+
+   if (version > BINARY_VERSION) {
+      qWarning() << "Unsupported binary text recording version" << version;
+      return nullptr;
+   }
+
+   //Check if the object is already loaded
+   QList<QString> sha1List;
+   stream >> sha1List;
+
+   if (sha1List.isEmpty())
+      return nullptr;
+
+   const QByteArray sha1 = sha1List.size() > 1 ?
+      mashSha1s(sha1List) : sha1List[0].toLatin1();
+
+   if (m_hPeers[sha1])
+      return m_hPeers[sha1];
+
+   //Load from the stream, the sha1s were already read
+   Serializable::Peers* p = new Serializable::Peers();
+   p->sha1s = sha1List;
+   p->read(stream);
+
+   if (stream.status() != QDataStream::Ok) {
+      qWarning() << "Corrupted binary text recording" << sha1;
+      delete p;
+      return nullptr;
+   }
+
+   m_hPeers[sha1] = p;
+
+   if (cm && p->peers.isEmpty())
+      addPeer(p,cm);
+
+   return p;
+}
+
+Media::TextRecordingPrivate::TextRecordingPrivate(TextRecording* r) : q_ptr(r),m_pImModel(nullptr),m_pCurrentGroup(nullptr),
+m_pCurrentPeers(nullptr),m_UnreadCount(0)
 {
 }
 
@@ -198,14 +270,20 @@ bool Media::TextRecordingPrivate::updateMessageStatus(Serializable::Message* m,
     return modified;
 }
 
-void Media::TextRecordingPrivate::accountMessageStatusChanged(const uint64_t id, DRing::Account::MessageStates status)
+///Apply a batch of status changes, the recording is saved only once
+void Media::TextRecordingPrivate::accountMessageStatusChanged(const QVector<QPair<uint64_t, DRing::Account::MessageStates>>& changes)
 {
-    if (auto node = m_hPendingMessages.value(id, nullptr)) {
-        if (updateMessageStatus(node->m_pMessage, static_cast<TextRecording::Status>(status))) {
-            //You're looking at why local file storage is a "bad" idea
-            q_ptr->save();
-            m_pImModel->dataChanged(QModelIndex(), QModelIndex());
-        }
+    bool modified = false;
+
+    for (const auto& change : changes) {
+        if (auto node = m_hPendingMessages.value(change.first, nullptr))
+            modified |= updateMessageStatus(node->m_pMessage, static_cast<TextRecording::Status>(change.second));
+    }
+
+    if (modified) {
+        //You're looking at why local file storage is a "bad" idea
+        q_ptr->save();
+        m_pImModel->dataChanged(QModelIndex(), QModelIndex());
     }
 }
 
@@ -229,9 +307,23 @@ QAbstractItemModel* Media::TextRecording::instantMessagingModel() const
    return d_ptr->m_pImModel;
 }
 
+/**
+ * The number of unread text messages. It is kept up to date as messages are
+ * inserted or read, so unlike unreadInstantTextMessagingModel() it doesn't
+ * need to look at every message.
+ */
+int Media::TextRecording::unreadCount() const
+{
+   return d_ptr->m_UnreadCount;
+}
+
 ///Set all messages as read and then save the recording
 void Media::TextRecording::setAllRead()
 {
+    //Nothing to do, avoid walking the whole conversation
+    if (!d_ptr->m_UnreadCount)
+        return;
+
     bool changed = false;
     for(int row = 0; row < d_ptr->m_lNodes.size(); ++row) {
         if (!d_ptr->m_lNodes[row]->m_pMessage->isRead) {
@@ -344,6 +436,18 @@ bool Media::TextRecording::isEmpty() const
    return !d_ptr->m_lNodes.size();
 }
 
+QHash<QByteArray,QByteArray> Media::TextRecordingPrivate::toBinaries() const
+{
+   QHash<QByteArray,QByteArray> ret;
+   for (Serializable::Peers* p : m_lAssociatedPeers) {
+      p->hasChanged = false;
+
+      ret[p->sha1s[0].toLatin1()] = SerializableEntityManager::toBinary(p);
+   }
+
+   return ret;
+}
+
 QHash<QByteArray,QByteArray> Media::TextRecordingPrivate::toJsons() const
 {
    QHash<QByteArray,QByteArray> ret;
@@ -368,21 +472,47 @@ Media::TextRecording* Media::TextRecording::fromJson(const QList<QJsonObject>& i
     if (backend)
         t->setCollection(backend);
 
-    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
-
     //Load the history data
     for (const QJsonObject& obj : items) {
         Serializable::Peers* p = SerializableEntityManager::fromJson(obj,cm);
         t->d_ptr->m_lAssociatedPeers << p;
     }
 
+    t->d_ptr->reconstruct(cm);
+
+    return t;
+}
+
+///Same as fromJson, but for the binary format created by toBinaries()
+Media::TextRecording* Media::TextRecording::fromBinary(const QList<QByteArray>& items, const ContactMethod* cm, CollectionInterface* backend)
+{
+    TextRecording* t = new TextRecording();
+    if (backend)
+        t->setCollection(backend);
+
+    //Load the history data
+    for (const QByteArray& data : items) {
+        if (Serializable::Peers* p = SerializableEntityManager::fromBinary(data,cm))
+            t->d_ptr->m_lAssociatedPeers << p;
+    }
+
+    t->d_ptr->reconstruct(cm);
+
+    return t;
+}
+
+///Create the TextMessageNodes from the associated peers
+void Media::TextRecordingPrivate::reconstruct(const ContactMethod* cm)
+{
+    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
+
     //Create the model
     bool statusChanged = false; // if a msg status changed during parsing, we need to re-save the model
-    t->instantMessagingModel();
+    q_ptr->instantMessagingModel();
 
     //Reconstruct the conversation
     //TODO do it right, right now it flatten the graph
-    for (const Serializable::Peers* p : t->d_ptr->m_lAssociatedPeers) {
+    for (const Serializable::Peers* p : m_lAssociatedPeers) {
         //Seems old version didn't store that
         if (p->peers.isEmpty())
             continue;
@@ -393,7 +523,7 @@ Media::TextRecording* Media::TextRecording::fromJson(const QList<QJsonObject>& i
         time_t lastUsed = 0;
         for (const Serializable::Group* g : p->groups) {
             for (Serializable::Message* m : g->messages) {
-                ::TextMessageNode* n  = new ::TextMessageNode();
+                ::TextMessageNode* n  = m_NodePool.create();
                 n->m_pMessage         = m                      ;
                 if (!n->m_pMessage->contactMethod) {
                     if (cm) {
@@ -413,29 +543,34 @@ Media::TextRecording* Media::TextRecording::fromJson(const QList<QJsonObject>& i
                     }
                 }
                 n->m_pContactMethod   = m->contactMethod;
-                t->d_ptr->m_pImModel->addRowBegin();
-                t->d_ptr->m_lNodes << n;
-                t->d_ptr->m_pImModel->addRowEnd();
+
+                if (m->m_HasText && !m->isRead)
+                    m_UnreadCount++;
+
+                m_pImModel->addRowBegin();
+                m_lNodes << n;
+                m_pImModel->addRowEnd();
 
                 if (lastUsed < n->m_pMessage->timestamp)
                     lastUsed = n->m_pMessage->timestamp;
                 if (m->id) {
                     int status = configurationManager.getMessageStatus(m->id);
-                    t->d_ptr->m_hPendingMessages[m->id] = n;
-                    if (t->d_ptr->updateMessageStatus(m, static_cast<TextRecording::Status>(status)))
+                    m_hPendingMessages[m->id] = n;
+                    if (updateMessageStatus(m, static_cast<TextRecording::Status>(status)))
                         statusChanged = true;
                 }
             }
         }
 
         if (statusChanged)
-            t->save();
+            q_ptr->save();
 
         // update the timestamp of the CM
         peerCM->setLastUsed(lastUsed);
     }
 
-    return t;
+    // format the messages in the background, newest first
+    scheduleFormatting(0, m_lNodes.size() - 1);
 }
 
 void Media::TextRecordingPrivate::insertNewMessage(const QMap<QString,QString>& message, ContactMethod* cm, Media::Media::Direction direction, uint64_t id)
@@ -452,12 +587,21 @@ void Media::TextRecordingPrivate::insertNewMessage(const QMap<QString,QString>&
             m_lAssociatedPeers << p;
         }
         p->groups << m_pCurrentGroup;
+        m_pCurrentPeers = p;
+   }
+
+   static const int profileSize = QString(RingMimes::PROFILE_VCF).size();
+
+   //Profiles are handled elsewhere, don't keep them in the pool
+   for (auto i = message.constBegin(); i != message.constEnd(); ++i) {
+      if (i.key().left(profileSize) == RingMimes::PROFILE_VCF)
+         return;
    }
 
    //Create the message
    time_t currentTime;
    ::time(&currentTime);
-   Serializable::Message* m = new Serializable::Message();
+   Serializable::Message* m = m_pCurrentPeers->m_MessagePool.create();
 
    m->timestamp = currentTime                      ;
    m->direction = direction                        ;
@@ -468,27 +612,25 @@ void Media::TextRecordingPrivate::insertNewMessage(const QMap<QString,QString>&
    if (direction == Media::Media::Direction::OUT)
       m->isRead = true; // assume outgoing messages are read, since we're sending them
 
-   static const int profileSize = QString(RingMimes::PROFILE_VCF).size();
+   m->payloads.reserve(message.size());
 
    QMapIterator<QString, QString> iter(message);
    while (iter.hasNext()) {
       iter.next();
-      if (iter.key().left(profileSize) == RingMimes::PROFILE_VCF)
-          return;
       if (iter.value() != QLatin1String("application/resource-lists+xml")) { //This one is useless
          const QString mimeType = iter.key();
 
-         Serializable::Payload* p = new Serializable::Payload();
-         p->mimeType = mimeType    ;
-         p->payload  = iter.value();
+         Serializable::Payload p;
+         p.mimeType = Serializable::Payload::internMimeType(mimeType);
+         p.payload  = iter.value();
          m->payloads << p;
 
-         if (p->mimeType == QLatin1String("text/plain")) {
-            m->m_PlainText = p->payload;
+         if (p.mimeType == QLatin1String("text/plain")) {
+            m->m_PlainText = p.payload;
             m->m_HasText   = true;
          }
-         else if (p->mimeType == QLatin1String("text/html")) {
-            m->m_HTML    = p->payload;
+         else if (p.mimeType == QLatin1String("text/html")) {
+            m->m_HTML    = p.payload;
             m->m_HasText = true;
          }
 
@@ -509,7 +651,7 @@ void Media::TextRecordingPrivate::insertNewMessage(const QMap<QString,QString>&
    q_ptr->instantMessagingModel();
 
    //Update the reconstructed conversation
-   ::TextMessageNode* n  = new ::TextMessageNode()       ;
+   ::TextMessageNode* n  = m_NodePool.create()           ;
    n->m_pMessage         = m                             ;
    n->m_pContactMethod   = const_cast<ContactMethod*>(cm);
    m_pImModel->addRowBegin();
@@ -519,12 +661,14 @@ void Media::TextRecordingPrivate::insertNewMessage(const QMap<QString,QString>&
    if (m->id > 0)
        m_hPendingMessages[id] = n;
 
+   scheduleFormatting(m_lNodes.size() - 1, m_lNodes.size() - 1);
+
    //Save the conversation
    q_ptr->save();
 
    cm->setLastUsed(currentTime);
    emit q_ptr->messageInserted(message, const_cast<ContactMethod*>(cm), direction);
-   if (!m->isRead) {
+   if (m->m_HasText && !m->isRead) {
       m_UnreadCount += 1;
       emit q_ptr->unreadCountChange(1);
       emit cm->unreadTextMessageCountChanged();
@@ -532,10 +676,62 @@ void Media::TextRecordingPrivate::insertNewMessage(const QMap<QString,QString>&
    }
 }
 
+/**
+ * Send the text messages between first and last (inclusive) to the
+ * TextFormatter. The rows are sent in chunks, starting from the end of the
+ * conversation, so the visible part of the view get updated first.
+ */
+void Media::TextRecordingPrivate::scheduleFormatting(int first, int last)
+{
+   static const int chunkSize = 128;
+
+   for (int end = last; end >= first; end -= chunkSize) {
+      QVector<TextFormatter::Entry> entries;
+      const int begin = std::max(first, end - chunkSize + 1);
+      entries.reserve(end - begin + 1);
+
+      for (int row = begin; row <= end; ++row) {
+         const Serializable::Message* m = m_lNodes[row]->m_pMessage;
+
+         if (m->m_HasText && m->m_FormattedHtml.isEmpty())
+            entries << TextFormatter::Entry { row, m, m->m_PlainText, {}, {} };
+      }
+
+      TextFormatter::instance().schedule(m_pImModel, entries);
+   }
+}
+
+/**
+ * Return a shared copy of the mime type. Most conversations only use one or
+ * two of them, there is no need to keep a copy for every message.
+ *
+ * The peers choose the mime types, only the first few are kept so the table
+ * cannot grow forever. It can be used from any thread.
+ */
+QString Serializable::Payload::internMimeType(const QString& mimeType)
+{
+   static const int MAX_MIME_TYPES = 64;
+
+   static QMutex                  mutex    ;
+   static QHash<QString, QString> mimeTypes;
+
+   QMutexLocker locker(&mutex);
+
+   auto i = mimeTypes.constFind(mimeType);
+
+   if (i != mimeTypes.constEnd())
+      return i.value();
+
+   if (mimeTypes.size() < MAX_MIME_TYPES)
+      mimeTypes[mimeType] = mimeType;
+
+   return mimeType;
+}
+
 void Serializable::Payload::read(const QJsonObject &json)
 {
    payload  = json["payload" ].toString();
-   mimeType = json["mimeType"].toString();
+   mimeType = internMimeType(json["mimeType"].toString());
 }
 
 void Serializable::Payload::write(QJsonObject& json) const
@@ -544,6 +740,21 @@ void Serializable::Payload::write(QJsonObject& json) const
    json["mimeType"] = mimeType;
 }
 
+void Serializable::Payload::read(QDataStream& stream, const QVector<QString>& strings)
+{
+   quint32    mime;
+   QByteArray data;
+   stream >> mime >> data;
+
+   mimeType = internMimeType(strings.value(static_cast<int>(mime)));
+   payload  = QString::fromUtf8(data);
+}
+
+void Serializable::Payload::write(QDataStream& stream, const StringTable& strings) const
+{
+   stream << strings.value(mimeType) << payload.toUtf8();
+}
+
 void Serializable::Message::read (const QJsonObject &json)
 {
    timestamp  = json["timestamp" ].toInt                (                           );
@@ -555,29 +766,21 @@ void Serializable::Message::read (const QJsonObject &json)
    deliveryStatus = static_cast<Media::TextRecording::Status>(json["deliveryStatus"].toInt());
 
    QJsonArray a = json["payloads"].toArray();
+   payloads.reserve(a.size());
    for (int i = 0; i < a.size(); ++i) {
       QJsonObject o = a[i].toObject();
-      Payload* p = new Payload();
-      p->read(o);
-      payloads << p;
-
-      if (p->mimeType == "text/plain") {
-         m_PlainText = p->payload;
-         m_HasText   = true;
-      }
-      else if (p->mimeType == "text/html") {
-         m_HTML    = p->payload;
-         m_HasText = true;
-      }
+      Payload p;
+      p.read(o);
+      addPayload(p);
    }
 
    //Load older conversation from a time when only 1 mime/payload pair was supported
    if (!json["payload"   ].toString().isEmpty()) {
-      Payload* p  = new Payload();
-      p->payload  = json["payload"  ].toString();
-      p->mimeType = json["mimeType" ].toString();
+      Payload p;
+      p.payload  = json["payload"  ].toString();
+      p.mimeType = Payload::internMimeType(json["mimeType" ].toString());
       payloads << p;
-      m_PlainText = p->payload;
+      m_PlainText = p.payload;
       m_HasText   = true;
    }
 }
@@ -593,48 +796,82 @@ void Serializable::Message::write(QJsonObject &json) const
    json["deliveryStatus"         ] = static_cast<int>(deliveryStatus);
 
    QJsonArray a;
-   foreach (const Payload* p, payloads) {
+   for (const Payload& p : payloads) {
       QJsonObject o;
-      p->write(o);
+      p.write(o);
       a.append(o);
    }
    json["payloads"] = a;
 }
 
-const QRegularExpression Serializable::Message::m_linkRegex = QRegularExpression(QStringLiteral("((?>(?>https|http|ftp|ring):|www\\.)(?>[^\\s,.);!>]|[,.);!>](?!\\s|$))+)"),
-                                                                                 QRegularExpression::CaseInsensitiveOption);
+void Serializable::Message::read(QDataStream& stream, const QVector<QString>& strings)
+{
+   qint64  time  ;
+   quint32 author;
+   quint8  dir   ;
+   quint8  t     ;
+   quint64 token ;
+   quint8  status;
+   quint32 count ;
+
+   stream >> time >> author >> dir >> t >> isRead >> token >> status >> count;
+
+   timestamp      = static_cast<time_t>(time);
+   authorSha1     = strings.value(static_cast<int>(author));
+   direction      = static_cast<Media::Media::Direction>(dir);
+   type           = static_cast<Serializable::Message::Type>(t);
+   id             = token;
+   deliveryStatus = static_cast<Media::TextRecording::Status>(status);
+
+   payloads.reserve(static_cast<int>(std::min<quint32>(count, 8)));
+   for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      Payload p;
+      p.read(stream, strings);
+      addPayload(p);
+   }
+}
 
-const QString& Serializable::Message::getFormattedHtml()
+void Serializable::Message::write(QDataStream& stream, const StringTable& strings) const
 {
-    if (m_FormattedHtml.isEmpty())
-    {
-        QString re;
-        auto p = 0;
-        auto it = m_linkRegex.globalMatch(m_PlainText);
-        while (it.hasNext()) {
-            QRegularExpressionMatch match = it.next();
-            auto start = match.capturedStart();
-
-            auto url = QUrl::fromUserInput(match.capturedRef().toString());
-
-            if (start > p)
-                re.append(m_PlainText.mid(p, start - p).toHtmlEscaped().replace(QLatin1Char('\n'),
-                                                                                QStringLiteral("<br/>")));
-            re.append(QStringLiteral("<a href=\"%1\">%2</a>")
-                      .arg(QString::fromLatin1(url.toEncoded()).toHtmlEscaped(),
-                           match.capturedRef().toString().toHtmlEscaped()));
-            m_LinkList.append(url);
-            p = match.capturedEnd();
-        }
-        if (p < m_PlainText.size())
-            re.append(m_PlainText.mid(p, m_PlainText.size() - p));
+   stream << static_cast<qint64 >(timestamp     )
+          << strings.value(authorSha1)
+          << static_cast<quint8 >(direction     )
+          << static_cast<quint8 >(type          )
+          << isRead
+          << static_cast<quint64>(id            )
+          << static_cast<quint8 >(deliveryStatus)
+          << static_cast<quint32>(payloads.size());
+
+   for (const Payload& p : payloads)
+      p.write(stream, strings);
+}
+
+void Serializable::Message::addPayload(const Payload& p)
+{
+   payloads << p;
 
-        m_FormattedHtml = QString("<body>%1</body>").arg(re);
+   if (p.mimeType == QLatin1String("text/plain")) {
+      m_PlainText = p.payload;
+      m_HasText   = true;
+   }
+   else if (p.mimeType == QLatin1String("text/html")) {
+      m_HTML    = p.payload;
+      m_HasText = true;
+   }
+}
+
+///Format the message now if the TextFormatter didn't do it yet
+const QString& Serializable::Message::getFormattedHtml()
+{
+    if (m_FormattedHtml.isEmpty()) {
+        m_LinkList.clear();
+        TextFormatter::format(m_PlainText, m_FormattedHtml, m_LinkList);
     }
+
     return m_FormattedHtml;
 }
 
-void Serializable::Group::read (const QJsonObject &json, const QHash<QString,ContactMethod*> sha1s)
+void Serializable::Group::read (const QJsonObject &json, const QHash<QString,ContactMethod*> sha1s, ObjectPool<Message>& pool)
 {
    id            = json["id"           ].toInt   ();
    nextGroupSha1 = json["nextGroupSha1"].toString();
@@ -643,7 +880,7 @@ void Serializable::Group::read (const QJsonObject &json, const QHash<QString,Con
    QJsonArray a = json["messages"].toArray();
    for (int i = 0; i < a.size(); ++i) {
       QJsonObject o = a[i].toObject();
-      Message* message = new Message();
+      Message* message = pool.create();
       message->contactMethod = sha1s[message->authorSha1];
       message->read(o);
       messages.append(message);
@@ -665,6 +902,37 @@ void Serializable::Group::write(QJsonObject &json) const
    json["messages"] = a;
 }
 
+void Serializable::Group::read(QDataStream& stream, const QHash<QString,ContactMethod*>& sha1s, const QVector<QString>& strings, ObjectPool<Message>& pool)
+{
+   Q_UNUSED(sha1s) //Like the JSON, the ContactMethod is resolved by the TextRecording
+
+   qint32  gid  ;
+   qint32  nid  ;
+   quint32 count;
+
+   stream >> gid >> nextGroupSha1 >> nid >> count;
+
+   id          = gid;
+   nextGroupId = nid;
+
+   for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      Message* message = pool.create();
+      message->read(stream, strings);
+      messages.append(message);
+   }
+}
+
+void Serializable::Group::write(QDataStream& stream, const StringTable& strings) const
+{
+   stream << static_cast<qint32 >(id             )
+          << nextGroupSha1
+          << static_cast<qint32 >(nextGroupId    )
+          << static_cast<quint32>(messages.size());
+
+   for (const Message* m : messages)
+      m->write(stream, strings);
+}
+
 void Serializable::Peer::read (const QJsonObject &json)
 {
    accountId = json["accountId"].toString();
@@ -672,6 +940,23 @@ void Serializable::Peer::read (const QJsonObject &json)
    personUID = json["personUID"].toString();
    sha1      = json["sha1"     ].toString();
 
+   resolveContactMethod();
+}
+
+void Serializable::Peer::read(QDataStream& stream)
+{
+   stream >> accountId >> uri >> personUID >> sha1;
+
+   resolveContactMethod();
+}
+
+void Serializable::Peer::write(QDataStream& stream) const
+{
+   stream << accountId << uri << personUID << sha1;
+}
+
+void Serializable::Peer::resolveContactMethod()
+{
    Account* a     = AccountModel::instance().getById(accountId.toLatin1());
    Person* person = personUID.isEmpty() ?
       nullptr : PersonModel::instance().getPersonByUid(personUID.toLatin1());
@@ -708,7 +993,7 @@ void Serializable::Peers::read (const QJsonObject &json)
    for (int i = 0; i < a.size(); ++i) {
       QJsonObject o = a[i].toObject();
       Group* group = new Group();
-      group->read(o,m_hSha1);
+      group->read(o,m_hSha1,m_MessagePool);
       groups.append(group);
    }
 }
@@ -738,6 +1023,74 @@ void Serializable::Peers::write(QJsonObject &json) const
    json["peers"] = a3;
 }
 
+///The sha1s are read by SerializableEntityManager::fromBinary
+void Serializable::Peers::read(QDataStream& stream)
+{
+   quint32 count;
+
+   stream >> count;
+   for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      Peer* peer = new Peer();
+      peer->read(stream);
+      m_hSha1[peer->sha1] = peer->m_pContactMethod;
+      peers.append(peer);
+   }
+
+   //Read the shared strings, the messages share these copies
+   QVector<QString> strings;
+   stream >> count;
+   strings.reserve(static_cast<int>(std::min<quint32>(count, 1024)));
+   for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      QString str;
+      stream >> str;
+      strings << str;
+   }
+
+   stream >> count;
+   for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      Group* group = new Group();
+      group->read(stream, m_hSha1, strings, m_MessagePool);
+      groups.append(group);
+   }
+}
+
+void Serializable::Peers::write(QDataStream& stream) const
+{
+   stream << sha1s;
+
+   stream << static_cast<quint32>(peers.size());
+   for (const Peer* p : peers)
+      p->write(stream);
+
+   //Store the mime types and authors only once
+   StringTable      table  ;
+   QVector<QString> strings;
+
+   for (const Group* g : groups) {
+      for (const Message* m : g->messages) {
+         if (!table.contains(m->authorSha1)) {
+            table[m->authorSha1] = strings.size();
+            strings << m->authorSha1;
+         }
+
+         for (const Payload& p : m->payloads) {
+            if (!table.contains(p.mimeType)) {
+               table[p.mimeType] = strings.size();
+               strings << p.mimeType;
+            }
+         }
+      }
+   }
+
+   stream << static_cast<quint32>(strings.size());
+   for (const QString& str : strings)
+      stream << str;
+
+   stream << static_cast<quint32>(groups.size());
+   for (const Group* g : groups)
+      g->write(stream, table);
+}
+
 
 ///Constructor
 InstantMessagingModel::InstantMessagingModel(Media::TextRecording* recording) : QAbstractListModel(recording),m_pRecording(recording)
@@ -831,6 +1184,7 @@ QVariant InstantMessagingModel::data( const QModelIndex& idx, int role) const
          case (int)Media::TextRecording::Role::FormattedHtml        :
             return QVariant::fromValue(n->m_pMessage->getFormattedHtml());
          case (int)Media::TextRecording::Role::LinkList             :
+            n->m_pMessage->getFormattedHtml();
             return QVariant::fromValue(n->m_pMessage->m_LinkList);
          default:
             break;
@@ -898,3 +1252,36 @@ void InstantMessagingModel::addRowEnd()
 {
    endInsertRows();
 }
+
+///Apply a batch of messages formatted by the TextFormatter
+void InstantMessagingModel::applyFormatting(const QVector<TextFormatter::Entry>& entries)
+{
+   static const QVector<int> roles {
+      static_cast<int>(Media::TextRecording::Role::FormattedHtml),
+      static_cast<int>(Media::TextRecording::Role::LinkList     ),
+   };
+
+   const auto& nodes = m_pRecording->d_ptr->m_lNodes;
+   int first = -1;
+   int last  = -1;
+
+   for (const TextFormatter::Entry& e : entries) {
+      if (e.row >= nodes.size() || nodes[e.row]->m_pMessage != e.message)
+         continue;
+
+      Serializable::Message* m = nodes[e.row]->m_pMessage;
+
+      //It was already formatted on demand
+      if (!m->m_FormattedHtml.isEmpty())
+         continue;
+
+      m->m_FormattedHtml = e.html ;
+      m->m_LinkList      = e.links;
+
+      first = first == -1 ? e.row : std::min(first, e.row);
+      last  = std::max(last, e.row);
+   }
+
+   if (first != -1)
+      emit dataChanged(index(first, 0), index(last, 0), roles);
+}
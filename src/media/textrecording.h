@@ -82,6 +82,7 @@ public:
    explicit TextRecording();
    virtual ~TextRecording();
    static TextRecording* fromJson(const QList<QJsonObject>& items, const ContactMethod* cm = nullptr, CollectionInterface* backend = nullptr);
+   static TextRecording* fromBinary(const QList<QByteArray>& items, const ContactMethod* cm = nullptr, CollectionInterface* backend = nullptr);
 
    //Getter
    QAbstractItemModel* instantMessagingModel    (                         ) const;
@@ -91,6 +92,7 @@ public:
    bool                hasMimeType              ( const QString& mimeType ) const;
    QStringList         mimeTypes                (                         ) const;
    QVector<ContactMethod*> peers                (                         ) const;
+   int                 unreadCount              (                         ) const;
 
    //Helper
    void setAllRead();
@@ -44,7 +44,8 @@
 #include "private/phonedirectorymodel_p.h"
 
 PhoneDirectoryModelPrivate::PhoneDirectoryModelPrivate(PhoneDirectoryModel* parent) : QObject(parent), q_ptr(parent),
-m_CallWithAccount(false),m_pPopularModel(nullptr)
+m_CallWithAccount(false),m_pPopularModel(nullptr),
+m_PresenceEvents([this](const PresenceEvents::Batch& events) { processPresenceEvents(events); })
 {
 }
 
@@ -689,11 +690,24 @@ void PhoneDirectoryModelPrivate::slotIncomingAccountMessage(const QString& accou
 
 void PhoneDirectoryModelPrivate::slotNewBuddySubscription(const QString& accountId, const QString& uri, bool status, const QString& message)
 {
-   qDebug() << "New presence buddy" << uri << status << message;
-   ContactMethod* number = q_ptr->getNumber(uri,AccountModel::instance().getById(accountId.toLatin1()));
-   number->setPresent(status);
-   number->setPresenceMessage(message);
-   emit number->changed();
+   m_PresenceEvents.add({accountId, uri}, {status, message});
+}
+
+///Apply the presence notifications received during the last event loop iteration
+void PhoneDirectoryModelPrivate::processPresenceEvents(const PresenceEvents::Batch& events)
+{
+   for (const auto& event : events) {
+      const QString& accountId = event.first.first  ;
+      const QString& uri       = event.first.second ;
+      const bool     status    = event.second.first ;
+      const QString& message   = event.second.second;
+
+      qDebug() << "New presence buddy" << uri << status << message;
+      ContactMethod* number = q_ptr->getNumber(uri,AccountModel::instance().getById(accountId.toLatin1()));
+      number->setPresent(status);
+      number->setPresenceMessage(message);
+      emit number->changed();
+   }
 }
 
 ///Make sure the indexes are still valid for those names
@@ -24,6 +24,7 @@
 //Ring
 #include <account.h>
 #include <private/matrixutils.h>
+#include <private/accountdetails.h>
 
 class AccountPrivate;
 class ContactMethod;
@@ -72,7 +73,7 @@ public:
 
    //Attributes
    QByteArray                 m_AccountId                ;
-   QHash<QString,QString>     m_hAccountDetails          ;
+   AccountDetails             m_Details                  ;
    ContactMethod*             m_pAccountNumber           ;
    Account*                   q_ptr                      ;
    bool                       m_isLoaded                 ;
@@ -83,6 +84,7 @@ public:
    unsigned short             m_UseDefaultPort           ;
    bool                       m_RemoteEnabledState       ;
    uint                       m_InternalId               ;
+   MapStringString            m_hPrefetchedDetails       ; // used by the next reload()
 
    //Statistic
    bool   m_HaveCalled    ;
@@ -97,12 +99,14 @@ public:
 
    //Getters
    const QString accountDetail(const QString& param) const;
+   const QString& accountDetail(AccountDetails::Property p) const;
    uint internalId() const;
 
    //Mutator
    bool merge(Account* account);
    //Constructors
-   static Account* buildExistingAccountFromId(const QByteArray& _accountId);
+   static Account* buildExistingAccountFromId(const QByteArray& _accountId,
+                                              const MapStringString& details = MapStringString());
    static Account* buildNewAccountFromAlias  (Account::Protocol proto, const QString& alias);
 
    //Helpers
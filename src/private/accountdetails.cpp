@@ -0,0 +1,203 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "accountdetails.h"
+
+//Ring
+#include <account_const.h>
+#include "private/matrixutils.h"
+
+static const Matrix1D<AccountDetails::Property, const char*> propertyNames = {{
+   /* ALIAS                          */ DRing::Account::ConfProperties::ALIAS,
+   /* TYPE                           */ DRing::Account::ConfProperties::TYPE,
+   /* ENABLED                        */ DRing::Account::ConfProperties::ENABLED,
+   /* DISPLAYNAME                    */ DRing::Account::ConfProperties::DISPLAYNAME,
+   /* USERNAME                       */ DRing::Account::ConfProperties::USERNAME,
+   /* HOSTNAME                       */ DRing::Account::ConfProperties::HOSTNAME,
+   /* MAILBOX                        */ DRing::Account::ConfProperties::MAILBOX,
+   /* ROUTE                          */ DRing::Account::ConfProperties::ROUTE,
+   /* AUTOANSWER                     */ DRing::Account::ConfProperties::AUTOANSWER,
+   /* ACTIVE_CALL_LIMIT              */ DRing::Account::ConfProperties::ACTIVE_CALL_LIMIT,
+   /* DTMF_TYPE                      */ DRing::Account::ConfProperties::DTMF_TYPE,
+   /* LOCAL_INTERFACE                */ DRing::Account::ConfProperties::LOCAL_INTERFACE,
+   /* LOCAL_PORT                     */ DRing::Account::ConfProperties::LOCAL_PORT,
+   /* PUBLISHED_SAMEAS_LOCAL         */ DRing::Account::ConfProperties::PUBLISHED_SAMEAS_LOCAL,
+   /* PUBLISHED_ADDRESS              */ DRing::Account::ConfProperties::PUBLISHED_ADDRESS,
+   /* PUBLISHED_PORT                 */ DRing::Account::ConfProperties::PUBLISHED_PORT,
+   /* UPNP_ENABLED                   */ DRing::Account::ConfProperties::UPNP_ENABLED,
+   /* HAS_CUSTOM_USER_AGENT          */ DRing::Account::ConfProperties::HAS_CUSTOM_USER_AGENT,
+   /* USER_AGENT                     */ DRing::Account::ConfProperties::USER_AGENT,
+   /* ALLOW_CERT_FROM_HISTORY        */ DRing::Account::ConfProperties::ALLOW_CERT_FROM_HISTORY,
+   /* ALLOW_CERT_FROM_CONTACT        */ DRing::Account::ConfProperties::ALLOW_CERT_FROM_CONTACT,
+   /* REGISTRATION_EXPIRE            */ DRing::Account::ConfProperties::Registration::EXPIRE,
+   /* REGISTRATION_STATUS            */ DRing::Account::ConfProperties::Registration::STATUS,
+   /* RINGTONE_ENABLED               */ DRing::Account::ConfProperties::Ringtone::ENABLED,
+   /* RINGTONE_PATH                  */ DRing::Account::ConfProperties::Ringtone::PATH,
+   /* PRESENCE_ENABLED               */ DRing::Account::ConfProperties::Presence::ENABLED,
+   /* PRESENCE_SUPPORT_PUBLISH       */ DRing::Account::ConfProperties::Presence::SUPPORT_PUBLISH,
+   /* PRESENCE_SUPPORT_SUBSCRIBE     */ DRing::Account::ConfProperties::Presence::SUPPORT_SUBSCRIBE,
+   /* AUDIO_PORT_MIN                 */ DRing::Account::ConfProperties::Audio::PORT_MIN,
+   /* AUDIO_PORT_MAX                 */ DRing::Account::ConfProperties::Audio::PORT_MAX,
+   /* VIDEO_ENABLED                  */ DRing::Account::ConfProperties::Video::ENABLED,
+   /* VIDEO_PORT_MIN                 */ DRing::Account::ConfProperties::Video::PORT_MIN,
+   /* VIDEO_PORT_MAX                 */ DRing::Account::ConfProperties::Video::PORT_MAX,
+   /* STUN_ENABLED                   */ DRing::Account::ConfProperties::STUN::ENABLED,
+   /* STUN_SERVER                    */ DRing::Account::ConfProperties::STUN::SERVER,
+   /* TURN_ENABLED                   */ DRing::Account::ConfProperties::TURN::ENABLED,
+   /* TURN_SERVER                    */ DRing::Account::ConfProperties::TURN::SERVER,
+   /* TURN_SERVER_UNAME              */ DRing::Account::ConfProperties::TURN::SERVER_UNAME,
+   /* TURN_SERVER_PWD                */ DRing::Account::ConfProperties::TURN::SERVER_PWD,
+   /* TURN_SERVER_REALM              */ DRing::Account::ConfProperties::TURN::SERVER_REALM,
+   /* SRTP_ENABLED                   */ DRing::Account::ConfProperties::SRTP::ENABLED,
+   /* SRTP_KEY_EXCHANGE              */ DRing::Account::ConfProperties::SRTP::KEY_EXCHANGE,
+   /* SRTP_RTP_FALLBACK              */ DRing::Account::ConfProperties::SRTP::RTP_FALLBACK,
+   /* TLS_ENABLED                    */ DRing::Account::ConfProperties::TLS::ENABLED,
+   /* TLS_LISTENER_PORT              */ DRing::Account::ConfProperties::TLS::LISTENER_PORT,
+   /* TLS_CA_LIST_FILE               */ DRing::Account::ConfProperties::TLS::CA_LIST_FILE,
+   /* TLS_CERTIFICATE_FILE           */ DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE,
+   /* TLS_PRIVATE_KEY_FILE           */ DRing::Account::ConfProperties::TLS::PRIVATE_KEY_FILE,
+   /* TLS_PASSWORD                   */ DRing::Account::ConfProperties::TLS::PASSWORD,
+   /* TLS_METHOD                     */ DRing::Account::ConfProperties::TLS::METHOD,
+   /* TLS_CIPHERS                    */ DRing::Account::ConfProperties::TLS::CIPHERS,
+   /* TLS_SERVER_NAME                */ DRing::Account::ConfProperties::TLS::SERVER_NAME,
+   /* TLS_VERIFY_SERVER              */ DRing::Account::ConfProperties::TLS::VERIFY_SERVER,
+   /* TLS_VERIFY_CLIENT              */ DRing::Account::ConfProperties::TLS::VERIFY_CLIENT,
+   /* TLS_REQUIRE_CLIENT_CERTIFICATE */ DRing::Account::ConfProperties::TLS::REQUIRE_CLIENT_CERTIFICATE,
+   /* TLS_NEGOTIATION_TIMEOUT_SEC    */ DRing::Account::ConfProperties::TLS::NEGOTIATION_TIMEOUT_SEC,
+   /* DHT_PORT                       */ DRing::Account::ConfProperties::DHT::PORT,
+   /* DHT_PUBLIC_IN_CALLS            */ DRing::Account::ConfProperties::DHT::PUBLIC_IN_CALLS,}};
+
+const QString& AccountDetails::value(Property p) const
+{
+   static const QString empty;
+   const Slot& s = m_lSlots[static_cast<int>(p)];
+   return s.isSet ? s.value : empty;
+}
+
+bool AccountDetails::toBool(Property p) const
+{
+   return m_lSlots[static_cast<int>(p)].isTrue;
+}
+
+int AccountDetails::toInt(Property p) const
+{
+   return m_lSlots[static_cast<int>(p)].number;
+}
+
+bool AccountDetails::contains(Property p) const
+{
+   return m_lSlots[static_cast<int>(p)].isSet;
+}
+
+QString AccountDetails::value(const QString& key) const
+{
+   const Property p = property(key);
+
+   return p == Property::COUNT__ ? m_hOther.value(key) : value(p);
+}
+
+bool AccountDetails::contains(const QString& key) const
+{
+   const Property p = property(key);
+
+   return p == Property::COUNT__ ? m_hOther.contains(key) : contains(p);
+}
+
+int AccountDetails::size() const
+{
+   return m_Count + m_hOther.size();
+}
+
+bool AccountDetails::isEmpty() const
+{
+   return !size();
+}
+
+///Convert back to the daemon format
+MapStringString AccountDetails::toMap() const
+{
+   MapStringString ret;
+
+   for (int i = 0; i < enum_class_size<Property>(); i++) {
+      if (m_lSlots[i].isSet)
+         ret[propertyNames[static_cast<Property>(i)]] = m_lSlots[i].value;
+   }
+
+   for (auto i = m_hOther.constBegin(); i != m_hOther.constEnd(); ++i)
+      ret[i.key()] = i.value();
+
+   return ret;
+}
+
+///Set a known property, the typed values are parsed once here
+void AccountDetails::setValue(Property p, const QString& value)
+{
+   Slot& s = m_lSlots[static_cast<int>(p)];
+
+   if (!s.isSet)
+      m_Count++;
+
+   s.value  = value;
+   s.number = value.toInt();
+   s.isTrue = value == QLatin1String("true");
+   s.isSet  = true;
+}
+
+void AccountDetails::setValue(const QString& key, const QString& value)
+{
+   const Property p = property(key);
+
+   if (p == Property::COUNT__)
+      m_hOther[key] = value;
+   else
+      setValue(p, value);
+}
+
+///Replace all details with the ones sent by the daemon
+void AccountDetails::fromMap(const MapStringString& details)
+{
+   clear();
+
+   for (auto i = details.constBegin(); i != details.constEnd(); ++i)
+      setValue(i.key(), i.value());
+}
+
+void AccountDetails::clear()
+{
+   m_lSlots.fill(Slot());
+   m_hOther.clear();
+   m_Count = 0;
+}
+
+///Get the property for a daemon key, COUNT__ if it isn't a known property
+AccountDetails::Property AccountDetails::property(const QString& key)
+{
+   static const QHash<QString, Property> properties = [] {
+      QHash<QString, Property> ret;
+      for (int i = 0; i < enum_class_size<Property>(); i++)
+         ret[propertyNames[static_cast<Property>(i)]] = static_cast<Property>(i);
+      return ret;
+   }();
+
+   return properties.value(key, Property::COUNT__);
+}
+
+///Get the daemon key for a property
+const char* AccountDetails::key(Property p)
+{
+   return propertyNames[p];
+}
@@ -0,0 +1,140 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QString>
+#include <QtCore/QHash>
+
+//Ring
+#include <typedefs.h>
+
+// Std
+#include <array>
+
+/**
+ * Typed storage for the account details.
+ *
+ * The daemon send and receive the details as a string map. Looking up those
+ * strings (and parsing "true" or numbers) for every getter is wasteful, as
+ * the account views call them for each role of each row. The known
+ * properties are stored in a dense array indexed by Property and their
+ * boolean and integer forms are parsed once, when the value is set. Unknown
+ * keys go to an overflow map so nothing is lost on the way back.
+ *
+ * Only convert from and to MapStringString at the daemon boundary.
+ */
+class AccountDetails final
+{
+public:
+   enum class Property {
+      ALIAS,
+      TYPE,
+      ENABLED,
+      DISPLAYNAME,
+      USERNAME,
+      HOSTNAME,
+      MAILBOX,
+      ROUTE,
+      AUTOANSWER,
+      ACTIVE_CALL_LIMIT,
+      DTMF_TYPE,
+      LOCAL_INTERFACE,
+      LOCAL_PORT,
+      PUBLISHED_SAMEAS_LOCAL,
+      PUBLISHED_ADDRESS,
+      PUBLISHED_PORT,
+      UPNP_ENABLED,
+      HAS_CUSTOM_USER_AGENT,
+      USER_AGENT,
+      ALLOW_CERT_FROM_HISTORY,
+      ALLOW_CERT_FROM_CONTACT,
+      REGISTRATION_EXPIRE,
+      REGISTRATION_STATUS,
+      RINGTONE_ENABLED,
+      RINGTONE_PATH,
+      PRESENCE_ENABLED,
+      PRESENCE_SUPPORT_PUBLISH,
+      PRESENCE_SUPPORT_SUBSCRIBE,
+      AUDIO_PORT_MIN,
+      AUDIO_PORT_MAX,
+      VIDEO_ENABLED,
+      VIDEO_PORT_MIN,
+      VIDEO_PORT_MAX,
+      STUN_ENABLED,
+      STUN_SERVER,
+      TURN_ENABLED,
+      TURN_SERVER,
+      TURN_SERVER_UNAME,
+      TURN_SERVER_PWD,
+      TURN_SERVER_REALM,
+      SRTP_ENABLED,
+      SRTP_KEY_EXCHANGE,
+      SRTP_RTP_FALLBACK,
+      TLS_ENABLED,
+      TLS_LISTENER_PORT,
+      TLS_CA_LIST_FILE,
+      TLS_CERTIFICATE_FILE,
+      TLS_PRIVATE_KEY_FILE,
+      TLS_PASSWORD,
+      TLS_METHOD,
+      TLS_CIPHERS,
+      TLS_SERVER_NAME,
+      TLS_VERIFY_SERVER,
+      TLS_VERIFY_CLIENT,
+      TLS_REQUIRE_CLIENT_CERTIFICATE,
+      TLS_NEGOTIATION_TIMEOUT_SEC,
+      DHT_PORT,
+      DHT_PUBLIC_IN_CALLS,
+      COUNT__
+   };
+
+   //Getters
+   const QString& value   (Property p        ) const;
+   bool           toBool  (Property p        ) const;
+   int            toInt   (Property p        ) const;
+   bool           contains(Property p        ) const;
+   QString        value   (const QString& key) const;
+   bool           contains(const QString& key) const;
+   int            size    (                  ) const;
+   bool           isEmpty (                  ) const;
+   MapStringString toMap  (                  ) const;
+
+   //Setters
+   void setValue(Property p        , const QString& value);
+   void setValue(const QString& key, const QString& value);
+   void fromMap (const MapStringString& details          );
+   void clear   (                                        );
+
+   //Helpers
+   static Property    property(const QString& key);
+   static const char* key     (Property p        );
+
+private:
+   struct Slot {
+      QString value           ;
+      int     number  { 0     };
+      bool    isSet   { false };
+      bool    isTrue  { false };
+   };
+
+   //Attributes
+   std::array<Slot, enum_class_size<Property>()> m_lSlots ;
+   QHash<QString,QString>                        m_hOther ;
+   int                                           m_Count {0};
+};
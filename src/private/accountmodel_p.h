@@ -25,6 +25,7 @@
 #include <account.h>
 #include <accountmodel.h>
 #include "matrixutils.h"
+#include "eventcoalescer.h"
 class AccountModel;
 class ProtocolModel;
 class QItemSelectionModel;
@@ -41,11 +42,22 @@ public:
    explicit AccountModelPrivate(AccountModel* parent);
    void init();
 
+   ///A registration state change, as sent by the daemon
+   struct RegistrationEvent {
+      QString  state ;
+      unsigned code  ;
+      QString  status;
+   };
+
    //Helpers
    static Account::RegistrationState fromDaemonName(const QString& st);
    void enableProtocol(Account::Protocol proto);
    AccountModel::EditState convertAccountEditState(const Account::EditState s);
    void insertAccount(Account* a, int idx);
+   void addMissingAccounts();
+   QStringList newAccountIds(const QStringList& accountIds) const;
+   void addAccounts(const QStringList& accountIds, const QStringList& newIds, const QVector<MapStringString>& details);
+   void processRegistrationEvents(const EventCoalescer<QString, RegistrationEvent>::Batch& events);
 
    //Attributes
    AccountModel*                     q_ptr                ;
@@ -59,6 +71,7 @@ public:
    QList<Account*>                   m_lSipAccounts       ;
    QList<Account*>                   m_lRingAccounts      ;
    Matrix1D<Account::Protocol, bool> m_lSupportedProtocols;
+   EventCoalescer<QString, RegistrationEvent> m_RegistrationEvents;
 
    //Future account cache
    static QHash<QByteArray,AccountPlaceHolder*> m_hsPlaceHolder;
@@ -0,0 +1,58 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "asyncrequest.h"
+
+//Qt
+#include <QtCore/QThreadPool>
+
+/**
+ * Some requests can take a while, keep them away from the global pool.
+ *
+ * A single thread is used so the replies are delivered in the same order as
+ * the requests, like with D-Bus.
+ */
+static QThreadPool* pool()
+{
+   static QThreadPool* p = []() {
+      auto ret = new QThreadPool();
+      ret->setMaxThreadCount(1);
+      return ret;
+   }();
+
+   return p;
+}
+
+void AsyncRequest::Private::start(Job* job)
+{
+   pool()->start(job);
+}
+
+AsyncRequest::Private::Delivery::Delivery(QObject* context) : QObject(nullptr)
+{
+   moveToThread(context->thread());
+
+   connect(this, &Delivery::ready, context, [this]() { m_Function(); });
+   connect(this, &Delivery::ready, this   , &QObject::deleteLater    );
+}
+
+///Called once, from the request thread
+void AsyncRequest::Private::Delivery::deliver(std::function<void()> f)
+{
+   m_Function = f;
+   emit ready();
+}
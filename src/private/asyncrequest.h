@@ -0,0 +1,295 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QRunnable>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+#include <QtCore/QDebug>
+
+#if !defined(ENABLE_LIBWRAP) && !defined(ENABLE_FAKEDAEMON)
+ #include <QtDBus/QDBusPendingReply>
+ #include <QtDBus/QDBusPendingCallWatcher>
+#endif
+
+// Std
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <utility>
+
+//Ring
+#ifdef ENABLE_IPC_STATS
+ #include "qtwrapper/ipcstats.h"
+#endif
+
+/**
+ * Send requests to the daemon without blocking the calling thread.
+ *
+ * The requests are lambdas calling one of the CallManager,
+ * ConfigurationManager, VideoManager or PresenceManager methods:
+ *
+ * @code
+ * AsyncRequest::call(this, [id]() {
+ *    return ConfigurationManager::instance().getVolatileAccountDetails(id);
+ * }, [this, id](const MapStringString& details) {
+ *    slotVolatileAccountDetailsChange(id, details);
+ * });
+ * @endcode
+ *
+ * With D-Bus, the request returns a QDBusPendingReply and nothing blocks
+ * until the reply is used. With libwrap, the request is executed by a worker
+ * thread. In both cases, the callbacks are called in the request order.
+ */
+namespace AsyncRequest {
+
+///The value of a reply, the reply itself when it isn't a pending one
+template<typename T>
+struct Value { typedef T type; };
+
+#if !defined(ENABLE_LIBWRAP) && !defined(ENABLE_FAKEDAEMON)
+template<typename T>
+struct Value<QDBusPendingReply<T>> { typedef T type; };
+#endif
+
+namespace Private {
+
+///Run a function in one of the request threads
+class Job final : public QRunnable
+{
+public:
+   explicit Job(std::function<void()> f) : m_Function(f) {}
+   virtual void run() override { m_Function(); }
+
+private:
+   std::function<void()> m_Function;
+};
+
+void start(Job* job);
+
+#if !defined(ENABLE_LIBWRAP) && !defined(ENABLE_FAKEDAEMON)
+/**
+ * Time a D-Bus request from when it is sent until its reply is delivered,
+ * see IpcStats. The libwrap calls are recorded by the wrappers.
+ */
+template<typename Request>
+class ReplyTimer final
+{
+public:
+#ifdef ENABLE_IPC_STATS
+   void done() const {
+      // The reply doesn't name the method, use the function sending it
+      static const IpcStats::Site site = IpcStats::site(__PRETTY_FUNCTION__);
+
+      IpcStats::record(IpcStats::Kind::CALL, site.interfaceName.constData(),
+         site.name.constData(), m_Start);
+   }
+
+private:
+   std::chrono::steady_clock::time_point m_Start {std::chrono::steady_clock::now()};
+#else
+   void done() const {}
+#endif
+};
+#endif
+
+/**
+ * Call a function from the thread of "context", the function is discarded
+ * if the context is destroyed first.
+ */
+class Delivery final : public QObject
+{
+   Q_OBJECT
+public:
+   explicit Delivery(QObject* context);
+
+   void deliver(std::function<void()> f);
+
+Q_SIGNALS:
+   void ready();
+
+private:
+   std::function<void()> m_Function;
+};
+
+} // namespace Private
+
+/**
+ * Execute "request" and call "callback" with its result in the thread of
+ * "context". The callback is never called if the context is destroyed
+ * first.
+ */
+template<typename Request, typename Callback>
+void call(QObject* context, Request request, Callback callback)
+{
+#if defined(ENABLE_LIBWRAP) || defined(ENABLE_FAKEDAEMON)
+   auto delivery = new Private::Delivery(context);
+
+   Private::start(new Private::Job([request, callback, delivery]() {
+      const auto result = request();
+      delivery->deliver([callback, result]() { callback(result); });
+   }));
+#else
+   typedef decltype(request()) Reply;
+
+   const Private::ReplyTimer<Request> timer {};
+
+   auto watcher = new QDBusPendingCallWatcher(request(), context);
+
+   QObject::connect(watcher, &QDBusPendingCallWatcher::finished, context,
+      [callback, timer](QDBusPendingCallWatcher* w) {
+         timer.done();
+
+         const Reply reply = *w;
+
+         if (reply.isError())
+            qWarning() << "Request to the daemon failed" << reply.error().message();
+
+         callback(reply.value());
+         w->deleteLater();
+   });
+#endif
+}
+
+/**
+ * Send a request for each of the "keys" at once and call "callback" with
+ * all the results, in the same order as the keys, in the thread of
+ * "context". The callback is never called if the context is destroyed
+ * first.
+ *
+ * @code
+ * AsyncRequest::collect(this, ids, [](const QString& id) {
+ *    return ConfigurationManager::instance().getAccountDetails(id);
+ * }, [this, ids](const QVector<MapStringString>& details) {
+ *    ...
+ * });
+ * @endcode
+ */
+template<typename Request, typename Callback>
+void collect(QObject* context, const QStringList& keys, Request request, Callback callback)
+{
+   typedef decltype(request(QString())) Reply;
+   typedef typename Value<Reply>::type  Result;
+
+#if defined(ENABLE_LIBWRAP) || defined(ENABLE_FAKEDAEMON)
+   auto delivery = new Private::Delivery(context);
+
+   Private::start(new Private::Job([keys, request, callback, delivery]() {
+      QVector<Result> results;
+      results.reserve(keys.size());
+
+      for (const QString& key : keys)
+         results << request(key);
+
+      delivery->deliver([callback, results]() { callback(results); });
+   }));
+#else
+   const Private::ReplyTimer<Request> timer {};
+
+   auto replies = std::make_shared<QVector<Reply>>();
+   replies->reserve(keys.size());
+
+   // Send them all before waiting for any reply
+   for (const QString& key : keys)
+      *replies << request(key);
+
+   const auto finish = [replies, callback]() {
+      QVector<Result> results;
+      results.reserve(replies->size());
+
+      for (const Reply& reply : *replies) {
+         if (reply.isError())
+            qWarning() << "Request to the daemon failed" << reply.error().message();
+
+         results << reply.value();
+      }
+
+      callback(results);
+   };
+
+   // Still asynchronous, like when there are replies to wait for
+   if (replies->isEmpty()) {
+      QTimer::singleShot(0, context, finish);
+      return;
+   }
+
+   auto pending = std::make_shared<int>(replies->size());
+
+   for (const Reply& reply : *replies) {
+      auto watcher = new QDBusPendingCallWatcher(reply, context);
+
+      QObject::connect(watcher, &QDBusPendingCallWatcher::finished, context,
+         [pending, finish, timer](QDBusPendingCallWatcher* w) {
+            timer.done();
+            w->deleteLater();
+
+            if (!--*pending)
+               finish();
+      });
+   }
+#endif
+}
+
+/**
+ * Send a request for each of the "keys" at once, then wait for all the
+ * results.
+ *
+ * This blocks, but the requests are pipelined rather than waiting for each
+ * reply before sending the next request. Use the asynchronous version
+ * unless the results are needed before returning.
+ *
+ * @return the results, in the same order as the keys
+ */
+template<typename Request>
+auto collect(const QStringList& keys, Request request)
+   -> QVector<typename Value<decltype(request(QString()))>::type>
+{
+   QVector<typename Value<decltype(request(QString()))>::type> ret;
+   ret.reserve(keys.size());
+
+#if defined(ENABLE_LIBWRAP) || defined(ENABLE_FAKEDAEMON)
+   // There is no round trip to save, it is a function call
+   for (const QString& key : keys)
+      ret << request(key);
+#else
+   const Private::ReplyTimer<Request> timer {};
+
+   QVector<decltype(request(QString()))> replies;
+   replies.reserve(keys.size());
+
+   for (const QString& key : keys)
+      replies << request(key);
+
+   for (auto& reply : replies) {
+      reply.waitForFinished();
+      timer.done();
+
+      if (reply.isError())
+         qWarning() << "Request to the daemon failed" << reply.error().message();
+
+      ret << reply.value();
+   }
+#endif
+
+   return ret;
+}
+
+} // namespace AsyncRequest
@@ -234,6 +234,7 @@ public:
    void removeRenderer(Video::Renderer* renderer);
    void setRecordingPath(const QString& path);
    static MapStringString getCallDetailsCommon(const QString& callId);
+   static MapStringString getCallDetailsCommon(MapStringString details);
    void peerHoldChanged(bool onPeerHold);
    template<typename T>
    T* mediaFactory(Media::Media::Direction dir);
@@ -246,12 +247,15 @@ public:
    static Call* buildDialingCall  (const QString & peerName, Account* account = nullptr, Call* parent = nullptr );
    static Call* buildIncomingCall (const QString& callId                                );
    static Call* buildExistingCall (const QString& callId                                );
+   static Call* buildExistingCall (const QString& callId, const MapStringString& details);
 
 private:
     Call* q_ptr;
 
     //Constructor helper
     static Call* buildCall(const QString& callId, Call::Direction callDirection, Call::State startState);
+    static Call* buildCall(const QString& callId, Call::Direction callDirection, Call::State startState,
+                           const MapStringString& details);
 
     //Destructor helper (~Call is private, CallPrivate is a friend class)
     static void deleteCall(Call* call);
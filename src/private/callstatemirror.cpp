@@ -0,0 +1,519 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "callstatemirror.h"
+
+//Qt
+#include <QtCore/QDebug>
+#include <QtCore/QSet>
+
+//Ring
+#include <call_const.h>
+#include "dbus/callmanager.h"
+#include "private/asyncrequest.h"
+#include "private/call_p.h"
+
+///How often the mirror is compared with the daemon
+static constexpr const int CHECK_INTERVAL     = 30000;
+
+///How long to wait after a conference change before comparing
+static constexpr const int FOLLOW_UP_INTERVAL = 1000 ;
+
+///The daemon lists, as fetched by fetch()
+struct CallStateMirror::Snapshot {
+   QStringList                     calls       ;
+   QHash<QString, MapStringString> details     ;
+   QStringList                     conferences ;
+   QHash<QString, QStringList>     participants;
+   QHash<QString, QString>         states      ; // conference id -> state
+   int                             pending {0} ;
+   uint                            revision{0} ;
+};
+
+CallStateMirror& CallStateMirror::instance()
+{
+   static auto instance = new CallStateMirror();
+   return *instance;
+}
+
+CallStateMirror::CallStateMirror() : QObject()
+{
+   CallManagerInterface& callManager = CallManager::instance();
+
+   connect(&callManager, &CallManagerInterface::callStateChanged , this, &CallStateMirror::slotCallStateChanged );
+   connect(&callManager, &CallManagerInterface::incomingCall     , this, &CallStateMirror::slotNewCall          );
+   connect(&callManager, &CallManagerInterface::newCallCreated   , this, &CallStateMirror::slotNewCall          );
+   connect(&callManager, &CallManagerInterface::conferenceCreated, this, &CallStateMirror::slotConferenceCreated);
+   connect(&callManager, &CallManagerInterface::conferenceChanged, this, &CallStateMirror::slotConferenceChanged);
+   connect(&callManager, &CallManagerInterface::conferenceRemoved, this, &CallStateMirror::slotConferenceRemoved);
+
+   reload();
+
+   m_CheckTimer.setInterval(CHECK_INTERVAL);
+   connect(&m_CheckTimer, &QTimer::timeout, this, &CallStateMirror::checkConsistency);
+   m_CheckTimer.start();
+
+   m_FollowUpTimer.setSingleShot(true);
+   m_FollowUpTimer.setInterval(FOLLOW_UP_INTERVAL);
+   connect(&m_FollowUpTimer, &QTimer::timeout, this, &CallStateMirror::checkConsistency);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Getters                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+///The calls, in the order they were seen, without the INACTIVE ones
+QStringList CallStateMirror::calls() const
+{
+   QStringList ret;
+   ret.reserve(m_lCalls.size());
+
+   for (const QString& callId : m_lCalls) {
+      if (m_hCalls[callId][DRing::Call::Details::CALL_STATE] != DRing::Call::StateEvent::INACTIVE)
+         ret << callId;
+   }
+
+   return ret;
+}
+
+bool CallStateMirror::hasCall(const QString& callId) const
+{
+   return m_hCalls.contains(callId);
+}
+
+MapStringString CallStateMirror::details(const QString& callId) const
+{
+   return m_hCalls.value(callId);
+}
+
+QString CallStateMirror::state(const QString& callId) const
+{
+   return m_hCalls.value(callId).value(DRing::Call::Details::CALL_STATE);
+}
+
+QString CallStateMirror::conferenceId(const QString& callId) const
+{
+   return m_hCalls.value(callId).value(DRing::Call::Details::CONF_ID);
+}
+
+///If the daemon lists were fetched, the mirror is empty until then
+bool CallStateMirror::isLoaded() const
+{
+   return m_IsLoaded;
+}
+
+QStringList CallStateMirror::conferences() const
+{
+   return m_lConferences;
+}
+
+bool CallStateMirror::hasConference(const QString& confId) const
+{
+   return m_hConferences.contains(confId);
+}
+
+QStringList CallStateMirror::participants(const QString& confId) const
+{
+   return m_hConferences.value(confId).participants;
+}
+
+QString CallStateMirror::conferenceState(const QString& confId) const
+{
+   return m_hConferences.value(confId).state;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Helpers                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+///Fetch everything once, without blocking, loaded() is emitted when done
+void CallStateMirror::reload()
+{
+   fetch([this](const Snapshot& snapshot) {
+      // The signals received in the meantime are more recent
+      for (const QString& callId : snapshot.calls) {
+         if (m_hRevisions.value(callId) <= snapshot.revision)
+            addCall(callId, snapshot.details[callId]);
+      }
+
+      for (const QString& confId : snapshot.conferences) {
+         if (m_hRevisions.value(confId) <= snapshot.revision) {
+            setParticipants(confId, snapshot.participants[confId]);
+            m_hConferences[confId].state = snapshot.states[confId];
+         }
+      }
+
+      m_IsLoaded = true;
+      emit loaded();
+   });
+}
+
+/**
+ * Fetch the daemon lists without blocking, then call "done" with them.
+ *
+ * Only one snapshot is fetched at a time, see m_pCheck.
+ */
+void CallStateMirror::fetch(const std::function<void(const Snapshot&)>& done)
+{
+   // Only the changes made after this snapshot matter
+   m_hRevisions.clear();
+
+   m_pCheck = std::make_shared<Snapshot>();
+   m_pCheck->revision = m_Revision;
+   m_pCheck->pending  = 2;
+
+   const std::shared_ptr<Snapshot> snapshot = m_pCheck;
+
+   const auto finish = [this, snapshot, done]() {
+      if (--snapshot->pending)
+         return;
+
+      m_pCheck.reset();
+      done(*snapshot);
+   };
+
+   AsyncRequest::call(this, []() {
+      return CallManager::instance().getCallList();
+   }, [this, snapshot, finish](const QStringList& callList) {
+      snapshot->calls = callList;
+
+      AsyncRequest::collect(this, callList, [](const QString& callId) {
+         return CallManager::instance().getCallDetails(callId);
+      }, [snapshot, finish, callList](const QVector<MapStringString>& details) {
+         for (int i = 0; i < callList.size(); i++)
+            snapshot->details[callList[i]] = details[i];
+
+         finish();
+      });
+   });
+
+   AsyncRequest::call(this, []() {
+      return CallManager::instance().getConferenceList();
+   }, [this, snapshot, finish](const QStringList& confList) {
+      snapshot->conferences = confList;
+      snapshot->pending++;
+
+      AsyncRequest::collect(this, confList, [](const QString& confId) {
+         return CallManager::instance().getParticipantList(confId);
+      }, [snapshot, finish, confList](const QVector<QStringList>& participants) {
+         for (int i = 0; i < confList.size(); i++)
+            snapshot->participants[confList[i]] = participants[i];
+
+         finish();
+      });
+
+      AsyncRequest::collect(this, confList, [](const QString& confId) {
+         return CallManager::instance().getConferenceDetails(confId);
+      }, [snapshot, finish, confList](const QVector<MapStringString>& details) {
+         for (int i = 0; i < confList.size(); i++)
+            snapshot->states[confList[i]] = details[i][CallPrivate::ConfDetailsMapFields::CONF_STATE];
+
+         finish();
+      });
+   });
+}
+
+void CallStateMirror::addCall(const QString& callId, const MapStringString& details)
+{
+   if (!m_hCalls.contains(callId))
+      m_lCalls << callId;
+
+   m_hCalls[callId] = details;
+}
+
+void CallStateMirror::removeCall(const QString& callId)
+{
+   const QString confId = conferenceId(callId);
+
+   if (!confId.isEmpty() && m_hConferences.contains(confId))
+      m_hConferences[confId].participants.removeAll(callId);
+
+   m_hCalls.remove(callId);
+   m_lCalls.removeAll(callId);
+}
+
+///Replace the participants and update their conference id
+void CallStateMirror::setParticipants(const QString& confId, const QStringList& callIds)
+{
+   if (!m_hConferences.contains(confId))
+      m_lConferences << confId;
+
+   Conference& conf = m_hConferences[confId];
+
+   for (const QString& callId : conf.participants) {
+      auto it = m_hCalls.find(callId);
+      if (it != m_hCalls.end() && (*it)[DRing::Call::Details::CONF_ID] == confId)
+         it->remove(DRing::Call::Details::CONF_ID);
+   }
+
+   for (const QString& callId : callIds) {
+      auto it = m_hCalls.find(callId);
+      if (it != m_hCalls.end())
+         (*it)[DRing::Call::Details::CONF_ID] = confId;
+   }
+
+   conf.participants = callIds;
+}
+
+void CallStateMirror::removeConference(const QString& confId)
+{
+   setParticipants(confId, {});
+   m_hConferences.remove(confId);
+   m_lConferences.removeAll(confId);
+}
+
+///A signal changed this call or conference
+void CallStateMirror::touch(const QString& id)
+{
+   m_hRevisions[id] = ++m_Revision;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                             Consistency check                             *
+ *                                                                           *
+ ****************************************************************************/
+
+/**
+ * Fetch the daemon lists without blocking and compare them with the mirror.
+ *
+ * The calls and conferences changed by a signal before the check is done
+ * are skipped, they are checked again later.
+ */
+void CallStateMirror::checkConsistency()
+{
+   // One at a time
+   if (m_pCheck)
+      return;
+
+   m_FollowUpTimer.stop();
+
+   fetch([this](const Snapshot& snapshot) {
+      compare(snapshot);
+   });
+}
+
+///Make the mirror match the daemon
+void CallStateMirror::compare(const Snapshot& snapshot)
+{
+   QSet<QString> diverged;
+   bool          skipped = false;
+
+   // The signals received after the snapshot are more recent than it
+   const auto isOutdated = [this, &snapshot, &skipped](const QString& id) {
+      const bool ret = m_hRevisions.value(id) > snapshot.revision;
+      skipped |= ret;
+      return ret;
+   };
+
+   const QSet<QString> daemonCalls = snapshot.calls.toSet();
+
+   for (const QString& callId : QStringList(m_lCalls)) {
+      if (isOutdated(callId))
+         continue;
+
+      if (!daemonCalls.contains(callId)) {
+         qWarning() << "Call" << callId << "is gone from the daemon";
+         const QString confId = conferenceId(callId);
+         if (!confId.isEmpty())
+            diverged << confId;
+         removeCall(callId);
+      }
+   }
+
+   for (const QString& callId : snapshot.calls) {
+      if (isOutdated(callId))
+         continue;
+
+      const MapStringString& details = snapshot.details[callId];
+
+      if (!m_hCalls.contains(callId)) {
+         qWarning() << "Call" << callId << "was missing from the mirror";
+         addCall(callId, details);
+         continue;
+      }
+
+      MapStringString& local = m_hCalls[callId];
+
+      if (local[DRing::Call::Details::CALL_STATE] != details[DRing::Call::Details::CALL_STATE]) {
+         qWarning() << "Call" << callId << "state mismatch" << local[DRing::Call::Details::CALL_STATE]
+            << details[DRing::Call::Details::CALL_STATE];
+         local[DRing::Call::Details::CALL_STATE] = details[DRing::Call::Details::CALL_STATE];
+      }
+   }
+
+   const QSet<QString> daemonConfs = snapshot.conferences.toSet();
+
+   for (const QString& confId : QStringList(m_lConferences)) {
+      if (isOutdated(confId))
+         continue;
+
+      if (!daemonConfs.contains(confId)) {
+         qWarning() << "Conference" << confId << "is gone from the daemon";
+         removeConference(confId);
+         diverged << confId;
+      }
+   }
+
+   for (const QString& confId : snapshot.conferences) {
+      if (isOutdated(confId))
+         continue;
+
+      const QStringList& participants = snapshot.participants[confId];
+
+      if ((!m_hConferences.contains(confId))
+       || m_hConferences[confId].participants.toSet() != participants.toSet()) {
+         qWarning() << "Conference" << confId << "participants mismatch";
+         setParticipants(confId, participants);
+         diverged << confId;
+      }
+   }
+
+   for (const QString& confId : diverged)
+      emit conferenceDiverged(confId);
+
+   // Check the skipped ones once they settle
+   if (skipped)
+      m_FollowUpTimer.start();
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   Slots                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+void CallStateMirror::slotCallStateChanged(const QString& callId, const QString& state, int code)
+{
+   Q_UNUSED(code)
+   touch(callId);
+
+   if (state == DRing::Call::StateEvent::HUNGUP || state == DRing::Call::StateEvent::OVER) {
+      removeCall(callId);
+      return;
+   }
+
+   // The details use CURRENT, there is no UNHOLD state
+   const QString detailState = state == DRing::Call::StateEvent::UNHOLD ?
+      QString(DRing::Call::StateEvent::CURRENT) : state;
+
+   if (m_hCalls.contains(callId)) {
+      m_hCalls[callId][DRing::Call::Details::CALL_STATE] = detailState;
+      return;
+   }
+
+   addCall(callId, {{DRing::Call::Details::CALL_STATE, detailState}});
+   slotNewCall({}, callId, {});
+}
+
+///Fill the details of a call seen for the first time
+void CallStateMirror::slotNewCall(const QString& accountId, const QString& callId, const QString& peer)
+{
+   touch(callId);
+
+   if (!m_hCalls.contains(callId)) {
+      addCall(callId, {
+         {DRing::Call::Details::ACCOUNTID  , accountId},
+         {DRing::Call::Details::PEER_NUMBER, peer     },
+      });
+   }
+
+   AsyncRequest::call(this, [callId]() {
+      return CallManager::instance().getCallDetails(callId);
+   }, [this, callId](const MapStringString& details) {
+      auto it = m_hCalls.find(callId);
+
+      // The signals are more recent than the details
+      if (it == m_hCalls.end())
+         return;
+
+      MapStringString merged = details;
+      for (const char* field : {DRing::Call::Details::CALL_STATE, DRing::Call::Details::CONF_ID}) {
+         if (it->contains(field))
+            merged[field] = (*it)[field];
+      }
+
+      *it = merged;
+   });
+}
+
+///The conference is known right away, its content once it is fetched
+void CallStateMirror::slotConferenceCreated(const QString& confId)
+{
+   touch(confId);
+
+   if (!m_hConferences.contains(confId))
+      setParticipants(confId, {});
+
+   AsyncRequest::call(this, [confId]() {
+      return CallManager::instance().getParticipantList(confId);
+   }, [this, confId](const QStringList& participants) {
+      // Removed in the meantime
+      if (!m_hConferences.contains(confId))
+         return;
+
+      touch(confId);
+      setParticipants(confId, participants);
+   });
+
+   AsyncRequest::call(this, [confId]() {
+      return CallManager::instance().getConferenceDetails(confId);
+   }, [this, confId](const MapStringString& details) {
+      if (!m_hConferences.contains(confId))
+         return;
+
+      touch(confId);
+      m_hConferences[confId].state = details[CallPrivate::ConfDetailsMapFields::CONF_STATE];
+
+      emit conferenceCreated(confId);
+   });
+}
+
+void CallStateMirror::slotConferenceChanged(const QString& confId, const QString& state)
+{
+   touch(confId);
+
+   if (!m_hConferences.contains(confId))
+      setParticipants(confId, {});
+
+   m_hConferences[confId].state = state;
+
+   // The signal does not say what changed, fetch the participants
+   AsyncRequest::call(this, [confId]() {
+      return CallManager::instance().getParticipantList(confId);
+   }, [this, confId, state](const QStringList& participants) {
+      if (!m_hConferences.contains(confId))
+         return;
+
+      touch(confId);
+      setParticipants(confId, participants);
+
+      emit conferenceChanged(confId, state);
+   });
+
+   m_FollowUpTimer.start();
+}
+
+void CallStateMirror::slotConferenceRemoved(const QString& confId)
+{
+   touch(confId);
+   removeConference(confId);
+}
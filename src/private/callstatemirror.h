@@ -0,0 +1,128 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+
+//Ring
+#include <typedefs.h>
+
+// Std
+#include <functional>
+#include <memory>
+
+/**
+ * A local copy of the daemon call and conference lists.
+ *
+ * The CallManager queries are round trips to the daemon. This mirror is
+ * filled once, without blocking, then kept up to date from the CallManager
+ * signals so the models can query it as often as they want. It connects to
+ * the signals when it is created, so it is updated before the slots
+ * connected later. loaded() is emitted once the initial lists are known.
+ *
+ * The conference participants are fetched without blocking when a
+ * conference is created or changes, the models are told with the
+ * conferenceCreated() and conferenceChanged() signals of the mirror once
+ * they are known.
+ *
+ * The daemon does not always send the signals it should, so the mirror is
+ * compared with the daemon in the background, periodically and after each
+ * conference change. The calls and conferences changed by a signal while
+ * the daemon lists were fetched are left for the next check. The other
+ * differences are fixed locally and reported with conferenceDiverged().
+ *
+ * The call details are the ones fetched when the call was first seen, only
+ * the state, conference and account fields are kept up to date.
+ */
+class CallStateMirror final : public QObject
+{
+   Q_OBJECT
+public:
+   static CallStateMirror& instance();
+
+   bool isLoaded() const;
+
+   //Calls
+   QStringList     calls      (                      ) const;
+   bool            hasCall    (const QString& callId ) const;
+   MapStringString details    (const QString& callId ) const;
+   QString         state      (const QString& callId ) const;
+   QString         conferenceId(const QString& callId) const;
+
+   //Conferences
+   QStringList     conferences     (                      ) const;
+   bool            hasConference   (const QString& confId ) const;
+   QStringList     participants    (const QString& confId ) const;
+   QString         conferenceState (const QString& confId ) const;
+
+   //Mutator
+   void checkConsistency();
+
+private:
+   explicit CallStateMirror();
+
+   struct Conference {
+      QString     state       ;
+      QStringList participants;
+   };
+
+   struct Snapshot;
+
+   //Attributes
+   QStringList                     m_lCalls       ;
+   QHash<QString, MapStringString> m_hCalls       ;
+   QStringList                     m_lConferences ;
+   QHash<QString, Conference>      m_hConferences ;
+   QTimer                          m_CheckTimer   ;
+   QTimer                          m_FollowUpTimer;
+   std::shared_ptr<Snapshot>       m_pCheck       ;
+   uint                            m_Revision {0} ;
+   bool                            m_IsLoaded {false};
+   QHash<QString, uint>            m_hRevisions   ; // call or conference id -> last signal revision
+
+   //Helpers
+   void reload          (                                                     );
+   void addCall         (const QString& callId, const MapStringString& details);
+   void removeCall      (const QString& callId                                );
+   void setParticipants (const QString& confId, const QStringList& callIds    );
+   void removeConference(const QString& confId                                );
+   void compare         (const Snapshot& snapshot                             );
+   void touch           (const QString& id                                    );
+   void fetch           (const std::function<void(const Snapshot&)>& done     );
+
+private Q_SLOTS:
+   void slotCallStateChanged  (const QString& callId, const QString& state, int code      );
+   void slotNewCall           (const QString& accountId, const QString& callId, const QString& peer);
+   void slotConferenceCreated (const QString& confId                                      );
+   void slotConferenceChanged (const QString& confId, const QString& state                );
+   void slotConferenceRemoved (const QString& confId                                      );
+
+Q_SIGNALS:
+   ///The initial daemon lists are known
+   void loaded();
+   ///The daemon has a different view of this conference, it has been fixed
+   void conferenceDiverged(const QString& confId);
+   ///A new conference participants and state are known
+   void conferenceCreated(const QString& confId);
+   ///The participants of a conference that changed are known
+   void conferenceChanged(const QString& confId, const QString& state);
+};
@@ -127,6 +127,11 @@ public:
    //Helpers
    void loadDetails(bool reload = false);
    void loadChecks (bool loadChecks = false);
+   void revalidateChecks();
+   bool isCacheable     () const;
+   QString   cacheKey        () const;
+   QDateTime modificationTime() const;
+   void setChecks(const MapStringString& checks);
 
    static Matrix1D<Certificate::Checks ,QString> m_slChecksName;
    static Matrix1D<Certificate::Checks ,QString> m_slChecksDescription;
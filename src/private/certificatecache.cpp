@@ -0,0 +1,263 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "certificatecache.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+//Ring daemon
+#include <security_const.h>
+
+static const quint32 CACHE_MAGIC   = 0x52434331;
+static const quint16 CACHE_VERSION = 1;
+
+///How long the details are kept, in seconds
+static constexpr const qint64 DETAILS_MAX_AGE       = 30 * 24 * 3600;
+
+///How long the checks can be used, in seconds
+static constexpr const qint64 CHECKS_MAX_AGE        = 7  * 24 * 3600;
+
+///When the checks are revalidated in the background, in seconds
+static constexpr const qint64 CHECKS_STALE_AGE      = 3600;
+
+///Time between two background revalidations, in milliseconds
+static constexpr const int    REVALIDATION_INTERVAL = 250;
+
+///Time between a change and writing the cache to disk, in milliseconds
+static constexpr const int    SAVE_DELAY            = 5000;
+
+CertificateCache& CertificateCache::instance()
+{
+   static auto instance = new CertificateCache();
+   return *instance;
+}
+
+CertificateCache::CertificateCache() : QObject(QCoreApplication::instance())
+{
+   m_SaveTimer.setSingleShot(true);
+   m_SaveTimer.setInterval(SAVE_DELAY);
+   connect(&m_SaveTimer, &QTimer::timeout, this, &CertificateCache::save);
+
+   m_WorkerTimer.setInterval(REVALIDATION_INTERVAL);
+   connect(&m_WorkerTimer, &QTimer::timeout, this, &CertificateCache::processJob);
+
+   // Don't lose the last changes
+   if (QCoreApplication::instance()) {
+      connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+         if (m_SaveTimer.isActive())
+            save();
+      });
+   }
+
+   load();
+}
+
+QString CertificateCache::fileName()
+{
+   return QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1String("/certificates.cache");
+}
+
+/**
+ * Look for a cached value.
+ *
+ * @param modified the certificate file modification time, if it has a path
+ * @param values   set to the cached values unless the status is MISSING
+ */
+CertificateCache::Status CertificateCache::find(const QString& key, Kind kind, const QDateTime& modified, MapStringString& values)
+{
+   auto it = m_hEntries.find(key);
+
+   if (it == m_hEntries.end())
+      return Status::MISSING;
+
+   // The file has been replaced
+   if (it->modified != modified) {
+      m_hEntries.erase(it);
+      m_SaveTimer.start();
+      return Status::MISSING;
+   }
+
+   const QDateTime& fetched = it->fetched[static_cast<int>(kind)];
+
+   if (!fetched.isValid())
+      return Status::MISSING;
+
+   const qint64 age    = fetched.secsTo(QDateTime::currentDateTimeUtc());
+   const qint64 maxAge = kind == Kind::DETAILS ? DETAILS_MAX_AGE : CHECKS_MAX_AGE;
+
+   // The clock can go backward
+   if (age < 0 || age > maxAge)
+      return Status::MISSING;
+
+   values = it->values[static_cast<int>(kind)];
+
+   return (kind == Kind::CHECKS && age > CHECKS_STALE_AGE) ? Status::STALE : Status::FRESH;
+}
+
+/**
+ * Add or replace a value fetched from the daemon.
+ *
+ * @return if the values differ from the cached ones
+ */
+bool CertificateCache::insert(const QString& key, Kind kind, const QDateTime& modified, const MapStringString& values)
+{
+   Entry& entry = m_hEntries[key];
+
+   if (entry.modified != modified)
+      entry = Entry();
+
+   entry.modified = modified;
+
+   // Another certificate with the same path or id, the checks are not its
+   if (kind == Kind::DETAILS) {
+      const QByteArray fingerprint = values[DRing::Certificate::DetailsNames::SHA1_FINGERPRINT].toLatin1();
+
+      if ((!entry.fingerprint.isEmpty()) && entry.fingerprint != fingerprint) {
+         entry.fetched[static_cast<int>(Kind::CHECKS)] = QDateTime();
+         entry.values [static_cast<int>(Kind::CHECKS)].clear();
+      }
+
+      entry.fingerprint = fingerprint;
+   }
+
+   const bool changed = entry.values[static_cast<int>(kind)] != values;
+
+   entry.fetched[static_cast<int>(kind)] = QDateTime::currentDateTimeUtc();
+   entry.values [static_cast<int>(kind)] = values;
+
+   m_SaveTimer.start();
+
+   return changed;
+}
+
+/**
+ * Run "job" later, one job at a time, so the revalidations don't compete
+ * with the requests the user is waiting for. The job is dropped if the
+ * context is destroyed first.
+ */
+void CertificateCache::revalidate(QObject* context, std::function<void()> job)
+{
+   m_lJobs.enqueue({context, job});
+
+   if (!m_WorkerTimer.isActive())
+      m_WorkerTimer.start();
+}
+
+void CertificateCache::processJob()
+{
+   while (!m_lJobs.isEmpty()) {
+      const Job job = m_lJobs.dequeue();
+
+      if (job.context) {
+         job.function();
+         break;
+      }
+   }
+
+   if (m_lJobs.isEmpty())
+      m_WorkerTimer.stop();
+}
+
+void CertificateCache::load()
+{
+   QFile file(fileName());
+
+   if (!file.open(QIODevice::ReadOnly))
+      return;
+
+   QDataStream stream(&file);
+   stream.setVersion(QDataStream::Qt_5_0);
+
+   quint32 magic   = 0;
+   quint16 version = 0;
+   quint32 count   = 0;
+   stream >> magic >> version >> count;
+
+   // An older or newer format, it will be rebuilt
+   if (stream.status() != QDataStream::Ok || magic != CACHE_MAGIC || version != CACHE_VERSION)
+      return;
+
+   for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+      QString key;
+      Entry   entry;
+
+      stream >> key >> entry.modified >> entry.fingerprint;
+
+      for (int k = 0; k < enum_class_size<Kind>(); k++)
+         stream >> entry.fetched[k] >> entry.values[k];
+
+      if (stream.status() == QDataStream::Ok)
+         m_hEntries[key] = entry;
+   }
+
+   if (stream.status() != QDataStream::Ok) {
+      qWarning() << "The certificate cache" << file.fileName() << "is corrupted";
+      m_hEntries.clear();
+   }
+}
+
+///Write the cache, without the expired entries
+void CertificateCache::save()
+{
+   m_SaveTimer.stop();
+
+   const QDateTime now = QDateTime::currentDateTimeUtc();
+
+   for (auto it = m_hEntries.begin(); it != m_hEntries.end();) {
+      const QDateTime& details = it->fetched[static_cast<int>(Kind::DETAILS)];
+      const QDateTime& checks  = it->fetched[static_cast<int>(Kind::CHECKS )];
+
+      const bool expired = (!details.isValid() || details.secsTo(now) > DETAILS_MAX_AGE)
+                        && (!checks .isValid() || checks .secsTo(now) > CHECKS_MAX_AGE );
+
+      if (expired)
+         it = m_hEntries.erase(it);
+      else
+         ++it;
+   }
+
+   QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+
+   QSaveFile file(fileName());
+
+   if (!file.open(QIODevice::WriteOnly)) {
+      qWarning() << "Cannot write the certificate cache" << file.fileName();
+      return;
+   }
+
+   QDataStream stream(&file);
+   stream.setVersion(QDataStream::Qt_5_0);
+
+   stream << CACHE_MAGIC << CACHE_VERSION << static_cast<quint32>(m_hEntries.size());
+
+   for (auto it = m_hEntries.constBegin(); it != m_hEntries.constEnd(); ++it) {
+      stream << it.key() << it->modified << it->fingerprint;
+
+      for (int k = 0; k < enum_class_size<Kind>(); k++)
+         stream << it->fetched[k] << it->values[k];
+   }
+
+   if (!file.commit())
+      qWarning() << "Cannot write the certificate cache" << file.fileName();
+}
@@ -0,0 +1,101 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
+#include <QtCore/QQueue>
+#include <QtCore/QTimer>
+
+//Ring
+#include <typedefs.h>
+
+// Std
+#include <array>
+#include <functional>
+
+/**
+ * Keep the certificate details and checks on disk between the sessions.
+ *
+ * Each certificate referenced by the history is otherwise validated by
+ * the daemon at every start. The entries are keyed by the certificate id
+ * or by its path, a path entry is dropped when the file modification time
+ * changes and the checks are dropped when the fingerprint changes.
+ *
+ * The details don't change, they are kept for DETAILS_MAX_AGE. The checks
+ * depend on the time and on the trust store, they are used for up to
+ * CHECKS_MAX_AGE but are revalidated in the background once they are
+ * older than CHECKS_STALE_AGE.
+ *
+ * This must be used from the CertificateModel thread.
+ */
+class CertificateCache final : public QObject
+{
+   Q_OBJECT
+public:
+   enum class Kind {
+      DETAILS,
+      CHECKS ,
+      COUNT__
+   };
+
+   enum class Status {
+      MISSING, /*!< Ask the daemon                          */
+      FRESH  , /*!< Use it                                  */
+      STALE  , /*!< Use it, but ask the daemon in background */
+   };
+
+   static CertificateCache& instance();
+
+   Status find  (const QString& key, Kind kind, const QDateTime& modified, MapStringString& values);
+   bool   insert(const QString& key, Kind kind, const QDateTime& modified, const MapStringString& values);
+
+   void revalidate(QObject* context, std::function<void()> job);
+
+private:
+   explicit CertificateCache();
+
+   struct Entry {
+      QDateTime                                         modified   ;
+      QByteArray                                        fingerprint;
+      std::array<QDateTime      , enum_class_size<Kind>()> fetched ;
+      std::array<MapStringString, enum_class_size<Kind>()> values  ;
+   };
+
+   struct Job {
+      QPointer<QObject>     context ;
+      std::function<void()> function;
+   };
+
+   //Attributes
+   QHash<QString, Entry> m_hEntries    ;
+   QQueue<Job>           m_lJobs       ;
+   QTimer                m_SaveTimer   ;
+   QTimer                m_WorkerTimer ;
+
+   //Helpers
+   static QString fileName();
+   void load();
+
+private Q_SLOTS:
+   void save      ();
+   void processJob();
+};
@@ -33,6 +33,8 @@
 #include "private/videorenderermanager.h"
 #include "video/resolution.h"
 #include "private/videorenderer_p.h"
+#include "private/framebufferpool.h"
+#include "private/rendererstatistics_p.h"
 
 #include "videomanager_interface.h"
 
@@ -49,6 +51,13 @@ public:
     DRing::SinkTarget target;
     mutable QMutex directmutex;
     mutable DRing::SinkTarget::FrameBufferPtr daemonFramePtr_;
+
+    FrameBufferPool::Buffer m_pWriting; // lent to the daemon between pull and push
+    FrameBufferPool::Buffer m_pLatest ; // last complete frame
+
+    std::chrono::steady_clock::time_point m_LatestTimestamp;
+    quint64                               m_LatestSeq   {0};
+    quint64                               m_ConsumedSeq {0};
 private:
     Video::DirectRenderer* q_ptr;
 };
@@ -85,31 +94,81 @@ void Video::DirectRenderer::startRendering()
 void Video::DirectRenderer::stopRendering ()
 {
    Video::Renderer::d_ptr->m_isRendering = false;
+
+   {
+      QMutexLocker lk(mutex());
+      d_ptr->m_pLatest.reset();
+   }
+
    emit stopped();
 }
 
+/**
+ * The daemon write the frame directly in a pooled buffer. The
+ * DRing::FrameBuffer wrapper itself is handed back and forth, its own
+ * storage is never used.
+ */
 DRing::SinkTarget::FrameBufferPtr Video::DirectRendererPrivate::requestFrameBuffer(std::size_t bytes)
 {
+    auto buffer = q_ptr->Video::Renderer::d_ptr->m_Pool.acquire(bytes);
+
     QMutexLocker lk(q_ptr->mutex());
     if (not daemonFramePtr_)
         daemonFramePtr_.reset(new DRing::FrameBuffer);
-    daemonFramePtr_->storage.resize(bytes);
-    daemonFramePtr_->ptr = daemonFramePtr_->storage.data();
+    m_pWriting = std::move(buffer);
+    daemonFramePtr_->ptr = m_pWriting->data();
     daemonFramePtr_->ptrSize = bytes;
     return std::move(daemonFramePtr_);
 }
 
 void Video::DirectRendererPrivate::onNewFrame(DRing::SinkTarget::FrameBufferPtr buf)
 {
-    if (not q_ptr->isRendering())
-        return;
+    auto rendererPrivate = q_ptr->Video::Renderer::d_ptr;
+
+    // Release the previous frame outside of the lock
+    FrameBufferPool::Buffer old;
+    FrameBufferPool::Buffer latest;
 
     {
         QMutexLocker lk(q_ptr->mutex());
         daemonFramePtr_ = std::move(buf);
+
+        if (not q_ptr->isRendering()) {
+            old = std::move(m_pWriting);
+            return;
+        }
+
+        old = std::move(m_pLatest);
+        m_pLatest = std::move(m_pWriting);
+        m_LatestTimestamp = rendererPrivate->m_pStats->received();
+        m_LatestSeq++;
+        latest = m_pLatest;
+
+        // The queue and the snapshot share the buffer, no copy either
+        if (rendererPrivate->hasQueue() || rendererPrivate->isSnapshotWanted()) {
+            Video::Frame frame;
+            frame.buffer    = m_pLatest;
+            frame.ptr       = m_pLatest->data();
+            frame.size      = m_pLatest->size();
+            frame.timestamp = m_LatestTimestamp;
+
+            if (rendererPrivate->isSnapshotWanted())
+                rendererPrivate->setSnapshot(frame);
+
+            if (rendererPrivate->hasQueue())
+                rendererPrivate->enqueue(std::move(frame));
+        }
     }
 
+    // The queue already has it, only the signals are skipped
+    if (rendererPrivate->m_ChangeDetection
+      && !rendererPrivate->detectChanges(latest->data(), latest->size()))
+        return;
+
     emit q_ptr->frameUpdated();
+
+    if (rendererPrivate->isThumbnailDue())
+        rendererPrivate->updateThumbnail(latest->data(), latest->size());
 }
 
 Video::Frame Video::DirectRenderer::currentFrame() const
@@ -118,14 +177,27 @@ Video::Frame Video::DirectRenderer::currentFrame() const
         return {};
 
     QMutexLocker lock(mutex());
-    if (not d_ptr->daemonFramePtr_)
+    if (not d_ptr->m_pLatest)
         return {};
 
+    // No copy, the buffer stays alive as long as the client hold the frame
     Video::Frame frame;
-    frame.storage = std::move(d_ptr->daemonFramePtr_->storage);
-    frame.ptr = frame.storage.data();
-    frame.size = frame.storage.size();
-    return std::move(frame);
+    frame.buffer = d_ptr->m_pLatest;
+    frame.ptr = frame.buffer->data();
+    frame.size = frame.buffer->size();
+    frame.timestamp = d_ptr->m_LatestTimestamp;
+
+    // The same frame can be returned more than once, count it only once
+    if (d_ptr->m_ConsumedSeq != d_ptr->m_LatestSeq) {
+        Video::Renderer::d_ptr->m_pStats->consumed(
+            frame.timestamp, d_ptr->m_LatestSeq - d_ptr->m_ConsumedSeq - 1
+        );
+        d_ptr->m_ConsumedSeq = d_ptr->m_LatestSeq;
+    }
+
+    Video::Renderer::d_ptr->takeChangedRegions();
+
+    return frame;
 }
 
 const DRing::SinkTarget& Video::DirectRenderer::target() const
@@ -0,0 +1,90 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+// Std
+#include <functional>
+
+/**
+ * Merge the events received during an event loop iteration.
+ *
+ * The daemon can send bursts of signals, such as when many accounts
+ * register at once. Instead of updating the models for each of them, the
+ * events are collected and the handler receives them once control returns
+ * to the event loop. Only the latest value of each key is kept, the batch
+ * is in the order the keys were first seen.
+ *
+ * This must be used from a single thread.
+ */
+template<typename Key, typename Value>
+class EventCoalescer final
+{
+public:
+   typedef QVector<QPair<Key, Value>> Batch;
+
+   explicit EventCoalescer(std::function<void(const Batch&)> handler) : m_Handler(handler)
+   {
+      m_Timer.setSingleShot(true);
+      m_Timer.setInterval(0);
+      QObject::connect(&m_Timer, &QTimer::timeout, [this]() { flush(); });
+   }
+
+   ///Replace the pending value for this key, if any
+   void add(const Key& key, const Value& value)
+   {
+      const auto it = m_hIndex.constFind(key);
+
+      if (it != m_hIndex.constEnd())
+         m_lPending[*it].second = value;
+      else {
+         m_hIndex[key] = m_lPending.size();
+         m_lPending << qMakePair(key, value);
+      }
+
+      if (!m_Timer.isActive())
+         m_Timer.start();
+   }
+
+   ///Deliver the pending events now
+   void flush()
+   {
+      m_Timer.stop();
+
+      if (m_lPending.isEmpty())
+         return;
+
+      // The handler may add new events
+      Batch batch;
+      batch.swap(m_lPending);
+      m_hIndex.clear();
+
+      m_Handler(batch);
+   }
+
+private:
+   std::function<void(const Batch&)> m_Handler ;
+   Batch                             m_lPending;
+   QHash<Key, int>                   m_hIndex  ;
+   QTimer                            m_Timer   ;
+};
@@ -0,0 +1,236 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "framebufferpool.h"
+
+// Std
+#include <mutex>
+
+namespace Video {
+
+/**
+ * Recycle the shared_ptr control blocks.
+ *
+ * Every Buffer needs one to hold its reference count and deleter. They all
+ * have the same type, so the freed blocks are kept and handed back to the
+ * next acquire() instead of going through the heap for each frame.
+ */
+struct BlockList final
+{
+   static const int MAX_FREE = 32;
+
+   std::mutex         m_Mutex;
+   std::vector<void*> m_lFree;
+   std::size_t        m_Size {0}; // of the blocks in m_lFree
+
+   ~BlockList();
+
+   void* take(std::size_t size);
+   void  give(void* block, std::size_t size);
+};
+
+///Allocate the control blocks from a BlockList, it stays alive as long as they do
+template<typename T>
+struct BlockAllocator final
+{
+   typedef T value_type;
+
+   explicit BlockAllocator(const std::shared_ptr<BlockList>& list) : m_pList(list) {}
+
+   template<typename U>
+   BlockAllocator(const BlockAllocator<U>& other) : m_pList(other.m_pList) {}
+
+   T* allocate(std::size_t n) {
+      return static_cast<T*>(m_pList->take(n * sizeof(T)));
+   }
+
+   void deallocate(T* p, std::size_t n) {
+      m_pList->give(p, n * sizeof(T));
+   }
+
+   std::shared_ptr<BlockList> m_pList;
+};
+
+template<typename T, typename U>
+bool operator==(const BlockAllocator<T>& a, const BlockAllocator<U>& b)
+{
+   return a.m_pList == b.m_pList;
+}
+
+template<typename T, typename U>
+bool operator!=(const BlockAllocator<T>& a, const BlockAllocator<U>& b)
+{
+   return !(a == b);
+}
+
+struct FrameBufferPool::Shared
+{
+   std::mutex                          m_Mutex      ;
+   std::vector<std::vector<uint8_t>*>  m_lFree      ;
+   int                                 m_Capacity   ;
+   int                                 m_Allocations;
+   std::shared_ptr<BlockList>          m_pBlocks    ;
+
+   ~Shared();
+
+   void recycle(std::vector<uint8_t>* buffer);
+};
+
+} // namespace Video
+
+Video::BlockList::~BlockList()
+{
+   for (auto block : m_lFree)
+      ::operator delete(block);
+}
+
+void* Video::BlockList::take(std::size_t size)
+{
+   {
+      std::lock_guard<std::mutex> lk(m_Mutex);
+
+      if (size == m_Size && !m_lFree.empty()) {
+         void* block = m_lFree.back();
+         m_lFree.pop_back();
+         return block;
+      }
+   }
+
+   return ::operator new(size);
+}
+
+void Video::BlockList::give(void* block, std::size_t size)
+{
+   {
+      std::lock_guard<std::mutex> lk(m_Mutex);
+
+      if (m_lFree.empty())
+         m_Size = size;
+
+      if (size == m_Size && (int)m_lFree.size() < MAX_FREE) {
+         m_lFree.push_back(block);
+         return;
+      }
+   }
+
+   ::operator delete(block);
+}
+
+Video::FrameBufferPool::Shared::~Shared()
+{
+   for (auto buffer : m_lFree)
+      delete buffer;
+}
+
+///Called when the last reference to a buffer is released
+void Video::FrameBufferPool::Shared::recycle(std::vector<uint8_t>* buffer)
+{
+   {
+      std::lock_guard<std::mutex> lk(m_Mutex);
+
+      if ((int)m_lFree.size() < m_Capacity) {
+         m_lFree.push_back(buffer);
+         return;
+      }
+   }
+
+   delete buffer;
+}
+
+Video::FrameBufferPool::FrameBufferPool(int capacity) : m_pShared(std::make_shared<Shared>())
+{
+   m_pShared->m_Capacity    = capacity;
+   m_pShared->m_Allocations = 0;
+   m_pShared->m_pBlocks     = std::make_shared<BlockList>();
+}
+
+Video::FrameBufferPool::~FrameBufferPool()
+{
+}
+
+///The maximum number of idle buffers kept for later use
+int Video::FrameBufferPool::capacity() const
+{
+   std::lock_guard<std::mutex> lk(m_pShared->m_Mutex);
+   return m_pShared->m_Capacity;
+}
+
+///The number of buffers created so far, it stops growing once the pool is warm
+int Video::FrameBufferPool::allocations() const
+{
+   std::lock_guard<std::mutex> lk(m_pShared->m_Mutex);
+   return m_pShared->m_Allocations;
+}
+
+void Video::FrameBufferPool::setCapacity(int capacity)
+{
+   std::lock_guard<std::mutex> lk(m_pShared->m_Mutex);
+
+   m_pShared->m_Capacity = capacity;
+
+   while ((int)m_pShared->m_lFree.size() > capacity) {
+      delete m_pShared->m_lFree.back();
+      m_pShared->m_lFree.pop_back();
+   }
+}
+
+/**
+ * Get a buffer of exactly "bytes" bytes.
+ *
+ * The content is undefined, it usually holds an older frame.
+ */
+Video::FrameBufferPool::Buffer Video::FrameBufferPool::acquire(std::size_t bytes)
+{
+   std::vector<uint8_t>* buffer = nullptr;
+
+   {
+      std::lock_guard<std::mutex> lk(m_pShared->m_Mutex);
+
+      auto& free = m_pShared->m_lFree;
+
+      // Prefer a buffer that is already large enough
+      for (auto it = free.begin(); it != free.end(); ++it) {
+         if ((*it)->capacity() >= bytes) {
+            buffer = *it;
+            free.erase(it);
+            break;
+         }
+      }
+
+      if ((!buffer) && !free.empty()) {
+         buffer = free.back();
+         free.pop_back();
+      }
+
+      if ((!buffer) || buffer->capacity() < bytes)
+         m_pShared->m_Allocations++;
+   }
+
+   if (!buffer)
+      buffer = new std::vector<uint8_t>();
+
+   buffer->resize(bytes);
+
+   std::weak_ptr<Shared> pool = m_pShared;
+
+   return Buffer(buffer, [pool](std::vector<uint8_t>* b) {
+      if (auto shared = pool.lock())
+         shared->recycle(b);
+      else
+         delete b;
+   }, BlockAllocator<char>(m_pShared->m_pBlocks));
+}
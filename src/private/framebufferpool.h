@@ -0,0 +1,62 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+// Std
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace Video {
+
+/**
+ * Recycle the video frame buffers.
+ *
+ * Every buffer returned by acquire() is reference counted. Once the last
+ * reference (usually held by a Video::Frame) is released, the buffer goes
+ * back to the pool, so a stream with a stable resolution stops allocating
+ * after its first few frames. The reference count itself (the shared_ptr
+ * control block) is recycled the same way.
+ *
+ * The pool can be destroyed while some buffers are still in use, they are
+ * then freed normally. All methods are thread safe.
+ */
+class FrameBufferPool final
+{
+public:
+   typedef std::shared_ptr<std::vector<uint8_t>> Buffer;
+
+   explicit FrameBufferPool(int capacity = 4);
+   ~FrameBufferPool();
+
+   //Getters
+   int capacity   () const;
+   int allocations() const;
+
+   //Setters
+   void setCapacity(int capacity);
+
+   //Mutators
+   Buffer acquire(std::size_t bytes);
+
+private:
+   struct Shared;
+   std::shared_ptr<Shared> m_pShared;
+};
+
+} // namespace Video
@@ -0,0 +1,803 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "framekernels.h"
+
+// Std
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+ #define RING_X86_KERNELS
+ #include <immintrin.h>
+ #define TARGET_SSE2 __attribute__((target("sse2")))
+ #define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+using Video::FrameKernels::Backend;
+
+namespace {
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Scalar                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+// BT.601, limited range
+inline uint8_t luma(int r, int g, int b)
+{
+   return ((66*r + 129*g + 25*b + 128) >> 8) + 16;
+}
+
+inline uint8_t chromaBlue(int r, int g, int b)
+{
+   return ((-38*r - 74*g + 112*b + 128) >> 8) + 128;
+}
+
+inline uint8_t chromaRed(int r, int g, int b)
+{
+   return ((112*r - 94*g - 18*b + 128) >> 8) + 128;
+}
+
+///Rounded average, like the SIMD pavgb
+inline int average(int a, int b)
+{
+   return (a + b + 1) >> 1;
+}
+
+inline uint8_t blend(int a, int b, int f)
+{
+   return (a * (256 - f) + b * f + 128) >> 8;
+}
+
+void swizzleRowScalar(const uint8_t* src, uint8_t* dst, int from, int width)
+{
+   for (int x = from; x < width; x++) {
+      const uint8_t c0 = src[4*x];
+      dst[4*x    ] = src[4*x + 2];
+      dst[4*x + 1] = src[4*x + 1];
+      dst[4*x + 2] = c0;
+      dst[4*x + 3] = src[4*x + 3];
+   }
+}
+
+void lumaRowScalar(const uint8_t* src, uint8_t* y, int from, int width, bool rgba)
+{
+   const int ir = rgba ? 0 : 2;
+   const int ib = rgba ? 2 : 0;
+
+   for (int x = from; x < width; x++)
+      y[x] = luma(src[4*x + ir], src[4*x + 1], src[4*x + ib]);
+}
+
+///Chroma of the 2x2 blocks starting at an even column >= from
+void chromaRowScalar(const uint8_t* r0, const uint8_t* r1, int from, int width, bool rgba,
+                     uint8_t* u, uint8_t* v, int step)
+{
+   const int ir = rgba ? 0 : 2;
+   const int ib = rgba ? 2 : 0;
+
+   for (int x = from; x < width; x += 2) {
+      const int x1 = std::min(x + 1, width - 1);
+
+      int c[3];
+      for (int i = 0; i < 3; i++)
+         c[i] = average(average(r0[4*x + i], r1[4*x + i]), average(r0[4*x1 + i], r1[4*x1 + i]));
+
+      u[(x/2)*step] = chromaBlue(c[ir], c[1], c[ib]);
+      v[(x/2)*step] = chromaRed (c[ir], c[1], c[ib]);
+   }
+}
+
+void blendRowScalar(const uint8_t* a, const uint8_t* b, uint8_t* dst, int from, int bytes, int f)
+{
+   for (int i = from; i < bytes; i++)
+      dst[i] = blend(a[i], b[i], f);
+}
+
+///Add a row of bytes to 16 bits counters
+void accumulateRowScalar(const uint8_t* src, uint16_t* acc, int from, int bytes)
+{
+   for (int i = from; i < bytes; i++)
+      acc[i] += src[i];
+}
+
+///One step of the tile hash, each 32 bits lane of "chunk" goes in its own lane
+inline void hashChunkScalar(uint32_t* lanes, const uint8_t* chunk)
+{
+   for (int i = 0; i < 4; i++) {
+      uint32_t v;
+      memcpy(&v, chunk + 4*i, 4);
+      lanes[i] = (lanes[i] ^ v) + (lanes[i] << 5);
+   }
+}
+
+void hashRowScalar(const uint8_t* src, uint32_t* lanes, int bytes)
+{
+   for (int i = 0; i + 16 <= bytes; i += 16)
+      hashChunkScalar(lanes, src + i);
+}
+
+struct Tap {
+   int x0;
+   int x1;
+   int f ; /*!< weight of x1, in 1/256 */
+};
+
+void horizontalRowScalar(const uint8_t* src, uint8_t* dst, const Tap* taps, int from, int width)
+{
+   for (int x = from; x < width; x++) {
+      const Tap& t = taps[x];
+      for (int c = 0; c < 4; c++)
+         dst[4*x + c] = blend(src[4*t.x0 + c], src[4*t.x1 + c], t.f);
+   }
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   SSE2                                    *
+ *                                                                           *
+ ****************************************************************************/
+
+#ifdef RING_X86_KERNELS
+
+TARGET_SSE2 int swizzleRowSse2(const uint8_t* src, uint8_t* dst, int width)
+{
+   const __m128i ag  = _mm_set1_epi32(0xff00ff00);
+   const __m128i low = _mm_set1_epi32(0xff);
+
+   int x = 0;
+   for (; x + 4 <= width; x += 4) {
+      const __m128i p = _mm_loadu_si128((const __m128i*)(src + 4*x));
+
+      const __m128i r = _mm_or_si128(
+         _mm_and_si128(p, ag),
+         _mm_or_si128(
+            _mm_and_si128(_mm_srli_epi32(p, 16), low),
+            _mm_slli_epi32(_mm_and_si128(p, low), 16)
+         )
+      );
+
+      _mm_storeu_si128((__m128i*)(dst + 4*x), r);
+   }
+
+   return x;
+}
+
+TARGET_SSE2 int lumaRowSse2(const uint8_t* src, uint8_t* y, int width, bool rgba)
+{
+   const __m128i mask = _mm_set1_epi32(0xff);
+   const __m128i k0   = _mm_set1_epi16(rgba ? 66 : 25);
+   const __m128i k1   = _mm_set1_epi16(129);
+   const __m128i k2   = _mm_set1_epi16(rgba ? 25 : 66);
+   const __m128i half = _mm_set1_epi16(128);
+   const __m128i off  = _mm_set1_epi16(16);
+
+   int x = 0;
+   for (; x + 8 <= width; x += 8) {
+      const __m128i p0 = _mm_loadu_si128((const __m128i*)(src + 4*x     ));
+      const __m128i p1 = _mm_loadu_si128((const __m128i*)(src + 4*x + 16));
+
+      const __m128i c0 = _mm_packs_epi32(_mm_and_si128(p0, mask), _mm_and_si128(p1, mask));
+      const __m128i c1 = _mm_packs_epi32(
+         _mm_and_si128(_mm_srli_epi32(p0, 8), mask), _mm_and_si128(_mm_srli_epi32(p1, 8), mask)
+      );
+      const __m128i c2 = _mm_packs_epi32(
+         _mm_and_si128(_mm_srli_epi32(p0, 16), mask), _mm_and_si128(_mm_srli_epi32(p1, 16), mask)
+      );
+
+      // The sum fits in 16 bits unsigned, the shift is logical
+      __m128i s = _mm_add_epi16(_mm_mullo_epi16(c0, k0), _mm_mullo_epi16(c1, k1));
+      s = _mm_add_epi16(s, _mm_mullo_epi16(c2, k2));
+      s = _mm_add_epi16(_mm_srli_epi16(_mm_add_epi16(s, half), 8), off);
+
+      _mm_storel_epi64((__m128i*)(y + x), _mm_packus_epi16(s, s));
+   }
+
+   return x;
+}
+
+TARGET_SSE2 int chromaRowSse2(const uint8_t* r0, const uint8_t* r1, int width, bool rgba,
+                              uint8_t* u, uint8_t* v, int step)
+{
+   const __m128i mask = _mm_set1_epi32(0xff);
+   const __m128i ku0  = _mm_set1_epi16(rgba ? -38 : 112);
+   const __m128i ku1  = _mm_set1_epi16(-74);
+   const __m128i ku2  = _mm_set1_epi16(rgba ? 112 : -38);
+   const __m128i kv0  = _mm_set1_epi16(rgba ? 112 : -18);
+   const __m128i kv1  = _mm_set1_epi16(-94);
+   const __m128i kv2  = _mm_set1_epi16(rgba ? -18 : 112);
+   const __m128i half = _mm_set1_epi16(128);
+
+   int x = 0;
+   for (; x + 8 <= width; x += 8) {
+      // Vertical then horizontal average, 8 pixels give 4 samples
+      __m128i a = _mm_avg_epu8(
+         _mm_loadu_si128((const __m128i*)(r0 + 4*x)), _mm_loadu_si128((const __m128i*)(r1 + 4*x))
+      );
+      __m128i b = _mm_avg_epu8(
+         _mm_loadu_si128((const __m128i*)(r0 + 4*x + 16)), _mm_loadu_si128((const __m128i*)(r1 + 4*x + 16))
+      );
+
+      a = _mm_shuffle_epi32(_mm_avg_epu8(a, _mm_srli_epi64(a, 32)), _MM_SHUFFLE(3,1,2,0));
+      b = _mm_shuffle_epi32(_mm_avg_epu8(b, _mm_srli_epi64(b, 32)), _MM_SHUFFLE(3,1,2,0));
+
+      const __m128i c  = _mm_unpacklo_epi64(a, b);
+      const __m128i c0 = _mm_packs_epi32(_mm_and_si128(c, mask), _mm_setzero_si128());
+      const __m128i c1 = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(c, 8 ), mask), _mm_setzero_si128());
+      const __m128i c2 = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(c, 16), mask), _mm_setzero_si128());
+
+      // The sums fit in 16 bits signed
+      __m128i cu = _mm_add_epi16(_mm_mullo_epi16(c0, ku0), _mm_mullo_epi16(c1, ku1));
+      cu = _mm_add_epi16(cu, _mm_mullo_epi16(c2, ku2));
+      cu = _mm_add_epi16(_mm_srai_epi16(_mm_add_epi16(cu, half), 8), half);
+
+      __m128i cv = _mm_add_epi16(_mm_mullo_epi16(c0, kv0), _mm_mullo_epi16(c1, kv1));
+      cv = _mm_add_epi16(cv, _mm_mullo_epi16(c2, kv2));
+      cv = _mm_add_epi16(_mm_srai_epi16(_mm_add_epi16(cv, half), 8), half);
+
+      const uint32_t us = _mm_cvtsi128_si32(_mm_packus_epi16(cu, cu));
+      const uint32_t vs = _mm_cvtsi128_si32(_mm_packus_epi16(cv, cv));
+
+      for (int i = 0; i < 4; i++) {
+         u[(x/2 + i)*step] = us >> (8*i);
+         v[(x/2 + i)*step] = vs >> (8*i);
+      }
+   }
+
+   return x;
+}
+
+TARGET_SSE2 int blendRowSse2(const uint8_t* a, const uint8_t* b, uint8_t* dst, int bytes, int f)
+{
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i wa   = _mm_set1_epi16(256 - f);
+   const __m128i wb   = _mm_set1_epi16(f);
+   const __m128i half = _mm_set1_epi16(128);
+
+   int i = 0;
+   for (; i + 16 <= bytes; i += 16) {
+      const __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+      const __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+
+      __m128i lo = _mm_add_epi16(
+         _mm_mullo_epi16(_mm_unpacklo_epi8(va, zero), wa), _mm_mullo_epi16(_mm_unpacklo_epi8(vb, zero), wb)
+      );
+      __m128i hi = _mm_add_epi16(
+         _mm_mullo_epi16(_mm_unpackhi_epi8(va, zero), wa), _mm_mullo_epi16(_mm_unpackhi_epi8(vb, zero), wb)
+      );
+
+      lo = _mm_srli_epi16(_mm_add_epi16(lo, half), 8);
+      hi = _mm_srli_epi16(_mm_add_epi16(hi, half), 8);
+
+      _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+   }
+
+   return i;
+}
+
+TARGET_SSE2 int accumulateRowSse2(const uint8_t* src, uint16_t* acc, int bytes)
+{
+   const __m128i zero = _mm_setzero_si128();
+
+   int i = 0;
+   for (; i + 16 <= bytes; i += 16) {
+      const __m128i v  = _mm_loadu_si128((const __m128i*)(src + i));
+      const __m128i lo = _mm_add_epi16(_mm_loadu_si128((const __m128i*)(acc + i    )), _mm_unpacklo_epi8(v, zero));
+      const __m128i hi = _mm_add_epi16(_mm_loadu_si128((const __m128i*)(acc + i + 8)), _mm_unpackhi_epi8(v, zero));
+
+      _mm_storeu_si128((__m128i*)(acc + i    ), lo);
+      _mm_storeu_si128((__m128i*)(acc + i + 8), hi);
+   }
+
+   return i;
+}
+
+TARGET_SSE2 void hashRowSse2(const uint8_t* src, uint32_t* lanes, int bytes)
+{
+   __m128i h = _mm_loadu_si128((const __m128i*)lanes);
+
+   for (int i = 0; i + 16 <= bytes; i += 16) {
+      const __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+      h = _mm_add_epi32(_mm_xor_si128(h, v), _mm_slli_epi32(h, 5));
+   }
+
+   _mm_storeu_si128((__m128i*)lanes, h);
+}
+
+TARGET_SSE2 int horizontalRowSse2(const uint8_t* src, uint8_t* dst, const Tap* taps, int width)
+{
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i half = _mm_set1_epi16(128);
+
+   for (int x = 0; x < width; x++) {
+      const Tap& t = taps[x];
+
+      int32_t p0, p1;
+      memcpy(&p0, src + 4*t.x0, 4);
+      memcpy(&p1, src + 4*t.x1, 4);
+
+      const __m128i p = _mm_unpacklo_epi8(
+         _mm_unpacklo_epi32(_mm_cvtsi32_si128(p0), _mm_cvtsi32_si128(p1)), zero
+      );
+      const __m128i w = _mm_set_epi16(t.f, t.f, t.f, t.f, 256 - t.f, 256 - t.f, 256 - t.f, 256 - t.f);
+      const __m128i m = _mm_mullo_epi16(p, w);
+
+      __m128i s = _mm_add_epi16(m, _mm_srli_si128(m, 8));
+      s = _mm_srli_epi16(_mm_add_epi16(s, half), 8);
+
+      const int32_t r = _mm_cvtsi128_si32(_mm_packus_epi16(s, s));
+      memcpy(dst + 4*x, &r, 4);
+   }
+
+   return width;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   AVX2                                    *
+ *                                                                           *
+ ****************************************************************************/
+
+TARGET_AVX2 int swizzleRowAvx2(const uint8_t* src, uint8_t* dst, int width)
+{
+   const __m256i shuffle = _mm256_setr_epi8(
+      2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15,
+      2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15
+   );
+
+   int x = 0;
+   for (; x + 8 <= width; x += 8) {
+      const __m256i p = _mm256_loadu_si256((const __m256i*)(src + 4*x));
+      _mm256_storeu_si256((__m256i*)(dst + 4*x), _mm256_shuffle_epi8(p, shuffle));
+   }
+
+   return x;
+}
+
+TARGET_AVX2 int lumaRowAvx2(const uint8_t* src, uint8_t* y, int width, bool rgba)
+{
+   const __m256i mask = _mm256_set1_epi32(0xff);
+   const __m256i k0   = _mm256_set1_epi16(rgba ? 66 : 25);
+   const __m256i k1   = _mm256_set1_epi16(129);
+   const __m256i k2   = _mm256_set1_epi16(rgba ? 25 : 66);
+   const __m256i half = _mm256_set1_epi16(128);
+   const __m256i off  = _mm256_set1_epi16(16);
+
+   int x = 0;
+   for (; x + 16 <= width; x += 16) {
+      const __m256i p0 = _mm256_loadu_si256((const __m256i*)(src + 4*x     ));
+      const __m256i p1 = _mm256_loadu_si256((const __m256i*)(src + 4*x + 32));
+
+      const __m256i c0 = _mm256_packs_epi32(_mm256_and_si256(p0, mask), _mm256_and_si256(p1, mask));
+      const __m256i c1 = _mm256_packs_epi32(
+         _mm256_and_si256(_mm256_srli_epi32(p0, 8), mask), _mm256_and_si256(_mm256_srli_epi32(p1, 8), mask)
+      );
+      const __m256i c2 = _mm256_packs_epi32(
+         _mm256_and_si256(_mm256_srli_epi32(p0, 16), mask), _mm256_and_si256(_mm256_srli_epi32(p1, 16), mask)
+      );
+
+      __m256i s = _mm256_add_epi16(_mm256_mullo_epi16(c0, k0), _mm256_mullo_epi16(c1, k1));
+      s = _mm256_add_epi16(s, _mm256_mullo_epi16(c2, k2));
+      s = _mm256_add_epi16(_mm256_srli_epi16(_mm256_add_epi16(s, half), 8), off);
+
+      // The packs work per 128 bits lane, put the pixels back in order
+      s = _mm256_permute4x64_epi64(s, _MM_SHUFFLE(3,1,2,0));
+      s = _mm256_permute4x64_epi64(_mm256_packus_epi16(s, _mm256_setzero_si256()), _MM_SHUFFLE(3,1,2,0));
+
+      _mm_storeu_si128((__m128i*)(y + x), _mm256_castsi256_si128(s));
+   }
+
+   return x;
+}
+
+TARGET_AVX2 int blendRowAvx2(const uint8_t* a, const uint8_t* b, uint8_t* dst, int bytes, int f)
+{
+   const __m256i zero = _mm256_setzero_si256();
+   const __m256i wa   = _mm256_set1_epi16(256 - f);
+   const __m256i wb   = _mm256_set1_epi16(f);
+   const __m256i half = _mm256_set1_epi16(128);
+
+   int i = 0;
+   for (; i + 32 <= bytes; i += 32) {
+      const __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+      const __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+
+      __m256i lo = _mm256_add_epi16(
+         _mm256_mullo_epi16(_mm256_unpacklo_epi8(va, zero), wa), _mm256_mullo_epi16(_mm256_unpacklo_epi8(vb, zero), wb)
+      );
+      __m256i hi = _mm256_add_epi16(
+         _mm256_mullo_epi16(_mm256_unpackhi_epi8(va, zero), wa), _mm256_mullo_epi16(_mm256_unpackhi_epi8(vb, zero), wb)
+      );
+
+      lo = _mm256_srli_epi16(_mm256_add_epi16(lo, half), 8);
+      hi = _mm256_srli_epi16(_mm256_add_epi16(hi, half), 8);
+
+      // unpack and pack are both per lane, the order is preserved
+      _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(lo, hi));
+   }
+
+   return i;
+}
+
+TARGET_AVX2 int accumulateRowAvx2(const uint8_t* src, uint16_t* acc, int bytes)
+{
+   int i = 0;
+   for (; i + 16 <= bytes; i += 16) {
+      const __m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(src + i)));
+      const __m256i a = _mm256_loadu_si256((const __m256i*)(acc + i));
+
+      _mm256_storeu_si256((__m256i*)(acc + i), _mm256_add_epi16(a, v));
+   }
+
+   return i;
+}
+
+#endif //RING_X86_KERNELS
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Dispatch                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+Backend detect()
+{
+#ifdef RING_X86_KERNELS
+   __builtin_cpu_init();
+
+   if (__builtin_cpu_supports("avx2"))
+      return Backend::AVX2;
+
+   if (__builtin_cpu_supports("sse2"))
+      return Backend::SSE2;
+#endif
+
+   return Backend::SCALAR;
+}
+
+const Backend g_Supported = detect();
+std::atomic_int g_Backend {static_cast<int>(g_Supported)};
+
+inline Backend current()
+{
+   return static_cast<Backend>(g_Backend.load(std::memory_order_relaxed));
+}
+
+void swizzleRow(const uint8_t* src, uint8_t* dst, int width)
+{
+   int done = 0;
+
+#ifdef RING_X86_KERNELS
+   switch(current()) {
+      case Backend::AVX2:
+         done = swizzleRowAvx2(src, dst, width);
+         break;
+      case Backend::SSE2:
+         done = swizzleRowSse2(src, dst, width);
+         break;
+      case Backend::SCALAR:
+         break;
+   }
+#endif
+
+   swizzleRowScalar(src, dst, done, width);
+}
+
+void lumaRow(const uint8_t* src, uint8_t* y, int width, bool rgba)
+{
+   int done = 0;
+
+#ifdef RING_X86_KERNELS
+   switch(current()) {
+      case Backend::AVX2:
+         done = lumaRowAvx2(src, y, width, rgba);
+         break;
+      case Backend::SSE2:
+         done = lumaRowSse2(src, y, width, rgba);
+         break;
+      case Backend::SCALAR:
+         break;
+   }
+#endif
+
+   lumaRowScalar(src, y, done, width, rgba);
+}
+
+void chromaRow(const uint8_t* r0, const uint8_t* r1, int width, bool rgba, uint8_t* u, uint8_t* v, int step)
+{
+   int done = 0;
+
+#ifdef RING_X86_KERNELS
+   if (current() != Backend::SCALAR)
+      done = chromaRowSse2(r0, r1, width, rgba, u, v, step);
+#endif
+
+   chromaRowScalar(r0, r1, done, width, rgba, u, v, step);
+}
+
+void blendRow(const uint8_t* a, const uint8_t* b, uint8_t* dst, int bytes, int f)
+{
+   int done = 0;
+
+#ifdef RING_X86_KERNELS
+   switch(current()) {
+      case Backend::AVX2:
+         done = blendRowAvx2(a, b, dst, bytes, f);
+         break;
+      case Backend::SSE2:
+         done = blendRowSse2(a, b, dst, bytes, f);
+         break;
+      case Backend::SCALAR:
+         break;
+   }
+#endif
+
+   blendRowScalar(a, b, dst, done, bytes, f);
+}
+
+void accumulateRow(const uint8_t* src, uint16_t* acc, int bytes)
+{
+   int done = 0;
+
+#ifdef RING_X86_KERNELS
+   switch(current()) {
+      case Backend::AVX2:
+         done = accumulateRowAvx2(src, acc, bytes);
+         break;
+      case Backend::SSE2:
+         done = accumulateRowSse2(src, acc, bytes);
+         break;
+      case Backend::SCALAR:
+         break;
+   }
+#endif
+
+   accumulateRowScalar(src, acc, done, bytes);
+}
+
+///The hash is memory bound, there is no AVX2 version
+void hashRow(const uint8_t* src, uint32_t* lanes, int bytes)
+{
+#ifdef RING_X86_KERNELS
+   if (current() != Backend::SCALAR) {
+      hashRowSse2(src, lanes, bytes);
+      return;
+   }
+#endif
+
+   hashRowScalar(src, lanes, bytes);
+}
+
+void horizontalRow(const uint8_t* src, uint8_t* dst, const Tap* taps, int width)
+{
+   int done = 0;
+
+#ifdef RING_X86_KERNELS
+   if (current() != Backend::SCALAR)
+      done = horizontalRowSse2(src, dst, taps, width);
+#endif
+
+   horizontalRowScalar(src, dst, taps, done, width);
+}
+
+void yuv(const uint8_t* src, int srcStride, int width, int height, bool rgba,
+         uint8_t* y, uint8_t* u, uint8_t* v, int chromaStride, int step)
+{
+   for (int row = 0; row < height; row += 2) {
+      const uint8_t* r0 = src + row * srcStride;
+      const uint8_t* r1 = row + 1 < height ? r0 + srcStride : r0;
+
+      lumaRow(r0, y + row * width, width, rgba);
+
+      if (row + 1 < height)
+         lumaRow(r1, y + (row + 1) * width, width, rgba);
+
+      chromaRow(r0, r1, width, rgba, u + (row/2) * chromaStride, v + (row/2) * chromaStride, step);
+   }
+}
+
+///Source position of each destination pixel center, in 1/256 of pixel
+Tap tap(int i, int srcSize, int dstSize)
+{
+   int64_t pos = ((int64_t)(2*i + 1) * srcSize * 128) / dstSize - 128;
+
+   if (pos < 0)
+      pos = 0;
+
+   Tap t;
+   t.x0 = pos >> 8;
+   t.f  = pos & 0xff;
+
+   if (t.x0 >= srcSize - 1) {
+      t.x0 = srcSize - 1;
+      t.f  = 0;
+   }
+
+   t.x1 = std::min(t.x0 + 1, srcSize - 1);
+
+   return t;
+}
+
+} // namespace
+
+///The kernels being used
+Backend Video::FrameKernels::backend()
+{
+   return current();
+}
+
+///Restrict the kernels to an older instruction set, to compare them
+void Video::FrameKernels::setBackend(Backend backend)
+{
+   g_Backend = std::min(static_cast<int>(backend), static_cast<int>(g_Supported));
+}
+
+///Swap the red and blue channels, src and dst can be the same
+void Video::FrameKernels::swizzle(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride,
+                                  int width, int height)
+{
+   for (int row = 0; row < height; row++)
+      swizzleRow(src + row * srcStride, dst + row * dstStride, width);
+}
+
+///Planar YUV 4:2:0, the planes are tightly packed
+void Video::FrameKernels::toI420(const uint8_t* src, int srcStride, int width, int height, bool rgba,
+                                 uint8_t* y, uint8_t* u, uint8_t* v)
+{
+   yuv(src, srcStride, width, height, rgba, y, u, v, (width + 1) / 2, 1);
+}
+
+///Y plane followed by an interleaved UV plane
+void Video::FrameKernels::toNV12(const uint8_t* src, int srcStride, int width, int height, bool rgba,
+                                 uint8_t* y, uint8_t* uv)
+{
+   yuv(src, srcStride, width, height, rgba, y, uv, uv + 1, 2 * ((width + 1) / 2), 2);
+}
+
+///Bilinear scaling of 32 bits pixels, it is meant for downscaling
+void Video::FrameKernels::scale(const uint8_t* src, int srcStride, int srcWidth, int srcHeight,
+                                uint8_t* dst, int dstStride, int dstWidth, int dstHeight)
+{
+   if (srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 || dstHeight <= 0)
+      return;
+
+   std::vector<Tap> taps(dstWidth);
+   for (int x = 0; x < dstWidth; x++)
+      taps[x] = tap(x, srcWidth, dstWidth);
+
+   // The vertical pass is done first, for the full source width
+   std::vector<uint8_t> line(srcWidth * 4);
+
+   for (int row = 0; row < dstHeight; row++) {
+      const Tap t = tap(row, srcHeight, dstHeight);
+
+      const uint8_t* r0 = src + t.x0 * srcStride;
+      const uint8_t* r1 = src + t.x1 * srcStride;
+
+      if (t.f)
+         blendRow(r0, r1, line.data(), srcWidth * 4, t.f);
+
+      horizontalRow(t.f ? line.data() : r0, dst + row * dstStride, taps.data(), dstWidth);
+   }
+}
+
+/**
+ * Average each block of source pixels covered by a destination pixel.
+ *
+ * This is meant for large downscaling ratios (thumbnails), where the
+ * bilinear filter would skip most of the source pixels.
+ */
+void Video::FrameKernels::boxScale(const uint8_t* src, int srcStride, int srcWidth, int srcHeight,
+                                   uint8_t* dst, int dstStride, int dstWidth, int dstHeight)
+{
+   if (srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 || dstHeight <= 0)
+      return;
+
+   // The 16 bits counters can hold 257 rows, larger ratios don't need
+   // that much precision anyway
+   const int maxRows = 65535 / 255;
+
+   if (dstWidth > srcWidth || dstHeight > srcHeight || srcHeight / dstHeight >= maxRows) {
+      scale(src, srcStride, srcWidth, srcHeight, dst, dstStride, dstWidth, dstHeight);
+      return;
+   }
+
+   std::vector<uint16_t> acc(srcWidth * 4);
+
+   for (int row = 0; row < dstHeight; row++) {
+      const int y0 = (int64_t) row      * srcHeight / dstHeight;
+      const int y1 = (int64_t)(row + 1) * srcHeight / dstHeight;
+
+      std::fill(acc.begin(), acc.end(), 0);
+
+      for (int y = y0; y < y1; y++)
+         accumulateRow(src + y * srcStride, acc.data(), srcWidth * 4);
+
+      uint8_t* line = dst + row * dstStride;
+
+      for (int x = 0; x < dstWidth; x++) {
+         const int x0 = (int64_t) x      * srcWidth / dstWidth;
+         const int x1 = (int64_t)(x + 1) * srcWidth / dstWidth;
+         const int n  = (x1 - x0) * (y1 - y0);
+
+         for (int c = 0; c < 4; c++) {
+            uint32_t sum = 0;
+
+            for (int i = x0; i < x1; i++)
+               sum += acc[4*i + c];
+
+            line[4*x + c] = (sum + n / 2) / n;
+         }
+      }
+   }
+}
+
+/**
+ * Hash each tileSize x tileSize block of a 32 bits frame.
+ *
+ * This is used to find what changed between two frames, it reads every
+ * pixel but is not a cryptographic hash. The tiles are in row-major order,
+ * "hashes" must have room for all of them.
+ */
+void Video::FrameKernels::tileHashes(const uint8_t* src, int stride, int width, int height, int tileSize,
+                                     uint64_t* hashes)
+{
+   if (width <= 0 || height <= 0 || tileSize <= 0)
+      return;
+
+   const int tilesX = (width  + tileSize - 1) / tileSize;
+   const int tilesY = (height + tileSize - 1) / tileSize;
+
+   std::vector<uint32_t> lanes(tilesX * 4);
+
+   for (int ty = 0; ty < tilesY; ty++) {
+      std::fill(lanes.begin(), lanes.end(), 0x811c9dc5);
+
+      const int y1 = std::min(height, (ty + 1) * tileSize);
+
+      for (int y = ty * tileSize; y < y1; y++) {
+         const uint8_t* line = src + y * stride;
+
+         for (int tx = 0; tx < tilesX; tx++) {
+            const int x0    = tx * tileSize;
+            const int bytes = (std::min(width, x0 + tileSize) - x0) * 4;
+            const int full  = bytes & ~15;
+
+            hashRow(line + x0 * 4, &lanes[tx * 4], full);
+
+            // The last pixels of a row, padded to a full chunk
+            if (full != bytes) {
+               uint8_t chunk[16] = {};
+               memcpy(chunk, line + x0 * 4 + full, bytes - full);
+               hashChunkScalar(&lanes[tx * 4], chunk);
+            }
+         }
+      }
+
+      for (int tx = 0; tx < tilesX; tx++) {
+         const uint32_t* l = &lanes[tx * 4];
+         const uint64_t  a = ((uint64_t)l[0] << 32) | l[1];
+         const uint64_t  b = ((uint64_t)l[2] << 32) | l[3];
+
+         hashes[ty * tilesX + tx] = a ^ (b * 0x9E3779B97F4A7C15ULL);
+      }
+   }
+}
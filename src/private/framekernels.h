@@ -0,0 +1,67 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+// Std
+#include <cstdint>
+
+namespace Video {
+
+/**
+ * Pixel conversion and scaling loops used by the FrameConverter.
+ *
+ * The 32 bits pixel formats (BGRA and RGBA) are little endian, the "rgba"
+ * arguments tell which one the source is. The YUV output is BT.601 limited
+ * range with the chroma planes subsampled by 2 in both directions.
+ *
+ * Each kernel has a scalar version and SSE2 and/or AVX2 versions, the best
+ * one supported by the CPU is selected at runtime. They all produce the
+ * same output.
+ */
+namespace FrameKernels {
+
+enum class Backend {
+   SCALAR,
+   SSE2  ,
+   AVX2  ,
+};
+
+Backend backend   ();
+void    setBackend(Backend backend);
+
+void swizzle(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride,
+             int width, int height);
+
+void toI420 (const uint8_t* src, int srcStride, int width, int height, bool rgba,
+             uint8_t* y, uint8_t* u, uint8_t* v);
+
+void toNV12 (const uint8_t* src, int srcStride, int width, int height, bool rgba,
+             uint8_t* y, uint8_t* uv);
+
+void scale  (const uint8_t* src, int srcStride, int srcWidth, int srcHeight,
+             uint8_t* dst, int dstStride, int dstWidth, int dstHeight);
+
+void boxScale(const uint8_t* src, int srcStride, int srcWidth, int srcHeight,
+              uint8_t* dst, int dstStride, int dstWidth, int dstHeight);
+
+void tileHashes(const uint8_t* src, int stride, int width, int height, int tileSize,
+                uint64_t* hashes);
+
+} // namespace FrameKernels
+
+} // namespace Video
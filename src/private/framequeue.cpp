@@ -0,0 +1,132 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "framequeue.h"
+
+// Std
+#include <cstdint>
+
+Video::FrameQueue::FrameQueue(int capacity) :
+   m_Capacity(capacity > 0 ? capacity : 1), m_lCells(new Cell[m_Capacity]),
+   m_EnqueuePos(0), m_DequeuePos(0)
+{
+   for (std::size_t i = 0; i < m_Capacity; i++)
+      m_lCells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+Video::FrameQueue::~FrameQueue()
+{
+}
+
+int Video::FrameQueue::capacity() const
+{
+   return m_Capacity;
+}
+
+///If there is no frame to pop, a frame being pushed may not count yet
+bool Video::FrameQueue::isEmpty() const
+{
+   return m_DequeuePos.load(std::memory_order_relaxed)
+      >= m_EnqueuePos.load(std::memory_order_relaxed);
+}
+
+///Move the frame in the queue if there is room left
+bool Video::FrameQueue::tryPush(Frame& frame)
+{
+   std::size_t pos = m_EnqueuePos.load(std::memory_order_relaxed);
+   Cell* cell;
+
+   while (true) {
+      cell = &m_lCells[pos % m_Capacity];
+
+      const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t    dif = (intptr_t)seq - (intptr_t)pos;
+
+      if (!dif) {
+         if (m_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            break;
+      }
+      else if (dif < 0)
+         return false;
+      else
+         pos = m_EnqueuePos.load(std::memory_order_relaxed);
+   }
+
+   cell->frame = std::move(frame);
+   cell->sequence.store(pos + 1, std::memory_order_release);
+
+   return true;
+}
+
+/**
+ * Add a frame to the queue.
+ *
+ * When the queue is full, either the oldest frame (latestWins) or the new
+ * one is discarded.
+ *
+ * @return false if a frame was discarded
+ */
+bool Video::FrameQueue::push(Frame&& frame, bool latestWins)
+{
+   if (tryPush(frame))
+      return true;
+
+   if (!latestWins)
+      return false;
+
+   // The consumer may have made some room in the meantime, then nothing
+   // is actually lost
+   Frame discarded;
+   bool  dropped = false;
+
+   do {
+      dropped |= pop(discarded);
+   } while (!tryPush(frame));
+
+   return !dropped;
+}
+
+///Take the oldest frame, return false if the queue is empty
+bool Video::FrameQueue::pop(Frame& frame)
+{
+   std::size_t pos = m_DequeuePos.load(std::memory_order_relaxed);
+   Cell* cell;
+
+   while (true) {
+      cell = &m_lCells[pos % m_Capacity];
+
+      const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t    dif = (intptr_t)seq - (intptr_t)(pos + 1);
+
+      if (!dif) {
+         if (m_DequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            break;
+      }
+      else if (dif < 0)
+         return false;
+      else
+         pos = m_DequeuePos.load(std::memory_order_relaxed);
+   }
+
+   frame = std::move(cell->frame);
+
+   // Don't keep the buffer alive until the cell is reused
+   cell->frame = Frame();
+   cell->sequence.store(pos + m_Capacity, std::memory_order_release);
+
+   return true;
+}
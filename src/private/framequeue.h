@@ -0,0 +1,66 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+// Std
+#include <atomic>
+#include <memory>
+
+//Ring
+#include "video/renderer.h"
+
+namespace Video {
+
+/**
+ * Bounded frame queue between the thread receiving the frames and the client.
+ *
+ * This is a lock free array based queue (Dmitry Vyukov's bounded MPMC
+ * design). There is a single producer and a single consumer, but the
+ * producer also act as a consumer when it has to discard the oldest frame to
+ * make room for a new one.
+ */
+class FrameQueue final
+{
+public:
+   explicit FrameQueue(int capacity);
+   ~FrameQueue();
+
+   //Getters
+   int  capacity() const;
+   bool isEmpty () const;
+
+   //Mutators
+   bool push(Frame&& frame, bool latestWins);
+   bool pop (Frame&  frame                 );
+
+private:
+   struct Cell {
+      std::atomic<std::size_t> sequence;
+      Frame                    frame   ;
+   };
+
+   bool tryPush(Frame& frame);
+
+   //Attributes
+   const std::size_t        m_Capacity;
+   std::unique_ptr<Cell[]>  m_lCells  ;
+   alignas(64) std::atomic<std::size_t> m_EnqueuePos;
+   alignas(64) std::atomic<std::size_t> m_DequeuePos;
+};
+
+} // namespace Video
@@ -0,0 +1,350 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "framewaiter.h"
+
+//Qt
+#include <QtCore/QDebug>
+
+// Std
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include <errno.h>
+
+// glibc keeps the value of a semaphore in the low 32 bits of a 64 bits word
+// on 64 bits architectures, and the number of waiters in the high 32 bits.
+// The value is the futex sem_post() wakes when there are waiters.
+#if defined(__linux__) && defined(__GLIBC__) && defined(__LP64__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+ #define HAVE_SEMAPHORE_FUTEX
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef HAVE_SEMAPHORE_FUTEX
+///struct futex_waitv, the headers before Linux 5.16 don't have it
+struct FutexWaitv {
+   uint64_t val     ;
+   uint64_t uaddr   ;
+   uint32_t flags   ;
+   uint32_t reserved;
+};
+
+// Constants
+constexpr static const long     SYS_FUTEX_WAITV  = 449 ; // on every architecture
+constexpr static const uint32_t WAITV_U32        = 0x02;
+constexpr static const uint32_t WAITV_PRIVATE    = 128 ;
+constexpr static const int      WAITV_MAX        = 128 ;
+constexpr static const uint64_t SEMAPHORE_WAITER = uint64_t(1) << 32;
+
+///If all the semaphores can be waited on at once
+bool hasFutexWaitv()
+{
+   static const bool ret = [] {
+      // Check that the semaphores have the expected layout
+      sem_t sem;
+      ::sem_init(&sem, 0, 3);
+      ::sem_post(&sem);
+
+      uint64_t data;
+      ::memcpy(&data, &sem, sizeof(data));
+      ::sem_destroy(&sem);
+
+      if (data != 4)
+         return false;
+
+      // An empty list is rejected when the call exists
+      return ::syscall(SYS_FUTEX_WAITV, nullptr, 0, 0, nullptr, 0) < 0 && errno == EINVAL;
+   }();
+
+   return ret;
+}
+#endif
+
+/**
+ * sem_post() only wakes the semaphore futex when the semaphore has waiters,
+ * the waiter counts as one for as long as the source is added.
+ */
+void setSemaphoreWaiter(FrameSource* source, bool waiting)
+{
+#ifdef HAVE_SEMAPHORE_FUTEX
+   if (!hasFutexWaitv())
+      return;
+
+   auto data = reinterpret_cast<uint64_t*>(source->frameSemaphore());
+
+   if (waiting)
+      __atomic_fetch_add(data, SEMAPHORE_WAITER, __ATOMIC_ACQ_REL);
+   else
+      __atomic_fetch_sub(data, SEMAPHORE_WAITER, __ATOMIC_ACQ_REL);
+#else
+   Q_UNUSED(source)
+   Q_UNUSED(waiting)
+#endif
+}
+
+}
+
+FrameWaiter::~FrameWaiter()
+{
+   {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Stop = true;
+      wakeUp();
+   }
+
+   m_Cond.notify_all();
+
+   if (m_Thread.joinable())
+      m_Thread.join();
+
+   // The sources should have been removed, they are still valid if not
+   for (FrameSource* source : m_lSources)
+      setSemaphoreWaiter(source, false);
+}
+
+///The number of sources a waiter accepts
+int FrameWaiter::capacity()
+{
+#ifdef HAVE_SEMAPHORE_FUTEX
+   // The first futex is used to wake the thread up
+   if (hasFutexWaitv())
+      return WAITV_MAX - 1;
+#endif
+
+   return 1;
+}
+
+bool FrameWaiter::isFull() const
+{
+   std::lock_guard<std::mutex> lock(m_Mutex);
+   return m_lSources.size() >= static_cast<std::size_t>(capacity());
+}
+
+///The thread is started with the first source, false if the waiter is full
+bool FrameWaiter::add(FrameSource* source)
+{
+   std::lock_guard<std::mutex> lock(m_Mutex);
+
+   if (m_lSources.size() >= static_cast<std::size_t>(capacity()))
+      return false;
+
+   setSemaphoreWaiter(source, true);
+   m_lSources.push_back(source);
+
+   if (!m_Thread.joinable())
+      m_Thread = std::thread(&FrameWaiter::run, this);
+
+   wakeUp();
+   m_Cond.notify_all();
+
+   return true;
+}
+
+///Return once the source is no longer used by the waiter thread
+void FrameWaiter::remove(FrameSource* source)
+{
+   std::unique_lock<std::mutex> lock(m_Mutex);
+
+   const auto it = std::find(m_lSources.begin(), m_lSources.end(), source);
+
+   // Another thread is removing it
+   if (it == m_lSources.end()) {
+      m_Cond.wait(lock, [this, source] {
+         return std::find(m_lRemoving.begin(), m_lRemoving.end(), source) == m_lRemoving.end();
+      });
+      return;
+   }
+
+   m_lSources.erase(it);
+
+   // Called while the source handles a frame, it returns right after
+   if (std::this_thread::get_id() == m_Thread.get_id()) {
+      setSemaphoreWaiter(source, false);
+      return;
+   }
+
+   m_lRemoving.push_back(source);
+
+   // The thread may be blocked on the semaphore, wait until it is released
+   const uint64_t round = m_Round;
+   wakeUp();
+
+   m_Cond.wait(lock, [this, source, round] {
+      return m_pCurrent != source && ((!m_Waiting) || m_Round != round);
+   });
+
+   setSemaphoreWaiter(source, false);
+
+   m_lRemoving.erase(std::remove(m_lRemoving.begin(), m_lRemoving.end(), source), m_lRemoving.end());
+   m_Cond.notify_all();
+}
+
+///Make a wait() in progress return, m_Mutex is locked
+void FrameWaiter::wakeUp()
+{
+   if (!m_Waiting)
+      return;
+
+#ifdef HAVE_SEMAPHORE_FUTEX
+   if (hasFutexWaitv()) {
+      __atomic_add_fetch(&m_Control, 1, __ATOMIC_SEQ_CST);
+      ::syscall(SYS_futex, &m_Control, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+      return;
+   }
+#endif
+
+   if (m_pBlockedOn)
+      ::sem_post(m_pBlockedOn);
+}
+
+///The next source with a posted semaphore, in turn
+FrameSource* FrameWaiter::nextReady()
+{
+   const std::size_t count = m_lSources.size();
+
+   for (std::size_t i = 0; i < count; i++) {
+      FrameSource* source = m_lSources[(m_Next + i) % count];
+
+      int value = 0;
+      if (::sem_getvalue(source->frameSemaphore(), &value) == 0 && value > 0) {
+         m_Next = (m_Next + i + 1) % count;
+         return source;
+      }
+   }
+
+   return nullptr;
+}
+
+/**
+ * Block until a semaphore is posted or wakeUp() is called.
+ *
+ * @return the source whose semaphore was taken, if any
+ */
+FrameSource* FrameWaiter::wait(std::unique_lock<std::mutex>& lock)
+{
+   FrameSource* ready = nullptr;
+   m_Waiting = true;
+
+#ifdef HAVE_SEMAPHORE_FUTEX
+   if (hasFutexWaitv()) {
+      FutexWaitv waitv[WAITV_MAX];
+      int        count = 0;
+
+      waitv[count++] = { m_Control, reinterpret_cast<uintptr_t>(&m_Control), WAITV_U32 | WAITV_PRIVATE, 0 };
+
+      // The semaphores are shared with the producer process
+      for (FrameSource* source : m_lSources)
+         waitv[count++] = { 0, reinterpret_cast<uintptr_t>(source->frameSemaphore()), WAITV_U32, 0 };
+
+      lock.unlock();
+
+      // Also returns right away if a semaphore was posted or m_Control changed
+      const long ret = ::syscall(SYS_FUTEX_WAITV, waitv, count, 0, nullptr, 0);
+      const int  err = errno;
+
+      lock.lock();
+
+      if (ret < 0 && err != EAGAIN && err != EINTR) {
+         qWarning() << "Waiting for the frames failed: " << strerror(err);
+
+         // Don't spin, wait for the sources to change
+         m_Waiting = false;
+         m_Round++;
+         m_Cond.notify_all();
+         m_Cond.wait(lock);
+         return nullptr;
+      }
+   }
+   else
+#endif
+   {
+      FrameSource* source = m_lSources.front();
+      m_pBlockedOn = source->frameSemaphore();
+
+      lock.unlock();
+
+      const int ret = ::sem_wait(m_pBlockedOn);
+      const int err = errno;
+
+      lock.lock();
+
+      m_pBlockedOn = nullptr;
+
+      // It may have been posted by wakeUp() for a removal or to stop
+      const bool isWatched = (!m_Stop) && (!m_lSources.empty()) && m_lSources.front() == source;
+
+      if (ret == 0 && isWatched)
+         ready = source;
+      else if (ret < 0 && err != EINTR && isWatched) {
+         qWarning() << "Waiting for a frame failed: " << strerror(err);
+         m_lSources.clear();
+      }
+   }
+
+   m_Waiting = false;
+   m_Round++;
+   m_Cond.notify_all();
+
+   return ready;
+}
+
+void FrameWaiter::run()
+{
+   std::unique_lock<std::mutex> lock(m_Mutex);
+
+   while (!m_Stop) {
+      if (m_lSources.empty()) {
+         m_Cond.wait(lock);
+         continue;
+      }
+
+      FrameSource* source = nextReady();
+
+      if (!source)
+         source = wait(lock);
+
+      if (!source)
+         continue;
+
+      m_pCurrent = source;
+      lock.unlock();
+
+      // One notification for all the frames posted since the last one
+      while (::sem_trywait(source->frameSemaphore()) == 0);
+
+      const auto result = source->handleFrame();
+
+      lock.lock();
+      m_pCurrent = nullptr;
+
+      if (result == FrameSource::Result::FAILED) {
+         const auto it = std::find(m_lSources.begin(), m_lSources.end(), source);
+
+         if (it != m_lSources.end()) {
+            m_lSources.erase(it);
+            setSemaphoreWaiter(source, false);
+         }
+      }
+
+      m_Cond.notify_all();
+   }
+}
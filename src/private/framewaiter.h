@@ -0,0 +1,96 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+// Std
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <semaphore.h>
+
+/**
+ * Something a FrameWaiter waits on, such as a shared memory area. The
+ * producer posts a process shared semaphore for each new frame.
+ *
+ * The calls are made from the waiter thread, one at a time.
+ */
+class FrameSource
+{
+public:
+   enum class Result {
+      FRAME  , /*!< A frame was handled                             */
+      NONE   , /*!< There was no new frame                          */
+      FAILED , /*!< The source is broken, it will not be waited on  */
+   };
+
+   virtual ~FrameSource() {}
+
+   ///The semaphore posted by the producer, it can move after handleFrame()
+   virtual sem_t* frameSemaphore() = 0;
+
+   ///Handle the latest frame without blocking, the semaphore was posted
+   virtual Result handleFrame() = 0;
+};
+
+/**
+ * Wait for the frames of one or more sources on a single thread.
+ *
+ * The thread sleeps until a source semaphore is posted or the sources
+ * change, it never polls. On Linux 5.16 and later, all the semaphores are
+ * waited on at once with futex_waitv(). Otherwise, or when the C library
+ * semaphores can't be used as futexes, a waiter only accepts one source.
+ */
+class FrameWaiter final
+{
+public:
+   FrameWaiter() = default;
+   ~FrameWaiter();
+
+   //Getters
+   bool isFull() const;
+
+   //Mutators
+   bool add   (FrameSource* source);
+   void remove(FrameSource* source);
+
+   static int capacity();
+
+private:
+   //Attributes
+   mutable std::mutex        m_Mutex     ;
+   std::condition_variable   m_Cond      ;
+   std::vector<FrameSource*> m_lSources  ;
+   std::vector<FrameSource*> m_lRemoving ; // removed, but maybe still in use
+   FrameSource*              m_pCurrent  {nullptr}; // being handled, outside of m_Mutex
+   bool                      m_Waiting   {false  }; // blocked outside of m_Mutex
+   sem_t*                    m_pBlockedOn{nullptr}; // without futex_waitv(), posted to wake up
+   uint64_t                  m_Round     {0      }; // incremented when the wait returns
+   uint32_t                  m_Control   {0      }; // futex, incremented to wake the thread up
+   std::size_t               m_Next      {0      }; // round robin position
+   bool                      m_Stop      {false  };
+   std::thread               m_Thread    ;
+
+   //Helpers
+   void         run      ();
+   void         wakeUp   ();
+   FrameSource* wait     (std::unique_lock<std::mutex>& lock);
+   FrameSource* nextReady();
+};
@@ -20,6 +20,8 @@
 #include <QtCore/QObject>
 #include <QtCore/QHash>
 
+#include "eventcoalescer.h"
+
 class Account;
 class Call;
 class ContactMethod;
@@ -38,6 +40,14 @@ public:
 
    static IMConversationManagerPrivate& instance();
 
+   ///The latest status of each (account, message id) pair, with the recipient
+   typedef EventCoalescer<QPair<QString,quint64>, QPair<QString,int>> StatusEvents;
+
+private:
+   StatusEvents m_StatusEvents;
+
+   void processStatusEvents(const StatusEvents::Batch& events);
+
 private Q_SLOTS:
    void newMessage       (const QString& callId   , const QString& from, const QMap<QString,QString>& payloads);
    void newAccountMessage(const QString& accountId, const QString& from, const QMap<QString,QString>& payloads);
@@ -0,0 +1,102 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//libSTDC++
+#include <new>
+#include <utility>
+#include <type_traits>
+
+/**
+ * Allocate objects in blocks of `BlockSize` and destroy them all at once.
+ *
+ * This is meant for objects that are created in large number and are never
+ * freed individually, such as the messages of a text conversation. It saves
+ * one heap allocation (and its bookkeeping overhead) per object and keeps
+ * them close in memory.
+ *
+ * Objects created with create() must not be deleted.
+ */
+template<typename T, int BlockSize = 128>
+class ObjectPool
+{
+public:
+   ObjectPool() {}
+   ~ObjectPool();
+
+   ObjectPool(const ObjectPool&) = delete;
+   ObjectPool& operator=(const ObjectPool&) = delete;
+
+   template<typename... Args>
+   T* create(Args&&... args);
+
+   ///The number of objects created from this pool
+   int size  () const { return m_Size;   }
+
+   ///The number of heap allocations done by this pool
+   int blocks() const { return m_Blocks; }
+
+private:
+   struct Block {
+      Block* m_pPrevious;
+      typename std::aligned_storage<sizeof(T), alignof(T)>::type m_lItems[BlockSize];
+   };
+
+   Block* m_pCurrent {nullptr  };
+   int    m_Used     {BlockSize};
+   int    m_Size     {0        };
+   int    m_Blocks   {0        };
+};
+
+template<typename T, int BlockSize>
+ObjectPool<T, BlockSize>::~ObjectPool()
+{
+   int used = m_Used;
+
+   while (m_pCurrent) {
+      for (int i = 0; i < used; ++i)
+         reinterpret_cast<T*>(&m_pCurrent->m_lItems[i])->~T();
+
+      Block* previous = m_pCurrent->m_pPrevious;
+      delete m_pCurrent;
+      m_pCurrent = previous;
+
+      //Only the last block can be partially used
+      used = BlockSize;
+   }
+}
+
+template<typename T, int BlockSize>
+template<typename... Args>
+T* ObjectPool<T, BlockSize>::create(Args&&... args)
+{
+   if (m_Used == BlockSize) {
+      Block* b       = new Block;
+      b->m_pPrevious = m_pCurrent;
+      m_pCurrent     = b;
+      m_Used         = 0;
+      ++m_Blocks;
+   }
+
+   T* ret = ::new (static_cast<void*>(&m_pCurrent->m_lItems[m_Used])) T(std::forward<Args>(args)...);
+
+   ++m_Used;
+   ++m_Size;
+
+   return ret;
+}
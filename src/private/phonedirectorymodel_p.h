@@ -22,6 +22,7 @@
 //Ring
 class PhoneDirectoryModel;
 #include "contactmethod.h"
+#include "eventcoalescer.h"
 
 //Internal data structures
 ///@struct NumberWrapper Wrap phone numbers to prevent collisions
@@ -76,7 +77,11 @@ public:
    };
 
 
+   ///The latest presence of each (account, uri) pair
+   typedef EventCoalescer<QPair<QString,QString>, QPair<bool,QString>> PresenceEvents;
+
    //Helpers
+   void processPresenceEvents(const PresenceEvents::Batch& events);
    void indexNumber(ContactMethod* number, const QStringList& names   );
    void setAccount (ContactMethod* number,       Account*     account );
    ContactMethod* fillDetails(NumberWrapper* wrap, const URI& strippedUri, Account* account, Person* contact, const QString& type);
@@ -90,6 +95,7 @@ public:
    QHash<QString,NumberWrapper*> m_hNumbersByNames  ;
    bool                          m_CallWithAccount  ;
    MostPopularNumberModel*       m_pPopularModel    ;
+   PresenceEvents                m_PresenceEvents   ;
 
    Q_DECLARE_PUBLIC(PhoneDirectoryModel)
 
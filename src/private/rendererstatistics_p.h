@@ -0,0 +1,74 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+// Std
+#include <atomic>
+#include <chrono>
+
+//Qt
+#include <QtCore/QtGlobal>
+class QTimer;
+
+namespace Video {
+
+class RendererStatisticsPrivate final
+{
+public:
+   typedef std::chrono::steady_clock Clock;
+
+   ///Upper bound of each inter-frame interval bucket (ms), the last is open
+   constexpr static const int BUCKETS[] = {10, 20, 35, 50, 70, 100, 200};
+   constexpr static const int BUCKET_COUNT = sizeof(BUCKETS)/sizeof(int) + 1;
+
+   RendererStatisticsPrivate();
+
+   //Attributes
+   std::atomic<quint64> m_Received                 ;
+   std::atomic<quint64> m_Consumed                 ;
+   std::atomic<quint64> m_Dropped                  ;
+   std::atomic<quint64> m_Overwritten              ;
+   std::atomic<quint64> m_lIntervals[BUCKET_COUNT] ;
+   std::atomic<quint64> m_LatencySum               ;
+   std::atomic<quint64> m_LatencyCount             ;
+   std::atomic<quint64> m_LatencyMax               ;
+   std::atomic<quint64> m_LockWaitSum              ;
+   std::atomic<quint64> m_LockWaitCount            ;
+   std::atomic<quint64> m_LockWaitMax              ;
+   std::atomic<qint64>  m_LastReceived             ; // Clock ticks, 0 for none
+
+   //Sampling, only used by the RendererStatistics thread
+   QTimer*              m_pTimer         {nullptr} ;
+   quint64              m_LastSample     {0}       ;
+
+   //Mutators
+   Clock::time_point received  (                                           );
+   void              consumed  ( Clock::time_point timestamp, quint64 skipped );
+   void              dropped   (                                           );
+   void              lockWaited( Clock::duration wait                      );
+   void              reset     (                                           );
+
+   //Getters
+   Clock::time_point lastReceived() const;
+   quint64           sampleKey   () const;
+
+private:
+   static void storeMax(std::atomic<quint64>& max, quint64 value);
+};
+
+} // namespace Video
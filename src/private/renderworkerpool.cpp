@@ -0,0 +1,226 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "renderworkerpool.h"
+
+//Qt
+#include <QtCore/QThread>
+
+// Std
+#include <algorithm>
+
+//Ring
+#include <video/renderer.h>
+#include "private/videorenderer_p.h"
+
+#ifndef ENABLE_LIBWRAP
+ #include "private/framewaiter.h"
+#endif
+
+/**
+ * @param size the maximum number of threads, the number of cores if <= 0
+ */
+RenderWorkerPool::RenderWorkerPool(int size, QObject* parent) : QObject(parent),
+m_Size(size > 0 ? size : qMax(1, QThread::idealThreadCount()))
+{
+}
+
+RenderWorkerPool::~RenderWorkerPool()
+{
+   QList<Video::Renderer*> renderers;
+
+   {
+      QMutexLocker locker(&m_Mutex);
+      renderers = m_hRenderers.keys();
+      m_hRenderers.clear();
+   }
+
+   // Stop waiting for their frames before the waiters are deleted
+   for (Video::Renderer* r : renderers)
+      unwatchAll(r);
+
+   // The renderers removed earlier are deleted when their thread finishes
+   for (const auto& w : m_lWorkers) {
+      w.thread->quit();
+      w.thread->wait();
+   }
+
+   qDeleteAll(renderers);
+
+#ifndef ENABLE_LIBWRAP
+   for (const auto& w : m_lWorkers)
+      qDeleteAll(w.waiters);
+#endif
+}
+
+///The maximum number of threads
+int RenderWorkerPool::size() const
+{
+   return m_Size;
+}
+
+///The number of threads created so far
+int RenderWorkerPool::threadCount() const
+{
+   QMutexLocker locker(&m_Mutex);
+   return m_lWorkers.size();
+}
+
+int RenderWorkerPool::rendererCount() const
+{
+   QMutexLocker locker(&m_Mutex);
+   return m_hRenderers.size();
+}
+
+///Move the renderer to the least busy thread, a new one is started if possible
+void RenderWorkerPool::add(Video::Renderer* r)
+{
+   QMutexLocker locker(&m_Mutex);
+
+   if (m_hRenderers.contains(r))
+      return;
+
+   int idx = -1;
+
+   for (int i = 0; i < m_lWorkers.size(); i++) {
+      if (idx == -1 || m_lWorkers[i].renderers < m_lWorkers[idx].renderers)
+         idx = i;
+   }
+
+   if (idx == -1 || (m_lWorkers[idx].renderers && m_lWorkers.size() < m_Size)) {
+      QThread* t = new QThread(this);
+      t->setObjectName(QStringLiteral("RenderWorker%1").arg(m_lWorkers.size()));
+      t->start();
+
+      m_lWorkers << Worker { t, {}, 0 };
+      idx = m_lWorkers.size() - 1;
+   }
+
+   m_lWorkers[idx].renderers++;
+   m_hRenderers[r] = idx;
+   r->d_ptr->m_pWorkers = this;
+
+   r->moveToThread(m_lWorkers[idx].thread);
+}
+
+///Forget the renderer and delete it once its thread is done with it
+void RenderWorkerPool::remove(Video::Renderer* r)
+{
+   {
+      QMutexLocker locker(&m_Mutex);
+
+      const int idx = m_hRenderers.value(r, -1);
+
+      if (idx == -1)
+         return;
+
+      m_hRenderers.remove(r);
+      m_lWorkers[idx].renderers--;
+   }
+
+   unwatchAll(r);
+
+   r->deleteLater();
+}
+
+/**
+ * Wait for the frames of "source" on a waiter of the renderer thread.
+ *
+ * @return false if the renderer is not in the pool
+ */
+bool RenderWorkerPool::watch(Video::Renderer* r, FrameSource* source)
+{
+#ifdef ENABLE_LIBWRAP
+   // The frames are pushed by the daemon threads
+   Q_UNUSED(r)
+   Q_UNUSED(source)
+   return false;
+#else
+   QMutexLocker locker(&m_Mutex);
+
+   const int idx = m_hRenderers.value(r, -1);
+
+   if (idx == -1 || m_hSources.contains(source))
+      return false;
+
+   auto& waiters = m_lWorkers[idx].waiters;
+
+   const auto it = std::find_if(waiters.constBegin(), waiters.constEnd(), [](FrameWaiter* w) {
+      return !w->isFull();
+   });
+
+   FrameWaiter* w = it == waiters.constEnd() ? nullptr : *it;
+
+   if (!w) {
+      w = new FrameWaiter();
+      waiters << w;
+   }
+
+   w->add(source);
+   m_hSources[source] = { r, w };
+
+   return true;
+#endif
+}
+
+///Stop waiting for "source", it is no longer used when this returns
+void RenderWorkerPool::unwatch(FrameSource* source)
+{
+#ifdef ENABLE_LIBWRAP
+   Q_UNUSED(source)
+#else
+   FrameWaiter* w = nullptr;
+
+   {
+      QMutexLocker locker(&m_Mutex);
+
+      if (!m_hSources.contains(source))
+         return;
+
+      w = m_hSources[source].waiter;
+   }
+
+   // Outside of the pool lock, this may wait for the waiter thread. It can
+   // be removed by the renderer and the pool at the same time.
+   w->remove(source);
+
+   QMutexLocker locker(&m_Mutex);
+   m_hSources.remove(source);
+#endif
+}
+
+///Stop waiting for the sources of a renderer leaving the pool
+void RenderWorkerPool::unwatchAll(Video::Renderer* r)
+{
+   QList<FrameSource*> sources;
+
+   {
+      QMutexLocker locker(&m_Mutex);
+
+      for (auto i = m_hSources.constBegin(); i != m_hSources.constEnd(); ++i) {
+         if (i.value().renderer == r)
+            sources << i.key();
+      }
+   }
+
+   for (FrameSource* source : sources)
+      unwatch(source);
+
+   // It no longer uses the pool
+   QMutexLocker locker(&m_Mutex);
+   r->d_ptr->m_pWorkers = nullptr;
+}
@@ -0,0 +1,87 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
+class QThread;
+
+class FrameSource;
+class FrameWaiter;
+
+namespace Video {
+   class Renderer;
+}
+
+/**
+ * A fixed set of threads shared by all the video renderers.
+ *
+ * The renderers are moved to the least busy thread when they are added and
+ * deleted from there when they are removed. The threads are created on
+ * demand, they are kept until the pool is destroyed.
+ *
+ * Each thread also has FrameWaiters for the frame sources of its renderers.
+ * A waiter blocks on all of its sources at once, so the number of blocked
+ * threads doesn't grow with the number of renderers where the system allows
+ * it. The renderers still in the pool when it is destroyed are deleted.
+ */
+class RenderWorkerPool final : public QObject
+{
+   Q_OBJECT
+
+public:
+   explicit RenderWorkerPool(int size = 0, QObject* parent = nullptr);
+   virtual ~RenderWorkerPool();
+
+   //Getters
+   int size        () const;
+   int threadCount () const;
+   int rendererCount() const;
+
+   //Mutators
+   void add    (Video::Renderer* r);
+   void remove (Video::Renderer* r);
+   bool watch  (Video::Renderer* r, FrameSource* source);
+   void unwatch(FrameSource* source);
+
+private:
+   struct Worker {
+      QThread*              thread   ;
+      QVector<FrameWaiter*> waiters  ;
+      int                   renderers;
+   };
+
+   struct Watch {
+      Video::Renderer* renderer;
+      FrameWaiter*     waiter  ;
+   };
+
+   //Attributes
+   int                          m_Size       ;
+   mutable QMutex               m_Mutex      ; // the pool is used by the renderer threads
+   QVector<Worker>              m_lWorkers   ;
+   QHash<Video::Renderer*, int> m_hRenderers ; // renderer -> worker index
+   QHash<FrameSource*, Watch>   m_hSources   ;
+
+   //Helpers
+   void unwatchAll(Video::Renderer* r);
+};
@@ -0,0 +1,57 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+#include <semaphore.h>
+#include <cstdint>
+
+/* Shared memory object
+ * Implementation note: double-buffering
+ * Shared memory is divided in two regions, each representing one frame.
+ * First byte of each frame is warranted to by aligned on 16 bytes.
+ * One region is marked readable: this region can be safely read.
+ * The other region is writeable: only the producer can use it.
+ *
+ * This layout is shared with the daemon, it is in its own header so an
+ * alternative producer can be written against it. A producer:
+ *
+ *  1. Creates the area with shm_open() and ftruncate() it to
+ *     sizeof(SHMHeader) + 2 * frameSize (plus alignment), then initializes
+ *     both semaphores with sem_init(..., 1, 1) for "mutex" and
+ *     sem_init(..., 1, 0) for "frameGenMutex".
+ *  2. Writes each frame at data + writeOffset without holding the lock.
+ *  3. Locks "mutex", swaps readOffset and writeOffset, increments frameGen,
+ *     unlocks "mutex" and posts "frameGenMutex".
+ *  4. To change the frame size, it locks "mutex", grows the area with
+ *     ftruncate(), updates frameSize, mapSize and both offsets, then
+ *     unlocks it. The clients remap the area when mapSize changes.
+ */
+struct SHMHeader {
+   sem_t    mutex        ; /*!< Lock it before any operations on following fields.           */
+   sem_t    frameGenMutex; /*!< unlocked by producer when frameGen modified                  */
+   unsigned frameGen     ; /*!< monotonically incremented when a producer changes readOffset */
+   unsigned frameSize    ; /*!< size in bytes of 1 frame                                     */
+   unsigned mapSize      ; /*!< size to map if you need to see all data                      */
+   unsigned readOffset   ; /*!< offset of readable frame in data                             */
+   unsigned writeOffset  ; /*!< offset of writable frame in data                             */
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-pedantic"
+   uint8_t data[]     ; /*!< the whole shared memory                                      */
+#pragma GCC diagnostic pop
+};
@@ -35,43 +35,24 @@
 #define CLOCK_REALTIME 0
 #endif
 
-#include <QtCore/QTimer>
 #include <chrono>
+#include <cstring>
 
 #include "private/videorenderermanager.h"
+#include "private/renderworkerpool.h"
+#include "private/framewaiter.h"
 #include "video/resolution.h"
 #include "private/videorenderer_p.h"
+#include "private/rendererstatistics_p.h"
+#include "private/shmheader.h"
 #include "videomanager_interface.h"
 
 // Uncomment following line to output in console the FPS value
 //#define DEBUG_FPS
 
-/* Shared memory object
- * Implementation note: double-buffering
- * Shared memory is divided in two regions, each representing one frame.
- * First byte of each frame is warranted to by aligned on 16 bytes.
- * One region is marked readable: this region can be safely read.
- * The other region is writeable: only the producer can use it.
- */
-
-struct SHMHeader {
-   sem_t    mutex        ; /*!< Lock it before any operations on following fields.           */
-   sem_t    frameGenMutex; /*!< unlocked by producer when frameGen modified                  */
-   unsigned frameGen     ; /*!< monotonically incremented when a producer changes readOffset */
-   unsigned frameSize    ; /*!< size in bytes of 1 frame                                     */
-   unsigned mapSize      ; /*!< size to map if you need to see all data                      */
-   unsigned readOffset   ; /*!< offset of readable frame in data                             */
-   unsigned writeOffset  ; /*!< offset of writable frame in data                             */
-
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-pedantic"
-   uint8_t data[]     ; /*!< the whole shared memory                                      */
-#pragma GCC diagnostic pop
-};
-
 namespace Video {
 
-class ShmRendererPrivate final : public QObject
+class ShmRendererPrivate final : public QObject, public FrameSource
 {
    Q_OBJECT
 
@@ -79,29 +60,38 @@ public:
    ShmRendererPrivate(ShmRenderer* parent);
 
    //Types
-   using TimePoint = std::chrono::time_point<std::chrono::system_clock>;
+   using TimePoint = std::chrono::time_point<std::chrono::steady_clock>;
 
    // Attributes
-   QString    m_ShmPath       ;
-   int        m_fd            ;
-   SHMHeader* m_pShmArea      ;
-   unsigned   m_ShmAreaLen    ;
-   uint       m_FrameGen      ;
-   int        m_fpsC          ;
-   int        m_Fps           ;
-   TimePoint  m_lastFrameDebug;
-   QTimer*    m_pTimer        ;
+   QString          m_ShmPath       ;
+   int              m_fd            ;
+   SHMHeader*       m_pShmArea      ;
+   unsigned         m_ShmAreaLen    ;
+   uint             m_FrameGen      ;
+   int              m_fpsC          ;
+   int              m_Fps           ;
+   TimePoint        m_lastFrameDebug;
+   FrameWaiter*     m_pWaiter       ; // when the renderer isn't in a pool
+   SHMHeader*       m_pWaiterArea   ; // the waiter mapping, see handleFrame()
+   size_t           m_WaiterAreaLen ;
+   unsigned         m_WaiterGen     ;
+   std::atomic_bool m_StopWaiter    ;
 
    // Constants
-   constexpr static const int FPS_RATE_SEC        = 1  ;
-   constexpr static const int FRAME_CHECK_RATE_HZ = 120;
+   constexpr static const int FPS_RATE_SEC       = 1  ;
 
    // Helpers
-   timespec createTimeout(           );
+   timespec createTimeout( int ms    );
    bool     shmLock      (           );
    void     shmUnlock    (           );
    bool     getNewFrame  ( bool wait );
    bool     remapShm     (           );
+   void     startWaiter  (           );
+   void     stopWaiter   (           );
+
+   //FrameSource
+   virtual sem_t* frameSemaphore() override;
+   virtual Result handleFrame   () override;
 
 private:
    Video::ShmRenderer* q_ptr;
@@ -116,10 +106,14 @@ ShmRendererPrivate::ShmRendererPrivate(ShmRenderer* parent)
    , m_pShmArea  ( (SHMHeader*)MAP_FAILED              )
    , m_ShmAreaLen( 0                                   )
    , m_FrameGen  ( 0                                   )
-   , m_pTimer    ( nullptr                             )
+   , m_pWaiter   ( nullptr                             )
+   , m_pWaiterArea( (SHMHeader*)MAP_FAILED             )
+   , m_WaiterAreaLen( 0                                )
+   , m_WaiterGen ( 0                                   )
+   , m_StopWaiter( false                               )
 #ifdef DEBUG_FPS
    , m_frameCount( 0                                   )
-   , m_lastFrameDebug(std::chrono::system_clock::now() )
+   , m_lastFrameDebug(std::chrono::steady_clock::now() )
 #endif
 {
 }
@@ -136,13 +130,27 @@ ShmRenderer::ShmRenderer(const QByteArray& id, const QString& shmPath, const QSi
 /// Destructor
 ShmRenderer::~ShmRenderer()
 {
-   if (d_ptr->m_pTimer) {
-      d_ptr->m_pTimer->stop();
-      d_ptr->m_pTimer = nullptr;
-   }
    stopShm();
 }
 
+/// Absolute CLOCK_REALTIME deadline, as expected by sem_timedwait
+timespec ShmRendererPrivate::createTimeout(int ms)
+{
+   timespec timeout;
+
+   ::clock_gettime(CLOCK_REALTIME, &timeout);
+
+   timeout.tv_sec  += ms / 1000;
+   timeout.tv_nsec += (ms % 1000) * 1000000L;
+
+   if (timeout.tv_nsec >= 1000000000L) {
+      timeout.tv_sec  += 1;
+      timeout.tv_nsec -= 1000000000L;
+   }
+
+   return timeout;
+}
+
 /// Wait new frame data from shared memory and save pointer
 bool ShmRendererPrivate::getNewFrame(bool wait)
 {
@@ -156,7 +164,7 @@ bool ShmRendererPrivate::getNewFrame(bool wait)
          return false;
 
       // wait for a new frame, max 33ms
-      static const struct timespec timeout = {0, 33000000};
+      const timespec timeout = createTimeout(33);
       if (::sem_timedwait(&m_pShmArea->frameGenMutex, &timeout) < 0)
          return false;
 
@@ -183,6 +191,14 @@ bool ShmRendererPrivate::getNewFrame(bool wait)
    frame_ptr->storage.clear();
    frame_ptr->ptr = m_pShmArea->data + m_pShmArea->readOffset;
    frame_ptr->size = m_pShmArea->frameSize;
+
+   // The waiter saw this frame first, it knows when it arrived
+   auto stats = q_ptr->Video::Renderer::d_ptr->m_pStats;
+   frame_ptr->timestamp = stats->lastReceived();
+   stats->consumed(frame_ptr->timestamp,
+      m_FrameGen ? m_pShmArea->frameGen - m_FrameGen - 1 : 0
+   );
+
    m_FrameGen = m_pShmArea->frameGen;
 
    shmUnlock();
@@ -190,7 +206,7 @@ bool ShmRendererPrivate::getNewFrame(bool wait)
    ++m_fpsC;
 
    // Compute the FPS shown to the client
-   auto currentTime = std::chrono::system_clock::now();
+   auto currentTime = std::chrono::steady_clock::now();
    const std::chrono::duration<double> seconds = currentTime - m_lastFrameDebug;
    if (seconds.count() >= FPS_RATE_SEC) {
       m_Fps = (int)(m_fpsC / seconds.count());
@@ -236,6 +252,149 @@ bool ShmRendererPrivate::remapShm()
    return true;
 }
 
+/// The semaphore posted by the daemon for each frame, in the waiter mapping
+sem_t* ShmRendererPrivate::frameSemaphore()
+{
+   return &m_pWaiterArea->frameGenMutex;
+}
+
+/**
+ * Notify the clients only when the daemon produced a new frame. Called by
+ * the waiter once the frame generation semaphore was posted.
+ *
+ * The waiter use its own mapping, m_pShmArea is remapped by the client
+ * thread when the frame size changes. Only the header is mapped unless the
+ * frames have to be copied in the renderer queue.
+ */
+FrameSource::Result ShmRendererPrivate::handleFrame()
+{
+   if (m_StopWaiter)
+      return Result::NONE;
+
+   auto header = m_pWaiterArea;
+
+   auto rendererPrivate = q_ptr->Video::Renderer::d_ptr;
+
+   const auto lockStart = std::chrono::steady_clock::now();
+
+   if (::sem_wait(&header->mutex) < 0)
+      return Result::NONE;
+
+   rendererPrivate->m_pStats->lockWaited(std::chrono::steady_clock::now() - lockStart);
+
+   const unsigned gen       = header->frameGen ;
+   const unsigned frameSize = header->frameSize;
+   const bool     isNew     = frameSize && gen != m_WaiterGen;
+
+   Frame frame;
+
+   if (isNew)
+      frame.timestamp = rendererPrivate->m_pStats->received();
+
+   const bool toQueue     = isNew && rendererPrivate->hasQueue();
+   const bool toThumbnail = isNew && rendererPrivate->isThumbnailDue();
+   const bool toDetect    = isNew && rendererPrivate->m_ChangeDetection;
+   const bool toSnapshot  = isNew && rendererPrivate->isSnapshotWanted();
+
+   // The daemon will overwrite this frame, take a copy
+   if (toQueue || toThumbnail || toDetect || toSnapshot) {
+      if (header->mapSize != m_WaiterAreaLen) {
+         const size_t mapSize = header->mapSize;
+         auto area = (SHMHeader*) ::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE,
+                                         MAP_SHARED, m_fd, 0);
+
+         // The lock state lives in the shared memory, it survives the remap
+         if (area != MAP_FAILED) {
+            ::munmap(header, m_WaiterAreaLen);
+            header          = area;
+            m_pWaiterArea   = area;
+            m_WaiterAreaLen = mapSize;
+         }
+      }
+
+      if (header->readOffset + frameSize <= m_WaiterAreaLen - sizeof(SHMHeader)) {
+         frame.buffer    = rendererPrivate->m_Pool.acquire(frameSize);
+         frame.ptr       = frame.buffer->data();
+         frame.size      = frameSize;
+         ::memcpy(frame.ptr, header->data + header->readOffset, frameSize);
+      }
+   }
+
+   ::sem_post(&header->mutex);
+
+   if (!isNew)
+      return Result::NONE;
+
+   m_WaiterGen = gen;
+
+   // An unchanged frame is still queued, only the signals are skipped
+   const bool changed = !(frame.ptr && toDetect)
+      || rendererPrivate->detectChanges(frame.ptr, frame.size);
+
+   if (frame.ptr && toThumbnail && changed)
+      rendererPrivate->updateThumbnail(frame.ptr, frame.size);
+
+   if (frame.ptr && toSnapshot)
+      rendererPrivate->setSnapshot(frame);
+
+   if (frame.ptr && toQueue)
+      rendererPrivate->enqueue(std::move(frame));
+
+   if (changed)
+      emit q_ptr->frameUpdated();
+
+   return Result::FRAME;
+}
+
+/// Wait for the frames on a waiter of the renderer thread
+void ShmRendererPrivate::startWaiter()
+{
+   if (m_pWaiterArea != MAP_FAILED)
+      return;
+
+   m_pWaiterArea = (SHMHeader*) ::mmap(nullptr, sizeof(SHMHeader), PROT_READ | PROT_WRITE,
+                                       MAP_SHARED, m_fd, 0);
+
+   if (m_pWaiterArea == MAP_FAILED) {
+      qDebug() << "Could not map the shared memory header: " << strerror(errno);
+      return;
+   }
+
+   m_WaiterAreaLen = sizeof(SHMHeader);
+   m_WaiterGen     = 0;
+   m_StopWaiter    = false;
+
+   // The renderers created by the VideoRendererManager share the pool waiters
+   auto workers = q_ptr->Video::Renderer::d_ptr->m_pWorkers;
+
+   if ((!workers) || !workers->watch(q_ptr, this)) {
+      m_pWaiter = new FrameWaiter();
+      m_pWaiter->add(this);
+   }
+}
+
+void ShmRendererPrivate::stopWaiter()
+{
+   if (m_pWaiterArea == MAP_FAILED)
+      return;
+
+   m_StopWaiter = true;
+
+   if (m_pWaiter) {
+      m_pWaiter->remove(this);
+      delete m_pWaiter;
+      m_pWaiter = nullptr;
+   }
+   else if (auto workers = q_ptr->Video::Renderer::d_ptr->m_pWorkers) {
+      // Otherwise the pool already stopped waiting when the renderer left it
+      workers->unwatch(this);
+   }
+
+   ::munmap(m_pWaiterArea, m_WaiterAreaLen);
+   m_pWaiterArea   = (SHMHeader*) MAP_FAILED;
+   m_WaiterAreaLen = 0;
+}
+
 /// Connect to the shared memory
 bool ShmRenderer::startShm()
 {
@@ -274,10 +433,7 @@ void ShmRenderer::stopShm()
    if (d_ptr->m_fd < 0)
       return;
 
-   if (d_ptr->m_pTimer) {
-      d_ptr->m_pTimer->stop();
-      d_ptr->m_pTimer = nullptr;
-   }
+   d_ptr->stopWaiter();
 
    // reset the frame so it doesn't point to an old value
    Video::Renderer::d_ptr->m_pFrame.reset();
@@ -300,7 +456,14 @@ void ShmRenderer::stopShm()
 /// Lock the memory while the copy is being made
 bool ShmRendererPrivate::shmLock()
 {
-   return ::sem_wait(&m_pShmArea->mutex) >= 0;
+   const auto start = std::chrono::steady_clock::now();
+
+   if (::sem_wait(&m_pShmArea->mutex) < 0)
+      return false;
+
+   q_ptr->Video::Renderer::d_ptr->m_pStats->lockWaited(std::chrono::steady_clock::now() - start);
+
+   return true;
 }
 
 /// Remove the lock, allow a new frame to be drawn
@@ -325,15 +488,7 @@ void ShmRenderer::startRendering()
 
    Video::Renderer::d_ptr->m_isRendering = true;
 
-   if (!d_ptr->m_pTimer) {
-      d_ptr->m_pTimer = new QTimer(this);
-      d_ptr->m_pTimer->setInterval(33);
-      connect(d_ptr->m_pTimer,&QTimer::timeout,[this]() {
-         emit this->frameUpdated();
-      });
-   }
-   //FIXME This is a temporary hack as frameUpdated() is no longer emitted
-   d_ptr->m_pTimer->start();
+   d_ptr->startWaiter();
 
    emit started();
 }
@@ -344,11 +499,6 @@ void ShmRenderer::stopRendering()
    QMutexLocker locker {mutex()};
    Video::Renderer::d_ptr->m_isRendering = false;
 
-   if (d_ptr->m_pTimer) {
-      d_ptr->m_pTimer->stop();
-      d_ptr->m_pTimer = nullptr;
-   }
-
    stopShm();
 }
 
@@ -372,8 +522,10 @@ Frame ShmRenderer::currentFrame() const
 
     QMutexLocker lk {mutex()};
     if (d_ptr->getNewFrame(false)) {
-        if (auto frame_ptr = Video::Renderer::d_ptr->m_pFrame)
+        if (auto frame_ptr = Video::Renderer::d_ptr->m_pFrame) {
+            Video::Renderer::d_ptr->takeChangedRegions();
             return std::move(*frame_ptr);
+        }
     }
     return {};
 }
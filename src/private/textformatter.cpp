@@ -0,0 +1,270 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "textformatter.h"
+
+//Qt
+#include <QtCore/QThread>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QCoreApplication>
+
+//Ring
+#include "private/textrecording_p.h"
+
+/**
+ * Lives in the TextFormatter thread, it only drain the pending jobs and hand
+ * them back to the main thread.
+ */
+class TextFormatterWorker final : public QObject
+{
+   Q_OBJECT
+public:
+   explicit TextFormatterWorker(TextFormatter* parent) : QObject(nullptr), m_pParent(parent) {}
+
+   TextFormatter* m_pParent;
+
+public Q_SLOTS:
+   void process();
+};
+
+namespace {
+
+///Match QRegularExpression "\s", the daemon doesn't send unicode spaces
+inline bool isSpace(const QChar c)
+{
+   switch (c.unicode()) {
+      case ' ' :
+      case '\t':
+      case '\n':
+      case '\v':
+      case '\f':
+      case '\r':
+         return true;
+      default:
+         return false;
+   }
+}
+
+///Characters that are part of an URL unless they end it
+inline bool isTrailingPunctuation(const QChar c)
+{
+   switch (c.unicode()) {
+      case ',':
+      case '.':
+      case ')':
+      case ';':
+      case '!':
+      case '>':
+         return true;
+      default:
+         return false;
+   }
+}
+
+inline bool matchNoCase(const QChar* data, int size, int pos, const char* prefix, int len)
+{
+   if (size - pos < len)
+      return false;
+
+   for (int i = 0; i < len; ++i) {
+      const ushort c = data[pos + i].unicode();
+      if ((c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c) != static_cast<ushort>(prefix[i]))
+         return false;
+   }
+
+   return true;
+}
+
+///Return the size of the "https:", "http:", "ftp:", "ring:" or "www." prefix at pos, or 0
+inline int schemeLength(const QChar* data, int size, int pos)
+{
+   switch (data[pos].unicode()) {
+      case 'h': case 'H':
+         if (matchNoCase(data, size, pos, "https:", 6)) return 6;
+         if (matchNoCase(data, size, pos, "http:" , 5)) return 5;
+         return 0;
+      case 'f': case 'F':
+         return matchNoCase(data, size, pos, "ftp:" , 4) ? 4 : 0;
+      case 'r': case 'R':
+         return matchNoCase(data, size, pos, "ring:", 5) ? 5 : 0;
+      case 'w': case 'W':
+         return matchNoCase(data, size, pos, "www." , 4) ? 4 : 0;
+      default:
+         return 0;
+   }
+}
+
+void appendEscaped(QString& html, const QString& plainText, int from, int to)
+{
+   html.append(plainText.mid(from, to - from).toHtmlEscaped().replace(QLatin1Char('\n'),
+                                                                      QStringLiteral("<br/>")));
+}
+
+} //anonymous namespace
+
+TextFormatter::TextFormatter() : QObject(QCoreApplication::instance()),
+m_pThread(new QThread()), m_pWorker(new TextFormatterWorker(this))
+{
+   m_pWorker->moveToThread(m_pThread);
+   connect(m_pThread, &QThread::finished, m_pWorker, &QObject::deleteLater);
+
+   if (QCoreApplication::instance())
+      connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, m_pThread, &QThread::quit);
+
+   m_pThread->start(QThread::LowPriority);
+}
+
+TextFormatter::~TextFormatter()
+{
+   m_pThread->quit();
+   m_pThread->wait();
+   delete m_pThread;
+}
+
+TextFormatter& TextFormatter::instance()
+{
+   static auto instance = new TextFormatter();
+   return *instance;
+}
+
+/**
+ * Linear replacement for the old link regular expression:
+ *
+ * ((?>(?>https|http|ftp|ring):|www\.)(?>[^\s,.);!>]|[,.);!>](?!\s|$))+)
+ *
+ * It produce the exact same output, but doesn't require a regex engine, an
+ * iterator and a QRegularExpressionMatch allocation for each link.
+ */
+void TextFormatter::format(const QString& plainText, QString& html, QList<QUrl>& links)
+{
+   const QChar* data = plainText.constData();
+   const int    size = plainText.size();
+
+   QString re;
+   re.reserve(size + 64);
+
+   int p = 0;
+   int i = 0;
+
+   while (i < size) {
+      const int prefix = schemeLength(data, size, i);
+
+      if (!prefix) {
+         ++i;
+         continue;
+      }
+
+      int end = i + prefix;
+
+      while (end < size) {
+         const QChar c = data[end];
+
+         if (isSpace(c) || (isTrailingPunctuation(c) && (end + 1 == size || isSpace(data[end + 1]))))
+            break;
+
+         ++end;
+      }
+
+      //A scheme alone isn't a link
+      if (end == i + prefix) {
+         ++i;
+         continue;
+      }
+
+      const QString link = plainText.mid(i, end - i);
+      const QUrl    url  = QUrl::fromUserInput(link);
+
+      if (i > p)
+         appendEscaped(re, plainText, p, i);
+
+      re.append(QStringLiteral("<a href=\"%1\">%2</a>")
+                .arg(QString::fromLatin1(url.toEncoded()).toHtmlEscaped(),
+                     link.toHtmlEscaped()));
+      links.append(url);
+
+      p = i = end;
+   }
+
+   if (p < size)
+      re.append(plainText.mid(p, size - p));
+
+   html = QStringLiteral("<body>%1</body>").arg(re);
+}
+
+/**
+ * Queue a batch of messages to be formatted. The entries are applied to the
+ * model, if it still exists, as a single batch.
+ */
+void TextFormatter::schedule(InstantMessagingModel* model, const QVector<Entry>& entries)
+{
+   if (entries.isEmpty())
+      return;
+
+   {
+      QMutexLocker locker(&m_Mutex);
+      m_lPending << Job { model, entries };
+   }
+
+   QMetaObject::invokeMethod(m_pWorker, "process", Qt::QueuedConnection);
+}
+
+void TextFormatterWorker::process()
+{
+   QVector<TextFormatter::Job> jobs;
+
+   {
+      QMutexLocker locker(&m_pParent->m_Mutex);
+      jobs.swap(m_pParent->m_lPending);
+   }
+
+   //Many calls may have been coalesced into this one
+   if (jobs.isEmpty())
+      return;
+
+   for (TextFormatter::Job& job : jobs) {
+      for (TextFormatter::Entry& e : job.entries) {
+         TextFormatter::format(e.plainText, e.html, e.links);
+         e.plainText.clear();
+      }
+   }
+
+   {
+      QMutexLocker locker(&m_pParent->m_Mutex);
+      m_pParent->m_lDone << jobs;
+   }
+
+   QMetaObject::invokeMethod(m_pParent, "deliver", Qt::QueuedConnection);
+}
+
+///Apply the results in the main thread
+void TextFormatter::deliver()
+{
+   QVector<Job> jobs;
+
+   {
+      QMutexLocker locker(&m_Mutex);
+      jobs.swap(m_lDone);
+   }
+
+   for (const Job& job : jobs) {
+      //The model is only accessed (or deleted) from this thread
+      if (job.model)
+         job.model->applyFormatting(job.entries);
+   }
+}
+
+#include "textformatter.moc"
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QMutex>
+#include <QtCore/QPointer>
+#include <QtCore/QVector>
+#include <QtCore/QList>
+#include <QtCore/QUrl>
+
+class QThread;
+class InstantMessagingModel;
+class TextFormatterWorker;
+
+namespace Serializable {
+   class Message;
+}
+
+/**
+ * Turn the plain text payload of the messages into HTML with clickable links.
+ *
+ * This used to be done lazily by the view the first time it requested the
+ * FormattedHtml role. As it is relatively expensive, it is now done by a
+ * worker thread when the messages are loaded or received. The results are
+ * sent back to the InstantMessagingModel in batches.
+ *
+ * The worker never touch the Serializable::Message objects, it only get a
+ * copy of the (implicitly shared) plain text.
+ */
+class TextFormatter final : public QObject
+{
+   #pragma GCC diagnostic push
+   #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+   Q_OBJECT
+   #pragma GCC diagnostic pop
+
+   friend class TextFormatterWorker;
+public:
+   struct Entry {
+      int                          row      ;
+      const Serializable::Message* message  ;
+      QString                      plainText;
+      QString                      html     ;
+      QList<QUrl>                  links    ;
+   };
+
+   //Singleton
+   static TextFormatter& instance();
+
+   //Helpers
+   void schedule(InstantMessagingModel* model, const QVector<Entry>& entries);
+   static void format(const QString& plainText, QString& html, QList<QUrl>& links);
+
+private:
+   struct Job {
+      QPointer<InstantMessagingModel> model  ;
+      QVector<Entry>                  entries;
+   };
+
+   explicit TextFormatter();
+   virtual ~TextFormatter();
+
+   //Attributes
+   QThread*             m_pThread;
+   TextFormatterWorker* m_pWorker;
+   QMutex               m_Mutex  ;
+   QVector<Job>         m_lPending;
+   QVector<Job>         m_lDone   ;
+
+private Q_SLOTS:
+   void deliver();
+};
@@ -19,8 +19,6 @@
 
 //Qt
 #include <QtCore/QAbstractListModel>
-#include <QtCore/QRegExp>
-#include <QtCore/QRegularExpression>
 
 //Daemon
 #include <account_const.h>
@@ -28,6 +26,10 @@
 //Ring
 #include "media/media.h"
 #include "media/textrecording.h"
+#include "private/textformatter.h"
+#include "private/objectpool.h"
+
+class QDataStream;
 
 class SerializableEntityManager;
 struct TextMessageNode;
@@ -43,16 +45,28 @@ namespace Media {
  * Those classes map 1:1 to the json stored on the disk. References are then
  * extracted, the conversation reconstructed and placed into a TextMessageNode
  * vector.
+ *
+ * They can also be stored in a more compact binary format. It is versioned
+ * and the repetitive strings (mime types and author sha1s) are stored once per
+ * file in a string table. JSON is kept for export and older files.
  */
 namespace Serializable {
 
+///Index of the strings shared by many messages in the binary format
+typedef QHash<QString,quint32> StringTable;
+
 class Payload {
 public:
    QString payload;
+   ///Interned, the same few mime types are used by every message
    QString mimeType;
 
    void read (const QJsonObject &json);
    void write(QJsonObject       &json) const;
+   void read (QDataStream& stream, const QVector<QString>& strings);
+   void write(QDataStream& stream, const StringTable&      strings) const;
+
+   static QString internMimeType(const QString& mimeType);
 };
 
 class Message {
@@ -65,7 +79,7 @@ public:
    ///The time associated with this message
    time_t                  timestamp ;
    ///A group of alternate payloads (mimetype as key)
-   QList<Payload*>         payloads  ;
+   QVector<Payload>        payloads  ;
    ///The author display name
    QString                 authorSha1;
    ///The direction
@@ -81,9 +95,7 @@ public:
    //Delivery Status
    Media::TextRecording::Status deliveryStatus;
 
-   static const QRegularExpression m_linkRegex;
-
-   //Cache the most common payload to avoid lookup
+   //Cache the most common payload to avoid lookup, they share the payload data
    QString m_PlainText;
    QString m_HTML;
    QString m_FormattedHtml;
@@ -92,7 +104,12 @@ public:
 
    void read (const QJsonObject &json);
    void write(QJsonObject       &json) const;
+   void read (QDataStream& stream, const QVector<QString>& strings);
+   void write(QDataStream& stream, const StringTable&      strings) const;
    const QString& getFormattedHtml();
+
+private:
+   void addPayload(const Payload& p);
 };
 
 class Peer {
@@ -109,6 +126,11 @@ public:
 
    void read (const QJsonObject &json);
    void write(QJsonObject       &json) const;
+   void read (QDataStream& stream);
+   void write(QDataStream& stream) const;
+
+private:
+   void resolveContactMethod();
 };
 
 
@@ -124,8 +146,10 @@ public:
    int nextGroupId;
    ///The account used for this conversation
 
-   void read (const QJsonObject &json, const QHash<QString,ContactMethod*> sha1s);
+   void read (const QJsonObject &json, const QHash<QString,ContactMethod*> sha1s, ObjectPool<Message>& pool);
    void write(QJsonObject       &json) const;
+   void read (QDataStream& stream, const QHash<QString,ContactMethod*>& sha1s, const QVector<QString>& strings, ObjectPool<Message>& pool);
+   void write(QDataStream& stream, const StringTable& strings) const;
 };
 
 class Peers {
@@ -145,8 +169,13 @@ public:
    ///Keep a cache of the peers sha1
    QHash<QString,ContactMethod*> m_hSha1;
 
+   ///The messages from all groups, they are never freed individually
+   ObjectPool<Message> m_MessagePool;
+
    void read (const QJsonObject &json);
    void write(QJsonObject       &json) const;
+   void read (QDataStream& stream);
+   void write(QDataStream& stream) const;
 
 private:
    Peers() : hasChanged(false) {}
@@ -155,6 +184,21 @@ private:
 }
 //END Those classes are serializable to JSon
 
+/**
+ * This is the structure used internally to create the text conversation
+ * frontend. It will be stored as a vector by the IM Model but also implement
+ * a chained list for convenience
+ */
+struct TextMessageNode
+{
+   TextMessageNode() : m_pNext(nullptr),m_pContactMethod(nullptr)
+   {}
+
+   Serializable::Message* m_pMessage      ;
+   ContactMethod*         m_pContactMethod;
+   TextMessageNode*       m_pNext         ;
+};
+
 namespace Media {
 
 /**
@@ -170,6 +214,8 @@ public:
    InstantMessagingModel*      m_pImModel           ;
    QVector<::TextMessageNode*> m_lNodes             ;
    Serializable::Group*        m_pCurrentGroup      ;
+   Serializable::Peers*        m_pCurrentPeers      ;
+   ObjectPool<TextMessageNode> m_NodePool           ;
    QList<Serializable::Peers*> m_lAssociatedPeers   ;
    QHash<QString,bool>         m_hMimeTypes         ;
    int                         m_UnreadCount        ;
@@ -180,8 +226,11 @@ public:
 
    //Helper
    void insertNewMessage(const QMap<QString,QString>& message, ContactMethod* cm, Media::Media::Direction direction, uint64_t id = 0);
+   void scheduleFormatting(int first, int last);
    QHash<QByteArray,QByteArray> toJsons() const;
-   void accountMessageStatusChanged(const uint64_t id, DRing::Account::MessageStates status);
+   QHash<QByteArray,QByteArray> toBinaries() const;
+   void reconstruct(const ContactMethod* cm);
+   void accountMessageStatusChanged(const QVector<QPair<uint64_t, DRing::Account::MessageStates>>& changes);
    bool updateMessageStatus(Serializable::Message* m, TextRecording::Status status);
 
 private:
@@ -202,25 +251,12 @@ public:
    static Serializable::Peers* peers(QList<const ContactMethod*> cms);
    static Serializable::Peers* fromSha1(const QByteArray& sha1);
    static Serializable::Peers* fromJson(const QJsonObject& obj, const ContactMethod* cm = nullptr);
+   static Serializable::Peers* fromBinary(const QByteArray& data, const ContactMethod* cm = nullptr);
+   static QByteArray           toBinary  (const Serializable::Peers* p);
 private:
    static QHash<QByteArray,Serializable::Peers*> m_hPeers;
 };
 
-/**
- * This is the structure used internally to create the text conversation
- * frontend. It will be stored as a vector by the IM Model but also implement
- * a chained list for convenience
- */
-struct TextMessageNode
-{
-   TextMessageNode() : m_pNext(nullptr),m_pContactMethod(nullptr)
-   {}
-
-   Serializable::Message* m_pMessage      ;
-   ContactMethod*         m_pContactMethod;
-   TextMessageNode*       m_pNext         ;
-};
-
 ///Model for the Instant Messaging (IM) features
 class InstantMessagingModel final : public QAbstractListModel
 {
@@ -248,4 +284,5 @@ public:
    //Helper
    void addRowBegin();
    void addRowEnd();
+   void applyFormatting(const QVector<TextFormatter::Entry>& entries);
 };
@@ -34,6 +34,9 @@
 #include "interfaces/pixmapmanipulatori.h"
 #include "personmodel.h"
 
+// Std
+#include <cstring>
+
 /* https://www.ietf.org/rfc/rfc2045.txt
  * https://www.ietf.org/rfc/rfc2047.txt
  * https://www.ietf.org/rfc/rfc2426.txt
@@ -400,26 +403,59 @@ Person* VCardUtils::mapToPerson(const QHash<QByteArray, QByteArray>& vCard, QLis
     return personMapped;
 }
 
+/**
+ * Parse the vCard properties in a single pass, without splitting the content
+ * into lines first. Folded lines (starting with a space or a tab) are
+ * appended to the previous property, this is how large PHOTO are sent.
+ */
 QHash<QByteArray, QByteArray> VCardUtils::toHashMap(const QByteArray& content)
 {
     QHash<QByteArray, QByteArray> vCard;
-    QByteArray previousKey,previousValue;
-    const QList<QByteArray> lines = content.split('\n');
+    QByteArray key, value;
+
+    const char* data = content.constData();
+    const int   size = content.size();
+    int         pos  = 0;
+
+    while (pos < size) {
+        int end = content.indexOf('\n', pos);
+        if (end == -1)
+            end = size;
+
+        const int lineEnd = (end > pos && data[end-1] == '\r') ? end - 1 : end;
 
-    foreach (const QByteArray& property, lines) {
         //Ignore empty lines
-        if (property.size()) {
+        if (lineEnd > pos) {
             //Some properties are over multiple lines
-            if (property[0] == ' ' && previousKey.size()) {
-                previousValue += property.right(property.size()-1);
+            if ((data[pos] == ' ' || data[pos] == '\t') && key.size()) {
+                value.append(data + pos + 1, lineEnd - pos - 1);
+            }
+            else {
+                if (key.size())
+                    vCard[key] = value;
+
+                //Do not use split, URIs can have : in them. Only look in
+                //this line, or each line without one rescans the payload
+                const char* dblpt    = static_cast<const char*>(memchr(data + pos, ':', lineEnd - pos));
+                const int   dblptPos = dblpt ? static_cast<int>(dblpt - data) : -1;
+
+                if (dblptPos == -1) {
+                    key.clear();
+                    value.clear();
+                }
+                else {
+                    key   = content.mid(pos, dblptPos - pos);
+                    value = content.mid(dblptPos + 1, lineEnd - dblptPos - 1);
+                }
             }
-
-            //Do not use split, URIs can have : in them
-            const int dblptPos = property.indexOf(':');
-            const QByteArray k(property.left(dblptPos)),v(property.right(property.size()-dblptPos-1));
-            vCard[k] = v;
         }
+
+        pos = end + 1;
     }
+
+    if (key.size())
+        vCard[key] = value;
+
     return vCard;
 }
 
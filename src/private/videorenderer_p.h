@@ -20,24 +20,66 @@
 
 //Qt
 #include <QtCore/QObject>
+#include <QtCore/QMutex>
+#include <QtCore/QRect>
 #include <QtCore/QSize>
+#include <QtCore/QVector>
 
 // Std
 #include <atomic>
+#include <chrono>
 #include <memory>
+#include <vector>
+
+//Ring
+#include "private/framebufferpool.h"
+#include "video/renderer.h"
 
 class QMutex;
+class RenderWorkerPool;
 
 namespace Video {
 
 class Renderer;
-struct Frame;
+class FrameQueue;
+class RendererStatistics;
+class RendererStatisticsPrivate;
+class FrameConverter;
+
+/**
+ * The latest frame kept for the composite renderers, see
+ * RendererPrivate::retainSnapshot().
+ *
+ * They share its ownership with the renderer, so it can still be read and
+ * released from their thread after the renderer is deleted.
+ */
+class SnapshotSlot final
+{
+public:
+    //Getters
+    Frame frame   (QSize* size, Renderer::ColorSpace* colorSpace) const;
+    bool  isClosed() const;
+
+    //Mutators
+    void release();
+
+private:
+    friend class RendererPrivate;
+
+    std::atomic_int      m_Users     {0}    ;
+    std::atomic_bool     m_Closed    {false}; // the renderer was deleted
+    mutable QMutex       m_Mutex            ;
+    Frame                m_Frame            ; // protected by m_Mutex
+    QSize                m_Size             ; // protected by m_Mutex
+    Renderer::ColorSpace m_ColorSpace {Renderer::ColorSpace::BGRA}; // protected by m_Mutex
+};
 
 class RendererPrivate final : public QObject
 {
 Q_OBJECT
 public:
     RendererPrivate(Video::Renderer* parent);
+    virtual ~RendererPrivate();
 
     //Attributes
     std::atomic_bool     m_isRendering ;
@@ -45,6 +87,60 @@ public:
     QString              m_Id          ;
     QSize                m_pSize       ;
     std::shared_ptr<Frame> m_pFrame; // frame given by daemon for direct rendering
+    FrameBufferPool          m_Pool          ;
+    std::atomic<FrameQueue*> m_pQueue        ;
+    mutable std::atomic_int  m_QueueUsers    ; // threads holding m_pQueue
+    std::atomic_int          m_BufferPolicy  ;
+    RendererStatistics*        m_pStatistics ;
+    RendererStatisticsPrivate* m_pStats      ; // its private part, updated by both threads
+    FrameConverter*            m_pConverter  ;
+    RenderWorkerPool*          m_pWorkers    ; // set while the renderer is in a pool
+
+    // Thumbnails, m_Thumbnail* are protected by m_ThumbnailMutex
+    QMutex                                m_ThumbnailMutex   ;
+    QSize                                 m_ThumbnailSize    ;
+    int                                   m_ThumbnailInterval;
+    std::chrono::steady_clock::time_point m_LastThumbnail    ;
+    Frame                                 m_Thumbnail        ;
+    FrameBufferPool                       m_ThumbnailPool    ;
+
+    // Change detection, the hashes are only used by the producer thread
+    std::atomic_bool      m_ChangeDetection ;
+    std::atomic_bool      m_HashesExpired   ; // frames were not hashed for a while
+    std::vector<uint64_t> m_lTileHashes     ;
+    QSize                 m_HashedSize      ;
+    mutable QMutex        m_ChangedMutex    ;
+    QVector<QRect>        m_lChangedRegions ; // not taken yet, protected by m_ChangedMutex
+    QVector<QRect>        m_lTakenRegions   ; // protected by m_ChangedMutex
+
+    // Latest frame kept for the composite renderers, see retainSnapshot()
+    std::shared_ptr<SnapshotSlot> m_pSnapshot;
+
+    /**
+     * Use m_pQueue, it cannot be freed while this exists. Increment first,
+     * then load the pointer, a queue replaced after that point is kept
+     * until the count drops to zero.
+     */
+    class QueueUse final {
+    public:
+       explicit QueueUse(const RendererPrivate* d) : m_pD(d) { m_pD->m_QueueUsers++; }
+       ~QueueUse() { m_pD->m_QueueUsers--; }
+       FrameQueue* queue() const { return m_pD->m_pQueue; }
+    private:
+       const RendererPrivate* m_pD;
+    };
+
+    //Helpers
+    bool hasQueue       () const;
+    void enqueue        (Frame&& frame);
+    bool isThumbnailDue ();
+    void updateThumbnail(const uint8_t* data, std::size_t size);
+    bool detectChanges  (const uint8_t* data, std::size_t size);
+    void takeChangedRegions();
+    std::shared_ptr<SnapshotSlot> retainSnapshot();
+    bool isSnapshotWanted() const;
+    void setSnapshot    (const Frame& frame);
+
 private:
     Video::Renderer* q_ptr;
 };
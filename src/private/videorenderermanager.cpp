@@ -36,6 +36,7 @@
 #include <video/resolution.h>
 #include "private/videorate_p.h"
 #include "private/call_p.h"
+#include "private/renderworkerpool.h"
 
 #ifdef ENABLE_LIBWRAP
  #include "private/directrenderer.h"
@@ -57,7 +58,7 @@ public:
    uint                               m_BufferSize  ;
    QHash<QByteArray,Video::Renderer*> m_hRenderers  ;
    QHash<Video::Renderer*,QByteArray> m_hRendererIds;
-   QHash<Video::Renderer*, QThread*>  m_hThreads    ;
+   RenderWorkerPool*                  m_pWorkers    ;
 
    //Helper
    void removeRenderer(Video::Renderer* r);
@@ -73,7 +74,7 @@ public Q_SLOTS:
 };
 
 VideoRendererManagerPrivate::VideoRendererManagerPrivate(VideoRendererManager* parent) : QObject(parent), q_ptr(parent),
-m_BufferSize(0),m_PreviewState(false)
+m_BufferSize(0),m_PreviewState(false),m_pWorkers(new RenderWorkerPool(0, this))
 {
 
 }
@@ -138,10 +139,9 @@ Video::Renderer* VideoRendererManager::previewRenderer()
       r = new Video::ShmRenderer(PREVIEW_RENDERER_ID,"",res->size());
 #endif
 
-      QThread* t = new QThread(this);
-      d_ptr->m_hThreads[r] = t;
+      r->setBufferSize(d_ptr->m_BufferSize);
 
-      r->moveToThread(t);
+      d_ptr->m_pWorkers->add(r);
 
       d_ptr->m_hRenderers[PREVIEW_RENDERER_ID] = r;
       d_ptr->m_hRendererIds[r] = PREVIEW_RENDERER_ID;
@@ -179,10 +179,16 @@ bool VideoRendererManager::isPreviewing() const
    return d_ptr->m_PreviewState;
 }
 
-///@todo Set the video buffer size
+/**
+ * Set how many frames each renderer can queue for Video::Renderer::takeFrame().
+ * 0 (the default) disables the queues.
+ */
 void VideoRendererManager::setBufferSize(uint size)
 {
    d_ptr->m_BufferSize = size;
+
+   for (auto r : d_ptr->m_hRenderers)
+      r->setBufferSize(size);
 }
 
 ///A video is not being rendered
@@ -216,24 +222,14 @@ void VideoRendererManagerPrivate::startedDecoding(const QString& id, const QStri
 
 #endif
 
+      r->setBufferSize(m_BufferSize);
 
-      QThread* t = new QThread(this);
-      m_hThreads[r] = t;
-
-      r->moveToThread(t);
-
-      if (!t->isRunning())
-         t->start();
+      m_pWorkers->add(r);
 
    }
    else {
       r = m_hRenderers.value(rid);
 
-      QThread* t = m_hThreads.value(r);
-
-      if (t && !t->isRunning())
-         t->start();
-
       r->setSize(res);
 
 #ifdef ENABLE_LIBWRAP
@@ -284,17 +280,11 @@ void VideoRendererManagerPrivate::startedDecoding(const QString& id, const QStri
 void VideoRendererManagerPrivate::removeRenderer(Video::Renderer* r)
 {
     const auto id = m_hRendererIds.value(r);
-    auto t = m_hThreads.value(r);
 
     m_hRendererIds.remove(r);
     m_hRenderers.remove(id);
-    m_hThreads.remove(r);
-
-    if (t) {
-        t->deleteLater();
-    }
 
-    r->deleteLater();
+    m_pWorkers->remove(r);
 }
 
 /**
@@ -335,13 +325,6 @@ void VideoRendererManagerPrivate::stoppedDecoding(const QString& id, const QStri
         emit q_ptr->previewStopped(r);
     }
 
-    QThread* t = m_hThreads.value(r);
-
-    if (t) {
-        t->quit();
-        t->wait();
-    }
-
     // decoding stopped; remove the renderer, if/when call is over
     if (c && c->lifeCycleState() == Call::LifeCycleState::FINISHED) {
         removeRenderer(r);
@@ -30,6 +30,7 @@
 #include <callmanager_interface.h>
 #include "typedefs.h"
 #include "conversions_wrap.hpp"
+#include "eventqueue.h"
 
 /*
  * Proxy class for interface cx.ring.Ring.CallManager
@@ -50,128 +51,146 @@ public:
          callHandlers = {
             exportable_callback<CallSignal::StateChange>(
                 [this] (const std::string &callID, const std::string &state, int code) {
-                    QTimer::singleShot(0, [this,callID, state, code] {
-                        LOG_DRING_SIGNAL3("callStateChanged",QString(callID.c_str()) , QString(state.c_str()) , code);
-                        Q_EMIT callStateChanged(QString(callID.c_str()), QString(state.c_str()), code);
+                    EventQueue::post([this,callID, state, code] {
+                        IPC_STATS_SIGNAL("callStateChanged");
+                        LOG_DRING_SIGNAL3("callStateChanged",toQString(callID) , toQString(state) , code);
+                        Q_EMIT callStateChanged(toQString(callID), toQString(state), code);
                     });
             }),
             exportable_callback<CallSignal::TransferFailed>(
                 [this] () {
-                       QTimer::singleShot(0, [this] {
+                       EventQueue::post([this] {
+                             IPC_STATS_SIGNAL("transferFailed");
                              LOG_DRING_SIGNAL("transferFailed","");
                              Q_EMIT transferFailed();
                        });
             }),
             exportable_callback<CallSignal::TransferSucceeded>(
                 [this] () {
-                       QTimer::singleShot(0, [this] {
+                       EventQueue::post([this] {
+                             IPC_STATS_SIGNAL("transferSucceeded");
                              LOG_DRING_SIGNAL("transferSucceeded","");
                              Q_EMIT transferSucceeded();
                        });
             }),
             exportable_callback<CallSignal::RecordPlaybackStopped>(
                 [this] (const std::string &filepath) {
-                       QTimer::singleShot(0, [this,filepath] {
-                             LOG_DRING_SIGNAL("recordPlaybackStopped",QString(filepath.c_str()));
-                             Q_EMIT recordPlaybackStopped(QString(filepath.c_str()));
+                       EventQueue::post([this,filepath] {
+                             IPC_STATS_SIGNAL("recordPlaybackStopped");
+                             LOG_DRING_SIGNAL("recordPlaybackStopped",toQString(filepath));
+                             Q_EMIT recordPlaybackStopped(toQString(filepath));
                        });
             }),
             exportable_callback<CallSignal::VoiceMailNotify>(
                 [this] (const std::string &accountID, int count) {
-                       QTimer::singleShot(0, [this,accountID, count] {
-                             LOG_DRING_SIGNAL2("voiceMailNotify",QString(accountID.c_str()), count);
-                             Q_EMIT voiceMailNotify(QString(accountID.c_str()), count);
+                       EventQueue::post([this,accountID, count] {
+                             IPC_STATS_SIGNAL("voiceMailNotify");
+                             LOG_DRING_SIGNAL2("voiceMailNotify",toQString(accountID), count);
+                             Q_EMIT voiceMailNotify(toQString(accountID), count);
                        });
             }),
             exportable_callback<CallSignal::IncomingMessage>(
                 [this] (const std::string &callID, const std::string &from, const std::map<std::string,std::string> &message) {
-                       QTimer::singleShot(0, [this,callID, from, message] {
-                             LOG_DRING_SIGNAL3("incomingMessage",QString(callID.c_str()),QString(from.c_str()),convertMap(message));
-                             Q_EMIT incomingMessage(QString(callID.c_str()), QString(from.c_str()), convertMap(message));
+                       EventQueue::post([this,callID, from, message] {
+                             IPC_STATS_SIGNAL("incomingMessage");
+                             LOG_DRING_SIGNAL3("incomingMessage",toQString(callID),toQString(from),convertMap(message));
+                             Q_EMIT incomingMessage(toQString(callID), toQString(from), convertMap(message));
                        });
             }),
             exportable_callback<CallSignal::IncomingCall>(
                 [this] (const std::string &accountID, const std::string &callID, const std::string &from) {
-                       QTimer::singleShot(0, [this,accountID, callID, from] {
-                             LOG_DRING_SIGNAL3("incomingCall",QString(accountID.c_str()), QString(callID.c_str()), QString(from.c_str()));
-                             Q_EMIT incomingCall(QString(accountID.c_str()), QString(callID.c_str()), QString(from.c_str()));
+                       EventQueue::post([this,accountID, callID, from] {
+                             IPC_STATS_SIGNAL("incomingCall");
+                             LOG_DRING_SIGNAL3("incomingCall",toQString(accountID), toQString(callID), toQString(from));
+                             Q_EMIT incomingCall(toQString(accountID), toQString(callID), toQString(from));
                        });
             }),
             exportable_callback<CallSignal::RecordPlaybackFilepath>(
                 [this] (const std::string &callID, const std::string &filepath) {
-                       QTimer::singleShot(0, [this,callID, filepath] {
-                             LOG_DRING_SIGNAL2("recordPlaybackFilepath",QString(callID.c_str()), QString(filepath.c_str()));
-                             Q_EMIT recordPlaybackFilepath(QString(callID.c_str()), QString(filepath.c_str()));
+                       EventQueue::post([this,callID, filepath] {
+                             IPC_STATS_SIGNAL("recordPlaybackFilepath");
+                             LOG_DRING_SIGNAL2("recordPlaybackFilepath",toQString(callID), toQString(filepath));
+                             Q_EMIT recordPlaybackFilepath(toQString(callID), toQString(filepath));
                        });
             }),
             exportable_callback<CallSignal::ConferenceCreated>(
                 [this] (const std::string &confID) {
-                       QTimer::singleShot(0, [this,confID] {
-                             LOG_DRING_SIGNAL("conferenceCreated",QString(confID.c_str()));
-                             Q_EMIT conferenceCreated(QString(confID.c_str()));
+                       EventQueue::post([this,confID] {
+                             IPC_STATS_SIGNAL("conferenceCreated");
+                             LOG_DRING_SIGNAL("conferenceCreated",toQString(confID));
+                             Q_EMIT conferenceCreated(toQString(confID));
                        });
             }),
             exportable_callback<CallSignal::ConferenceChanged>(
                 [this] (const std::string &confID, const std::string &state) {
-                       QTimer::singleShot(0, [this,confID, state] {
-                             LOG_DRING_SIGNAL2("conferenceChanged",QString(confID.c_str()), QString(state.c_str()));
-                             Q_EMIT conferenceChanged(QString(confID.c_str()), QString(state.c_str()));
+                       EventQueue::post([this,confID, state] {
+                             IPC_STATS_SIGNAL("conferenceChanged");
+                             LOG_DRING_SIGNAL2("conferenceChanged",toQString(confID), toQString(state));
+                             Q_EMIT conferenceChanged(toQString(confID), toQString(state));
                        });
             }),
             exportable_callback<CallSignal::UpdatePlaybackScale>(
                 [this] (const std::string &filepath, int position, int size) {
-                       QTimer::singleShot(0, [this,filepath, position, size] {
-                             LOG_DRING_SIGNAL3("updatePlaybackScale",QString(filepath.c_str()), position, size);
-                             Q_EMIT updatePlaybackScale(QString(filepath.c_str()), position, size);
+                       EventQueue::post([this,filepath, position, size] {
+                             IPC_STATS_SIGNAL("updatePlaybackScale");
+                             LOG_DRING_SIGNAL3("updatePlaybackScale",toQString(filepath), position, size);
+                             Q_EMIT updatePlaybackScale(toQString(filepath), position, size);
                        });
             }),
             exportable_callback<CallSignal::ConferenceRemoved>(
                 [this] (const std::string &confID) {
-                       QTimer::singleShot(0, [this,confID] {
-                             LOG_DRING_SIGNAL("conferenceRemoved",QString(confID.c_str()));
-                             Q_EMIT conferenceRemoved(QString(confID.c_str()));
+                       EventQueue::post([this,confID] {
+                             IPC_STATS_SIGNAL("conferenceRemoved");
+                             LOG_DRING_SIGNAL("conferenceRemoved",toQString(confID));
+                             Q_EMIT conferenceRemoved(toQString(confID));
                        });
             }),
             exportable_callback<CallSignal::NewCallCreated>(
                 [this] (const std::string &accountID, const std::string &callID, const std::string &to) {
-                       QTimer::singleShot(0, [this,accountID, callID, to] {
-                             LOG_DRING_SIGNAL3("newCallCreated",QString(accountID.c_str()), QString(callID.c_str()), QString(to.c_str()));
-                             Q_EMIT newCallCreated(QString(accountID.c_str()), QString(callID.c_str()), QString(to.c_str()));
+                       EventQueue::post([this,accountID, callID, to] {
+                             IPC_STATS_SIGNAL("newCallCreated");
+                             LOG_DRING_SIGNAL3("newCallCreated",toQString(accountID), toQString(callID), toQString(to));
+                             Q_EMIT newCallCreated(toQString(accountID), toQString(callID), toQString(to));
                        });
             }),
             exportable_callback<CallSignal::RecordingStateChanged>(
                 [this] (const std::string &callID, bool recordingState) {
-                       QTimer::singleShot(0, [this,callID, recordingState] {
-                             LOG_DRING_SIGNAL2("recordingStateChanged",QString(callID.c_str()), recordingState);
-                             Q_EMIT recordingStateChanged(QString(callID.c_str()), recordingState);
+                       EventQueue::post([this,callID, recordingState] {
+                             IPC_STATS_SIGNAL("recordingStateChanged");
+                             LOG_DRING_SIGNAL2("recordingStateChanged",toQString(callID), recordingState);
+                             Q_EMIT recordingStateChanged(toQString(callID), recordingState);
                        });
             }),
 			exportable_callback<CallSignal::RtcpReportReceived>(
 				[this] (const std::string &callID, const std::map<std::string, int>& report) {
-                       QTimer::singleShot(0, [this,callID, report] {
-                             LOG_DRING_SIGNAL2("onRtcpReportReceived",QString(callID.c_str()), convertStringInt(report));
-                             Q_EMIT onRtcpReportReceived(QString(callID.c_str()), convertStringInt(report));
+                       EventQueue::post([this,callID, report] {
+                             IPC_STATS_SIGNAL("onRtcpReportReceived");
+                             LOG_DRING_SIGNAL2("onRtcpReportReceived",toQString(callID), convertStringInt(report));
+                             Q_EMIT onRtcpReportReceived(toQString(callID), convertStringInt(report));
                        });
 			}),
 			exportable_callback<CallSignal::PeerHold>(
 				[this] (const std::string &callID, bool state) {
-                       QTimer::singleShot(0, [this,callID, state] {
-                             LOG_DRING_SIGNAL2("peerHold",QString(callID.c_str()), state);
-                             Q_EMIT peerHold(QString(callID.c_str()), state);
+                       EventQueue::post([this,callID, state] {
+                             IPC_STATS_SIGNAL("peerHold");
+                             LOG_DRING_SIGNAL2("peerHold",toQString(callID), state);
+                             Q_EMIT peerHold(toQString(callID), state);
                        });
             }),
 			exportable_callback<CallSignal::AudioMuted>(
 				[this] (const std::string &callID, bool state) {
-                       QTimer::singleShot(0, [this,callID, state] {
-                             LOG_DRING_SIGNAL2("audioMuted",QString(callID.c_str()), state);
-                             Q_EMIT audioMuted(QString(callID.c_str()), state);
+                       EventQueue::post([this,callID, state] {
+                             IPC_STATS_SIGNAL("audioMuted");
+                             LOG_DRING_SIGNAL2("audioMuted",toQString(callID), state);
+                             Q_EMIT audioMuted(toQString(callID), state);
                        });
 			}),
 			exportable_callback<CallSignal::VideoMuted>(
 				[this] (const std::string &callID, bool state) {
-                       QTimer::singleShot(0, [this,callID, state] {
-                             LOG_DRING_SIGNAL2("videoMuted",QString(callID.c_str()), state);
-                             Q_EMIT videoMuted(QString(callID.c_str()), state);
+                       EventQueue::post([this,callID, state] {
+                             IPC_STATS_SIGNAL("videoMuted");
+                             LOG_DRING_SIGNAL2("videoMuted",toQString(callID), state);
+                             Q_EMIT videoMuted(toQString(callID), state);
                        });
 			})
          };
@@ -184,39 +203,46 @@ public:
 public Q_SLOTS: // METHODS
     bool accept(const QString &callID)
     {
+        IPC_STATS_CALL();
         return DRing::accept(callID.toStdString());
     }
 
     bool addMainParticipant(const QString &confID)
     {
+        IPC_STATS_CALL();
         return DRing::addMainParticipant(confID.toStdString());
     }
 
     bool addParticipant(const QString &callID, const QString &confID)
     {
+        IPC_STATS_CALL();
         return DRing::addParticipant(
                         callID.toStdString(), confID.toStdString());
     }
 
     bool attendedTransfer(const QString &transferID, const QString &targetID)
     {
+        IPC_STATS_CALL();
         return DRing::attendedTransfer(
                         transferID.toStdString(), targetID.toStdString());
     }
 
     void createConfFromParticipantList(const QStringList &participants)
     {
+        IPC_STATS_CALL();
         DRing::createConfFromParticipantList(
                         convertStringList(participants));
     }
 
     bool detachParticipant(const QString &callID)
     {
+        IPC_STATS_CALL();
         return DRing::detachParticipant(callID.toStdString());
     }
 
     MapStringString getCallDetails(const QString &callID)
     {
+        IPC_STATS_CALL();
         MapStringString temp =
             convertMap(DRing::getCallDetails(callID.toStdString()));
         return temp;
@@ -224,6 +250,7 @@ public Q_SLOTS: // METHODS
 
     QStringList getCallList()
     {
+        IPC_STATS_CALL();
         QStringList temp =
             convertStringList(DRing::getCallList());
         return temp;
@@ -231,6 +258,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString getConferenceDetails(const QString &callID)
     {
+        IPC_STATS_CALL();
         MapStringString temp =
             convertMap(DRing::getConferenceDetails(
                 callID.toStdString()));
@@ -239,12 +267,14 @@ public Q_SLOTS: // METHODS
 
     QString getConferenceId(const QString &callID)
     {
-        QString temp(DRing::getConferenceId(callID.toStdString()).c_str());
+        IPC_STATS_CALL();
+        QString temp = toQString(DRing::getConferenceId(callID.toStdString()));
         return temp;
     }
 
     QStringList getConferenceList()
     {
+        IPC_STATS_CALL();
         QStringList temp =
             convertStringList(DRing::getConferenceList());
         return temp;
@@ -252,6 +282,7 @@ public Q_SLOTS: // METHODS
 
     QStringList getDisplayNames(const QString &confID)
     {
+        IPC_STATS_CALL();
         QStringList temp =
             convertStringList(DRing::getDisplayNames(
                 confID.toStdString()));
@@ -260,12 +291,14 @@ public Q_SLOTS: // METHODS
 
     bool getIsRecording(const QString &callID)
     {
+        IPC_STATS_CALL();
         //TODO: match API
         return DRing::getIsRecording(callID.toStdString());
     }
 
     QStringList getParticipantList(const QString &confID)
     {
+        IPC_STATS_CALL();
         QStringList temp =
             convertStringList(DRing::getParticipantList(
                 confID.toStdString()));
@@ -274,64 +307,76 @@ public Q_SLOTS: // METHODS
 
     bool hangUp(const QString &callID)
     {
+        IPC_STATS_CALL();
         return DRing::hangUp(callID.toStdString());
     }
 
     bool hangUpConference(const QString &confID)
     {
+        IPC_STATS_CALL();
         return DRing::hangUpConference(confID.toStdString());
     }
 
     bool hold(const QString &callID)
     {
+        IPC_STATS_CALL();
         return DRing::hold(callID.toStdString());
     }
 
     bool holdConference(const QString &confID)
     {
+        IPC_STATS_CALL();
         return DRing::holdConference(confID.toStdString());
     }
 
     bool isConferenceParticipant(const QString &callID)
     {
+        IPC_STATS_CALL();
         return DRing::isConferenceParticipant(callID.toStdString());
     }
 
     bool joinConference(const QString &sel_confID, const QString &drag_confID)
     {
+        IPC_STATS_CALL();
         return DRing::joinConference(
             sel_confID.toStdString(), drag_confID.toStdString());
     }
 
     bool joinParticipant(const QString &sel_callID, const QString &drag_callID)
     {
+        IPC_STATS_CALL();
         return DRing::joinParticipant(
             sel_callID.toStdString(), drag_callID.toStdString());
     }
 
     QString placeCall(const QString &accountID, const QString &to)
     {
-        QString temp(DRing::placeCall(accountID.toStdString(), to.toStdString()).c_str());
+        IPC_STATS_CALL();
+        QString temp = toQString(DRing::placeCall(accountID.toStdString(), to.toStdString()));
         return temp;
     }
 
     void playDTMF(const QString &key)
     {
+        IPC_STATS_CALL();
         DRing::playDTMF(key.toStdString());
     }
 
     void recordPlaybackSeek(double value)
     {
+        IPC_STATS_CALL();
         DRing::recordPlaybackSeek(value);
     }
 
     bool refuse(const QString &callID)
     {
+        IPC_STATS_CALL();
         return DRing::refuse(callID.toStdString());
     }
 
     void sendTextMessage(const QString &callID, const QMap<QString,QString> &message, bool isMixed)
     {
+        IPC_STATS_CALL();
         DRing::sendTextMessage(
             callID.toStdString(), convertMap(message), QObject::tr("Me").toStdString(), isMixed
         );
@@ -339,43 +384,51 @@ public Q_SLOTS: // METHODS
 
     bool startRecordedFilePlayback(const QString &filepath)
     {
+        IPC_STATS_CALL();
         // TODO: Change method name to match API
         return DRing::startRecordedFilePlayback(filepath.toStdString());
     }
 
     void startTone(int start, int type)
     {
+        IPC_STATS_CALL();
         DRing::startTone(start, type);
     }
 
     void stopRecordedFilePlayback(const QString &filepath)
     {
+        IPC_STATS_CALL();
         DRing::stopRecordedFilePlayback(filepath.toStdString());
     }
 
     bool toggleRecording(const QString &callID)
     {
+        IPC_STATS_CALL();
         return DRing::toggleRecording(callID.toStdString());
     }
 
     bool transfer(const QString &callID, const QString &to)
     {
+        IPC_STATS_CALL();
         return DRing::transfer(
             callID.toStdString(), to.toStdString());
     }
 
     bool unhold(const QString &callID)
     {
+        IPC_STATS_CALL();
         return DRing::unhold(callID.toStdString());
     }
 
     bool unholdConference(const QString &confID)
     {
+        IPC_STATS_CALL();
         return DRing::unholdConference(confID.toStdString());
     }
 
     bool muteLocalMedia(const QString& callid, const QString& mediaType, bool mute)
     {
+        IPC_STATS_CALL();
         return DRing::muteLocalMedia(callid.toStdString(), mediaType.toStdString(), mute);
     }
 
@@ -34,6 +34,7 @@
 
 #include "typedefs.h"
 #include "conversions_wrap.hpp"
+#include "eventqueue.h"
 
 /*
  * Proxy class for interface org.ring.Ring.ConfigurationManager
@@ -57,88 +58,102 @@ public:
       confHandlers = {
          exportable_callback<ConfigurationSignal::VolumeChanged>(
                [this] (const std::string &device, double value) {
-                     QTimer::singleShot(0, [this,device,value] {
-                           Q_EMIT this->volumeChanged(QString(device.c_str()), value);
+                     EventQueue::post([this,device,value] {
+                           IPC_STATS_SIGNAL("volumeChanged");
+                           Q_EMIT this->volumeChanged(toQString(device), value);
                      });
          }),
          exportable_callback<ConfigurationSignal::AccountsChanged>(
                [this] () {
-                     QTimer::singleShot(0, [this] {
+                     EventQueue::post([this] {
+                           IPC_STATS_SIGNAL("accountsChanged");
                            Q_EMIT this->accountsChanged();
                      });
             }),
          exportable_callback<ConfigurationSignal::StunStatusFailed>(
                [this] (const std::string &reason) {
-                     QTimer::singleShot(0, [this, reason] {
-                           Q_EMIT this->stunStatusFailure(QString(reason.c_str()));
+                     EventQueue::post([this, reason] {
+                           IPC_STATS_SIGNAL("stunStatusFailure");
+                           Q_EMIT this->stunStatusFailure(toQString(reason));
                      });
          }),
          exportable_callback<ConfigurationSignal::RegistrationStateChanged>(
                [this] (const std::string &accountID, const std::string& registration_state, unsigned detail_code, const std::string& detail_str) {
-                     QTimer::singleShot(0, [this, accountID, registration_state, detail_code, detail_str] {
-                           Q_EMIT this->registrationStateChanged(QString(accountID.c_str()),
-                                                               QString(registration_state.c_str()),
+                     EventQueue::post([this, accountID, registration_state, detail_code, detail_str] {
+                           IPC_STATS_SIGNAL("registrationStateChanged");
+                           Q_EMIT this->registrationStateChanged(toQString(accountID),
+                                                               toQString(registration_state),
                                                                detail_code,
-                                                               QString(detail_str.c_str()));
+                                                               toQString(detail_str));
                      });
          }),
          exportable_callback<ConfigurationSignal::VolatileDetailsChanged>(
                [this] (const std::string &accountID, const std::map<std::string, std::string>& details) {
-                     QTimer::singleShot(0, [this, accountID, details] {
-                        Q_EMIT this->volatileAccountDetailsChanged(QString(accountID.c_str()), convertMap(details));
+                     EventQueue::post([this, accountID, details] {
+                        IPC_STATS_SIGNAL("volatileAccountDetailsChanged");
+                        Q_EMIT this->volatileAccountDetailsChanged(toQString(accountID), convertMap(details));
                      });
          }),
          exportable_callback<ConfigurationSignal::Error>(
                [this] (int code) {
-                     QTimer::singleShot(0, [this,code] {
+                     EventQueue::post([this,code] {
+                        IPC_STATS_SIGNAL("errorAlert");
                         Q_EMIT this->errorAlert(code);
                      });
          }),
          exportable_callback<ConfigurationSignal::CertificateExpired>(
                [this] (const std::string &certId) {
-                     QTimer::singleShot(0, [this, certId] {
-                           Q_EMIT this->certificateExpired(QString(certId.c_str()));
+                     EventQueue::post([this, certId] {
+                           IPC_STATS_SIGNAL("certificateExpired");
+                           Q_EMIT this->certificateExpired(toQString(certId));
                      });
          }),
          exportable_callback<ConfigurationSignal::CertificatePinned>(
                [this] (const std::string &certId) {
-                     QTimer::singleShot(0, [this, certId] {
-                           Q_EMIT this->certificatePinned(QString(certId.c_str()));
+                     EventQueue::post([this, certId] {
+                           IPC_STATS_SIGNAL("certificatePinned");
+                           Q_EMIT this->certificatePinned(toQString(certId));
                      });
          }),
          exportable_callback<ConfigurationSignal::CertificatePathPinned>(
                [this] (const std::string &certPath, const std::vector<std::string>& list) {
-                     QTimer::singleShot(0, [this, certPath, list] {
-                           Q_EMIT this->certificatePathPinned(QString(certPath.c_str()),convertStringList(list));
+                     EventQueue::post([this, certPath, list] {
+                           IPC_STATS_SIGNAL("certificatePathPinned");
+                           Q_EMIT this->certificatePathPinned(toQString(certPath),convertStringList(list));
                      });
          }),
          exportable_callback<DRing::ConfigurationSignal::AccountMessageStatusChanged>(
                [this] (const std::string& accountID, uint64_t id, const std::string& to, int status) {
-               QTimer::singleShot(0, [this, accountID, id, to, status] {
-                     Q_EMIT this->accountMessageStatusChanged(QString(accountID.c_str()), id, QString(to.c_str()), status);
+               EventQueue::post([this, accountID, id, to, status] {
+                     IPC_STATS_SIGNAL("accountMessageStatusChanged");
+                     Q_EMIT this->accountMessageStatusChanged(toQString(accountID), id, toQString(to), status);
                });
          }),
          exportable_callback<ConfigurationSignal::IncomingTrustRequest>(
                [this] (const std::string &accountId, const std::string &certId, const std::vector<uint8_t> &payload, time_t timestamp) {
-                     QTimer::singleShot(0, [this, certId,accountId,payload,timestamp] {
-                           Q_EMIT this->incomingTrustRequest(QString(accountId.c_str()), QString(certId.c_str()), QByteArray(reinterpret_cast<const char*>(payload.data()), payload.size()), timestamp);
+                     EventQueue::post([this, certId,accountId,payload,timestamp] {
+                           IPC_STATS_SIGNAL("incomingTrustRequest");
+                           Q_EMIT this->incomingTrustRequest(toQString(accountId), toQString(certId), QByteArray(reinterpret_cast<const char*>(payload.data()), payload.size()), timestamp);
                      });
          }),
          exportable_callback<ConfigurationSignal::IncomingAccountMessage>(
                [this] (const std::string& account_id, const std::string& from, const std::map<std::string, std::string>& payloads) {
-                     QTimer::singleShot(0, [this, account_id,from,payloads] {
-                           Q_EMIT this->incomingAccountMessage(QString(account_id.c_str()), QString(from.c_str()), convertMap(payloads));
+                     EventQueue::post([this, account_id,from,payloads] {
+                           IPC_STATS_SIGNAL("incomingAccountMessage");
+                           Q_EMIT this->incomingAccountMessage(toQString(account_id), toQString(from), convertMap(payloads));
                      });
          }),
          exportable_callback<ConfigurationSignal::MediaParametersChanged>(
                [this] (const std::string& account_id) {
-                     QTimer::singleShot(0, [this, account_id] {
-                           Q_EMIT this->mediaParametersChanged(QString(account_id.c_str()));
+                     EventQueue::post([this, account_id] {
+                           IPC_STATS_SIGNAL("mediaParametersChanged");
+                           Q_EMIT this->mediaParametersChanged(toQString(account_id));
                      });
          }),
          exportable_callback<AudioSignal::DeviceEvent>(
                [this] () {
-                     QTimer::singleShot(0, [this] {
+                     EventQueue::post([this] {
+                           IPC_STATS_SIGNAL("audioDeviceEvent");
                            Q_EMIT this->audioDeviceEvent();
                      });
          }),
@@ -150,13 +165,15 @@ public:
 public Q_SLOTS: // METHODS
    QString addAccount(MapStringString details)
    {
-      QString temp(
-         DRing::addAccount(convertMap(details)).c_str());
+      IPC_STATS_CALL();
+      QString temp = toQString(
+         DRing::addAccount(convertMap(details)));
       return temp;
    }
 
    MapStringString getAccountDetails(const QString& accountID)
    {
+      IPC_STATS_CALL();
       MapStringString temp =
          convertMap(DRing::getAccountDetails(accountID.toStdString()));
       return temp;
@@ -164,6 +181,7 @@ public Q_SLOTS: // METHODS
 
    QStringList getAccountList()
    {
+      IPC_STATS_CALL();
       QStringList temp =
          convertStringList(DRing::getAccountList());
       return temp;
@@ -171,6 +189,7 @@ public Q_SLOTS: // METHODS
 
    MapStringString getAccountTemplate(const QString& accountType)
    {
+      IPC_STATS_CALL();
       MapStringString temp =
          convertMap(DRing::getAccountTemplate(accountType.toStdString()));
       return temp;
@@ -179,19 +198,22 @@ public Q_SLOTS: // METHODS
    // TODO: works?
    VectorUInt getActiveCodecList(const QString& accountID)
    {
+      IPC_STATS_CALL();
       return QVector<unsigned int>::fromStdVector(
          DRing::getActiveCodecList(accountID.toStdString()));
    }
 
    QString getAddrFromInterfaceName(const QString& interface)
    {
-      QString temp(
-         DRing::getAddrFromInterfaceName(interface.toStdString()).c_str());
+      IPC_STATS_CALL();
+      QString temp = toQString(
+         DRing::getAddrFromInterfaceName(interface.toStdString()));
       return temp;
    }
 
    QStringList getAllIpInterface()
    {
+      IPC_STATS_CALL();
       QStringList temp =
          convertStringList(DRing::getAllIpInterface());
       return temp;
@@ -199,6 +221,7 @@ public Q_SLOTS: // METHODS
 
    QStringList getAllIpInterfaceByName()
    {
+      IPC_STATS_CALL();
       QStringList temp =
          convertStringList(DRing::getAllIpInterfaceByName());
       return temp;
@@ -206,6 +229,7 @@ public Q_SLOTS: // METHODS
 
    MapStringString getCodecDetails(const QString& accountID, int payload)
    {
+      IPC_STATS_CALL();
       MapStringString temp =
          convertMap(DRing::getCodecDetails(
                accountID.toStdString().c_str(), payload));
@@ -214,16 +238,19 @@ public Q_SLOTS: // METHODS
 
    VectorUInt getCodecList()
    {
+      IPC_STATS_CALL();
       return QVector<unsigned int>::fromStdVector(DRing::getCodecList());
    }
 
    int getAudioInputDeviceIndex(const QString& devname)
    {
+      IPC_STATS_CALL();
       return DRing::getAudioInputDeviceIndex(devname.toStdString());
    }
 
    QStringList getAudioInputDeviceList()
    {
+      IPC_STATS_CALL();
       QStringList temp =
          convertStringList(DRing::getAudioInputDeviceList());
       return temp;
@@ -231,18 +258,21 @@ public Q_SLOTS: // METHODS
 
    QString getAudioManager()
    {
-      QString temp(
-         DRing::getAudioManager().c_str());
+      IPC_STATS_CALL();
+      QString temp = toQString(
+         DRing::getAudioManager());
       return temp;
    }
 
    int getAudioOutputDeviceIndex(const QString& devname)
    {
+      IPC_STATS_CALL();
       return DRing::getAudioOutputDeviceIndex(devname.toStdString());
    }
 
    QStringList getAudioOutputDeviceList()
    {
+      IPC_STATS_CALL();
       QStringList temp =
          convertStringList(DRing::getAudioOutputDeviceList());
       return temp;
@@ -250,6 +280,7 @@ public Q_SLOTS: // METHODS
 
    QStringList getAudioPluginList()
    {
+      IPC_STATS_CALL();
       QStringList temp =
          convertStringList(DRing::getAudioPluginList());
       return temp;
@@ -257,6 +288,7 @@ public Q_SLOTS: // METHODS
 
    VectorMapStringString getCredentials(const QString& accountID)
    {
+      IPC_STATS_CALL();
       VectorMapStringString temp;
       for(auto x : DRing::getCredentials(accountID.toStdString())) {
          temp.push_back(convertMap(x));
@@ -266,6 +298,7 @@ public Q_SLOTS: // METHODS
 
    QStringList getCurrentAudioDevicesIndex()
    {
+      IPC_STATS_CALL();
       QStringList temp =
          convertStringList(DRing::getCurrentAudioDevicesIndex());
       return temp;
@@ -273,18 +306,21 @@ public Q_SLOTS: // METHODS
 
    QString getCurrentAudioOutputPlugin()
    {
-      QString temp(
-         DRing::getCurrentAudioOutputPlugin().c_str());
+      IPC_STATS_CALL();
+      QString temp = toQString(
+         DRing::getCurrentAudioOutputPlugin());
       return temp;
    }
 
    int getHistoryLimit()
    {
+      IPC_STATS_CALL();
       return DRing::getHistoryLimit();
    }
 
    MapStringString getHookSettings()
    {
+      IPC_STATS_CALL();
       MapStringString temp =
          convertMap(DRing::getHookSettings());
       return temp;
@@ -292,29 +328,34 @@ public Q_SLOTS: // METHODS
 
    bool getIsAlwaysRecording()
    {
+      IPC_STATS_CALL();
       return DRing::getIsAlwaysRecording();
    }
 
    bool getNoiseSuppressState()
    {
+      IPC_STATS_CALL();
       return DRing::getNoiseSuppressState();
    }
 
    QString getRecordPath()
    {
-      QString temp(
-         DRing::getRecordPath().c_str());
+      IPC_STATS_CALL();
+      QString temp = toQString(
+         DRing::getRecordPath());
       return temp;
    }
 
    QStringList getSupportedAudioManagers()
    {
+      IPC_STATS_CALL();
       QStringList temp;
       return temp;
    }
 
    MapStringString getShortcuts()
    {
+      IPC_STATS_CALL();
       MapStringString temp =
          convertMap(DRing::getShortcuts());
       return temp;
@@ -322,6 +363,7 @@ public Q_SLOTS: // METHODS
 
    QStringList getSupportedTlsMethod()
    {
+      IPC_STATS_CALL();
       QStringList temp =
          convertStringList(DRing::getSupportedTlsMethod());
       return temp;
@@ -329,6 +371,7 @@ public Q_SLOTS: // METHODS
 
    MapStringString validateCertificate(const QString& unused, const QString& certificate)
    {
+      IPC_STATS_CALL();
       MapStringString temp =
          convertMap(DRing::validateCertificate(unused.toStdString(),
                                              certificate.toStdString()));
@@ -337,6 +380,7 @@ public Q_SLOTS: // METHODS
 
    MapStringString validateCertificatePath(const QString& unused, const QString& certificate, const QString& privateKey, const QString& privateKeyPass, const QString& caListPath)
    {
+      IPC_STATS_CALL();
       MapStringString temp =
          convertMap(DRing::validateCertificatePath(unused.toStdString(),
                                              certificate.toStdString(),
@@ -348,6 +392,7 @@ public Q_SLOTS: // METHODS
 
    MapStringString getCertificateDetails(const QString& certificate)
    {
+      IPC_STATS_CALL();
       MapStringString temp =
          convertMap(DRing::getCertificateDetails(certificate.toStdString()));
       return temp;
@@ -355,6 +400,7 @@ public Q_SLOTS: // METHODS
 
    MapStringString getCertificateDetailsPath(const QString& certificate, const QString& privateKey, const QString& privateKeyPass)
    {
+      IPC_STATS_CALL();
       MapStringString temp =
          convertMap(DRing::getCertificateDetailsPath(certificate.toStdString(),
                                                      privateKey.toStdString(),
@@ -364,6 +410,7 @@ public Q_SLOTS: // METHODS
 
    QStringList getSupportedCiphers(const QString& accountID)
    {
+      IPC_STATS_CALL();
       QStringList temp =
          convertStringList(DRing::getSupportedCiphers(accountID.toStdString()));
       return temp;
@@ -371,6 +418,7 @@ public Q_SLOTS: // METHODS
 
    MapStringString getTlsDefaultSettings()
    {
+      IPC_STATS_CALL();
       MapStringString temp =
          convertMap(DRing::getTlsDefaultSettings());
       return temp;
@@ -378,82 +426,98 @@ public Q_SLOTS: // METHODS
 
    double getVolume(const QString& device)
    {
+      IPC_STATS_CALL();
       return DRing::getVolume(device.toStdString());
    }
 
    bool isAgcEnabled()
    {
+      IPC_STATS_CALL();
       return DRing::isAgcEnabled();
    }
 
    bool isCaptureMuted()
    {
+      IPC_STATS_CALL();
       return DRing::isCaptureMuted();
    }
 
    bool isDtmfMuted()
    {
+      IPC_STATS_CALL();
       return DRing::isDtmfMuted();
    }
 
    bool isPlaybackMuted()
    {
+      IPC_STATS_CALL();
       return DRing::isPlaybackMuted();
    }
 
    void muteCapture(bool mute)
    {
+      IPC_STATS_CALL();
       DRing::muteCapture(mute);
    }
 
    void muteDtmf(bool mute)
    {
+      IPC_STATS_CALL();
       DRing::muteDtmf(mute);
    }
 
    void mutePlayback(bool mute)
    {
+      IPC_STATS_CALL();
       DRing::mutePlayback(mute);
    }
 
    void registerAllAccounts()
    {
+      IPC_STATS_CALL();
       DRing::registerAllAccounts();
    }
 
    void removeAccount(const QString& accountID)
    {
+      IPC_STATS_CALL();
       DRing::removeAccount(accountID.toStdString());
    }
 
    int  exportAccounts(const QStringList& accountIDs, const QString& filePath, const QString& password)
    {
+      IPC_STATS_CALL();
       return DRing::exportAccounts(convertStringList(accountIDs), filePath.toStdString(), password.toStdString());
    }
 
    int importAccounts(const QString& filePath, const QString& password)
    {
+      IPC_STATS_CALL();
       return DRing::importAccounts(filePath.toStdString(), password.toStdString());
    }
 
    void sendRegister(const QString& accountID, bool enable)
    {
+      IPC_STATS_CALL();
       DRing::sendRegister(accountID.toStdString(), enable);
    }
 
    void setAccountDetails(const QString& accountID, MapStringString details)
    {
+      IPC_STATS_CALL();
       DRing::setAccountDetails(accountID.toStdString(),
          convertMap(details));
    }
 
    void setAccountsOrder(const QString& order)
    {
+      IPC_STATS_CALL();
       DRing::setAccountsOrder(order.toStdString());
    }
 
    void setActiveCodecList(const QString& accountID, VectorUInt &list)
    {
+      IPC_STATS_CALL();
       //const std::vector<unsigned int> converted = convertStringList(list);
       DRing::setActiveCodecList(accountID.toStdString(),
       list.toStdVector());
@@ -461,36 +525,43 @@ public Q_SLOTS: // METHODS
 
    void setAgcState(bool enabled)
    {
+      IPC_STATS_CALL();
       DRing::setAgcState(enabled);
    }
 
    void setAudioInputDevice(int index)
    {
+      IPC_STATS_CALL();
       DRing::setAudioInputDevice(index);
    }
 
    bool setAudioManager(const QString& api)
    {
+      IPC_STATS_CALL();
       return DRing::setAudioManager(api.toStdString());
    }
 
    void setAudioOutputDevice(int index)
    {
+      IPC_STATS_CALL();
       DRing::setAudioOutputDevice(index);
    }
 
    void setAudioPlugin(const QString& audioPlugin)
    {
+      IPC_STATS_CALL();
       DRing::setAudioPlugin(audioPlugin.toStdString());
    }
 
    void setAudioRingtoneDevice(int index)
    {
+      IPC_STATS_CALL();
       DRing::setAudioRingtoneDevice(index);
    }
 
    void setCredentials(const QString& accountID, VectorMapStringString credentialInformation)
    {
+      IPC_STATS_CALL();
       std::vector<std::map<std::string, std::string> > temp;
       for (auto x : credentialInformation) {
          temp.push_back(convertMap(x));
@@ -500,47 +571,56 @@ public Q_SLOTS: // METHODS
 
    void setHistoryLimit(int days)
    {
+      IPC_STATS_CALL();
       DRing::setHistoryLimit(days);
    }
 
    void setHookSettings(MapStringString settings)
    {
+      IPC_STATS_CALL();
       DRing::setHookSettings(convertMap(settings));
    }
 
    void setIsAlwaysRecording(bool enabled)
    {
+      IPC_STATS_CALL();
       DRing::setIsAlwaysRecording(enabled);
    }
 
    void setNoiseSuppressState(bool state)
    {
+      IPC_STATS_CALL();
       DRing::setNoiseSuppressState(state);
    }
 
    void setRecordPath(const QString& rec)
    {
+      IPC_STATS_CALL();
       DRing::setRecordPath(rec.toStdString());
    }
 
    void setShortcuts(MapStringString shortcutsMap)
    {
+      IPC_STATS_CALL();
       DRing::setShortcuts(convertMap(shortcutsMap));
    }
 
    void setVolume(const QString& device, double value)
    {
+      IPC_STATS_CALL();
       DRing::setVolume(device.toStdString(), value);
    }
 
    MapStringString getVolatileAccountDetails(const QString& accountID)
    {
+      IPC_STATS_CALL();
       MapStringString temp = convertMap(DRing::getVolatileAccountDetails(accountID.toStdString()));
       return temp;
    }
 
    QStringList getPinnedCertificates()
    {
+      IPC_STATS_CALL();
       QStringList temp =
          convertStringList(DRing::getPinnedCertificates());
       return temp;
@@ -548,78 +628,93 @@ public Q_SLOTS: // METHODS
 
    QStringList pinCertificate(const QByteArray& content, bool local)
    {
+      IPC_STATS_CALL();
       std::vector<unsigned char> raw(content.begin(), content.end());
       return convertStringList(DRing::pinCertificate(raw,local));
    }
 
    bool unpinCertificate(const QString& certId)
    {
+      IPC_STATS_CALL();
       return DRing::unpinCertificate(certId.toStdString());
    }
 
    void pinCertificatePath(const QString& certPath)
    {
+      IPC_STATS_CALL();
       DRing::pinCertificatePath(certPath.toStdString());
    }
 
    uint unpinCertificatePath(const QString& certPath)
    {
+      IPC_STATS_CALL();
       return DRing::unpinCertificatePath(certPath.toStdString());
    }
 
    bool pinRemoteCertificate(const QString& accountId, const QString& certPath)
    {
+      IPC_STATS_CALL();
       return DRing::pinRemoteCertificate(accountId.toStdString(), certPath.toStdString());
    }
 
    bool setCertificateStatus(const QString& accountId, const QString& certPath, const QString& status)
    {
+      IPC_STATS_CALL();
       return DRing::setCertificateStatus(accountId.toStdString(), certPath.toStdString(), status.toStdString());
    }
 
    QStringList getCertificatesByStatus(const QString& accountId, const QString& status)
    {
+      IPC_STATS_CALL();
       return convertStringList(DRing::getCertificatesByStatus(accountId.toStdString(), status.toStdString()));
    }
 
    MapStringString getTrustRequests(const QString& accountId)
    {
+      IPC_STATS_CALL();
       return convertMap(DRing::getTrustRequests(accountId.toStdString()));
    }
 
    bool acceptTrustRequest(const QString& accountId, const QString& from)
    {
+      IPC_STATS_CALL();
       return DRing::acceptTrustRequest(accountId.toStdString(), from.toStdString());
    }
 
    bool discardTrustRequest(const QString& accountId, const QString& from)
    {
+      IPC_STATS_CALL();
       return DRing::discardTrustRequest(accountId.toStdString(), from.toStdString());
    }
 
    void sendTrustRequest(const QString& accountId, const QString& from, const QByteArray& payload)
    {
+      IPC_STATS_CALL();
       std::vector<unsigned char> raw(payload.begin(), payload.end());
       DRing::sendTrustRequest(accountId.toStdString(), from.toStdString(), raw);
    }
 
    uint64_t sendTextMessage(const QString& accountId, const QString& to, const QMap<QString,QString>& payloads)
    {
+      IPC_STATS_CALL();
       return DRing::sendAccountTextMessage(accountId.toStdString(), to.toStdString(), convertMap(payloads));
    }
 
    bool setCodecDetails(const QString& accountId, unsigned int codecId, const MapStringString& details)
    {
+      IPC_STATS_CALL();
       return DRing::setCodecDetails(accountId.toStdString(), codecId, convertMap(details));
    }
 
    int getMessageStatus(uint64_t id)
    {
+      IPC_STATS_CALL();
        return DRing::getMessageStatus(id);
    }
 
    void connectivityChanged()
    {
+      IPC_STATS_CALL();
        DRing::connectivityChanged();
    }
 
@@ -21,8 +21,14 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <unordered_map>
+
+#include <account_const.h>
+#include <call_const.h>
+#include <security_const.h>
 
 #include "../typedefs.h"
+#include "ipcstats.h"
 
 #define Q_NOREPLY
 
@@ -39,42 +45,214 @@
  #define LOG_DRING_SIGNAL4(name,arg,arg2,arg3,arg4)
 #endif
 
+/**
+ * The daemon strings are UTF-8 and their length is already known, there is
+ * no need for QString(const char*) to scan them again.
+ */
+inline QString toQString(const std::string& s) {
+   IPC_STATS_PAYLOAD(s.size());
+   return QString::fromUtf8(s.data(), static_cast<int>(s.size()));
+}
+
+inline std::string toStdString(const QString& s) {
+   const QByteArray utf8 = s.toUtf8();
+   IPC_STATS_PAYLOAD(static_cast<std::size_t>(utf8.size()));
+   return std::string(utf8.constData(), static_cast<std::size_t>(utf8.size()));
+}
+
+/**
+ * The detail maps use the same few hundred property names over and over.
+ * Reuse the QString of the known keys instead of allocating a new one for
+ * every map. QString is implicitly shared, so the copies are cheap.
+ *
+ * The table is built once from the daemon constants and never changes
+ * after that, so the callbacks can use it from any daemon thread. Other
+ * keys (ids, URIs, ...) are converted normally.
+ */
+inline const std::unordered_map<std::string, QString>& knownKeys() {
+   static const std::unordered_map<std::string, QString> keys = [] {
+      static const char* const names[] = {
+         DRing::Account::ConfProperties::ACTIVE_CALL_LIMIT,
+         DRing::Account::ConfProperties::ALIAS,
+         DRing::Account::ConfProperties::ALLOW_CERT_FROM_CONTACT,
+         DRing::Account::ConfProperties::ALLOW_CERT_FROM_HISTORY,
+         DRing::Account::ConfProperties::AUTOANSWER,
+         DRing::Account::ConfProperties::Audio::PORT_MAX,
+         DRing::Account::ConfProperties::Audio::PORT_MIN,
+         DRing::Account::ConfProperties::CodecInfo::AUTO_QUALITY_ENABLED,
+         DRing::Account::ConfProperties::CodecInfo::BITRATE,
+         DRing::Account::ConfProperties::CodecInfo::MAX_BITRATE,
+         DRing::Account::ConfProperties::CodecInfo::MAX_QUALITY,
+         DRing::Account::ConfProperties::CodecInfo::MIN_BITRATE,
+         DRing::Account::ConfProperties::CodecInfo::MIN_QUALITY,
+         DRing::Account::ConfProperties::CodecInfo::NAME,
+         DRing::Account::ConfProperties::CodecInfo::QUALITY,
+         DRing::Account::ConfProperties::CodecInfo::SAMPLE_RATE,
+         DRing::Account::ConfProperties::CodecInfo::TYPE,
+         DRing::Account::ConfProperties::DHT::PORT,
+         DRing::Account::ConfProperties::DHT::PUBLIC_IN_CALLS,
+         DRing::Account::ConfProperties::DISPLAYNAME,
+         DRing::Account::ConfProperties::DTMF_TYPE,
+         DRing::Account::ConfProperties::ENABLED,
+         DRing::Account::ConfProperties::HAS_CUSTOM_USER_AGENT,
+         DRing::Account::ConfProperties::HOSTNAME,
+         DRing::Account::ConfProperties::LOCAL_INTERFACE,
+         DRing::Account::ConfProperties::LOCAL_PORT,
+         DRing::Account::ConfProperties::MAILBOX,
+         DRing::Account::ConfProperties::PASSWORD,
+         DRing::Account::ConfProperties::PUBLISHED_ADDRESS,
+         DRing::Account::ConfProperties::PUBLISHED_PORT,
+         DRing::Account::ConfProperties::PUBLISHED_SAMEAS_LOCAL,
+         DRing::Account::ConfProperties::Presence::ENABLED,
+         DRing::Account::ConfProperties::Presence::SUPPORT_PUBLISH,
+         DRing::Account::ConfProperties::Presence::SUPPORT_SUBSCRIBE,
+         DRing::Account::ConfProperties::REALM,
+         DRing::Account::ConfProperties::ROUTE,
+         DRing::Account::ConfProperties::Registration::EXPIRE,
+         DRing::Account::ConfProperties::Registration::STATUS,
+         DRing::Account::ConfProperties::Ringtone::ENABLED,
+         DRing::Account::ConfProperties::Ringtone::PATH,
+         DRing::Account::ConfProperties::SRTP::ENABLED,
+         DRing::Account::ConfProperties::SRTP::KEY_EXCHANGE,
+         DRing::Account::ConfProperties::SRTP::RTP_FALLBACK,
+         DRing::Account::ConfProperties::STUN::ENABLED,
+         DRing::Account::ConfProperties::STUN::SERVER,
+         DRing::Account::ConfProperties::TLS::CA_LIST_FILE,
+         DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE,
+         DRing::Account::ConfProperties::TLS::CIPHERS,
+         DRing::Account::ConfProperties::TLS::ENABLED,
+         DRing::Account::ConfProperties::TLS::LISTENER_PORT,
+         DRing::Account::ConfProperties::TLS::METHOD,
+         DRing::Account::ConfProperties::TLS::NEGOTIATION_TIMEOUT_SEC,
+         DRing::Account::ConfProperties::TLS::PASSWORD,
+         DRing::Account::ConfProperties::TLS::PRIVATE_KEY_FILE,
+         DRing::Account::ConfProperties::TLS::REQUIRE_CLIENT_CERTIFICATE,
+         DRing::Account::ConfProperties::TLS::SERVER_NAME,
+         DRing::Account::ConfProperties::TLS::VERIFY_CLIENT,
+         DRing::Account::ConfProperties::TLS::VERIFY_SERVER,
+         DRing::Account::ConfProperties::TURN::ENABLED,
+         DRing::Account::ConfProperties::TURN::SERVER,
+         DRing::Account::ConfProperties::TURN::SERVER_PWD,
+         DRing::Account::ConfProperties::TURN::SERVER_REALM,
+         DRing::Account::ConfProperties::TURN::SERVER_UNAME,
+         DRing::Account::ConfProperties::TYPE,
+         DRing::Account::ConfProperties::UPNP_ENABLED,
+         DRing::Account::ConfProperties::USERNAME,
+         DRing::Account::ConfProperties::USER_AGENT,
+         DRing::Account::ConfProperties::Video::ENABLED,
+         DRing::Account::ConfProperties::Video::PORT_MAX,
+         DRing::Account::ConfProperties::Video::PORT_MIN,
+         DRing::Account::VolatileProperties::Registration::STATUS,
+         DRing::Account::VolatileProperties::Transport::STATE_CODE,
+         DRing::Account::VolatileProperties::Transport::STATE_DESC,
+         DRing::Call::Details::ACCOUNTID,
+         DRing::Call::Details::CALL_STATE,
+         DRing::Call::Details::CALL_TYPE,
+         DRing::Call::Details::CONF_ID,
+         DRing::Call::Details::DISPLAY_NAME,
+         DRing::Call::Details::PEER_NUMBER,
+         DRing::Call::Details::TIMESTAMP_START,
+         DRing::Call::Details::VIDEO_SOURCE,
+         DRing::Certificate::ChecksNames::AUTHORITY_MISMATCH,
+         DRing::Certificate::ChecksNames::EXIST,
+         DRing::Certificate::ChecksNames::EXPIRED,
+         DRing::Certificate::ChecksNames::HAS_PRIVATE_KEY,
+         DRing::Certificate::ChecksNames::KEY_MATCH,
+         DRing::Certificate::ChecksNames::KNOWN_AUTHORITY,
+         DRing::Certificate::ChecksNames::NOT_ACTIVATED,
+         DRing::Certificate::ChecksNames::NOT_REVOKED,
+         DRing::Certificate::ChecksNames::NOT_SELF_SIGNED,
+         DRing::Certificate::ChecksNames::PRIVATE_KEY_DIRECTORY_PERMISSIONS,
+         DRing::Certificate::ChecksNames::PRIVATE_KEY_SELINUX_ATTRIBUTES,
+         DRing::Certificate::ChecksNames::PRIVATE_KEY_STORAGE_LOCATION,
+         DRing::Certificate::ChecksNames::PRIVATE_KEY_STORAGE_PERMISSION,
+         DRing::Certificate::ChecksNames::PUBLIC_KEY_DIRECTORY_PERMISSIONS,
+         DRing::Certificate::ChecksNames::PUBLIC_KEY_SELINUX_ATTRIBUTES,
+         DRing::Certificate::ChecksNames::PUBLIC_KEY_STORAGE_LOCATION,
+         DRing::Certificate::ChecksNames::PUBLIC_KEY_STORAGE_PERMISSION,
+         DRing::Certificate::ChecksNames::STRONG_SIGNING,
+         DRing::Certificate::ChecksNames::UNEXPECTED_OWNER,
+         DRing::Certificate::ChecksNames::VALID,
+         DRing::Certificate::ChecksNames::VALID_AUTHORITY,
+         DRing::Certificate::DetailsNames::ACTIVATION_DATE,
+         DRing::Certificate::DetailsNames::CN,
+         DRing::Certificate::DetailsNames::EXPIRATION_DATE,
+         DRing::Certificate::DetailsNames::ISSUER,
+         DRing::Certificate::DetailsNames::ISSUER_DN,
+         DRing::Certificate::DetailsNames::MD,
+         DRing::Certificate::DetailsNames::N,
+         DRing::Certificate::DetailsNames::NEXT_EXPECTED_UPDATE_DATE,
+         DRing::Certificate::DetailsNames::O,
+         DRing::Certificate::DetailsNames::OUTGOING_SERVER,
+         DRing::Certificate::DetailsNames::PUBLIC_KEY_ID,
+         DRing::Certificate::DetailsNames::PUBLIC_SIGNATURE,
+         DRing::Certificate::DetailsNames::REQUIRE_PRIVATE_KEY_PASSWORD,
+         DRing::Certificate::DetailsNames::SERIAL_NUMBER,
+         DRing::Certificate::DetailsNames::SHA,
+         DRing::Certificate::DetailsNames::SIGNATURE_ALGORITHM,
+         DRing::Certificate::DetailsNames::SUBJECT_KEY_ALGORITHM,
+         DRing::Certificate::DetailsNames::VERSION_NUMBER,
+      };
+
+      std::unordered_map<std::string, QString> ret;
+      for (const char* name : names)
+         ret.emplace(name, QString::fromUtf8(name));
+      return ret;
+   }();
+
+   return keys;
+}
+
+inline QString internKey(const std::string& key) {
+   const auto& keys = knownKeys();
+
+   const auto it = keys.find(key);
+   if (it != keys.end())
+      return it->second;
+
+   return toQString(key);
+}
+
 inline MapStringString convertMap(const std::map<std::string, std::string>& m) {
    MapStringString temp;
+   //Both maps are sorted, always append at the end
    for (const auto& x : m) {
-      temp[QString(x.first.c_str())] = QString(x.second.c_str());
+      temp.insert(temp.constEnd(), internKey(x.first), toQString(x.second));
    }
    return temp;
 }
 
 inline std::map<std::string, std::string> convertMap(const MapStringString& m) {
    std::map<std::string, std::string> temp;
-   for (const auto& x : m.toStdMap()) {
-      temp[x.first.toStdString()] = x.second.toStdString();
+   for (auto x = m.constBegin(); x != m.constEnd(); ++x) {
+      temp.emplace_hint(temp.end(), toStdString(x.key()), toStdString(x.value()));
    }
    return temp;
 }
 
 inline QStringList convertStringList(const std::vector<std::string>& v) {
    QStringList temp;
+   temp.reserve(static_cast<int>(v.size()));
    for (const auto& x : v) {
-      temp.push_back(QString(x.c_str()));
+      temp.push_back(toQString(x));
    }
    return temp;
 }
 
 inline VectorString convertVectorString(const std::vector<std::string>& v) {
    VectorString temp;
+   temp.reserve(static_cast<int>(v.size()));
    for (const auto& x : v) {
-      temp.push_back(QString(x.c_str()));
+      temp.push_back(toQString(x));
    }
    return temp;
 }
 
 inline std::vector<std::string> convertStringList(const QStringList& v) {
    std::vector<std::string> temp;
+   temp.reserve(static_cast<std::size_t>(v.size()));
    for (const auto& x : v) {
-      temp.push_back(x.toStdString());
+      temp.push_back(toStdString(x));
    }
    return temp;
 }
@@ -82,7 +260,7 @@ inline std::vector<std::string> convertStringList(const QStringList& v) {
 inline MapStringInt  convertStringInt(const std::map<std::string, int>& m) {
    MapStringInt temp;
    for (const auto& x : m) {
-      temp[QString(x.first.c_str())] = x.second;
+      temp.insert(temp.constEnd(), internKey(x.first), x.second);
    }
    return temp;
 }
@@ -0,0 +1,222 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "eventqueue.h"
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QObject>
+#include <QtCore/QSocketNotifier>
+
+// libstdc++
+#include <atomic>
+#include <cstdint>
+
+#ifndef Q_OS_WIN
+ #include <fcntl.h>
+ #include <unistd.h>
+#endif
+
+#ifdef Q_OS_LINUX
+ #include <sys/eventfd.h>
+#endif
+
+namespace {
+
+/**
+ * Multiple producers, single consumer queue.
+ *
+ * This is Dmitry Vyukov's node based queue. push() never blocks, pop() can
+ * miss an element while it is being pushed, the producer then wakes the
+ * consumer again.
+ */
+class Queue final
+{
+public:
+   Queue() : m_pHead(new Node), m_pTail(m_pHead.load()) {}
+
+   ~Queue()
+   {
+      std::function<void()> event;
+      while (pop(event));
+      delete m_pTail;
+   }
+
+   void push(std::function<void()>&& event)
+   {
+      Node* n = new Node;
+      n->event = std::move(event);
+
+      Node* prev = m_pHead.exchange(n, std::memory_order_acq_rel);
+      prev->next.store(n, std::memory_order_release);
+   }
+
+   bool pop(std::function<void()>& event)
+   {
+      Node* next = m_pTail->next.load(std::memory_order_acquire);
+
+      if (!next)
+         return false;
+
+      event = std::move(next->event);
+
+      delete m_pTail;
+      m_pTail = next;
+
+      return true;
+   }
+
+private:
+   struct Node {
+      std::function<void()> event {         };
+      std::atomic<Node*>    next  { nullptr };
+   };
+
+   std::atomic<Node*> m_pHead; // last pushed, shared by the producers
+   Node*              m_pTail; // already consumed, only used by the consumer
+};
+
+}
+
+class EventQueueDispatcher final : public QObject
+{
+   Q_OBJECT
+public:
+   EventQueueDispatcher();
+   virtual ~EventQueueDispatcher();
+
+   void post(std::function<void()>&& event);
+
+private:
+   ///Give some time to the rest of the event loop when the daemon is busy
+   static constexpr int MAX_BATCH = 64;
+
+   void wakeUp();
+
+   Queue            m_Queue                 ;
+   std::atomic_bool m_WakeUpPending { false };
+   int              m_ReadFd        { -1    };
+   int              m_WriteFd       { -1    };
+   QSocketNotifier* m_pNotifier     { nullptr };
+
+private Q_SLOTS:
+   void dispatch();
+};
+
+static std::atomic<EventQueueDispatcher*> s_pDispatcher { nullptr };
+
+EventQueueDispatcher::EventQueueDispatcher() : QObject(QCoreApplication::instance())
+{
+#if defined(Q_OS_LINUX)
+   m_ReadFd = m_WriteFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#elif !defined(Q_OS_WIN)
+   int fds[2];
+   if (::pipe(fds) == 0) {
+      for (const int fd : fds)
+         ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+      m_ReadFd  = fds[0];
+      m_WriteFd = fds[1];
+   }
+#endif
+
+   // Otherwise, fallback to posted events
+   if (m_ReadFd != -1) {
+      m_pNotifier = new QSocketNotifier(m_ReadFd, QSocketNotifier::Read, this);
+      connect(m_pNotifier, SIGNAL(activated(int)), this, SLOT(dispatch()));
+   }
+}
+
+EventQueueDispatcher::~EventQueueDispatcher()
+{
+#ifndef Q_OS_WIN
+   if (m_WriteFd != m_ReadFd)
+      ::close(m_WriteFd);
+
+   if (m_ReadFd != -1)
+      ::close(m_ReadFd);
+#endif
+}
+
+///Called from the daemon threads
+void EventQueueDispatcher::post(std::function<void()>&& event)
+{
+   m_Queue.push(std::move(event));
+
+   // Only the first event since the last dispatch() needs to wake it up
+   if (!m_WakeUpPending.exchange(true))
+      wakeUp();
+}
+
+void EventQueueDispatcher::wakeUp()
+{
+#ifndef Q_OS_WIN
+   if (m_WriteFd != -1) {
+# ifdef Q_OS_LINUX
+      const uint64_t one = 1;
+# else
+      const char     one = 1;
+# endif
+      // If the pipe is full, the consumer is already awake
+      if (::write(m_WriteFd, &one, sizeof(one)) < 0) {}
+      return;
+   }
+#endif
+
+   QMetaObject::invokeMethod(this, "dispatch", Qt::QueuedConnection);
+}
+
+void EventQueueDispatcher::dispatch()
+{
+#ifndef Q_OS_WIN
+   if (m_ReadFd != -1) {
+      uint64_t buffer;
+      while (::read(m_ReadFd, &buffer, sizeof(buffer)) > 0);
+   }
+#endif
+
+   // Before reading the queue, see post()
+   m_WakeUpPending = false;
+
+   std::function<void()> event;
+
+   for (int i = 0; i < MAX_BATCH; i++) {
+      if (!m_Queue.pop(event))
+         return;
+
+      event();
+   }
+
+   // There may be more, come back after the other events
+   if (!m_WakeUpPending.exchange(true))
+      wakeUp();
+}
+
+///Must be called from the main thread before the daemon is started
+void EventQueue::init()
+{
+   if (!s_pDispatcher)
+      s_pDispatcher = new EventQueueDispatcher();
+}
+
+void EventQueue::post(std::function<void()> event)
+{
+   if (EventQueueDispatcher* d = s_pDispatcher)
+      d->post(std::move(event));
+}
+
+#include <eventqueue.moc>
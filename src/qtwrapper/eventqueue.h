@@ -0,0 +1,37 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+// libstdc++
+#include <functional>
+
+/**
+ * Deliver the daemon callbacks to the main thread.
+ *
+ * The daemon calls the callbacks from its own threads. post() can be called
+ * from any of them, the events are then executed in order, in batches, by
+ * the thread that called init(). On Linux, the main thread is woken up by an
+ * eventfd watched by a QSocketNotifier, nothing is polled while idle.
+ */
+namespace EventQueue {
+
+void init();
+
+void post(std::function<void()> event);
+
+}
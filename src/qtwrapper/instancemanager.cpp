@@ -18,6 +18,11 @@
  ***************************************************************************/
 
 #include "instancemanager_wrap.h"
+
+#include <QtCore/QThread>
+
+#include "eventqueue.h"
+#include "ipcstats.h"
 #include "callmanager.h"
 #include "presencemanager.h"
 #include "configurationmanager.h"
@@ -29,7 +34,7 @@ static int ringFlags = 0;
 
 void pollEvents();
 
-InstanceManagerInterface::InstanceManagerInterface() : m_pTimer(nullptr)
+InstanceManagerInterface::InstanceManagerInterface() : m_pTimer(nullptr), m_pPollThread(nullptr)
 {
    using namespace std::placeholders;
 
@@ -43,14 +48,31 @@ InstanceManagerInterface::InstanceManagerInterface() : m_pTimer(nullptr)
    using DRing::VideoSignal;
 #endif
 
-   m_pTimer = new QTimer(this);
+   // The callbacks are delivered by the event queue as soon as they happen,
+   // the daemon internal events are polled away from the main thread
+   EventQueue::init();
+
+#ifdef ENABLE_IPC_STATS
+   const int dumpInterval = qgetenv("LRC_IPC_STATS_DUMP").toInt();
+   if (dumpInterval > 0)
+      IpcStats::setDumpInterval(dumpInterval);
+#endif
+
+   // Only started once the daemon runs, see below
+   m_pPollThread = new QThread(this);
+   m_pPollThread->setObjectName("DRing::pollEvents");
+
+   m_pTimer = new QTimer();
    m_pTimer->setInterval(50);
+   m_pTimer->moveToThread(m_pPollThread);
 #ifdef Q_OS_WIN
-   connect(m_pTimer,SIGNAL(timeout()),this,SLOT(pollEvents()));
+   connect(m_pTimer,SIGNAL(timeout()),this,SLOT(pollEvents()),Qt::DirectConnection);
+   connect(m_pPollThread,SIGNAL(started()),m_pTimer,SLOT(start()));
 #else
-   connect(m_pTimer,&QTimer::timeout,this,&InstanceManagerInterface::pollEvents);
+   connect(m_pTimer,&QTimer::timeout,this,&InstanceManagerInterface::pollEvents,Qt::DirectConnection);
+   connect(m_pPollThread,&QThread::started,m_pTimer,static_cast<void(QTimer::*)()>(&QTimer::start));
 #endif
-   m_pTimer->start();
+   connect(m_pPollThread,&QThread::finished,m_pTimer,&QObject::deleteLater);
 
 #ifndef MUTE_DRING
    ringFlags |= DRing::DRING_FLAG_DEBUG;
@@ -66,22 +88,40 @@ InstanceManagerInterface::InstanceManagerInterface() : m_pTimer(nullptr)
    registerVideoHandlers(VideoManager::instance().videoHandlers);
 #endif
 
-   if (!DRing::start())
+   if (!DRing::start()) {
       printf("Error initializing daemon\n");
-   else
-      printf("Daemon is running\n");
+
+      // The poll thread never ran, nothing will delete it
+      delete m_pTimer;
+      m_pTimer = nullptr;
+      return;
+   }
+
+   printf("Daemon is running\n");
+
+   m_pPollThread->start();
 }
 
 InstanceManagerInterface::~InstanceManagerInterface()
 {
-
+   stopPolling();
 }
 
+///Called from the polling thread
 void InstanceManagerInterface::pollEvents()
 {
    DRing::pollEvents();
 }
 
+void InstanceManagerInterface::stopPolling()
+{
+   if (!m_pPollThread->isRunning())
+      return;
+
+   m_pPollThread->quit();
+   m_pPollThread->wait();
+}
+
 bool InstanceManagerInterface::isConnected()
 {
    return true;
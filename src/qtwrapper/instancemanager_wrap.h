@@ -26,6 +26,7 @@
 #include <QStringList>
 #include <QVariant>
 #include <QTimer>
+#include <QThread>
 
 #include "dring.h"
 #include "../typedefs.h"
@@ -52,7 +53,9 @@ public Q_SLOTS: // METHODS
 
    void Unregister(int pid)
    {
+      IPC_STATS_CALL();
       Q_UNUSED(pid) //When directly linked, the PID is always the current process PID
+      stopPolling();
       DRing::fini();
    }
 
@@ -61,7 +64,10 @@ public Q_SLOTS: // METHODS
    void pollEvents();
 
 private:
-   QTimer* m_pTimer;
+   QTimer*  m_pTimer     ;
+   QThread* m_pPollThread;
+
+   void stopPolling();
 
 Q_SIGNALS: // SIGNALS
    void started();
@@ -0,0 +1,262 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "ipcstats.h"
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+// libstdc++
+#include <algorithm>
+
+namespace {
+
+// The names are string literals or __func__, their address is a cheap key
+typedef QPair<const char*, const char*> Key;
+
+QMutex                        s_Mutex              ;
+QHash<Key, IpcStats::Method>  s_hMethods           ;
+thread_local IpcStats::Scope* s_pCurrent {nullptr} ;
+
+QString threadName()
+{
+   thread_local QString name;
+
+   if (name.isEmpty()) {
+      QThread* t = QThread::currentThread();
+
+      if (QCoreApplication::instance() && t == QCoreApplication::instance()->thread())
+         name = QStringLiteral("main");
+      else if (!t->objectName().isEmpty())
+         name = t->objectName();
+      else
+         name = QString::number(reinterpret_cast<quintptr>(QThread::currentThreadId()), 16);
+   }
+
+   return name;
+}
+
+int bucket(quint64 ns)
+{
+   const quint64 us = ns / 1000;
+
+   int i = 0;
+   while (i < IpcStats::Method::BUCKETS - 1 && us >= (quint64(1) << i))
+      i++;
+
+   return i;
+}
+
+QString formatNs(quint64 ns)
+{
+   return ns >= 1000000 ? QString("%1ms").arg(ns/1000000.0, 0, 'f', 1)
+                        : QString("%1us").arg(ns/1000.0   , 0, 'f', 1);
+}
+
+void add(IpcStats::Kind kind, const char* interfaceName, const char* name,
+         std::chrono::steady_clock::time_point start, std::size_t payload)
+{
+   const quint64 ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start
+   ).count();
+
+   const QString thread = threadName();
+
+   QMutexLocker l(&s_Mutex);
+
+   IpcStats::Method& m = s_hMethods[Key(interfaceName, name)];
+
+   if (!m.count) {
+      m.interfaceName = interfaceName;
+      m.name          = name;
+      m.kind          = kind;
+   }
+
+   m.count++;
+   m.totalNs += ns;
+   m.maxNs    = std::max(m.maxNs, ns);
+   m.payload += payload;
+   m.threads[thread]++;
+   m.histogram[bucket(ns)]++;
+}
+
+}
+
+IpcStats::Scope::Scope(Kind kind, const char* interfaceName, const char* name) :
+m_Kind(kind), m_Interface(interfaceName), m_Name(name), m_Payload(0), m_pParent(s_pCurrent),
+m_Start(std::chrono::steady_clock::now())
+{
+   s_pCurrent = this;
+}
+
+IpcStats::Scope::~Scope()
+{
+   s_pCurrent = m_pParent;
+
+   add(m_Kind, m_Interface, m_Name, m_Start, m_Payload);
+}
+
+void IpcStats::Scope::addPayload(std::size_t bytes)
+{
+   m_Payload += bytes;
+}
+
+IpcStats::Scope* IpcStats::Scope::current()
+{
+   return s_pCurrent;
+}
+
+/**
+ * GCC names a lambda after the function declaring it, for example
+ * "[with Request = CodecCatalog::load()::<lambda()>]". Clang uses its
+ * position, "[Request = (lambda at /path/codecmodel.cpp:171:24)]".
+ */
+IpcStats::Site IpcStats::site(const char* signature)
+{
+   QByteArray type = signature;
+
+   const int start = type.indexOf("Request = ");
+   if (start == -1)
+      return {"AsyncRequest", type};
+
+   type = type.mid(start + 10);
+   type.chop(type.size() - std::max(0, type.lastIndexOf(']')));
+
+   if (type.startsWith("(lambda at ")) {
+      const QList<QByteArray> position = type.mid(11).split(':');
+      const QByteArray        file     = position.first();
+
+      return {file.mid(file.lastIndexOf('/') + 1), position.value(1)};
+   }
+
+   // The innermost function, without its arguments
+   type = type.left(type.indexOf("::<lambda"));
+   type = type.left(type.indexOf('('));
+
+   const int separator = type.lastIndexOf("::");
+   if (separator == -1)
+      return {QByteArray(), type};
+
+   return {type.left(separator), type.mid(separator + 2)};
+}
+
+void IpcStats::record(Kind kind, const char* interfaceName, const char* name,
+                      std::chrono::steady_clock::time_point start)
+{
+   add(kind, interfaceName, name, start, 0);
+}
+
+///Get a copy of the numbers, sorted by total time
+QVector<IpcStats::Method> IpcStats::snapshot()
+{
+   QVector<Method> ret;
+
+   {
+      QMutexLocker l(&s_Mutex);
+
+      // The same name can have more than one address (one per translation unit)
+      QHash<QString, int> index;
+
+      for (const Method& m : s_hMethods) {
+         const QString key = m.interfaceName + "::" + m.name;
+
+         if (!index.contains(key)) {
+            index[key] = ret.size();
+            ret << m;
+            continue;
+         }
+
+         Method& merged = ret[index[key]];
+         merged.count   += m.count;
+         merged.totalNs += m.totalNs;
+         merged.maxNs    = std::max(merged.maxNs, m.maxNs);
+         merged.payload += m.payload;
+
+         for (auto t = m.threads.constBegin(); t != m.threads.constEnd(); ++t)
+            merged.threads[t.key()] += t.value();
+
+         for (int i = 0; i < Method::BUCKETS; i++)
+            merged.histogram[i] += m.histogram[i];
+      }
+   }
+
+   std::sort(ret.begin(), ret.end(), [](const Method& a, const Method& b) {
+      return a.totalNs > b.totalNs;
+   });
+
+   return ret;
+}
+
+void IpcStats::reset()
+{
+   QMutexLocker l(&s_Mutex);
+   s_hMethods.clear();
+}
+
+///Human readable version of snapshot()
+QString IpcStats::report()
+{
+   QString ret;
+
+   for (const Method& m : snapshot()) {
+      QStringList threads;
+      for (auto t = m.threads.constBegin(); t != m.threads.constEnd(); ++t)
+         threads << QString("%1:%2").arg(t.key()).arg(t.value());
+
+      // Median from the histogram, it is the upper bound of its bucket
+      quint64 seen = 0;
+      int median = 0;
+      while (median < Method::BUCKETS - 1 && (seen += m.histogram[median]) * 2 < m.count)
+         median++;
+
+      ret += QString("%1 %2::%3 count=%4 total=%5 avg=%6 p50<%7us max=%8 payload=%9B threads=[%10]\n")
+         .arg(m.kind == Kind::CALL ? "call  " : "signal")
+         .arg(m.interfaceName)
+         .arg(m.name)
+         .arg(m.count)
+         .arg(formatNs(m.totalNs))
+         .arg(formatNs(m.totalNs / m.count))
+         .arg(quint64(1) << median)
+         .arg(formatNs(m.maxNs))
+         .arg(m.payload)
+         .arg(threads.join(", "));
+   }
+
+   return ret;
+}
+
+void IpcStats::setDumpInterval(int seconds)
+{
+   static QTimer* timer = nullptr;
+
+   if (!timer) {
+      timer = new QTimer(QCoreApplication::instance());
+      QObject::connect(timer, &QTimer::timeout, [] {
+         qDebug().noquote() << "IPC statistics:\n" + report();
+      });
+   }
+
+   if (seconds > 0)
+      timer->start(seconds * 1000);
+   else
+      timer->stop();
+}
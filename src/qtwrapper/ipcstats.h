@@ -0,0 +1,136 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+/**
+ * Count the calls to the daemon and the time spent in them.
+ *
+ * This is compiled out unless ENABLE_IPC_STATS is set. Each wrapper method
+ * is recorded by IPC_STATS_CALL() and each daemon signal by
+ * IPC_STATS_SIGNAL() when it is delivered to the main thread, so its time is
+ * the time the models took to handle it. The strings converted while a call
+ * or signal is being recorded are added to its payload size.
+ *
+ * With D-Bus, the asynchronous requests sent through AsyncRequest are
+ * recorded by record() from when they are sent until their reply reaches the
+ * main thread. The replies don't say which method they answer, so they are
+ * counted under the function sending them.
+ *
+ * The LRC_IPC_STATS_DUMP environment variable, in seconds, print a report
+ * periodically.
+ */
+#ifdef ENABLE_IPC_STATS
+
+// Qt
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+// libstdc++
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace IpcStats {
+
+enum class Kind {
+   CALL  , /*!< A method called on the daemon   */
+   SIGNAL, /*!< A callback from the daemon      */
+};
+
+///Accumulated numbers for a single method or signal
+struct Method {
+   static constexpr int BUCKETS = 21;
+
+   QString                interfaceName;
+   QString                name         ;
+   Kind                   kind         { Kind::CALL };
+   quint64                count        { 0 };
+   quint64                totalNs      { 0 };
+   quint64                maxNs        { 0 };
+   quint64                payload      { 0 }; // bytes converted to or from the daemon
+   QHash<QString,quint64> threads      ;      // thread name -> count
+
+   /// Bucket i count latencies below 2^i microseconds, the last the rest
+   std::array<quint64, BUCKETS> histogram {{}};
+};
+
+///Record a call or signal for as long as the object lives
+class Scope final
+{
+public:
+   Scope(Kind kind, const char* interfaceName, const char* name);
+   ~Scope();
+
+   Scope(const Scope&) = delete;
+   Scope& operator=(const Scope&) = delete;
+
+   void addPayload(std::size_t bytes);
+
+   ///The innermost scope of the current thread, if any
+   static Scope* current();
+
+private:
+   Kind        m_Kind      ;
+   const char* m_Interface ;
+   const char* m_Name      ;
+   std::size_t m_Payload   ;
+   Scope*      m_pParent   ;
+   std::chrono::steady_clock::time_point m_Start;
+};
+
+///Where a request was sent from, see site()
+struct Site {
+   QByteArray interfaceName;
+   QByteArray name         ;
+};
+
+/**
+ * The class and function a lambda was declared in, from the
+ * __PRETTY_FUNCTION__ of a template taking it as its "Request" parameter.
+ */
+Site site(const char* signature);
+
+///Record a call that completed after its scope, like a D-Bus reply
+void record(Kind kind, const char* interfaceName, const char* name,
+            std::chrono::steady_clock::time_point start);
+
+QVector<Method> snapshot();
+void            reset   ();
+QString         report  ();
+
+///Print the report every `seconds` (0 to stop), call from the main thread
+void setDumpInterval(int seconds);
+
+inline void addPayload(std::size_t bytes)
+{
+   if (Scope* s = Scope::current())
+      s->addPayload(bytes);
+}
+
+}
+
+ #define IPC_STATS_CALL() IpcStats::Scope ipcStatsScope_(IpcStats::Kind::CALL, staticMetaObject.className(), __func__)
+ #define IPC_STATS_SIGNAL(name) IpcStats::Scope ipcStatsScope_(IpcStats::Kind::SIGNAL, staticMetaObject.className(), name)
+ #define IPC_STATS_PAYLOAD(bytes) IpcStats::addPayload(bytes)
+#else
+ #define IPC_STATS_CALL()
+ #define IPC_STATS_SIGNAL(name)
+ #define IPC_STATS_PAYLOAD(bytes)
+#endif
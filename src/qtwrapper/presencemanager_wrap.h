@@ -30,6 +30,7 @@
 #include "typedefs.h"
 #include <presencemanager_interface.h>
 #include "conversions_wrap.hpp"
+#include "eventqueue.h"
 
 
 /*
@@ -50,26 +51,30 @@ public:
         presHandlers = {
             exportable_callback<PresenceSignal::NewServerSubscriptionRequest>(
                 [this] (const std::string &buddyUri) {
-                       QTimer::singleShot(0, [this,buddyUri] {
-                             Q_EMIT this->newServerSubscriptionRequest(QString(buddyUri.c_str()));
+                       EventQueue::post([this,buddyUri] {
+                             IPC_STATS_SIGNAL("newServerSubscriptionRequest");
+                             Q_EMIT this->newServerSubscriptionRequest(toQString(buddyUri));
                        });
             }),
             exportable_callback<PresenceSignal::ServerError>(
                 [this] (const std::string &accountID, const std::string &error, const std::string &msg) {
-                       QTimer::singleShot(0, [this,accountID, error, msg] {
-                             Q_EMIT this->serverError(QString(accountID.c_str()), QString(error.c_str()), QString(msg.c_str()));
+                       EventQueue::post([this,accountID, error, msg] {
+                             IPC_STATS_SIGNAL("serverError");
+                             Q_EMIT this->serverError(toQString(accountID), toQString(error), toQString(msg));
                        });
             }),
             exportable_callback<PresenceSignal::NewBuddyNotification>(
                 [this] (const std::string &accountID, const std::string &buddyUri, bool status, const std::string &lineStatus) {
-                       QTimer::singleShot(0, [this,accountID, buddyUri, status, lineStatus] {
-                             Q_EMIT this->newBuddyNotification(QString(accountID.c_str()), QString(buddyUri.c_str()), status, QString(lineStatus.c_str()));
+                       EventQueue::post([this,accountID, buddyUri, status, lineStatus] {
+                             IPC_STATS_SIGNAL("newBuddyNotification");
+                             Q_EMIT this->newBuddyNotification(toQString(accountID), toQString(buddyUri), status, toQString(lineStatus));
                        });
             }),
             exportable_callback<PresenceSignal::SubscriptionStateChanged>(
                 [this] (const std::string &accountID, const std::string &buddyUri, bool state) {
-                       QTimer::singleShot(0, [this,accountID, buddyUri, state] {
-                             Q_EMIT this->subscriptionStateChanged(QString(accountID.c_str()), QString(buddyUri.c_str()), state);
+                       EventQueue::post([this,accountID, buddyUri, state] {
+                             IPC_STATS_SIGNAL("subscriptionStateChanged");
+                             Q_EMIT this->subscriptionStateChanged(toQString(accountID), toQString(buddyUri), state);
                        });
             })
          };
@@ -80,11 +85,13 @@ public:
 public Q_SLOTS: // METHODS
     void answerServerRequest(const QString &uri, bool flag)
     {
+        IPC_STATS_CALL();
         DRing::answerServerRequest(uri.toStdString(), flag);
     }
 
     VectorMapStringString getSubscriptions(const QString &accountID)
     {
+        IPC_STATS_CALL();
         VectorMapStringString temp;
         for (auto x : DRing::getSubscriptions(accountID.toStdString())) {
             temp.push_back(convertMap(x));
@@ -94,16 +101,19 @@ public Q_SLOTS: // METHODS
 
     void publish(const QString &accountID, bool status, const QString &note)
     {
+        IPC_STATS_CALL();
         DRing::publish(accountID.toStdString(), status, note.toStdString());
     }
 
     void setSubscriptions(const QString &accountID, const QStringList &uriList)
     {
+        IPC_STATS_CALL();
         DRing::setSubscriptions(accountID.toStdString(), convertStringList(uriList));
     }
 
     void subscribeBuddy(const QString &accountID, const QString &uri, bool flag)
     {
+        IPC_STATS_CALL();
         DRing::subscribeBuddy(accountID.toStdString(), uri.toStdString(), flag);
     }
 
@@ -38,37 +38,7 @@
 
 #include "typedefs.h"
 #include "conversions_wrap.hpp"
-
-class VideoManagerInterface;
-
-class VideoManagerSignalProxy : public QObject
-{
-   Q_OBJECT
-public:
-   VideoManagerSignalProxy(VideoManagerInterface* parent);
-
-public Q_SLOTS:
-   void slotDeviceEvent();
-   void slotStartedDecoding(const QString &id, const QString &shmPath, int width, int height, bool isMixer);
-   void slotStoppedDecoding(const QString &id, const QString &shmPath, bool isMixer);
-
-private:
-   VideoManagerInterface* m_pParent;
-};
-
-class VideoManagerProxySender : public QObject
-{
-    Q_OBJECT
-    friend class VideoManagerInterface;
-public:
-
-Q_SIGNALS:
-    void deviceEvent();
-    void startedDecoding(const QString &id, const QString &shmPath, int width, int height, bool isMixer);
-    void stoppedDecoding(const QString &id, const QString &shmPath, bool isMixer);
-};
-
-
+#include "eventqueue.h"
 
 /*
  * Proxy class for interface org.ring.Ring.VideoManager
@@ -77,8 +47,6 @@ class VideoManagerInterface: public QObject
 {
     Q_OBJECT
 
-friend class VideoManagerSignalProxy;
-
 public:
 
     VideoManagerInterface();
@@ -88,13 +56,10 @@ public:
      std::map<std::string, std::shared_ptr<DRing::CallbackWrapperBase>> videoHandlers;
 #endif
 
-private:
-    VideoManagerSignalProxy* proxy;
-    VideoManagerProxySender* sender;
-
 public Q_SLOTS: // METHODS
     void applySettings(const QString &name, MapStringString settings)
     {
+        IPC_STATS_CALL();
 #ifdef ENABLE_VIDEO
         DRing::applySettings(
             name.toStdString(), convertMap(settings));
@@ -107,6 +72,7 @@ public Q_SLOTS: // METHODS
 // TODO: test!!!!!!!!!!!!!!!
     MapStringMapStringVectorString getCapabilities(const QString &name)
     {
+        IPC_STATS_CALL();
         MapStringMapStringVectorString ret;
 #ifdef ENABLE_VIDEO
         std::map<std::string, std::map<std::string, std::vector<std::string>>> temp;
@@ -115,9 +81,9 @@ public Q_SLOTS: // METHODS
         for (auto& x : temp) {
                 QMap<QString, VectorString> ytemp;
             for (auto& y : x.second) {
-                ytemp[QString(y.first.c_str())] = convertVectorString(y.second);
+                ytemp[internKey(y.first)] = convertVectorString(y.second);
             }
-            ret[QString(x.first.c_str())] = ytemp;
+            ret[internKey(x.first)] = ytemp;
         }
 #else
         Q_UNUSED(name)
@@ -127,8 +93,9 @@ public Q_SLOTS: // METHODS
 
     QString getDefaultDevice()
     {
+        IPC_STATS_CALL();
 #ifdef ENABLE_VIDEO
-        return QString::fromStdString(DRing::getDefaultDevice().c_str());
+        return toQString(DRing::getDefaultDevice());
 #else
         return QString();
 #endif
@@ -136,6 +103,7 @@ public Q_SLOTS: // METHODS
 
     QStringList getDeviceList()
     {
+        IPC_STATS_CALL();
 #ifdef ENABLE_VIDEO
         QStringList temp =
             convertStringList(DRing::getDeviceList());
@@ -147,6 +115,7 @@ public Q_SLOTS: // METHODS
 
     MapStringString getSettings(const QString &device)
     {
+        IPC_STATS_CALL();
 #ifdef ENABLE_VIDEO
         MapStringString temp =
             convertMap(DRing::getSettings(device.toStdString()));
@@ -159,6 +128,7 @@ public Q_SLOTS: // METHODS
 
     bool hasCameraStarted()
     {
+        IPC_STATS_CALL();
 #ifdef ENABLE_VIDEO
         return DRing::hasCameraStarted();
 #else
@@ -168,6 +138,7 @@ public Q_SLOTS: // METHODS
 
     void setDefaultDevice(const QString &name)
     {
+        IPC_STATS_CALL();
 #ifdef ENABLE_VIDEO
         DRing::setDefaultDevice(name.toStdString());
 #else
@@ -177,6 +148,7 @@ public Q_SLOTS: // METHODS
 
     void startCamera()
     {
+        IPC_STATS_CALL();
 #ifdef ENABLE_VIDEO
         DRing::startCamera();
 #endif
@@ -184,6 +156,7 @@ public Q_SLOTS: // METHODS
 
     void stopCamera()
     {
+        IPC_STATS_CALL();
 #ifdef ENABLE_VIDEO
         DRing::stopCamera();
 #endif
@@ -191,6 +164,7 @@ public Q_SLOTS: // METHODS
 
     bool switchInput(const QString &resource)
     {
+        IPC_STATS_CALL();
 #ifdef ENABLE_VIDEO
         return DRing::switchInput(resource.toStdString());
 #else
@@ -202,6 +176,7 @@ public Q_SLOTS: // METHODS
     void registerSinkTarget(const QString &sinkID,
                             const DRing::SinkTarget& target)
     {
+        IPC_STATS_CALL();
 #ifdef ENABLE_VIDEO
         DRing::registerSinkTarget(sinkID.toStdString(), target);
 #else
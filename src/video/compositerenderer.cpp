@@ -0,0 +1,495 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "compositerenderer.h"
+
+//Qt
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QRect>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+// Std
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+//Ring
+#include "private/videorenderer_p.h"
+#include "private/framebufferpool.h"
+#include "private/framekernels.h"
+#include "private/rendererstatistics_p.h"
+
+namespace Video {
+
+class CompositeRendererPrivate : public QObject
+{
+   Q_OBJECT
+public:
+   CompositeRendererPrivate(Video::CompositeRenderer* parent);
+
+   /**
+    * The worker thread only uses the snapshot slot, the renderer can be
+    * deleted at any time.
+    */
+   struct Source {
+      Renderer*                         renderer  ; // only compared
+      quint64                           id        ;
+      std::shared_ptr<SnapshotSlot>     snapshot  ;
+      std::shared_ptr<std::atomic_bool> dirty     ;
+      QMetaObject::Connection           connection;
+   };
+
+   ///The last good frame of a source, to repaint it after a relayout
+   struct Tile {
+      Frame                frame     ;
+      QSize                size      ;
+      Renderer::ColorSpace colorSpace;
+      QRect                rect      ;
+   };
+
+   //Attributes
+   QThread              m_Thread       ;
+   QTimer*              m_pTimer       ;
+   std::atomic_int      m_Fps          ;
+   QMutex               m_SourcesMutex ;
+   QVector<Source>      m_lSources     ;
+   bool                 m_LayoutChanged;
+   quint64              m_NextId       ;
+
+   // Only used by the worker thread
+   std::vector<uint8_t> m_Canvas       ;
+   QSize                m_CanvasSize   ;
+   QHash<quint64, Tile> m_hTiles       ; // by Source::id
+
+   // Protected by the renderer mutex()
+   FrameBufferPool::Buffer               m_pLatest        ;
+   std::chrono::steady_clock::time_point m_LatestTimestamp;
+   quint64                               m_LatestSeq   {0};
+   quint64                               m_ConsumedSeq {0};
+
+   //Helpers
+   void  compose  (                               );
+   void  fill     ( const QRect& rect             );
+   QRect tile     ( int index, int count          ) const;
+   static QRect fitted(const QRect& tile, const QSize& size);
+
+private:
+   Video::CompositeRenderer* q_ptr;
+};
+
+} // namespace Video
+
+Video::CompositeRendererPrivate::CompositeRendererPrivate(Video::CompositeRenderer* parent) :
+QObject(parent), m_pTimer(new QTimer()), m_Fps(30), m_LayoutChanged(true), m_NextId(0),
+q_ptr(parent)
+{
+   m_Thread.setObjectName(QStringLiteral("CompositeRenderer"));
+
+   // The timer lives in the worker thread, so does compose()
+   m_pTimer->moveToThread(&m_Thread);
+   connect(m_pTimer, &QTimer::timeout, m_pTimer, [this]() { compose(); });
+   connect(&m_Thread, &QThread::finished, m_pTimer, &QTimer::stop);
+}
+
+///Constructor
+Video::CompositeRenderer::CompositeRenderer(const QByteArray& id, const QSize& res, int fps) :
+Renderer(id, res),
+d_ptr(new CompositeRendererPrivate(this))
+{
+   setObjectName("Video::CompositeRenderer:"+id);
+   d_ptr->m_Fps = qMax(1, fps);
+   d_ptr->m_Thread.start();
+}
+
+///Destructor
+Video::CompositeRenderer::~CompositeRenderer()
+{
+   d_ptr->m_Thread.quit();
+   d_ptr->m_Thread.wait();
+   delete d_ptr->m_pTimer;
+
+   for (const auto& s : d_ptr->m_lSources) {
+      disconnect(s.connection);
+      s.snapshot->release();
+   }
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Worker                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+///Fill a part of the canvas with opaque black
+void Video::CompositeRendererPrivate::fill(const QRect& rect)
+{
+   static const uint8_t black[4] = {0, 0, 0, 0xff};
+
+   const QRect r = rect & QRect(QPoint(0, 0), m_CanvasSize);
+
+   for (int y = r.top(); y <= r.bottom(); y++) {
+      uint8_t* line = m_Canvas.data() + (y * m_CanvasSize.width() + r.left()) * 4;
+
+      for (int x = 0; x < r.width(); x++)
+         memcpy(line + x * 4, black, 4);
+   }
+}
+
+///The grid cell of a source, the grid is as square as possible
+QRect Video::CompositeRendererPrivate::tile(int index, int count) const
+{
+   const int cols = std::ceil(std::sqrt(count));
+   const int rows = (count + cols - 1) / cols;
+   const int w    = m_CanvasSize.width () / cols;
+   const int h    = m_CanvasSize.height() / rows;
+
+   return QRect((index % cols) * w, (index / cols) * h, w, h);
+}
+
+///The largest rectangle with the source aspect ratio centered in the tile
+QRect Video::CompositeRendererPrivate::fitted(const QRect& tile, const QSize& size)
+{
+   const QSize s = size.scaled(tile.size(), Qt::KeepAspectRatio);
+
+   return QRect(
+      tile.x() + (tile.width () - s.width ()) / 2,
+      tile.y() + (tile.height() - s.height()) / 2,
+      s.width(), s.height()
+   );
+}
+
+void Video::CompositeRendererPrivate::compose()
+{
+   const QSize size = q_ptr->size();
+
+   if (size.isEmpty())
+      return;
+
+   QVector<Source> sources;
+   bool            redrawAll;
+
+   {
+      QMutexLocker lk(&m_SourcesMutex);
+
+      // Sources deleted without being removed
+      for (int i = m_lSources.size() - 1; i >= 0; i--) {
+         if (m_lSources[i].snapshot->isClosed()) {
+            m_lSources[i].snapshot->release();
+            m_lSources.remove(i);
+            m_LayoutChanged = true;
+         }
+      }
+
+      sources         = m_lSources;
+      redrawAll       = m_LayoutChanged;
+      m_LayoutChanged = false;
+   }
+
+   if (size != m_CanvasSize) {
+      m_CanvasSize = size;
+      m_Canvas.resize(size.width() * size.height() * 4);
+      redrawAll = true;
+   }
+
+   if (redrawAll) {
+      fill(QRect(QPoint(0, 0), m_CanvasSize));
+
+      // Keep the frames of the remaining sources, only their place changes
+      QHash<quint64, Tile> tiles;
+
+      for (const Source& s : sources) {
+         if (m_hTiles.contains(s.id)) {
+            tiles[s.id]      = m_hTiles[s.id];
+            tiles[s.id].rect = QRect();
+         }
+      }
+
+      m_hTiles = tiles;
+   }
+
+   const auto colorSpace = q_ptr->colorSpace();
+   bool       changed    = redrawAll;
+
+   for (int i = 0; i < sources.size(); i++) {
+      const Source& s = sources[i];
+
+      // Always consume the flag, even for a full redraw
+      const bool dirty = s.dirty->exchange(false);
+
+      if ((!dirty) && !redrawAll)
+         continue;
+
+      Tile& last = m_hTiles[s.id];
+
+      // Read without consuming, the other views of this source still get it
+      if (dirty) {
+         QSize                srcSize;
+         Renderer::ColorSpace srcColorSpace;
+         const Frame          frame = s.snapshot->frame(&srcSize, &srcColorSpace);
+
+         const bool isValid = frame.ptr && (!srcSize.isEmpty())
+            && frame.size >= (size_t) srcSize.width() * srcSize.height() * 4
+            && (srcColorSpace == Renderer::ColorSpace::BGRA || srcColorSpace == Renderer::ColorSpace::RGBA);
+
+         if (isValid) {
+            last.frame      = frame;
+            last.size       = srcSize;
+            last.colorSpace = srcColorSpace;
+         }
+      }
+
+      // Nothing was ever received, the tile stays black
+      if (!last.frame.ptr)
+         continue;
+
+      const QSize srcSize       = last.size;
+      const auto  srcColorSpace = last.colorSpace;
+      const Frame& frame        = last.frame;
+
+      const QRect cell = tile(i, sources.size());
+      const QRect rect = fitted(cell, srcSize);
+
+      if (rect.isEmpty())
+         continue;
+
+      // The source size changed, remove the old borders
+      if (last.rect != rect) {
+         fill(cell);
+         last.rect = rect;
+      }
+
+      const int stride = m_CanvasSize.width() * 4;
+      uint8_t*  dst    = m_Canvas.data() + rect.y() * stride + rect.x() * 4;
+
+      FrameKernels::scale(
+         frame.ptr, srcSize.width() * 4, srcSize.width(), srcSize.height(),
+         dst, stride, rect.width(), rect.height()
+      );
+
+      if (srcColorSpace != colorSpace)
+         FrameKernels::swizzle(dst, stride, dst, stride, rect.width(), rect.height());
+
+      changed = true;
+   }
+
+   if (!changed)
+      return;
+
+   auto rendererPrivate = q_ptr->Video::Renderer::d_ptr;
+   auto buffer          = rendererPrivate->m_Pool.acquire(m_Canvas.size());
+
+   memcpy(buffer->data(), m_Canvas.data(), m_Canvas.size());
+
+   {
+      QMutexLocker lk(q_ptr->mutex());
+
+      m_pLatest         = buffer;
+      m_LatestTimestamp = rendererPrivate->m_pStats->received();
+      m_LatestSeq++;
+
+      if (rendererPrivate->hasQueue() || rendererPrivate->isSnapshotWanted()) {
+         Frame frame;
+         frame.buffer    = m_pLatest;
+         frame.ptr       = m_pLatest->data();
+         frame.size      = m_pLatest->size();
+         frame.timestamp = m_LatestTimestamp;
+
+         if (rendererPrivate->isSnapshotWanted())
+            rendererPrivate->setSnapshot(frame);
+
+         if (rendererPrivate->hasQueue())
+            rendererPrivate->enqueue(std::move(frame));
+      }
+   }
+
+   // A source can be updated with the same picture
+   if (rendererPrivate->m_ChangeDetection
+     && !rendererPrivate->detectChanges(buffer->data(), buffer->size()))
+      return;
+
+   emit q_ptr->frameUpdated();
+
+   if (rendererPrivate->isThumbnailDue())
+      rendererPrivate->updateThumbnail(buffer->data(), buffer->size());
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Mutators                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+///Add a tile for "r", the existing tiles are rearranged
+void Video::CompositeRenderer::addRenderer(Renderer* r)
+{
+   if ((!r) || r == this || renderers().contains(r))
+      return;
+
+   CompositeRendererPrivate::Source s;
+   s.renderer = r;
+   s.snapshot = r->Video::Renderer::d_ptr->retainSnapshot();
+   s.dirty    = std::make_shared<std::atomic_bool>(true);
+
+   // Direct connection, it is only an atomic store in the producer thread
+   auto dirty = s.dirty;
+   s.connection = connect(r, &Renderer::frameUpdated, [dirty]() {
+      dirty->store(true);
+   });
+
+   QMutexLocker lk(&d_ptr->m_SourcesMutex);
+   s.id = d_ptr->m_NextId++;
+   d_ptr->m_lSources << s;
+   d_ptr->m_LayoutChanged = true;
+}
+
+void Video::CompositeRenderer::removeRenderer(Renderer* r)
+{
+   QMutexLocker lk(&d_ptr->m_SourcesMutex);
+
+   for (int i = 0; i < d_ptr->m_lSources.size(); i++) {
+      const auto& s = d_ptr->m_lSources[i];
+
+      // A deleted renderer address can be reused
+      if (s.renderer == r && !s.snapshot->isClosed()) {
+         disconnect(s.connection);
+         s.snapshot->release();
+         d_ptr->m_lSources.remove(i);
+         d_ptr->m_LayoutChanged = true;
+         return;
+      }
+   }
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Getters                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+QList<Video::Renderer*> Video::CompositeRenderer::renderers() const
+{
+   QList<Renderer*> ret;
+
+   QMutexLocker lk(&d_ptr->m_SourcesMutex);
+
+   for (const auto& s : d_ptr->m_lSources) {
+      if (!s.snapshot->isClosed())
+         ret << s.renderer;
+   }
+
+   return ret;
+}
+
+int Video::CompositeRenderer::frameRate() const
+{
+   return d_ptr->m_Fps;
+}
+
+Video::Frame Video::CompositeRenderer::currentFrame() const
+{
+   if (not isRendering())
+      return {};
+
+   QMutexLocker lock(mutex());
+   if (not d_ptr->m_pLatest)
+      return {};
+
+   Video::Frame frame;
+   frame.buffer    = d_ptr->m_pLatest;
+   frame.ptr       = frame.buffer->data();
+   frame.size      = frame.buffer->size();
+   frame.timestamp = d_ptr->m_LatestTimestamp;
+
+   if (d_ptr->m_ConsumedSeq != d_ptr->m_LatestSeq) {
+      Video::Renderer::d_ptr->m_pStats->consumed(
+         frame.timestamp, d_ptr->m_LatestSeq - d_ptr->m_ConsumedSeq - 1
+      );
+      d_ptr->m_ConsumedSeq = d_ptr->m_LatestSeq;
+   }
+
+   Video::Renderer::d_ptr->takeChangedRegions();
+
+   return frame;
+}
+
+///Use the same color space as the other renderers
+Video::Renderer::ColorSpace Video::CompositeRenderer::colorSpace() const
+{
+#if defined(Q_OS_DARWIN) && defined(ENABLE_LIBWRAP)
+   return Video::Renderer::ColorSpace::RGBA;
+#else
+   return Video::Renderer::ColorSpace::BGRA;
+#endif
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Setters                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+void Video::CompositeRenderer::setFrameRate(int fps)
+{
+   d_ptr->m_Fps = qMax(1, fps);
+
+   // Restart the timer with the new interval
+   if (isRendering()) {
+      QMetaObject::invokeMethod(d_ptr->m_pTimer, "start", Qt::QueuedConnection,
+         Q_ARG(int, 1000 / d_ptr->m_Fps)
+      );
+   }
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   Slots                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+void Video::CompositeRenderer::startRendering()
+{
+   Video::Renderer::d_ptr->m_isRendering = true;
+
+   {
+      QMutexLocker lk(&d_ptr->m_SourcesMutex);
+      d_ptr->m_LayoutChanged = true;
+   }
+
+   QMetaObject::invokeMethod(d_ptr->m_pTimer, "start", Qt::QueuedConnection,
+      Q_ARG(int, 1000 / d_ptr->m_Fps)
+   );
+
+   emit started();
+}
+
+void Video::CompositeRenderer::stopRendering()
+{
+   Video::Renderer::d_ptr->m_isRendering = false;
+
+   QMetaObject::invokeMethod(d_ptr->m_pTimer, "stop", Qt::QueuedConnection);
+
+   {
+      QMutexLocker lk(mutex());
+      d_ptr->m_pLatest.reset();
+   }
+
+   emit stopped();
+}
+
+#include <compositerenderer.moc>
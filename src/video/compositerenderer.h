@@ -0,0 +1,72 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Base
+#include "renderer.h"
+#include "typedefs.h"
+
+namespace Video {
+class CompositeRendererPrivate;
+
+/**
+ * Tile the frames of several renderers into a single frame.
+ *
+ * The mosaic is drawn on a worker thread at frameRate() frames per second.
+ * Only the tiles whose renderer produced a new frame are redrawn, and no
+ * frame is produced when nothing changed. The size of the output is the
+ * renderer size(), each tile keeps the aspect ratio of its source.
+ *
+ * The source frames are read without consuming them, the sources can be
+ * displayed elsewhere at the same time. The last frame of each source is
+ * kept, so a tile is repainted even if its source is idle.
+ */
+class LIB_EXPORT CompositeRenderer final : public Renderer {
+   #pragma GCC diagnostic push
+   #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+   Q_OBJECT
+   #pragma GCC diagnostic pop
+
+public:
+   //Constructor
+   explicit CompositeRenderer(const QByteArray& id, const QSize& res, int fps = 30);
+   virtual ~CompositeRenderer();
+
+   //Getters
+   virtual Frame      currentFrame() const override;
+   virtual ColorSpace colorSpace  () const override;
+   QList<Renderer*>   renderers   () const;
+   int                frameRate   () const;
+
+   //Setters
+   void setFrameRate(int fps);
+
+   //Mutators
+   void addRenderer   (Renderer* r);
+   void removeRenderer(Renderer* r);
+
+private:
+   QScopedPointer<CompositeRendererPrivate> d_ptr;
+   Q_DECLARE_PRIVATE(CompositeRenderer)
+
+public Q_SLOTS:
+   virtual void startRendering() override;
+   virtual void stopRendering () override;
+};
+
+}
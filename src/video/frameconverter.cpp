@@ -0,0 +1,145 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "frameconverter.h"
+
+//Ring
+#include "private/framebufferpool.h"
+#include "private/framekernels.h"
+
+namespace Video {
+
+class FrameConverterPrivate final
+{
+public:
+   //Attributes
+   FrameBufferPool m_Pool;
+
+   //Helpers
+   Frame output(std::size_t size, const Frame& source);
+};
+
+} // namespace Video
+
+///A frame in a pooled buffer with the same timestamp as the source
+Video::Frame Video::FrameConverterPrivate::output(std::size_t size, const Frame& source)
+{
+   Frame frame;
+   frame.buffer    = m_Pool.acquire(size);
+   frame.ptr       = frame.buffer->data();
+   frame.size      = size;
+   frame.timestamp = source.timestamp;
+   return frame;
+}
+
+Video::FrameConverter::FrameConverter() : d_ptr(new FrameConverterPrivate())
+{
+}
+
+Video::FrameConverter::~FrameConverter()
+{
+   delete d_ptr;
+}
+
+///The number of bytes used by a frame
+std::size_t Video::FrameConverter::frameSize(Renderer::ColorSpace colorSpace, const QSize& size)
+{
+   if (size.isEmpty())
+      return 0;
+
+   const std::size_t luma   = size.width() * size.height();
+   const std::size_t chroma = ((size.width() + 1) / 2) * ((size.height() + 1) / 2);
+
+   switch(colorSpace) {
+      case Renderer::ColorSpace::BGRA:
+      case Renderer::ColorSpace::RGBA:
+         return luma * 4;
+      case Renderer::ColorSpace::I420:
+      case Renderer::ColorSpace::NV12:
+         return luma + 2 * chroma;
+   }
+
+   return 0;
+}
+
+/**
+ * Scale "frame" to "targetSize" (if valid) then convert it to "targetColorSpace".
+ *
+ * @return an empty frame if the source is not a 32 bits format or is too small
+ */
+Video::Frame Video::FrameConverter::convert(const Frame& frame, Renderer::ColorSpace colorSpace,
+   const QSize& size, Renderer::ColorSpace targetColorSpace, const QSize& targetSize) const
+{
+   const bool rgba = colorSpace == Renderer::ColorSpace::RGBA;
+
+   if ((!rgba) && colorSpace != Renderer::ColorSpace::BGRA)
+      return {};
+
+   if ((!frame.ptr) || frame.size < frameSize(colorSpace, size) || size.isEmpty())
+      return {};
+
+   const QSize outSize  = targetSize.isValid() && !targetSize.isEmpty() ? targetSize : size;
+   const bool  isScaled = outSize != size;
+
+   const uint8_t* source = frame.ptr;
+   Frame          scaled;
+
+   if (isScaled) {
+      scaled = d_ptr->output(frameSize(colorSpace, outSize), frame);
+
+      FrameKernels::scale(
+         frame.ptr , size.width() * 4, size.width(), size.height(),
+         scaled.ptr, outSize.width() * 4, outSize.width(), outSize.height()
+      );
+
+      source = scaled.ptr;
+   }
+
+   const int w = outSize.width ();
+   const int h = outSize.height();
+
+   switch(targetColorSpace) {
+      case Renderer::ColorSpace::BGRA:
+      case Renderer::ColorSpace::RGBA: {
+         if (targetColorSpace == colorSpace)
+            return isScaled ? scaled : frame;
+
+         // The scaled buffer is not shared yet, it can be converted in place
+         Frame out = isScaled ? scaled : d_ptr->output(frameSize(targetColorSpace, outSize), frame);
+
+         FrameKernels::swizzle(source, w * 4, out.ptr, w * 4, w, h);
+         return out;
+      }
+      case Renderer::ColorSpace::I420: {
+         Frame out = d_ptr->output(frameSize(targetColorSpace, outSize), frame);
+         const int chroma = ((w + 1) / 2) * ((h + 1) / 2);
+
+         FrameKernels::toI420(source, w * 4, w, h, rgba,
+            out.ptr, out.ptr + w * h, out.ptr + w * h + chroma
+         );
+         return out;
+      }
+      case Renderer::ColorSpace::NV12: {
+         Frame out = d_ptr->output(frameSize(targetColorSpace, outSize), frame);
+
+         FrameKernels::toNV12(source, w * 4, w, h, rgba, out.ptr, out.ptr + w * h);
+         return out;
+      }
+   }
+
+   return {};
+}
@@ -0,0 +1,60 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+#include <typedefs.h>
+
+//Qt
+#include <QtCore/QSize>
+
+//Ring
+#include "renderer.h"
+
+namespace Video {
+
+class FrameConverterPrivate;
+
+/**
+ * Convert and scale the frames of a Video::Renderer.
+ *
+ * The source has to be a 32 bits format (BGRA or RGBA). The output can be
+ * any Renderer::ColorSpace, it is written in a recycled buffer owned by the
+ * returned Frame. The conversion uses SIMD instructions when available.
+ *
+ * Renderer::convertedFrame() is the easiest way to use it. A converter can
+ * be used from multiple threads.
+ */
+class LIB_EXPORT FrameConverter final
+{
+public:
+   FrameConverter();
+   ~FrameConverter();
+
+   //Mutators
+   Frame convert(const Frame& frame, Renderer::ColorSpace colorSpace, const QSize& size,
+                 Renderer::ColorSpace targetColorSpace, const QSize& targetSize = QSize()) const;
+
+   //Helpers
+   static std::size_t frameSize(Renderer::ColorSpace colorSpace, const QSize& size);
+
+private:
+   FrameConverterPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(FrameConverter)
+};
+
+}
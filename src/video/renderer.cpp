@@ -19,16 +19,276 @@
 
 //Ring
 #include "private/videorenderer_p.h"
+#include "private/framequeue.h"
+#include "private/rendererstatistics_p.h"
+#include "video/rendererstatistics.h"
+#include "video/frameconverter.h"
+#include "private/framekernels.h"
 
 //Qt
 #include <QtCore/QMutex>
 
+// Std
+#include <thread>
+
 Video::RendererPrivate::RendererPrivate(Video::Renderer* parent)
     : QObject(parent)
     , m_isRendering(false)
     , m_pMutex(new QMutex())
+    , m_pQueue(nullptr)
+    , m_QueueUsers(0)
+    , m_BufferPolicy((int)Video::Renderer::BufferPolicy::LATEST_WINS)
+    , m_pStatistics(new RendererStatistics(parent))
+    , m_pConverter(new FrameConverter())
+    , m_pWorkers(nullptr)
+    , m_ThumbnailInterval(0)
+    , m_ThumbnailPool(3)
+    , m_ChangeDetection(false)
+    , m_HashesExpired(false)
+    , m_pSnapshot(std::make_shared<SnapshotSlot>())
     , q_ptr(parent)
 {
+   m_pStats = m_pStatistics->d_ptr;
+}
+
+Video::RendererPrivate::~RendererPrivate()
+{
+   delete m_pConverter;
+   delete m_pQueue.load();
+
+   // The composite renderers drop their source when they see it
+   m_pSnapshot->m_Closed = true;
+}
+
+///If the producer needs to push its frames in the queue
+bool Video::RendererPrivate::hasQueue() const
+{
+   return m_pQueue.load(std::memory_order_relaxed);
+}
+
+///Called by the producer thread for each new frame when hasQueue() is true
+void Video::RendererPrivate::enqueue(Frame&& frame)
+{
+   const QueueUse use(this);
+   FrameQueue* queue = use.queue();
+
+   if (!queue)
+      return;
+
+   const bool latestWins = m_BufferPolicy == (int)Video::Renderer::BufferPolicy::LATEST_WINS;
+
+   if (!queue->push(std::move(frame), latestWins))
+      m_pStats->dropped();
+}
+
+///If the producer should call updateThumbnail() for the current frame
+bool Video::RendererPrivate::isThumbnailDue()
+{
+   QMutexLocker lk(&m_ThumbnailMutex);
+
+   if (m_ThumbnailSize.isEmpty())
+      return false;
+
+   return std::chrono::steady_clock::now() - m_LastThumbnail
+      >= std::chrono::milliseconds(m_ThumbnailInterval);
+}
+
+/**
+ * Called by the producer thread with a new 32 bits frame of the renderer
+ * size, when isThumbnailDue() is true.
+ */
+void Video::RendererPrivate::updateThumbnail(const uint8_t* data, std::size_t size)
+{
+   const QSize srcSize = m_pSize;
+   QSize       dstSize;
+
+   if (srcSize.isEmpty() || size < (std::size_t) srcSize.width() * srcSize.height() * 4)
+      return;
+
+   {
+      QMutexLocker lk(&m_ThumbnailMutex);
+      dstSize         = m_ThumbnailSize;
+      m_LastThumbnail = std::chrono::steady_clock::now();
+   }
+
+   if (dstSize.isEmpty())
+      return;
+
+   Frame frame;
+   frame.buffer    = m_ThumbnailPool.acquire(dstSize.width() * dstSize.height() * 4);
+   frame.ptr       = frame.buffer->data();
+   frame.size      = frame.buffer->size();
+   frame.timestamp = m_LastThumbnail;
+
+   FrameKernels::boxScale(
+      data     , srcSize.width() * 4, srcSize.width(), srcSize.height(),
+      frame.ptr, dstSize.width() * 4, dstSize.width(), dstSize.height()
+   );
+
+   {
+      QMutexLocker lk(&m_ThumbnailMutex);
+
+      // It was disabled or resized in the meantime
+      if (m_ThumbnailSize != dstSize)
+         return;
+
+      m_Thumbnail = std::move(frame);
+   }
+
+   emit q_ptr->thumbnailUpdated();
+}
+
+/**
+ * Ask the producer to keep a copy of the latest frame in the returned slot.
+ *
+ * Unlike currentFrame(), reading it doesn't consume anything, so a
+ * composite renderer can read the same source as the other views and
+ * read it again when it needs to redraw. Each call must be balanced by
+ * SnapshotSlot::release().
+ */
+std::shared_ptr<Video::SnapshotSlot> Video::RendererPrivate::retainSnapshot()
+{
+   m_pSnapshot->m_Users++;
+   return m_pSnapshot;
+}
+
+///If the producer should call setSnapshot() for each new frame
+bool Video::RendererPrivate::isSnapshotWanted() const
+{
+   return m_pSnapshot->m_Users.load(std::memory_order_relaxed) > 0;
+}
+
+///Called by the producer thread, "frame" must own its buffer
+void Video::RendererPrivate::setSnapshot(const Frame& frame)
+{
+   const auto colorSpace = q_ptr->colorSpace();
+
+   QMutexLocker lk(&m_pSnapshot->m_Mutex);
+   m_pSnapshot->m_Frame      = frame;
+   m_pSnapshot->m_Size       = m_pSize;
+   m_pSnapshot->m_ColorSpace = colorSpace;
+}
+
+///The latest frame kept by the producer, its size and color space
+Video::Frame Video::SnapshotSlot::frame(QSize* size, Renderer::ColorSpace* colorSpace) const
+{
+   QMutexLocker lk(&m_Mutex);
+
+   if (size)
+      *size = m_Size;
+
+   if (colorSpace)
+      *colorSpace = m_ColorSpace;
+
+   return m_Frame;
+}
+
+///If the renderer was deleted, no new frame will come
+bool Video::SnapshotSlot::isClosed() const
+{
+   return m_Closed;
+}
+
+void Video::SnapshotSlot::release()
+{
+   if (--m_Users)
+      return;
+
+   // Give the buffer back to the pool
+   QMutexLocker lk(&m_Mutex);
+   m_Frame = Frame();
+   m_Size  = QSize();
+}
+
+/**
+ * Called by the producer thread with a new 32 bits frame of the renderer
+ * size when change detection is enabled.
+ *
+ * Each TILE_SIZE block is hashed and compared with the previous frame, the
+ * changed blocks of a row are merged into a single rectangle.
+ *
+ * @return false if the frame is the same as the previous one
+ */
+bool Video::RendererPrivate::detectChanges(const uint8_t* data, std::size_t size)
+{
+   static const int TILE_SIZE = 64;
+
+   const QSize frameSize = m_pSize;
+
+   if (frameSize.isEmpty() || size < (std::size_t) frameSize.width() * frameSize.height() * 4)
+      return true;
+
+   const int tilesX = (frameSize.width () + TILE_SIZE - 1) / TILE_SIZE;
+   const int tilesY = (frameSize.height() + TILE_SIZE - 1) / TILE_SIZE;
+
+   std::vector<uint64_t> hashes(tilesX * tilesY);
+
+   FrameKernels::tileHashes(
+      data, frameSize.width() * 4, frameSize.width(), frameSize.height(), TILE_SIZE, hashes.data()
+   );
+
+   QVector<QRect> changed;
+
+   if (m_HashesExpired.exchange(false) || m_HashedSize != frameSize) {
+      changed << QRect(QPoint(0, 0), frameSize);
+   }
+   else {
+      for (int ty = 0; ty < tilesY; ty++) {
+         int start = -1;
+
+         for (int tx = 0; tx <= tilesX; tx++) {
+            const int  idx   = ty * tilesX + tx;
+            const bool dirty = tx < tilesX && hashes[idx] != m_lTileHashes[idx];
+
+            if (dirty && start == -1)
+               start = tx;
+            else if ((!dirty) && start != -1) {
+               changed << QRect(
+                  start * TILE_SIZE, ty * TILE_SIZE, (tx - start) * TILE_SIZE, TILE_SIZE
+               ).intersected(QRect(QPoint(0, 0), frameSize));
+               start = -1;
+            }
+         }
+      }
+   }
+
+   m_lTileHashes.swap(hashes);
+   m_HashedSize = frameSize;
+
+   if (changed.isEmpty())
+      return false;
+
+   // Keep the changes of the frames the consumer skipped
+   static const int MAX_REGIONS = 64;
+
+   QMutexLocker lk(&m_ChangedMutex);
+
+   for (const QRect& rect : changed) {
+      if (!m_lChangedRegions.contains(rect))
+         m_lChangedRegions << rect;
+   }
+
+   if (m_lChangedRegions.size() > MAX_REGIONS) {
+      QRect bounds;
+
+      for (const QRect& rect : m_lChangedRegions)
+         bounds = bounds.united(rect);
+
+      m_lChangedRegions = { bounds };
+   }
+
+   return true;
+}
+
+/**
+ * Called when the consumer gets a frame, the changes accumulated until now
+ * become the changedRegions() of this frame.
+ */
+void Video::RendererPrivate::takeChangedRegions()
+{
+   QMutexLocker lk(&m_ChangedMutex);
+   m_lTakenRegions = std::move(m_lChangedRegions);
+   m_lChangedRegions.clear();
 }
 
 Video::Renderer::Renderer(const QByteArray& id, const QSize& res) : d_ptr(new RendererPrivate(this))
@@ -67,6 +327,113 @@ QSize Video::Renderer::size() const
   return d_ptr->m_pSize;
 }
 
+///The size of the thumbnails, invalid when they are disabled
+QSize Video::Renderer::thumbnailSize() const
+{
+   QMutexLocker lk(&d_ptr->m_ThumbnailMutex);
+   return d_ptr->m_ThumbnailSize;
+}
+
+///The latest thumbnail, in the renderer colorSpace()
+Video::Frame Video::Renderer::thumbnail() const
+{
+   QMutexLocker lk(&d_ptr->m_ThumbnailMutex);
+   return d_ptr->m_Thumbnail;
+}
+
+bool Video::Renderer::isChangeDetectionEnabled() const
+{
+   return d_ptr->m_ChangeDetection;
+}
+
+/**
+ * The parts of the last frame returned by currentFrame() or takeFrame()
+ * that changed since the frame returned before it.
+ *
+ * The changes of the frames received in between are included, the regions
+ * can be used to upload only the modified parts of a texture. With a queue,
+ * takeFrame() only resets them once the queue is empty, so they can cover
+ * more than a single frame. This is the whole frame when change detection
+ * is disabled.
+ */
+QVector<QRect> Video::Renderer::changedRegions() const
+{
+   if (!d_ptr->m_ChangeDetection)
+      return { QRect(QPoint(0, 0), size()) };
+
+   QMutexLocker lk(&d_ptr->m_ChangedMutex);
+   return d_ptr->m_lTakenRegions;
+}
+
+///Return the number of frames that can be queued, 0 if the queue is disabled
+int Video::Renderer::bufferSize() const
+{
+   const RendererPrivate::QueueUse use(d_ptr);
+   const FrameQueue* queue = use.queue();
+   return queue ? queue->capacity() : 0;
+}
+
+Video::Renderer::BufferPolicy Video::Renderer::bufferPolicy() const
+{
+   return static_cast<BufferPolicy>(d_ptr->m_BufferPolicy.load());
+}
+
+///Return the number of frames discarded because the queue was full
+uint Video::Renderer::droppedFrames() const
+{
+   return d_ptr->m_pStatistics->framesDropped();
+}
+
+///The frame timing counters, they are owned by the renderer
+Video::RendererStatistics* Video::Renderer::statistics() const
+{
+   return d_ptr->m_pStatistics;
+}
+
+/**
+ * Take the oldest queued frame.
+ *
+ * This only works when bufferSize() is greater than 0. Unlike currentFrame(),
+ * each frame is returned only once. The frame timestamp can be used to
+ * schedule its presentation.
+ *
+ * @return false if there is no frame
+ */
+bool Video::Renderer::takeFrame(Frame& frame)
+{
+   const RendererPrivate::QueueUse use(d_ptr);
+   FrameQueue* queue = use.queue();
+
+   if ((!queue) || !queue->pop(frame))
+      return false;
+
+   d_ptr->m_pStats->consumed(frame.timestamp, 0);
+
+   // The changes of the frames still queued were already accumulated
+   if (queue->isEmpty())
+      d_ptr->takeChangedRegions();
+
+   return true;
+}
+
+/**
+ * Get the current frame in another format and/or size.
+ *
+ * The conversion is done in the calling thread, the returned frame uses a
+ * buffer recycled once it is released.
+ *
+ * @param size the size of the returned frame, the renderer size() if invalid
+ */
+Video::Frame Video::Renderer::convertedFrame(ColorSpace colorSpace, const QSize& size) const
+{
+   const Frame frame = currentFrame();
+
+   if (!frame.ptr)
+      return {};
+
+   return d_ptr->m_pConverter->convert(frame, this->colorSpace(), this->size(), colorSpace, size);
+}
+
 /*****************************************************************************
  *                                                                           *
  *                                 Setters                                   *
@@ -78,4 +445,73 @@ void Video::Renderer::setSize(const QSize& size) const
   d_ptr->m_pSize = size;
 }
 
+/**
+ * Keep up to "size" frames for takeFrame(). A size of 0 disables the queue,
+ * only the latest frame is then available from currentFrame().
+ *
+ * The frames queued before a resize are discarded.
+ */
+void Video::Renderer::setBufferSize(int size)
+{
+   if (size < 0)
+      size = 0;
+
+   if (size == bufferSize())
+      return;
+
+   // Each queued frame holds a buffer, keep enough of them around
+   d_ptr->m_Pool.setCapacity(size + 4);
+
+   FrameQueue* old = d_ptr->m_pQueue.exchange(size ? new FrameQueue(size) : nullptr);
+
+   if (!old)
+      return;
+
+   // The producer may still be pushing into it, wait until it is done. A
+   // push is short and the threads starting now get the new queue.
+   while (d_ptr->m_QueueUsers.load())
+      std::this_thread::yield();
+
+   delete old;
+}
+
+/**
+ * Produce a small copy of the frames, at most "fps" times per second.
+ *
+ * The thumbnails are computed by the thread receiving the frames, only when
+ * there is a new frame. thumbnailUpdated() is emitted for each of them. An
+ * invalid size disables them.
+ */
+void Video::Renderer::setThumbnailSize(const QSize& size, int fps)
+{
+   QMutexLocker lk(&d_ptr->m_ThumbnailMutex);
+
+   d_ptr->m_ThumbnailSize     = size.isValid() ? size : QSize();
+   d_ptr->m_ThumbnailInterval = 1000 / qMax(1, fps);
+   d_ptr->m_LastThumbnail     = std::chrono::steady_clock::time_point();
+
+   if (d_ptr->m_ThumbnailSize.isEmpty())
+      d_ptr->m_Thumbnail = Frame();
+}
+
+/**
+ * Compare each frame with the previous one and skip frameUpdated() when
+ * they are identical, for example when a screen or a still image is shared.
+ *
+ * The comparison is done by the thread receiving the frames. The queued
+ * frames, if any, are not affected.
+ */
+void Video::Renderer::setChangeDetectionEnabled(bool enabled)
+{
+   if (enabled && !d_ptr->m_ChangeDetection)
+      d_ptr->m_HashesExpired = true;
+
+   d_ptr->m_ChangeDetection = enabled;
+}
+
+void Video::Renderer::setBufferPolicy(BufferPolicy policy)
+{
+   d_ptr->m_BufferPolicy = (int)policy;
+}
+
 #include <renderer.moc>
@@ -25,10 +25,14 @@
 // Std
 #include <memory>
 #include <vector>
+#include <chrono>
 #include <cstdint>
 
 //Qt
+#include <QtCore/QRect>
+#include <QtCore/QVector>
 class QMutex;
+class RenderWorkerPool;
 
 //Ring
 #include "device.h"
@@ -40,6 +44,9 @@ class ShmRendererPrivate;
 class ShmRenderer;
 class DirectRendererPrivate;
 class DirectRenderer;
+class CompositeRendererPrivate;
+class CompositeRenderer;
+class RendererStatistics;
 
 /**
  * This class is used by Renderer class to expose video data frame
@@ -47,11 +54,18 @@ class DirectRenderer;
  * If an instance carries data, "storage.size()" is greater than 0
  * and equals to "size", "ptr" is equals to "storage.data()".
  * If shared data is carried, only "ptr" and "size" are set.
+ * If the data comes from a recycled buffer, "buffer" keeps it alive and
+ * "ptr" is equals to "buffer->data()". The buffer is reused for another
+ * frame once all copies of the Frame are released.
+ * "timestamp" is when the frame was received, it can be used to present
+ * queued frames at the right pace.
  */
 struct Frame {
    uint8_t*             ptr     { nullptr };
    std::size_t          size    { 0       };
    std::vector<uint8_t> storage {         };
+   std::shared_ptr<std::vector<uint8_t>> buffer {};
+   std::chrono::steady_clock::time_point timestamp {};
 };
 
 /**
@@ -72,7 +86,10 @@ class LIB_EXPORT Renderer : public QObject
    friend class Video::ShmRenderer          ;
    friend class Video::DirectRendererPrivate;
    friend class Video::DirectRenderer       ;
+   friend class Video::CompositeRendererPrivate;
+   friend class Video::CompositeRenderer    ;
    friend class VideoRendererManagerPrivate ;
+   friend class ::RenderWorkerPool          ;
 
 public:
 
@@ -83,6 +100,16 @@ public:
    enum class ColorSpace {
       BGRA , /*!< 32bit BLUE  GREEN RED ALPHA */
       RGBA , /*!< 32bit ALPHA GREEN RED BLUE  */
+      I420 , /*!< 8bit Y plane, then U and V planes subsampled by 2 */
+      NV12 , /*!< 8bit Y plane, then interleaved UV subsampled by 2 */
+   };
+
+   /**
+    * What to do when a frame is received while the queue is full.
+    */
+   enum class BufferPolicy {
+      LATEST_WINS, /*!< Discard the oldest queued frame (default) */
+      FIFO       , /*!< Discard the new frame                     */
    };
 
    //Constructor
@@ -95,11 +122,28 @@ public:
    virtual QSize      size            () const;
    virtual QMutex*    mutex           () const;
    virtual ColorSpace colorSpace      () const = 0;
+   int                bufferSize      () const;
+   BufferPolicy       bufferPolicy    () const;
+   uint               droppedFrames   () const;
+   RendererStatistics* statistics     () const;
+   QSize              thumbnailSize   () const;
+   Frame              thumbnail       () const;
+   bool               isChangeDetectionEnabled() const;
+   QVector<QRect>     changedRegions  () const;
+
+   //Mutators
+   bool  takeFrame     (Frame& frame);
+   Frame convertedFrame(ColorSpace colorSpace, const QSize& size = QSize()) const;
 
    void setSize(const QSize& size) const;
+   void setBufferSize  (int size            );
+   void setBufferPolicy(BufferPolicy policy );
+   void setThumbnailSize(const QSize& size, int fps = 5);
+   void setChangeDetectionEnabled(bool enabled);
 
 Q_SIGNALS:
    void frameUpdated(); // Emitted when a new frame is ready
+   void thumbnailUpdated(); // Emitted from the producer thread, see setThumbnailSize()
    void stopped     ();
    void started     ();
 
@@ -0,0 +1,272 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "rendererstatistics.h"
+
+//Qt
+#include <QtCore/QMetaMethod>
+#include <QtCore/QTimer>
+
+//Ring
+#include "private/rendererstatistics_p.h"
+
+constexpr const int Video::RendererStatisticsPrivate::BUCKETS[];
+
+///How often changed() can be emitted, in milliseconds
+static constexpr const int SAMPLING_INTERVAL = 1000;
+
+Video::RendererStatisticsPrivate::RendererStatisticsPrivate()
+{
+   reset();
+}
+
+void Video::RendererStatisticsPrivate::reset()
+{
+   m_Received      = 0;
+   m_Consumed      = 0;
+   m_Dropped       = 0;
+   m_Overwritten   = 0;
+   m_LatencySum    = 0;
+   m_LatencyCount  = 0;
+   m_LatencyMax    = 0;
+   m_LockWaitSum   = 0;
+   m_LockWaitCount = 0;
+   m_LockWaitMax   = 0;
+   m_LastReceived  = 0;
+
+   for (auto& bucket : m_lIntervals)
+      bucket = 0;
+}
+
+void Video::RendererStatisticsPrivate::storeMax(std::atomic<quint64>& max, quint64 value)
+{
+   quint64 current = max.load(std::memory_order_relaxed);
+
+   while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed));
+}
+
+///Called by the producer for each frame, return the frame timestamp
+Video::RendererStatisticsPrivate::Clock::time_point Video::RendererStatisticsPrivate::received()
+{
+   const auto now  = Clock::now();
+   const auto last = m_LastReceived.exchange(now.time_since_epoch().count());
+
+   m_Received.fetch_add(1, std::memory_order_relaxed);
+
+   if (!last)
+      return now;
+
+   const auto interval = std::chrono::duration_cast<std::chrono::milliseconds>(
+      now - Clock::time_point(Clock::duration(last))
+   ).count();
+
+   int bucket = 0;
+   while (bucket < BUCKET_COUNT - 1 && interval > BUCKETS[bucket])
+      bucket++;
+
+   m_lIntervals[bucket].fetch_add(1, std::memory_order_relaxed);
+
+   return now;
+}
+
+/**
+ * Called by the consumer for each new frame.
+ *
+ * @param timestamp when the frame was received
+ * @param skipped how many frames were replaced before the consumer got them
+ */
+void Video::RendererStatisticsPrivate::consumed(Clock::time_point timestamp, quint64 skipped)
+{
+   m_Consumed.fetch_add(1, std::memory_order_relaxed);
+
+   if (skipped)
+      m_Overwritten.fetch_add(skipped, std::memory_order_relaxed);
+
+   if (timestamp == Clock::time_point())
+      return;
+
+   const quint64 latency = std::chrono::duration_cast<std::chrono::microseconds>(
+      Clock::now() - timestamp
+   ).count();
+
+   m_LatencySum  .fetch_add(latency, std::memory_order_relaxed);
+   m_LatencyCount.fetch_add(1      , std::memory_order_relaxed);
+   storeMax(m_LatencyMax, latency);
+}
+
+void Video::RendererStatisticsPrivate::dropped()
+{
+   m_Dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Video::RendererStatisticsPrivate::lockWaited(Clock::duration wait)
+{
+   const quint64 us = std::chrono::duration_cast<std::chrono::microseconds>(wait).count();
+
+   m_LockWaitSum  .fetch_add(us, std::memory_order_relaxed);
+   m_LockWaitCount.fetch_add(1 , std::memory_order_relaxed);
+   storeMax(m_LockWaitMax, us);
+}
+
+///When the latest frame was received, the epoch if none was
+Video::RendererStatisticsPrivate::Clock::time_point Video::RendererStatisticsPrivate::lastReceived() const
+{
+   return Clock::time_point(Clock::duration(m_LastReceived.load()));
+}
+
+///Changes when any of the counters does
+quint64 Video::RendererStatisticsPrivate::sampleKey() const
+{
+   return m_Received + m_Consumed + m_Dropped + m_Overwritten + m_LockWaitCount;
+}
+
+Video::RendererStatistics::RendererStatistics(QObject* parent) : QObject(parent),
+d_ptr(new RendererStatisticsPrivate())
+{
+   d_ptr->m_pTimer = new QTimer(this);
+   d_ptr->m_pTimer->setInterval(SAMPLING_INTERVAL);
+   connect(d_ptr->m_pTimer, &QTimer::timeout, this, &RendererStatistics::sample);
+}
+
+Video::RendererStatistics::~RendererStatistics()
+{
+   delete d_ptr;
+}
+
+quint64 Video::RendererStatistics::framesReceived() const
+{
+   return d_ptr->m_Received;
+}
+
+///The number of frames returned by currentFrame() or takeFrame()
+quint64 Video::RendererStatistics::framesConsumed() const
+{
+   return d_ptr->m_Consumed;
+}
+
+///The number of frames discarded because the queue was full
+quint64 Video::RendererStatistics::framesDropped() const
+{
+   return d_ptr->m_Dropped;
+}
+
+///The number of frames replaced by a newer one before being consumed
+quint64 Video::RendererStatistics::framesOverwritten() const
+{
+   return d_ptr->m_Overwritten;
+}
+
+///The number of inter-frame intervals in each intervalBuckets() range
+QVariantList Video::RendererStatistics::intervalHistogram() const
+{
+   QVariantList ret;
+
+   for (const auto& bucket : d_ptr->m_lIntervals)
+      ret << QVariant::fromValue<quint64>(bucket);
+
+   return ret;
+}
+
+///The average time between the reception of a frame and its consumption
+int Video::RendererStatistics::averageLatency() const
+{
+   const quint64 count = d_ptr->m_LatencyCount;
+   return count ? d_ptr->m_LatencySum / count : 0;
+}
+
+int Video::RendererStatistics::maximumLatency() const
+{
+   return d_ptr->m_LatencyMax;
+}
+
+///The average time spent waiting for the shared memory lock
+int Video::RendererStatistics::averageLockWait() const
+{
+   const quint64 count = d_ptr->m_LockWaitCount;
+   return count ? d_ptr->m_LockWaitSum / count : 0;
+}
+
+int Video::RendererStatistics::maximumLockWait() const
+{
+   return d_ptr->m_LockWaitMax;
+}
+
+Video::RendererStatistics::Snapshot Video::RendererStatistics::snapshot() const
+{
+   Snapshot s;
+
+   s.time              = std::chrono::steady_clock::now();
+   s.framesReceived    = framesReceived   ();
+   s.framesConsumed    = framesConsumed   ();
+   s.framesDropped     = framesDropped    ();
+   s.framesOverwritten = framesOverwritten();
+   s.averageLatency    = averageLatency   ();
+   s.maximumLatency    = maximumLatency   ();
+   s.averageLockWait   = averageLockWait  ();
+   s.maximumLockWait   = maximumLockWait  ();
+
+   s.intervalHistogram.reserve(RendererStatisticsPrivate::BUCKET_COUNT);
+
+   for (const auto& bucket : d_ptr->m_lIntervals)
+      s.intervalHistogram << bucket;
+
+   return s;
+}
+
+///The upper bound (in milliseconds) of each histogram bucket but the last
+QVector<int> Video::RendererStatistics::intervalBuckets()
+{
+   QVector<int> ret;
+
+   for (const int bound : RendererStatisticsPrivate::BUCKETS)
+      ret << bound;
+
+   return ret;
+}
+
+void Video::RendererStatistics::reset()
+{
+   d_ptr->reset();
+   d_ptr->m_LastSample = 0;
+   emit changed();
+}
+
+void Video::RendererStatistics::sample()
+{
+   const quint64 key = d_ptr->sampleKey();
+
+   if (key == d_ptr->m_LastSample)
+      return;
+
+   d_ptr->m_LastSample = key;
+   emit changed();
+}
+
+///Only sample while someone listens, the connection can be from any thread
+void Video::RendererStatistics::connectNotify(const QMetaMethod& signal)
+{
+   if (signal == QMetaMethod::fromSignal(&RendererStatistics::changed))
+      QMetaObject::invokeMethod(d_ptr->m_pTimer, "start");
+}
+
+void Video::RendererStatistics::disconnectNotify(const QMetaMethod& signal)
+{
+   // An invalid signal means everything was disconnected
+   if ((!signal.isValid() || signal == QMetaMethod::fromSignal(&RendererStatistics::changed))
+    && !isSignalConnected(QMetaMethod::fromSignal(&RendererStatistics::changed)))
+      QMetaObject::invokeMethod(d_ptr->m_pTimer, "stop");
+}
@@ -0,0 +1,122 @@
+/****************************************************************************
+ *   Copyright (C) 2016 by Savoir-faire Linux                               *
+ *   Author : Emmanuel Lepage Vallee <emmanuel.lepage@savoirfairelinux.com> *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+#include <typedefs.h>
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+#include <QtCore/QVariant>
+
+// Std
+#include <chrono>
+
+namespace Video {
+
+class RendererStatisticsPrivate;
+class RendererPrivate;
+
+/**
+ * Frame timing counters of a Video::Renderer.
+ *
+ * They are updated by the thread receiving the frames and the one consuming
+ * them, reading them is cheap and can be done from any thread. Use the
+ * properties to display them or snapshot() to compare two samples. The
+ * durations are in microseconds.
+ *
+ * A high latency with regular intervals points to a client rendering stall,
+ * irregular intervals to network or decoding jitter.
+ *
+ * The counters change with every frame, changed() is instead emitted once
+ * per sampling period when they did. The sampling only runs while something
+ * is connected to changed().
+ */
+class LIB_EXPORT RendererStatistics final : public QObject
+{
+   #pragma GCC diagnostic push
+   #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+   Q_OBJECT
+   #pragma GCC diagnostic pop
+
+   friend class Video::RendererPrivate;
+
+public:
+   Q_PROPERTY(quint64      framesReceived    READ framesReceived    NOTIFY changed)
+   Q_PROPERTY(quint64      framesConsumed    READ framesConsumed    NOTIFY changed)
+   Q_PROPERTY(quint64      framesDropped     READ framesDropped     NOTIFY changed)
+   Q_PROPERTY(quint64      framesOverwritten READ framesOverwritten NOTIFY changed)
+   Q_PROPERTY(QVariantList intervalHistogram READ intervalHistogram NOTIFY changed)
+   Q_PROPERTY(int          averageLatency    READ averageLatency    NOTIFY changed)
+   Q_PROPERTY(int          maximumLatency    READ maximumLatency    NOTIFY changed)
+   Q_PROPERTY(int          averageLockWait   READ averageLockWait   NOTIFY changed)
+   Q_PROPERTY(int          maximumLockWait   READ maximumLockWait   NOTIFY changed)
+
+   ///The counters at a given time
+   struct Snapshot {
+      std::chrono::steady_clock::time_point time             ;
+      quint64                               framesReceived   ;
+      quint64                               framesConsumed   ;
+      quint64                               framesDropped    ;
+      quint64                               framesOverwritten;
+      QVector<quint64>                      intervalHistogram;
+      int                                   averageLatency   ;
+      int                                   maximumLatency   ;
+      int                                   averageLockWait  ;
+      int                                   maximumLockWait  ;
+   };
+
+   explicit RendererStatistics(QObject* parent = nullptr);
+   virtual ~RendererStatistics();
+
+   //Getters
+   quint64      framesReceived   () const;
+   quint64      framesConsumed   () const;
+   quint64      framesDropped    () const;
+   quint64      framesOverwritten() const;
+   QVariantList intervalHistogram() const;
+   int          averageLatency   () const;
+   int          maximumLatency   () const;
+   int          averageLockWait  () const;
+   int          maximumLockWait  () const;
+   Snapshot     snapshot         () const;
+
+   static QVector<int> intervalBuckets();
+
+public Q_SLOTS:
+   void reset();
+
+protected:
+   virtual void connectNotify   (const QMetaMethod& signal) override;
+   virtual void disconnectNotify(const QMetaMethod& signal) override;
+
+private:
+   RendererStatisticsPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(RendererStatistics)
+
+private Q_SLOTS:
+   void sample();
+
+Q_SIGNALS:
+   ///The counters changed during the last sampling period
+   void changed();
+};
+
+}
+
+Q_DECLARE_METATYPE(Video::RendererStatistics*)